@@ -18,6 +18,9 @@
 
 #include "controller.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include "instruction.h"
 
 using namespace nsbaci::types;
@@ -25,6 +28,71 @@ using namespace nsbaci::services;
 
 namespace nsbaci {
 
+namespace {
+
+QString deadlockMessage(const runtime::DeadlockReport& report) {
+  std::string text = report.global ? "Deadlock: every remaining thread is "
+                                     "blocked.\n"
+                                   : "Deadlock: these threads wait for each "
+                                     "other.\n";
+  return QString::fromStdString(text + report.describe() + "\n");
+}
+
+QString breakpointMessage(const BreakpointHit& hit) {
+  return QString("Thread %1 stopped at breakpoint %2.\n")
+      .arg(hit.thread)
+      .arg(hit.pc);
+}
+
+QString watchpointMessage(const std::vector<WatchpointHit>& hits) {
+  QString text;
+  for (const auto& hit : hits) {
+    text += QString("Thread %1 wrote %2 to address %3 at pc %4 (was %5).\n")
+                .arg(hit.thread)
+                .arg(hit.newValue)
+                .arg(hit.addr)
+                .arg(hit.pc)
+                .arg(hit.oldValue);
+  }
+  return text;
+}
+
+QString invariantMessage(const std::vector<InvariantFailure>& failures) {
+  QString text;
+  for (const auto& failure : failures) {
+    if (failure.error.empty()) {
+      text += QString("Invariant '%1' broken by thread %2 at pc %3.\n")
+                  .arg(QString::fromStdString(failure.text))
+                  .arg(failure.thread)
+                  .arg(failure.pc);
+    } else {
+      text += QString("Invariant '%1' could not be checked after thread %2 "
+                      "at pc %3: %4.\n")
+                  .arg(QString::fromStdString(failure.text))
+                  .arg(failure.thread)
+                  .arg(failure.pc)
+                  .arg(QString::fromStdString(failure.error));
+    }
+  }
+  return text;
+}
+
+QString contentionMessage(const runtime::ContentionReport& report) {
+  return QString::fromStdString("Contention over " +
+                                std::to_string(report.steps) + " steps:\n" +
+                                report.describe());
+}
+
+QString raceMessage(const std::vector<runtime::Race>& races) {
+  std::string text;
+  for (const auto& race : races) {
+    text += "Data race " + race.describe() + "\n";
+  }
+  return QString::fromStdString(text);
+}
+
+}  // namespace
+
 Controller::Controller(FileService&& f, CompilerService&& c, RuntimeService&& r,
                        DrawingService&& d, QObject* parent)
     : QObject(parent),
@@ -36,8 +104,17 @@ Controller::Controller(FileService&& f, CompilerService&& c, RuntimeService&& r,
   runTimer = new QTimer(this);
   runTimer->setInterval(1000);  // 10ms between batches for responsive UI
   connect(runTimer, &QTimer::timeout, this, &Controller::runBatch);
+
+  // Cheap at UI speed, and lets any run be saved and replayed
+  runtimeService.setRecording(true);
+
+  // Lets the user step backwards; older steps are rebuilt from snapshots
+  const size_t UNDO_JOURNAL_BYTES = size_t(64) << 20;
+  runtimeService.setUndoJournalLimit(UNDO_JOURNAL_BYTES);
 }
 
+Controller::~Controller() { stopTrace(); }
+
 void Controller::onSaveRequested(File file, Text contents) {
   auto saveRes = fileService.save(contents, file);
 
@@ -80,8 +157,11 @@ void Controller::onRunRequested() {
   // Get the compiled program and symbols, load into runtime
   auto instructions = compilerService.takeInstructions();
   auto symbols = compilerService.takeSymbols();
+  auto lines = compilerService.takeLines();
   runtimeService.loadProgram(
-      services::runtime::Program(std::move(instructions), std::move(symbols)));
+      std::make_shared<const services::runtime::CodeImage>(
+          std::move(instructions), std::move(symbols), std::move(lines)));
+  applyLineBreakpoints();
 
   // Set up output callback to forward to UI
   runtimeService.setOutputCallback([this](const std::string& output) {
@@ -102,6 +182,25 @@ void Controller::onStepRequested() {
     // TODO: Handle runtime errors
   }
 
+  if (!result.races.empty()) {
+    emit outputReceived(raceMessage(result.races));
+  }
+  if (result.deadlock.has_value()) {
+    emit outputReceived(deadlockMessage(*result.deadlock));
+  }
+  if (result.replayEnded) {
+    emit outputReceived(QString("Replay finished.\n"));
+  }
+  if (result.breakpoint.has_value()) {
+    emit outputReceived(breakpointMessage(*result.breakpoint));
+  }
+  if (!result.watchpoints.empty()) {
+    emit outputReceived(watchpointMessage(result.watchpoints));
+  }
+  if (!result.invariants.empty()) {
+    emit outputReceived(invariantMessage(result.invariants));
+  }
+
   // Handle input requests
   if (result.needsInput) {
     emit inputRequested(QString::fromStdString(result.inputPrompt));
@@ -122,6 +221,22 @@ void Controller::onStepThreadRequested(ThreadID threadId) {
     // TODO: Handle runtime errors
   }
 
+  if (!result.races.empty()) {
+    emit outputReceived(raceMessage(result.races));
+  }
+  if (result.deadlock.has_value()) {
+    emit outputReceived(deadlockMessage(*result.deadlock));
+  }
+  if (result.breakpoint.has_value()) {
+    emit outputReceived(breakpointMessage(*result.breakpoint));
+  }
+  if (!result.watchpoints.empty()) {
+    emit outputReceived(watchpointMessage(result.watchpoints));
+  }
+  if (!result.invariants.empty()) {
+    emit outputReceived(invariantMessage(result.invariants));
+  }
+
   // Handle input requests
   if (result.needsInput) {
     emit inputRequested(QString::fromStdString(result.inputPrompt));
@@ -134,6 +249,52 @@ void Controller::onStepThreadRequested(ThreadID threadId) {
   updateRuntimeDisplay();
 }
 
+void Controller::onStepBackRequested() {
+  if (isRunning) {
+    return;
+  }
+
+  auto result = runtimeService.stepBack();
+  if (!result.ok && !result.errors.empty()) {
+    emit outputReceived(
+        QString::fromStdString(result.errors[0].basic.message + "\n"));
+  }
+
+  emit runtimeStateChanged(false, runtimeService.isHalted());
+  updateRuntimeDisplay();
+}
+
+void Controller::onRunBackwardRequested() {
+  if (isRunning) {
+    return;
+  }
+
+  auto result =
+      runtimeService.runBackward(runtimeService.breakpointAddresses());
+  if (!result.ok && !result.errors.empty()) {
+    emit outputReceived(
+        QString::fromStdString(result.errors[0].basic.message + "\n"));
+  }
+
+  emit runtimeStateChanged(false, runtimeService.isHalted());
+  updateRuntimeDisplay();
+}
+
+void Controller::onSeekRequested(quint64 position) {
+  if (isRunning) {
+    return;
+  }
+
+  auto result = runtimeService.seekTo(position);
+  if (!result.ok && !result.errors.empty()) {
+    emit outputReceived(
+        QString::fromStdString(result.errors[0].basic.message + "\n"));
+  }
+
+  emit runtimeStateChanged(false, runtimeService.isHalted());
+  updateRuntimeDisplay();
+}
+
 void Controller::onRunContinueRequested() {
   if (runtimeService.isHalted()) {
     return;
@@ -164,6 +325,10 @@ void Controller::runBatch() {
       return;
     }
 
+    if (!result.races.empty()) {
+      emit outputReceived(raceMessage(result.races));
+    }
+
     // Handle I/O
     if (result.needsInput) {
       emit inputRequested(QString::fromStdString(result.inputPrompt));
@@ -175,14 +340,72 @@ void Controller::runBatch() {
       return;
     }
 
+    if (result.deadlock.has_value()) {
+      emit outputReceived(deadlockMessage(*result.deadlock));
+      reportContention();
+      isRunning = false;
+      runTimer->stop();
+      emit runtimeStateChanged(false, result.halted);
+      updateRuntimeDisplay();
+      return;
+    }
+
     if (result.halted) {
       emit outputReceived(QString("Program halted.\n"));
+      reportContention();
       isRunning = false;
       runTimer->stop();
       emit runtimeStateChanged(false, true);
       updateRuntimeDisplay();
       return;
     }
+
+    if (result.replayEnded) {
+      emit outputReceived(QString("Replay finished.\n"));
+      isRunning = false;
+      runTimer->stop();
+      emit runtimeStateChanged(false, false);
+      updateRuntimeDisplay();
+      return;
+    }
+
+    if (result.breakpoint.has_value()) {
+      emit outputReceived(breakpointMessage(*result.breakpoint));
+      isRunning = false;
+      runTimer->stop();
+      emit runtimeStateChanged(false, false);
+      updateRuntimeDisplay();
+      return;
+    }
+
+    if (!result.watchpoints.empty()) {
+      emit outputReceived(watchpointMessage(result.watchpoints));
+      isRunning = false;
+      runTimer->stop();
+      emit runtimeStateChanged(false, result.halted);
+      updateRuntimeDisplay();
+      return;
+    }
+
+    if (!result.invariants.empty()) {
+      emit outputReceived(invariantMessage(result.invariants));
+      isRunning = false;
+      runTimer->stop();
+      emit runtimeStateChanged(false, result.halted);
+      updateRuntimeDisplay();
+      return;
+    }
+
+    if (result.livelock) {
+      emit outputReceived(
+          QString("Probable livelock: the program keeps returning to the "
+                  "same states without making progress.\n"));
+      isRunning = false;
+      runTimer->stop();
+      emit runtimeStateChanged(false, false);
+      updateRuntimeDisplay();
+      return;
+    }
   }
 
   // Update display periodically during execution
@@ -228,12 +451,363 @@ void Controller::onInputProvided(const QString& input) {
   }
 }
 
+void Controller::onRaceDetectionToggled(bool enabled) {
+  runtimeService.setRaceDetection(enabled);
+}
+
+void Controller::onProfilingToggled(bool enabled) {
+  runtimeService.setProfiling(enabled);
+  runtimeService.setContentionProfiling(enabled);
+  emit lineProfileUpdated({});
+  if (programLoaded) {
+    updateRuntimeDisplay();
+  }
+}
+
+void Controller::onSaveProfileRequested(File file) {
+  if (!runtimeService.isProfilingEnabled()) {
+    emit outputReceived(
+        QString("Turn profiling on and run the program to save a profile.\n"));
+    return;
+  }
+
+  const auto& profile = runtimeService.getProfile();
+  const auto& image = *runtimeService.getProgram().codeImage();
+  auto saveRes = fileService.saveAuxiliary(profile.csv(image), file);
+  if (saveRes.ok) {
+    File folded = file;
+    folded.replace_extension(".folded");
+    saveRes = fileService.saveAuxiliary(profile.folded(image), folded);
+  }
+  if (saveRes.ok) {
+    File contention = file;
+    contention.replace_extension(".contention.csv");
+    saveRes = fileService.saveAuxiliary(
+        runtimeService.getContentionReport().csv(), contention);
+  }
+
+  if (!saveRes.ok) {
+    auto uiErrors = UIError::fromBackendErrors(saveRes.errors);
+    emit saveFailed(std::move(uiErrors));
+  }
+}
+
+void Controller::onTraceToggled(bool enabled, File file) {
+  stopTrace();
+  if (!enabled) {
+    return;
+  }
+
+  auto openRes = fileService.openStream(file);
+  if (!openRes.ok) {
+    auto uiErrors = UIError::fromBackendErrors(openRes.errors);
+    emit saveFailed(std::move(uiErrors));
+    return;
+  }
+  traceFile = std::move(openRes.stream);
+  runtimeService.startTrace(
+      [stream = traceFile](const std::string& part) {
+        return stream->write(part);
+      });
+}
+
+void Controller::stopTrace() {
+  if (!traceFile) {
+    return;
+  }
+  bool written = runtimeService.stopTrace();
+  written = traceFile->close() && written;
+  traceFile.reset();
+  if (!written) {
+    emit outputReceived(
+        QString("The trace could not be written completely.\n"));
+  }
+}
+
+void Controller::onSaveReplayRequested(File file) {
+  auto saveRes = fileService.saveAuxiliary(
+      runtimeService.getReplayLog().serialize(), file);
+
+  if (!saveRes.ok) {
+    auto uiErrors = UIError::fromBackendErrors(saveRes.errors);
+    emit saveFailed(std::move(uiErrors));
+  }
+}
+
+void Controller::onReplayRequested(File file) {
+  if (runtimeService.getState() == RuntimeState::Idle) {
+    emit outputReceived(QString("Run the program before replaying a log.\n"));
+    return;
+  }
+
+  auto openRes = fileService.loadAuxiliary(file);
+  if (!openRes.ok) {
+    auto uiErrors = UIError::fromBackendErrors(openRes.errors);
+    emit loadFailed(std::move(uiErrors));
+    return;
+  }
+  auto parsed = runtime::ReplayLog::parse(openRes.contents);
+  if (!parsed.ok) {
+    auto uiErrors = UIError::fromBackendErrors(parsed.errors);
+    emit loadFailed(std::move(uiErrors));
+    return;
+  }
+
+  isRunning = false;
+  runTimer->stop();
+  uint64_t picks = parsed.log.picks();
+  runtimeService.startReplay(std::move(parsed.log));
+  emit outputReceived(QString("Replaying %1 recorded steps.\n").arg(picks));
+  emit runtimeStateChanged(false, false);
+  updateRuntimeDisplay();
+}
+
+void Controller::onSaveSessionRequested(File file) {
+  if (runtimeService.getState() == RuntimeState::Idle) {
+    emit outputReceived(QString("Run the program before saving a session.\n"));
+    return;
+  }
+
+  auto saveRes = fileService.saveSession(
+      runtimeService.saveSession().serialize(), file);
+  if (!saveRes.ok) {
+    auto uiErrors = UIError::fromBackendErrors(saveRes.errors);
+    emit saveFailed(std::move(uiErrors));
+  }
+}
+
+void Controller::onResumeSessionRequested(File file) {
+  auto openRes = fileService.loadSession(file);
+  if (!openRes.ok) {
+    auto uiErrors = UIError::fromBackendErrors(openRes.errors);
+    emit loadFailed(std::move(uiErrors));
+    return;
+  }
+  auto parsed = runtime::Session::parse(openRes.contents->data(),
+                                        openRes.contents->size());
+  if (!parsed.ok) {
+    auto uiErrors = UIError::fromBackendErrors(parsed.errors);
+    emit loadFailed(std::move(uiErrors));
+    return;
+  }
+
+  isRunning = false;
+  runTimer->stop();
+  auto resumed = runtimeService.restoreSession(parsed.session);
+  for (const auto& err : resumed.errors) {
+    if (err.basic.severity != ErrSeverity::Warning) {
+      auto uiErrors = UIError::fromBackendErrors(resumed.errors);
+      emit loadFailed(std::move(uiErrors));
+      return;
+    }
+    emit outputReceived(QString::fromStdString(err.basic.message + "\n"));
+  }
+
+  runtimeService.setOutputCallback([this](const std::string& output) {
+    emit outputReceived(QString::fromStdString(output));
+  });
+  currentProgramName = "Program";
+  programLoaded = true;
+  emit runStarted(currentProgramName);
+  emit outputReceived(QString("Resumed at step %1.\n")
+                          .arg(runtimeService.getStepCount()));
+  updateRuntimeDisplay();
+}
+
+void Controller::onBreakpointToggled(quint32 pc, ThreadID threadId) {
+  if (runtimeService.getBreakpoints().count(pc)) {
+    runtimeService.clearBreakpoint(pc);
+    emit outputReceived(QString("Breakpoint %1 removed.\n").arg(pc));
+  } else {
+    runtimeService.setBreakpoint(pc, {threadId});
+    emit outputReceived(QString("Breakpoint %1 set for thread %2.\n")
+                            .arg(pc)
+                            .arg(threadId));
+  }
+  updateRuntimeDisplay();
+}
+
+void Controller::onWatchpointToggled(quint32 address) {
+  if (runtimeService.getWatchpoints().count(address)) {
+    runtimeService.clearWatchpoint(address);
+    emit outputReceived(QString("Watchpoint %1 removed.\n").arg(address));
+    updateRuntimeDisplay();
+    return;
+  }
+
+  Watchpoint watch;
+  watch.addr = address;
+  for (const auto& [name, info] : runtimeService.getProgram().symbols()) {
+    if (info.address == address) {
+      watch.count = std::max<size_t>(info.size, 1);
+      break;
+    }
+  }
+  runtimeService.setWatchpoint(watch);
+  emit outputReceived(QString("Watchpoint %1 set.\n").arg(address));
+  updateRuntimeDisplay();
+}
+
+void Controller::onLineBreakpointToggled(int line) {
+  const auto& lines = runtimeService.getProgram().codeImage()->lines();
+  uint32_t pc = 0;
+  bool resolved = line > 0 && lines.firstPcAt(static_cast<uint32_t>(line), pc);
+
+  if (breakpointLines.erase(line)) {
+    if (resolved) {
+      runtimeService.clearBreakpoint(pc);
+      lineBreakpointPcs.erase(
+          std::remove(lineBreakpointPcs.begin(), lineBreakpointPcs.end(), pc),
+          lineBreakpointPcs.end());
+    }
+  } else {
+    breakpointLines.insert(line);
+    if (resolved) {
+      runtimeService.setBreakpoint(pc);
+      lineBreakpointPcs.push_back(pc);
+    }
+  }
+  emit breakpointLinesUpdated(
+      QList<int>(breakpointLines.begin(), breakpointLines.end()));
+  if (programLoaded) {
+    updateRuntimeDisplay();
+  }
+}
+
+void Controller::applyLineBreakpoints() {
+  for (uint32_t pc : lineBreakpointPcs) {
+    runtimeService.clearBreakpoint(pc);
+  }
+  lineBreakpointPcs.clear();
+
+  const auto& lines = runtimeService.getProgram().codeImage()->lines();
+  for (int line : breakpointLines) {
+    uint32_t pc = 0;
+    if (!lines.firstPcAt(static_cast<uint32_t>(line), pc)) {
+      emit outputReceived(
+          QString("Line %1 has no code; its breakpoint is ignored.\n")
+              .arg(line));
+      continue;
+    }
+    runtimeService.setBreakpoint(pc);
+    lineBreakpointPcs.push_back(pc);
+  }
+}
+
+void Controller::onConditionalBreakpointRequested(quint32 pc,
+                                                  const QString& condition) {
+  auto compiled = compileCondition(condition);
+  if (!compiled) {
+    return;
+  }
+  auto set = runtimeService.setBreakpoint(pc, {}, std::move(*compiled));
+  if (!set.ok) {
+    emit outputReceived(
+        QString::fromStdString(set.errors[0].basic.message + "\n"));
+    return;
+  }
+  emit outputReceived(
+      QString("Breakpoint %1 set when %2.\n").arg(pc).arg(condition));
+  updateRuntimeDisplay();
+}
+
+void Controller::onInvariantAdded(const QString& text) {
+  auto compiled = compileCondition(text);
+  if (!compiled) {
+    return;
+  }
+  auto set = runtimeService.setInvariant(std::move(*compiled));
+  if (!set.ok) {
+    emit outputReceived(
+        QString::fromStdString(set.errors[0].basic.message + "\n"));
+    return;
+  }
+  emit outputReceived(QString("Invariant '%1' set.\n").arg(text));
+}
+
+void Controller::onInvariantsCleared() {
+  runtimeService.clearInvariants();
+  emit outputReceived(QString("Invariants removed.\n"));
+}
+
+std::optional<Condition> Controller::compileCondition(const QString& text) {
+  if (runtimeService.getState() == RuntimeState::Idle) {
+    emit outputReceived(
+        QString("Run the program before adding conditions on it.\n"));
+    return std::nullopt;
+  }
+
+  // Names resolve against the program being run, not the editor's contents
+  auto compiled = compilerService.compileExpression(
+      text.toStdString(), runtimeService.getProgram().symbols());
+  if (!compiled.ok) {
+    for (const auto& err : compiled.errors) {
+      emit outputReceived(QString("Condition '%1': %2\n")
+                              .arg(text)
+                              .arg(QString::fromStdString(err.basic.message)));
+    }
+    return std::nullopt;
+  }
+  return Condition{text.toStdString(), std::move(compiled.instructions),
+                   std::move(compiled.reads)};
+}
+
 void Controller::updateRuntimeDisplay() {
   auto threads = gatherThreadInfo();
   auto variables = gatherVariableInfo();
 
   emit threadsUpdated(threads);
   emit variablesUpdated(variables);
+  emit timelineUpdated(runtimeService.timelinePosition(),
+                       runtimeService.timelineLength());
+
+  std::set<int> lines;
+  for (const auto& thread : threads) {
+    if (thread.line > 0 && thread.state != ThreadState::Terminated) {
+      lines.insert(static_cast<int>(thread.line));
+    }
+  }
+  emit executionLinesUpdated(QList<int>(lines.begin(), lines.end()));
+
+  if (runtimeService.isProfilingEnabled()) {
+    auto counts = runtimeService.getProfile().lineCounts(
+        runtimeService.getProgram().codeImage()->lines());
+    emit lineProfileUpdated(QList<quint64>(counts.begin(), counts.end()));
+  }
+
+  if constexpr (runtime::RUNTIME_STATS) {
+    const auto& stats = runtimeService.getStats();
+    QString summary =
+        QString("%1 instr/s | %2 switches | %3 blocks, %4 wakeups | "
+                "%5 ready")
+            .arg(stats.instructionsPerSecond, 0, 'f', 0)
+            .arg(stats.contextSwitches)
+            .arg(stats.blocks)
+            .arg(stats.wakeups)
+            .arg(stats.averageReady(), 0, 'f', 2);
+
+    // The opcode that ran the most, as a share of the run
+    auto top = std::max_element(stats.byOpcode.begin(), stats.byOpcode.end());
+    if (*top > 0) {
+      auto opcode = static_cast<nsbaci::compiler::Opcode>(
+          std::distance(stats.byOpcode.begin(), top));
+      summary += QString(" | %1 %2%")
+                     .arg(nsbaci::compiler::opcodeName(opcode))
+                     .arg(100.0 * double(*top) / double(stats.instructions),
+                          0, 'f', 1);
+    }
+    emit statsUpdated(summary);
+  }
+}
+
+void Controller::reportContention() {
+  if (!runtimeService.isContentionProfilingEnabled()) {
+    return;
+  }
+  auto report = runtimeService.getContentionReport();
+  if (!report.resources.empty()) {
+    emit outputReceived(contentionMessage(report));
+  }
 }
 
 std::vector<nsbaci::ui::ThreadInfo> Controller::gatherThreadInfo() {
@@ -248,12 +822,24 @@ std::vector<nsbaci::ui::ThreadInfo> Controller::gatherThreadInfo() {
     info.state = thread.getState();
     info.pc = thread.getPC();
 
-    // Get current instruction name
+    // Get current instruction name, as compiled rather than trapped
     if (info.pc < program.instructionCount()) {
       const auto& instr =
-          program.getInstruction(static_cast<uint32_t>(info.pc));
+          program.originalInstruction(static_cast<uint32_t>(info.pc));
       info.currentInstruction = QString::fromStdString(
           std::string(nsbaci::compiler::opcodeName(instr.opcode)));
+      uint32_t at = static_cast<uint32_t>(info.pc);
+      if (const auto* condition = runtimeService.getBreakpointCondition(at)) {
+        info.currentInstruction +=
+            QString(" (breakpoint when %1)")
+                .arg(QString::fromStdString(condition->text));
+      } else if (runtimeService.getBreakpoints().count(at)) {
+        info.currentInstruction += " (breakpoint)";
+      }
+      info.line = program.codeImage()->lines().lineAt(at);
+      if (info.line > 0) {
+        info.currentInstruction += QString(" [line %1]").arg(info.line);
+      }
     } else {
       info.currentInstruction = "---";
     }
@@ -273,6 +859,9 @@ std::vector<nsbaci::ui::VariableInfo> Controller::gatherVariableInfo() {
   for (const auto& [name, info] : symbols) {
     nsbaci::ui::VariableInfo varInfo;
     varInfo.name = QString::fromStdString(name);
+    if (runtimeService.getWatchpoints().count(info.address)) {
+      varInfo.name += " (watched)";
+    }
     varInfo.type = QString::fromStdString(info.type);
     varInfo.address = info.address;
     varInfo.value = QString::number(program.readMemory(info.address));
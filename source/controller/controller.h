@@ -24,8 +24,12 @@
 #ifndef NSBACI_CONTROLLER_H
 #define NSBACI_CONTROLLER_H
 
+#include <QList>
 #include <QObject>
 #include <QTimer>
+#include <memory>
+#include <optional>
+#include <set>
 
 #include "compilerService.h"
 #include "compilerTypes.h"
@@ -93,11 +97,11 @@ class Controller : public QObject {
                       QObject* parent = nullptr);
 
   /**
-   * @brief Default destructor.
+   * @brief Destructor; completes the trace being recorded, if any.
    *
    * The QTimer is automatically cleaned up through Qt's parent-child system.
    */
-  ~Controller() = default;
+  ~Controller();
 
  signals:
   /**
@@ -176,6 +180,37 @@ class Controller : public QObject {
    */
   void inputRequested(const QString& prompt);
 
+  /**
+   * @brief Emitted with the display when the position on the run changes.
+   * @param position Steps taken since the program was (re)started.
+   * @param length Steps of the run so far, including steps undone.
+   */
+  void timelineUpdated(quint64 position, quint64 length);
+
+  /**
+   * @brief Emitted with the display with the source lines threads are on.
+   * @param lines 1-based lines of the live threads, without repeats.
+   */
+  void executionLinesUpdated(const QList<int>& lines);
+
+  /**
+   * @brief Emitted when the set of breakpoints by source line changes.
+   * @param lines 1-based lines holding a breakpoint.
+   */
+  void breakpointLinesUpdated(const QList<int>& lines);
+
+  /**
+   * @brief Emitted with the display while profiling.
+   * @param counts Instructions executed per source line, indexed by line.
+   */
+  void lineProfileUpdated(const QList<quint64>& counts);
+
+  /**
+   * @brief Emitted with the display in builds that keep runtime statistics.
+   * @param summary One line summing the statistics up.
+   */
+  void statsUpdated(const QString& summary);
+
  public slots:
   /**
    * @brief Handles a request to save source code to a file.
@@ -225,6 +260,28 @@ class Controller : public QObject {
    */
   void onStepThreadRequested(nsbaci::types::ThreadID threadId);
 
+  /**
+   * @brief Undoes the last instruction executed.
+   *
+   * Output already printed stays in the console.
+   */
+  void onStepBackRequested();
+
+  /**
+   * @brief Undoes instructions back to the start of the run.
+   */
+  void onRunBackwardRequested();
+
+  /**
+   * @brief Jumps to a step of the run from the timeline.
+   *
+   * Restores the nearest checkpoint and re-executes from there without
+   * updating the display or the console until the step is reached.
+   *
+   * @param position Step to jump to.
+   */
+  void onSeekRequested(quint64 position);
+
   /**
    * @brief Starts or resumes continuous execution mode.
    *
@@ -266,7 +323,156 @@ class Controller : public QObject {
    */
   void onInputProvided(const QString& input);
 
+  /**
+   * @brief Turns data race detection on or off.
+   *
+   * Races are reported through outputReceived as they are found. The
+   * setting survives reruns and newly compiled programs.
+   *
+   * @param enabled True to detect races.
+   */
+  void onRaceDetectionToggled(bool enabled);
+
+  /**
+   * @brief Turns execution profiling on or off.
+   *
+   * While on, the editor's line numbers are shaded by how many instructions
+   * each line ran. The setting survives reruns and newly compiled programs.
+   *
+   * @param enabled True to profile.
+   */
+  void onProfilingToggled(bool enabled);
+
+  /**
+   * @brief Saves the profile of the current run.
+   *
+   * Writes a CSV of the counts per line and thread to the given file, and
+   * the same counts per instruction as folded stacks for flame graph tools
+   * next to it, with the extension .folded. The contention of semaphores
+   * and monitors goes next to them too, with the extension .contention.csv.
+   *
+   * @param file Path of the CSV report, usually next to the program.
+   */
+  void onSaveProfileRequested(nsbaci::types::File file);
+
+  /**
+   * @brief Starts or stops recording the thread schedule as a trace.
+   *
+   * The trace is streamed to the file as Chrome Trace Event JSON, which the
+   * Perfetto UI and chrome://tracing open, until recording is turned off.
+   * Each rerun shows as a new run in the same trace.
+   *
+   * @param enabled True to start recording, false to complete the file.
+   * @param file Path of the trace, usually next to the program.
+   */
+  void onTraceToggled(bool enabled, nsbaci::types::File file);
+
+  /**
+   * @brief Saves the decisions of the current run as a replay log.
+   *
+   * Every run is recorded from its last reset, so the log reproduces the
+   * run so far exactly.
+   *
+   * @param file Path of the log, usually next to the program.
+   */
+  void onSaveReplayRequested(nsbaci::types::File file);
+
+  /**
+   * @brief Restarts the loaded program and replays a saved log.
+   *
+   * The replay then proceeds with the usual step and run controls, and
+   * stops when the log is exhausted.
+   *
+   * @param file Path of the log.
+   */
+  void onReplayRequested(nsbaci::types::File file);
+
+  /**
+   * @brief Saves the whole state of the current run as a session file.
+   *
+   * @param file Path of the session, usually next to the program.
+   */
+  void onSaveSessionRequested(nsbaci::types::File file);
+
+  /**
+   * @brief Resumes a run saved as a session file.
+   *
+   * The session carries its own code, so the run continues exactly where
+   * it was saved, whatever is in the editor.
+   *
+   * @param file Path of the session.
+   */
+  void onResumeSessionRequested(nsbaci::types::File file);
+
+  /**
+   * @brief Sets or removes the breakpoint at an instruction.
+   *
+   * A new breakpoint only stops the given thread; other threads run past
+   * it. Step, run and run backward all stop at breakpoints.
+   *
+   * @param pc Instruction address.
+   * @param threadId Thread the new breakpoint applies to.
+   */
+  void onBreakpointToggled(quint32 pc, nsbaci::types::ThreadID threadId);
+
+  /**
+   * @brief Sets or removes the watchpoint on a variable.
+   *
+   * The watchpoint covers the whole variable and stops on writes by any
+   * thread, after the writing instruction.
+   *
+   * @param address Address of the variable.
+   */
+  void onWatchpointToggled(quint32 address);
+
+  /**
+   * @brief Sets or removes the breakpoint on a source line.
+   *
+   * The breakpoint stops any thread at the first instruction compiled from
+   * the line. Lines are kept across runs and resolved against the line table
+   * each time the program is run.
+   *
+   * @param line 1-based source line.
+   */
+  void onLineBreakpointToggled(int line);
+
+  /**
+   * @brief Sets a breakpoint that stops any thread while a condition holds.
+   *
+   * The condition is an nsbaci expression over the program's variables,
+   * e.g. "count > 10"; compilation errors are reported as output.
+   *
+   * @param pc Instruction address.
+   * @param condition The condition.
+   */
+  void onConditionalBreakpointRequested(quint32 pc, const QString& condition);
+
+  /**
+   * @brief Adds an invariant checked for the rest of the run.
+   *
+   * The invariant is an nsbaci expression over the program's variables,
+   * e.g. "mutex_count <= 1". Step and run stop after any instruction that
+   * leaves it false.
+   *
+   * @param text The invariant.
+   */
+  void onInvariantAdded(const QString& text);
+
+  /**
+   * @brief Removes every invariant.
+   */
+  void onInvariantsCleared();
+
  private:
+  /**
+   * @brief Compiles a condition over the variables of the running program.
+   * @param text The condition, in nsbaci syntax.
+   * @return The condition, or nothing if there is no program running or the
+   * text does not compile; the errors are reported as output.
+   */
+  std::optional<nsbaci::services::Condition> compileCondition(
+      const QString& text);
+
   /**
    * @brief Updates the UI with current thread and variable states.
    *
@@ -275,6 +481,25 @@ class Controller : public QObject {
    */
   void updateRuntimeDisplay();
 
+  /**
+   * @brief Sets the breakpoints by source line on the loaded program.
+   *
+   * Removes those set for the previous program first, as its instructions
+   * may have moved.
+   */
+  void applyLineBreakpoints();
+
+  /**
+   * @brief Shows the contention report in the console, if contention is
+   * being profiled and any semaphore or monitor was used.
+   */
+  void reportContention();
+
+  /**
+   * @brief Completes the trace being recorded, if any, and closes its file.
+   */
+  void stopTrace();
+
   /**
    * @brief Collects current thread information from the runtime.
    * @return Vector of ThreadInfo structures for UI display.
@@ -311,6 +536,11 @@ class Controller : public QObject {
   bool wasRunningBeforeInput =
       false;  ///< Tracks if execution should resume after input.
   QTimer* runTimer = nullptr;  ///< Timer for continuous execution batching.
+  std::set<int> breakpointLines;  ///< Source lines holding a breakpoint.
+  std::vector<uint32_t>
+      lineBreakpointPcs;  ///< Instructions those lines resolved to.
+  /// @brief File the trace is streamed to, while recording one.
+  std::shared_ptr<nsbaci::services::OutputFile> traceFile;
 };
 
 }  // namespace nsbaci
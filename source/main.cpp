@@ -49,6 +49,24 @@ void setupViewController(nsbaci::Controller* c, MainWindow* w) {
                    &nsbaci::Controller::onStepRequested);
   QObject::connect(w, &MainWindow::stepThreadRequested, c,
                    &nsbaci::Controller::onStepThreadRequested);
+  QObject::connect(w, &MainWindow::stepBackRequested, c,
+                   &nsbaci::Controller::onStepBackRequested);
+  QObject::connect(w, &MainWindow::runBackwardRequested, c,
+                   &nsbaci::Controller::onRunBackwardRequested);
+  QObject::connect(w, &MainWindow::seekRequested, c,
+                   &nsbaci::Controller::onSeekRequested);
+  QObject::connect(w, &MainWindow::breakpointToggled, c,
+                   &nsbaci::Controller::onBreakpointToggled);
+  QObject::connect(w, &MainWindow::watchpointToggled, c,
+                   &nsbaci::Controller::onWatchpointToggled);
+  QObject::connect(w, &MainWindow::lineBreakpointToggled, c,
+                   &nsbaci::Controller::onLineBreakpointToggled);
+  QObject::connect(w, &MainWindow::conditionalBreakpointRequested, c,
+                   &nsbaci::Controller::onConditionalBreakpointRequested);
+  QObject::connect(w, &MainWindow::invariantAdded, c,
+                   &nsbaci::Controller::onInvariantAdded);
+  QObject::connect(w, &MainWindow::invariantsCleared, c,
+                   &nsbaci::Controller::onInvariantsCleared);
   QObject::connect(w, &MainWindow::runContinueRequested, c,
                    &nsbaci::Controller::onRunContinueRequested);
   QObject::connect(w, &MainWindow::pauseRequested, c,
@@ -59,6 +77,34 @@ void setupViewController(nsbaci::Controller* c, MainWindow* w) {
                    &nsbaci::Controller::onStopRequested);
   QObject::connect(w, &MainWindow::inputProvided, c,
                    &nsbaci::Controller::onInputProvided);
+  QObject::connect(w, &MainWindow::raceDetectionToggled, c,
+                   &nsbaci::Controller::onRaceDetectionToggled);
+  QObject::connect(w, &MainWindow::profilingToggled, c,
+                   &nsbaci::Controller::onProfilingToggled);
+  QObject::connect(w, &MainWindow::saveProfileRequested,
+                   [c](const QString& filePath) {
+                     c->onSaveProfileRequested(filePath.toStdString());
+                   });
+  QObject::connect(w, &MainWindow::traceToggled,
+                   [c](bool enabled, const QString& filePath) {
+                     c->onTraceToggled(enabled, filePath.toStdString());
+                   });
+  QObject::connect(w, &MainWindow::saveReplayRequested,
+                   [c](const QString& filePath) {
+                     c->onSaveReplayRequested(filePath.toStdString());
+                   });
+  QObject::connect(w, &MainWindow::replayRequested,
+                   [c](const QString& filePath) {
+                     c->onReplayRequested(filePath.toStdString());
+                   });
+  QObject::connect(w, &MainWindow::saveSessionRequested,
+                   [c](const QString& filePath) {
+                     c->onSaveSessionRequested(filePath.toStdString());
+                   });
+  QObject::connect(w, &MainWindow::resumeSessionRequested,
+                   [c](const QString& filePath) {
+                     c->onResumeSessionRequested(filePath.toStdString());
+                   });
 
   // Controller -> View connections
   QObject::connect(c, &nsbaci::Controller::saveSucceeded, w,
@@ -87,6 +133,16 @@ void setupViewController(nsbaci::Controller* c, MainWindow* w) {
                    &MainWindow::onOutputReceived);
   QObject::connect(c, &nsbaci::Controller::inputRequested, w,
                    &MainWindow::onInputRequested);
+  QObject::connect(c, &nsbaci::Controller::timelineUpdated, w,
+                   &MainWindow::onTimelineUpdated);
+  QObject::connect(c, &nsbaci::Controller::executionLinesUpdated, w,
+                   &MainWindow::onExecutionLinesUpdated);
+  QObject::connect(c, &nsbaci::Controller::breakpointLinesUpdated, w,
+                   &MainWindow::onBreakpointLinesUpdated);
+  QObject::connect(c, &nsbaci::Controller::lineProfileUpdated, w,
+                   &MainWindow::onLineProfileUpdated);
+  QObject::connect(c, &nsbaci::Controller::statsUpdated, w,
+                   &MainWindow::onStatsUpdated);
 }
 
 int main(int argc, char* argv[]) {
@@ -11,6 +11,7 @@
 
 #include "nsbaciInterpreter.h"
 #include "nsbaciScheduler.h"
+#include "pctScheduler.h"
 
 namespace nsbaci::factories {
 
@@ -25,4 +26,26 @@ nsbaci::services::RuntimeService RuntimeServiceFactory::createService(
                                           std::move(scheduler)};
 }
 
+nsbaci::services::RuntimeService RuntimeServiceFactory::createService(
+    NsbaciRuntime, uint64_t seed) {
+  auto interpreter =
+      std::make_unique<nsbaci::services::runtime::NsbaciInterpreter>();
+  auto scheduler =
+      std::make_unique<nsbaci::services::runtime::NsbaciScheduler>(seed);
+
+  return nsbaci::services::RuntimeService{std::move(interpreter),
+                                          std::move(scheduler)};
+}
+
+nsbaci::services::RuntimeService RuntimeServiceFactory::createService(
+    PctRuntime, uint64_t seed, uint32_t depth, uint64_t steps) {
+  auto interpreter =
+      std::make_unique<nsbaci::services::runtime::NsbaciInterpreter>();
+  auto scheduler = std::make_unique<nsbaci::services::runtime::PctScheduler>(
+      seed, depth, steps);
+
+  return nsbaci::services::RuntimeService{std::move(interpreter),
+                                          std::move(scheduler)};
+}
+
 }  // namespace nsbaci::factories
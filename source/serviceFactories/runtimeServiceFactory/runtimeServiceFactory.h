@@ -13,6 +13,8 @@
 #ifndef NSBACI_RUNTIMESERVICEFACTORY_H
 #define NSBACI_RUNTIMESERVICEFACTORY_H
 
+#include <cstdint>
+
 #include "runtimeService.h"
 
 /**
@@ -28,6 +30,13 @@ struct NsbaciRuntime {
 // Tag used to generate a service with a nsbaci runtime
 constexpr inline NsbaciRuntime nsbaciRuntime{};
 
+struct PctRuntime {
+  explicit PctRuntime() = default;
+};
+
+// Tag used to generate a nsbaci runtime scheduled by PCT, for bug finding
+constexpr inline PctRuntime pctRuntime{};
+
 /**
  * @class RuntimeServiceFactory
  * @brief Factory for creating RuntimeService instances.
@@ -38,6 +47,15 @@ class RuntimeServiceFactory {
 
  public:
   static nsbaci::services::RuntimeService createService(NsbaciRuntime t);
+  // Same runtime with a seeded scheduler, for reproducible interleavings
+  static nsbaci::services::RuntimeService createService(NsbaciRuntime t,
+                                                        uint64_t seed);
+  // PCT scheduling targeting bugs of the given depth in runs of about steps
+  // instructions; see PctScheduler
+  static nsbaci::services::RuntimeService createService(PctRuntime t,
+                                                        uint64_t seed,
+                                                        uint32_t depth = 3,
+                                                        uint64_t steps = 1000);
   // static nsbaci::services::RuntimeService createService(OtherRuntimeOrTest
   // t);
   ~RuntimeServiceFactory() = default;
@@ -27,6 +27,7 @@
 #include "baseResult.h"
 #include "compilerTypes.h"
 #include "instruction.h"
+#include "lineTable.h"
 
 /**
  * @namespace nsbaci::compiler
@@ -71,6 +72,48 @@ struct CompilerResult : nsbaci::BaseResult {
 
   InstructionStream instructions;      ///< Generated p-code instructions.
   nsbaci::types::SymbolTable symbols;  ///< Symbol table from compilation.
+  LineTable lines;                     ///< Source line of each instruction.
+};
+
+/**
+ * @struct ExpressionResult
+ * @brief Result of compiling a standalone expression.
+ *
+ * The code reads global memory only and ends in a Halt with the value of
+ * the expression on top of the stack. It is used for conditions evaluated
+ * by the runtime, such as conditional breakpoints and invariants.
+ *
+ * @note On failure, the instructions and reads fields should not be used.
+ */
+struct ExpressionResult : nsbaci::BaseResult {
+  /**
+   * @brief Default constructor creates a successful empty result.
+   */
+  ExpressionResult() : BaseResult() {}
+
+  /**
+   * @brief Constructs a failed result from a vector of errors.
+   * @param errs Vector of compilation errors.
+   */
+  explicit ExpressionResult(std::vector<nsbaci::Error> errs)
+      : BaseResult(std::move(errs)) {}
+
+  /**
+   * @brief Constructs a failed result from a single error.
+   * @param error The compilation error.
+   */
+  explicit ExpressionResult(nsbaci::Error error)
+      : BaseResult(std::move(error)) {}
+
+  ExpressionResult(ExpressionResult&&) noexcept = default;
+  ExpressionResult& operator=(ExpressionResult&&) noexcept = default;
+
+  ExpressionResult(const ExpressionResult&) = default;
+  ExpressionResult& operator=(const ExpressionResult&) = default;
+
+  InstructionStream instructions;  ///< Generated p-code instructions.
+  /// @brief Global words the value depends on, in increasing order
+  std::vector<nsbaci::types::MemoryAddr> reads;
 };
 
 /**
@@ -123,6 +166,20 @@ class Compiler {
    * failure.
    */
   virtual CompilerResult compile(std::istream& input) = 0;
+
+  /**
+   * @brief Compiles a standalone expression over a program's variables.
+   *
+   * The expression may name any variable of the program but must not
+   * assign to one, so that evaluating it leaves the run unchanged.
+   *
+   * @param source The expression, e.g. "mutex_count <= 1".
+   * @param symbols Symbol table of the compiled program.
+   * @return ExpressionResult containing instructions on success, or errors
+   * on failure.
+   */
+  virtual ExpressionResult compileExpression(
+      const std::string& source, const nsbaci::types::SymbolTable& symbols) = 0;
 };
 
 }  // namespace nsbaci::compiler
@@ -20,8 +20,6 @@ const char* opcodeName(Opcode op) {
       return "LoadAddress";
     case Opcode::LoadIndirect:
       return "LoadIndirect";
-    case Opcode::LoadBlock:
-      return "LoadBlock";
     case Opcode::Store:
       return "Store";
     case Opcode::StoreKeep:
@@ -32,8 +30,6 @@ const char* opcodeName(Opcode op) {
       return "Index";
     case Opcode::CopyBlock:
       return "CopyBlock";
-    case Opcode::ValueAt:
-      return "ValueAt";
     case Opcode::MarkStack:
       return "MarkStack";
     case Opcode::UpdateDisplay:
@@ -192,6 +188,8 @@ const char* opcodeName(Opcode op) {
       return "Random";
     case Opcode::Test:
       return "Test";
+    case Opcode::Trap:
+      return "Trap";
 
     case Opcode::_Count:
       return "_Count";
@@ -33,13 +33,11 @@ enum class Opcode : uint8_t {
   LoadValue,      // Load value from address onto stack
   LoadAddress,    // Load address onto stack
   LoadIndirect,   // Load value from address pointed to by top of stack
-  LoadBlock,      // Load block of memory onto stack
   Store,          // Store top of stack to address
   StoreKeep,      // Store and keep value on stack
   PushLiteral,    // Push literal value onto stack
   Index,          // Array indexing
   CopyBlock,      // Copy block of memory
-  ValueAt,        // Get value at address on stack
   MarkStack,      // Mark stack for procedure call
   UpdateDisplay,  // Update display register
 
@@ -131,6 +129,7 @@ enum class Opcode : uint8_t {
   // ============== Miscellaneous ==============
   Random,  // Generate random number
   Test,    // Generic test instruction
+  Trap,    // Breakpoint patched in by the runtime, never emitted
 
   // ============== Total count ==============
   _Count  // Number of opcodes (keep last)
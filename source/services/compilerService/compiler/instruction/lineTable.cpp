@@ -0,0 +1,94 @@
+/**
+ * @file lineTable.cpp
+ * @brief LineTable implementation for nsbaci compiler.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "lineTable.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace nsbaci::compiler {
+
+void LineTable::mark(uint32_t pc, uint32_t line) {
+  while (!byPc.empty() && byPc.back().pc >= pc) {
+    byPc.pop_back();
+  }
+  if (!byPc.empty() && byPc.back().line == line) {
+    return;  // Still the same run
+  }
+  byPc.push_back(Run{pc, line});
+}
+
+void LineTable::finish(size_t count) {
+  end = static_cast<uint32_t>(count);
+  while (!byPc.empty() && byPc.back().pc >= end) {
+    byPc.pop_back();
+  }
+
+  // Marks undone by a later, lower one may have left equal neighbours
+  size_t kept = 0;
+  for (size_t i = 0; i < byPc.size(); ++i) {
+    if (kept == 0 || byPc[kept - 1].line != byPc[i].line) {
+      byPc[kept++] = byPc[i];
+    }
+  }
+  byPc.resize(kept);
+
+  byLine.resize(byPc.size());
+  for (uint32_t i = 0; i < byLine.size(); ++i) {
+    byLine[i] = i;
+  }
+  std::stable_sort(byLine.begin(), byLine.end(),
+                   [this](uint32_t a, uint32_t b) {
+                     return byPc[a].line < byPc[b].line;
+                   });
+}
+
+uint32_t LineTable::lineAt(uint32_t pc) const {
+  if (pc >= end) {
+    return 0;
+  }
+  auto it = std::upper_bound(
+      byPc.begin(), byPc.end(), pc,
+      [](uint32_t value, const Run& run) { return value < run.pc; });
+  if (it == byPc.begin()) {
+    return 0;
+  }
+  return std::prev(it)->line;
+}
+
+std::vector<PcRange> LineTable::pcsAt(uint32_t line) const {
+  auto first = std::lower_bound(
+      byLine.begin(), byLine.end(), line,
+      [this](uint32_t run, uint32_t value) { return byPc[run].line < value; });
+  auto last = std::upper_bound(
+      first, byLine.end(), line,
+      [this](uint32_t value, uint32_t run) { return value < byPc[run].line; });
+
+  // Runs of equal line keep their address order in the index
+  std::vector<PcRange> ranges;
+  for (auto it = first; it != last; ++it) {
+    uint32_t begin = byPc[*it].pc;
+    uint32_t stop = *it + 1 < byPc.size() ? byPc[*it + 1].pc : end;
+    ranges.push_back(PcRange{begin, stop});
+  }
+  return ranges;
+}
+
+bool LineTable::firstPcAt(uint32_t line, uint32_t& pc) const {
+  auto first = std::lower_bound(
+      byLine.begin(), byLine.end(), line,
+      [this](uint32_t run, uint32_t value) { return byPc[run].line < value; });
+  if (first == byLine.end() || byPc[*first].line != line) {
+    return false;
+  }
+  pc = byPc[*first].pc;
+  return true;
+}
+
+}  // namespace nsbaci::compiler
@@ -0,0 +1,130 @@
+/**
+ * @file lineTable.h
+ * @brief LineTable class declaration for nsbaci compiler.
+ *
+ * This module defines the map from instruction addresses to the source lines
+ * they were generated from, built by the parser while it emits code.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_COMPILER_LINETABLE_H
+#define NSBACI_COMPILER_LINETABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @namespace nsbaci::compiler
+ * @brief Compiler namespace for nsbaci.
+ */
+namespace nsbaci::compiler {
+
+/**
+ * @struct PcRange
+ * @brief Half-open range of instruction addresses.
+ */
+struct PcRange {
+  uint32_t begin = 0;  ///< First address in the range.
+  uint32_t end = 0;    ///< One past the last address.
+};
+
+/**
+ * @class LineTable
+ * @brief Run-length encoded map between instructions and source lines.
+ *
+ * Consecutive instructions from the same line share one run, so the table
+ * holds one entry per change of line rather than one per instruction. Both
+ * directions are answered by binary search: lineAt() over the runs in
+ * address order, pcsAt() over an index of the same runs sorted by line.
+ *
+ * Lines are 1-based, as the lexer counts them; line 0 means unknown.
+ */
+class LineTable {
+ public:
+  /**
+   * @struct Run
+   * @brief Instructions from one line, up to the start of the next run.
+   */
+  struct Run {
+    uint32_t pc = 0;    ///< First instruction of the run.
+    uint32_t line = 0;  ///< Source line of every instruction in the run.
+  };
+
+  /**
+   * @brief Starts a run: instructions from pc on come from line.
+   *
+   * Runs at or past pc are dropped first, so the parser may mark the same
+   * address several times as it reduces nested rules; the last mark before
+   * an instruction is emitted wins.
+   *
+   * @param pc Address of the next instruction to be emitted.
+   * @param line Source line it comes from.
+   */
+  void mark(uint32_t pc, uint32_t line);
+
+  /**
+   * @brief Closes the table once code generation is over.
+   * @param count Number of instructions in the program.
+   */
+  void finish(size_t count);
+
+  /**
+   * @brief Gets the source line of an instruction.
+   * @param pc The instruction address.
+   * @return The line, or 0 if the address is not covered.
+   */
+  uint32_t lineAt(uint32_t pc) const;
+
+  /**
+   * @brief Gets the instructions generated from a source line.
+   *
+   * A line may own several runs: the condition of a loop, for instance, is
+   * tested at the end of the body.
+   *
+   * @param line The source line.
+   * @return Its ranges in address order; empty if the line has no code.
+   */
+  std::vector<PcRange> pcsAt(uint32_t line) const;
+
+  /**
+   * @brief Gets the first instruction generated from a source line.
+   * @param line The source line.
+   * @param pc Set to the lowest address of the line.
+   * @return False if the line has no code.
+   */
+  bool firstPcAt(uint32_t line, uint32_t& pc) const;
+
+  /**
+   * @brief Access to the runs in address order.
+   * @return Const reference to the runs.
+   */
+  const std::vector<Run>& runs() const { return byPc; }
+
+  /**
+   * @brief Gets the number of instructions covered.
+   * @return Address one past the last run.
+   */
+  uint32_t instructionCount() const { return end; }
+
+  /**
+   * @brief Checks whether the table maps anything.
+   * @return True if no instruction has a line.
+   */
+  bool empty() const { return byPc.empty(); }
+
+ private:
+  // Runs in address order
+  std::vector<Run> byPc;
+  // Indices into byPc sorted by line, then address
+  std::vector<uint32_t> byLine;
+  // Address one past the last run
+  uint32_t end = 0;
+};
+
+}  // namespace nsbaci::compiler
+
+#endif  // NSBACI_COMPILER_LINETABLE_H
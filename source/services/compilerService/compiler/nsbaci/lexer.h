@@ -31,6 +31,19 @@ class Lexer : public yyFlexLexer {
   virtual ~Lexer() = default;
 
   int yylex(Parser::semantic_type* yylval, Parser::location_type* yylloc);
+
+  /**
+   * @brief Makes the next yylex() call return a token before any input.
+   *
+   * The parser's start rule reads it to choose what to parse, e.g.
+   * Parser::token::START_EXPR for a standalone expression.
+   *
+   * @param token Token to return first.
+   */
+  void setStartToken(int token) { startToken = token; }
+
+ private:
+  int startToken = 0;  ///< Token to return before any input, or 0.
 };
 
 }  // namespace nsbaci::compiler
@@ -14,6 +14,7 @@
 
 #include "nsbaciCompiler.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "lexer.h"
@@ -40,6 +41,7 @@ nsbaci::types::SymbolTable convertSymbols(const SymbolTable& st) {
     info.name = sym.name;
     info.address = sym.address;
     info.isGlobal = (sym.scopeLevel == 0);
+    info.size = sym.size;
     switch (sym.type) {
       case VarType::Int:
         info.type = "int";
@@ -59,6 +61,53 @@ nsbaci::types::SymbolTable convertSymbols(const SymbolTable& st) {
   return result;
 }
 
+/**
+ * @brief Converts a runtime symbol table back to the parser's format.
+ *
+ * Used to compile expressions over an already compiled program. Constness
+ * is not kept by the runtime format, which is fine since expressions never
+ * assign.
+ *
+ * @param symbols Symbol table in the runtime format.
+ * @return SymbolTable the parser can resolve names against.
+ */
+SymbolTable restoreSymbols(const nsbaci::types::SymbolTable& symbols) {
+  SymbolTable result;
+  for (const auto& [name, info] : symbols) {
+    Symbol sym;
+    sym.name = info.name;
+    sym.address = info.address;
+    sym.isConst = false;
+    sym.scopeLevel = info.isGlobal ? 0 : 1;
+    sym.size = info.size;
+    if (info.type == "bool") {
+      sym.type = VarType::Bool;
+    } else if (info.type == "char") {
+      sym.type = VarType::Char;
+    } else if (info.type == "void") {
+      sym.type = VarType::Void;
+    } else {
+      sym.type = VarType::Int;
+    }
+    result.symbols[name] = sym;
+    result.nextAddress = std::max(result.nextAddress, info.address + 1);
+  }
+  return result;
+}
+
+/**
+ * @brief Builds a compilation error for an expression.
+ * @param message Description of the problem.
+ * @return The error.
+ */
+nsbaci::Error expressionError(std::string message) {
+  nsbaci::Error err;
+  err.basic.severity = nsbaci::types::ErrSeverity::Error;
+  err.basic.message = std::move(message);
+  err.basic.type = nsbaci::types::ErrType::compilationError;
+  return err;
+}
+
 }  // namespace
 
 CompilerResult NsbaciCompiler::compile(const std::string& source) {
@@ -71,9 +120,11 @@ CompilerResult NsbaciCompiler::compile(std::istream& input) {
 
   SymbolTable parserSymbols;  // Compiler's internal symbol table
   Lexer lexer(&input);
-  Parser parser(lexer, result.instructions, result.errors, parserSymbols);
+  Parser parser(lexer, result.instructions, result.errors, parserSymbols,
+                result.lines);
 
   int parseResult = parser.parse();
+  result.lines.finish(result.instructions.size());
 
   // Set ok based on both parse result and whether errors were collected
   result.ok = (parseResult == 0) && result.errors.empty();
@@ -86,4 +137,64 @@ CompilerResult NsbaciCompiler::compile(std::istream& input) {
   return result;
 }
 
+ExpressionResult NsbaciCompiler::compileExpression(
+    const std::string& source, const nsbaci::types::SymbolTable& symbols) {
+  ExpressionResult result;
+
+  SymbolTable parserSymbols = restoreSymbols(symbols);
+  std::istringstream input(source);
+  Lexer lexer(&input);
+  lexer.setStartToken(Parser::token::START_EXPR);
+  LineTable lines;  // A one-line condition needs no line table
+  Parser parser(lexer, result.instructions, result.errors, parserSymbols,
+                lines);
+
+  int parseResult = parser.parse();
+  if (parseResult != 0 || !result.errors.empty()) {
+    result.ok = false;
+    return result;
+  }
+
+  // Collect the words read; indexing is compiled as base, Add, LoadIndirect
+  // and may read any element of the array
+  const auto& code = result.instructions;
+  for (size_t i = 0; i < code.size(); ++i) {
+    switch (code[i].opcode) {
+      case Opcode::LoadValue:
+        result.reads.push_back(std::get<uint32_t>(code[i].operand1));
+        break;
+      case Opcode::LoadIndirect: {
+        const Symbol* array = nullptr;
+        if (i >= 2 && code[i - 1].opcode == Opcode::Add &&
+            code[i - 2].opcode == Opcode::PushLiteral) {
+          array = parserSymbols.arrayAt(
+              static_cast<uint32_t>(std::get<int32_t>(code[i - 2].operand1)));
+        }
+        if (!array) {
+          result.errors.push_back(
+              expressionError("Only arrays can be indexed in a condition"));
+          break;
+        }
+        for (uint32_t j = 0; j < array->size; ++j) {
+          result.reads.push_back(array->address + j);
+        }
+        break;
+      }
+      case Opcode::Store:
+      case Opcode::StoreKeep:
+        result.errors.push_back(
+            expressionError("A condition cannot assign to a variable"));
+        break;
+      default:
+        break;
+    }
+  }
+
+  std::sort(result.reads.begin(), result.reads.end());
+  result.reads.erase(std::unique(result.reads.begin(), result.reads.end()),
+                     result.reads.end());
+  result.ok = result.errors.empty();
+  return result;
+}
+
 }  // namespace nsbaci::compiler
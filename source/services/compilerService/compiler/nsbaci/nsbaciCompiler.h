@@ -89,6 +89,22 @@ class NsbaciCompiler final : public Compiler {
    *         or detailed error information on failure.
    */
   CompilerResult compile(std::istream& input) override;
+
+  /**
+   * @brief Compiles a standalone expression over a program's variables.
+   *
+   * Runs the same parser with a start token that selects its expression
+   * rules, with the program's symbols in scope. Expressions that assign,
+   * such as x++, and indexing of anything but an array are rejected.
+   *
+   * @param source The expression.
+   * @param symbols Symbol table of the compiled program.
+   * @return ExpressionResult with instructions and the words they read on
+   *         success, or detailed error information on failure.
+   */
+  ExpressionResult compileExpression(
+      const std::string& source,
+      const nsbaci::types::SymbolTable& symbols) override;
 };
 
 }  // namespace nsbaci::compiler
@@ -16,6 +16,7 @@
   #include <stack>
   #include "instruction.h"
   #include "error.h"
+  #include "lineTable.h"
   namespace nsbaci::compiler { class Lexer; }
 
   namespace nsbaci::compiler {
@@ -27,6 +28,7 @@
       uint32_t address;
       bool isConst;
       int scopeLevel;
+      uint32_t size = 1;  // Number of words (array length for arrays)
     };
 
     struct SymbolTable {
@@ -47,6 +49,14 @@
         return it != symbols.end() ? &it->second : nullptr;
       }
 
+      // Array symbol whose block starts at the given address, if any
+      Symbol* arrayAt(uint32_t address) {
+        for (auto& [name, sym] : symbols) {
+          if (sym.address == address && sym.size > 1) return &sym;
+        }
+        return nullptr;
+      }
+
       void enterScope() { currentScope++; }
       void exitScope() {
         // Keep all symbols for runtime display - just decrement scope level
@@ -69,6 +79,39 @@
       is.emplace_back(op, arg);
     }
 
+    // Whole-array copy: dst and src addresses on stack, size as operand
+    inline void emitBlockCopy(InstructionStream& is, uint32_t dst,
+                              uint32_t src, uint32_t count) {
+      is.emplace_back(Opcode::LoadAddress, dst);
+      is.emplace_back(Opcode::LoadAddress, src);
+      is.emplace_back(Opcode::CopyBlock, count);
+    }
+
+    // Whole-array zero fill: clear the first word, then double the cleared
+    // prefix with block copies until it spans the array
+    inline void emitBlockClear(InstructionStream& is, uint32_t base,
+                               uint32_t count) {
+      is.emplace_back(Opcode::PushLiteral, int32_t(0));
+      is.emplace_back(Opcode::Store, base);
+      for (uint32_t done = 1; done < count; done *= 2) {
+        uint32_t part = done < count - done ? done : count - done;
+        emitBlockCopy(is, base + done, base, part);
+      }
+    }
+
+    // If the operand emitted from start on is nothing but a load of an array
+    // by name, drop it and return the array's base address so a block
+    // operation can replace it
+    inline bool takeTrailingLoad(InstructionStream& is, size_t start,
+                                 uint32_t& addr) {
+      if (is.size() != start + 1 || is.back().opcode != Opcode::LoadValue) {
+        return false;
+      }
+      addr = std::get<uint32_t>(is.back().operand1);
+      is.pop_back();
+      return true;
+    }
+
     // For patching jumps
     inline size_t emitJump(InstructionStream& is, Opcode op) {
       size_t addr = is.size();
@@ -88,6 +131,23 @@
   #include "lexer.h"
   #define yylex lexer.yylex
 
+  // Same span as Bison's default, then marks the line of the rule being
+  // reduced: Bison computes @$ right before running the rule's action, so
+  // whatever the action emits is attributed to the line the rule starts on.
+  // Inner rules reduce first, so an instruction takes the line of the
+  // innermost construct that generated it.
+  #define YYLLOC_DEFAULT(Current, Rhs, N)                                 \
+    do {                                                                  \
+      if (N) {                                                            \
+        (Current).begin = YYRHSLOC(Rhs, 1).begin;                         \
+        (Current).end = YYRHSLOC(Rhs, N).end;                             \
+      } else {                                                            \
+        (Current).begin = (Current).end = YYRHSLOC(Rhs, 0).end;           \
+      }                                                                   \
+      lines.mark(static_cast<uint32_t>(instructions.size()),              \
+                 static_cast<uint32_t>((Current).begin.line));            \
+    } while (false)
+
   // Global symbol table for parsing - passed implicitly
   static nsbaci::compiler::SymbolTable symtab;
 
@@ -100,6 +160,7 @@
 %parse-param { nsbaci::compiler::InstructionStream& instructions }
 %parse-param { std::vector<nsbaci::Error>& errors }
 %parse-param { nsbaci::compiler::SymbolTable& outSymbols }
+%parse-param { nsbaci::compiler::LineTable& lines }
 
 // Tokens
 %token <std::string> IDENT
@@ -125,6 +186,9 @@
 %token INC DEC
 %token PLUS_ASSIGN MINUS_ASSIGN MULT_ASSIGN DIV_ASSIGN MOD_ASSIGN
 
+// First token of a standalone expression, injected by the lexer
+%token START_EXPR
+
 // Precedence (lowest to highest)
 %right '='
 %left OR
@@ -138,18 +202,30 @@
 
 // Types for non-terminals
 %type <nsbaci::compiler::VarType> type_spec
-%type <size_t> if_head
+%type <size_t> if_head operand_start
 
 %%
 
 start:
     program
     {
-      // Ensure program ends with a Halt
+      // Ensure program ends with a Halt, reached at the end of the source
+      lines.mark(static_cast<uint32_t>(instructions.size()),
+                 static_cast<uint32_t>(@1.end.line));
       emit(instructions, Opcode::Halt);
       // Copy internal symbol table to output parameter
       outSymbols = symtab;
     }
+  | START_EXPR
+    {
+      // Standalone expression (a condition): names are resolved against the
+      // program's symbols, passed in through outSymbols
+      symtab = outSymbols;
+    }
+    expr
+    {
+      emit(instructions, Opcode::Halt);
+    }
   ;
 
 program:
@@ -221,18 +297,55 @@ declaration:
       for (int i = 0; i < $4; i++) {
         std::string elemName = $2 + "[" + std::to_string(i) + "]";
         symtab.declare(elemName, $1);
-        emit(instructions, Opcode::PushLiteral, int32_t(0));
-        emit(instructions, Opcode::Store, symtab.lookup(elemName)->address);
       }
       // Store base address in symbol table under array name
       std::string baseName = $2 + "[0]";
       Symbol* base = symtab.lookup(baseName);
       if (base) {
-        symtab.symbols[$2] = {$2, $1, base->address, false, symtab.currentScope};
+        symtab.symbols[$2] = {$2, $1, base->address, false, symtab.currentScope,
+                              uint32_t($4)};
+        // Initialize to 0 with block copies rather than a store per element
+        emitBlockClear(instructions, base->address, uint32_t($4));
+      }
+    }
+  | type_spec IDENT '[' NUMBER ']' '=' operand_start expr ';'
+    {
+      // Array initialised from another array - a single block copy
+      uint32_t srcAddr = 0;
+      Symbol* src = nullptr;
+      if (takeTrailingLoad(instructions, $7, srcAddr)) {
+        src = symtab.arrayAt(srcAddr);
+      }
+      if (!src || src->size != uint32_t($4)) {
+        nsbaci::Error err;
+        err.basic.severity = nsbaci::types::ErrSeverity::Error;
+        err.basic.message = "Array '" + $2 + "' must be initialised from an "
+                            "array of " + std::to_string($4) + " elements";
+        err.basic.type = nsbaci::types::ErrType::compilationError;
+        errors.push_back(std::move(err));
+      }
+      for (int i = 0; i < $4; i++) {
+        symtab.declare($2 + "[" + std::to_string(i) + "]", $1);
+      }
+      Symbol* base = symtab.lookup($2 + "[0]");
+      if (base) {
+        symtab.symbols[$2] = {$2, $1, base->address, false, symtab.currentScope,
+                              uint32_t($4)};
+        if (src) {
+          emitBlockCopy(instructions, base->address, src->address, src->size);
+        }
       }
     }
   ;
 
+operand_start:
+    %empty
+    {
+      // Where the next operand's code begins
+      $$ = instructions.size();
+    }
+  ;
+
 type_spec:
     INT   { $$ = nsbaci::compiler::VarType::Int; }
   | BOOL  { $$ = nsbaci::compiler::VarType::Bool; }
@@ -241,7 +354,7 @@ type_spec:
   ;
 
 assignment_stmt:
-    IDENT '=' expr
+    IDENT '=' operand_start expr
     {
       Symbol* sym = symtab.lookup($1);
       if (!sym) {
@@ -256,6 +369,24 @@ assignment_stmt:
         err.basic.message = "Cannot assign to constant '" + $1 + "'";
         err.basic.type = nsbaci::types::ErrType::compilationError;
         errors.push_back(std::move(err));
+      } else if (sym->size > 1) {
+        // Whole-array assignment - replace the source load by a block copy
+        uint32_t srcAddr = 0;
+        Symbol* src = nullptr;
+        if (takeTrailingLoad(instructions, $3, srcAddr)) {
+          src = symtab.arrayAt(srcAddr);
+        }
+        if (!src || src->size != sym->size) {
+          nsbaci::Error err;
+          err.basic.severity = nsbaci::types::ErrSeverity::Error;
+          err.basic.message = "Array '" + $1 + "' can only be assigned an "
+                              "array of " + std::to_string(sym->size) +
+                              " elements";
+          err.basic.type = nsbaci::types::ErrType::compilationError;
+          errors.push_back(std::move(err));
+        } else {
+          emitBlockCopy(instructions, sym->address, src->address, sym->size);
+        }
       } else {
         emit(instructions, Opcode::Store, sym->address);
       }
@@ -21,6 +21,7 @@ nsbaci::compiler::CompilerResult CompilerService::compile(
   if (result.ok) {
     lastCompiledInstructions = std::move(result.instructions);
     lastCompiledSymbols = std::move(result.symbols);
+    lastCompiledLines = std::move(result.lines);
     programReady = true;
   } else {
     programReady = false;
@@ -40,4 +41,13 @@ nsbaci::types::SymbolTable CompilerService::takeSymbols() {
   return std::move(lastCompiledSymbols);
 }
 
+nsbaci::compiler::LineTable CompilerService::takeLines() {
+  return std::move(lastCompiledLines);
+}
+
+nsbaci::compiler::ExpressionResult CompilerService::compileExpression(
+    nsbaci::types::Text raw, const nsbaci::types::SymbolTable& symbols) {
+  return compiler->compileExpression(raw, symbols);
+}
+
 }  // namespace nsbaci::services
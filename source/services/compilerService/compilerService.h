@@ -42,7 +42,8 @@ namespace nsbaci::services {
  * The service functions like the following:
  * 1. Call compile() with source code
  * 2. Check hasProgramReady() to verify success
- * 3. Call takeInstructions() and takeSymbols() to retrieve compiled data
+ * 3. Call takeInstructions(), takeSymbols() and takeLines() to retrieve
+ *    compiled data
  *
  * After taking the instructions, the program is no longer considered ready
  * until a new successful compilation occurs.
@@ -130,6 +131,30 @@ class CompilerService {
    */
   nsbaci::types::SymbolTable takeSymbols();
 
+  /**
+   * @brief Retrieves and releases ownership of the line table.
+   *
+   * Maps every compiled instruction back to the source line it came from,
+   * for the editor and for breakpoints by line.
+   *
+   * @return The line table from the last successful compilation.
+   */
+  nsbaci::compiler::LineTable takeLines();
+
+  /**
+   * @brief Compiles a condition over the variables of a compiled program.
+   *
+   * Does not touch the program held for execution, so it can be used while
+   * the program runs, e.g. for conditional breakpoints and invariants.
+   *
+   * @param raw The expression, in nsbaci syntax.
+   * @param symbols Symbol table of the program the condition reads.
+   * @return ExpressionResult with the compiled expression and the words it
+   * reads, or the compilation errors.
+   */
+  nsbaci::compiler::ExpressionResult compileExpression(
+      nsbaci::types::Text raw, const nsbaci::types::SymbolTable& symbols);
+
  private:
   std::unique_ptr<nsbaci::compiler::Compiler>
       compiler;  ///< The underlying compiler implementation.
@@ -137,6 +162,8 @@ class CompilerService {
       lastCompiledInstructions;  ///< Stored instructions from last compile.
   nsbaci::types::SymbolTable
       lastCompiledSymbols;    ///< Stored symbols from last compile.
+  nsbaci::compiler::LineTable
+      lastCompiledLines;      ///< Stored line table from last compile.
   bool programReady = false;  ///< True if valid compiled program is available.
 };
 
@@ -3,8 +3,11 @@
  * @brief Implementation of the FileService class for nsbaci.
  *
  * This file contains the implementation of file save and load operations
- * for NsBaci source files (.nsb). It provides comprehensive validation and
- * error handling for all file system operations.
+ * for NsBaci source files (.nsb), the auxiliary text files saved next to
+ * them, replay logs (.replay) and profiles (.csv and .folded), binary
+ * sessions (.session) and traces (.json and .nsbtrace). It provides
+ * comprehensive validation and error handling for all file system
+ * operations.
  *
  * @author Nicolás Serrano García
  * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
@@ -14,12 +17,77 @@
 #include "fileService.h"
 
 #include <fstream>
+#include <system_error>
 
 using namespace nsbaci::types;
 
 namespace nsbaci::services {
 
-saveResult FileService::save(Text contents, File file) {
+namespace {
+
+// Program sources
+bool isSourceExtension(const File& file) {
+  return file.extension() == ".nsb";
+}
+
+// Text files the runtime tools save next to a source
+bool isAuxiliaryExtension(const File& file) {
+  return file.extension() == ".replay" || file.extension() == ".csv" ||
+         file.extension() == ".folded";
+}
+
+template <typename Payload>
+Error fileError(ErrType type, std::string message, Payload payload) {
+  Error err;
+  err.basic.severity = ErrSeverity::Error;
+  err.basic.message = std::move(message);
+  err.basic.type = type;
+  err.payload = std::move(payload);
+  return err;
+}
+
+// Maps a binary file of the given extension into Result's contents
+template <typename Result>
+Result mapFile(const File& file, const char* extension,
+               const char* badExtension) {
+  if (file.empty()) {
+    return Result(
+        fileError(ErrType::emptyPath, "File path is empty.", LoadError{file}));
+  }
+
+  if (file.extension() != extension) {
+    return Result(
+        fileError(ErrType::invalidExtension, badExtension, LoadError{file}));
+  }
+
+  if (!fs::exists(file)) {
+    return Result(fileError(ErrType::fileNotFound,
+                            "File does not exist: " + file.string(),
+                            LoadError{file}));
+  }
+
+  if (!fs::is_regular_file(file)) {
+    return Result(fileError(ErrType::notARegularFile,
+                            "Path is not a regular file: " + file.string(),
+                            LoadError{file}));
+  }
+
+  auto mapped = std::make_shared<MappedFile>();
+  if (!mapped->open(file)) {
+    return Result(fileError(ErrType::openFailed,
+                            "Could not map file for reading: " + file.string(),
+                            LoadError{file}));
+  }
+
+  Result result;
+  result.contents = std::move(mapped);
+  result.fileName = file.filename();
+  return result;
+}
+
+// Writes a text file, accepting only the extensions accepts() allows
+saveResult writeText(const Text& contents, const File& file,
+                     bool (*accepts)(const File&), const char* badExtension) {
   // Validate file path
   if (file.empty()) {
     Error err;
@@ -30,12 +98,11 @@ saveResult FileService::save(Text contents, File file) {
     return saveResult(err);
   }
 
-  // Validate .nsb extension
-  if (file.extension() != ".nsb") {
+  // Validate extension
+  if (!accepts(file)) {
     Error err;
     err.basic.severity = ErrSeverity::Error;
-    err.basic.message =
-        "Invalid file extension. Only .nsb files are supported.";
+    err.basic.message = badExtension;
     err.basic.type = ErrType::invalidExtension;
     err.payload = SaveError{file};
     return saveResult(err);
@@ -85,7 +152,9 @@ saveResult FileService::save(Text contents, File file) {
   return saveResult();
 }
 
-LoadResult FileService::load(File file) {
+// Reads a text file, accepting only the extensions accepts() allows
+LoadResult readText(const File& file, bool (*accepts)(const File&),
+                    const char* badExtension) {
   // Validate file path
   if (file.empty()) {
     Error err;
@@ -96,12 +165,11 @@ LoadResult FileService::load(File file) {
     return LoadResult(err);
   }
 
-  // Validate .nsb extension
-  if (file.extension() != ".nsb") {
+  // Validate extension
+  if (!accepts(file)) {
     Error err;
     err.basic.severity = ErrSeverity::Error;
-    err.basic.message =
-        "Invalid file extension. Only .nsb files are supported.";
+    err.basic.message = badExtension;
     err.basic.type = ErrType::invalidExtension;
     err.payload = LoadError{file};
     return LoadResult(err);
@@ -158,4 +226,128 @@ LoadResult FileService::load(File file) {
   return LoadResult(std::move(contents), file.filename());
 }
 
+}  // namespace
+
+saveResult FileService::save(Text contents, File file) {
+  return writeText(contents, file, isSourceExtension,
+                   "Invalid file extension. Only .nsb files are supported.");
+}
+
+LoadResult FileService::load(File file) {
+  return readText(file, isSourceExtension,
+                  "Invalid file extension. Only .nsb files are supported.");
+}
+
+saveResult FileService::saveAuxiliary(Text contents, File file) {
+  return writeText(contents, file, isAuxiliaryExtension,
+                   "Invalid file extension. Only .replay, .csv and .folded "
+                   "files are supported.");
+}
+
+LoadResult FileService::loadAuxiliary(File file) {
+  return readText(file, isAuxiliaryExtension,
+                  "Invalid file extension. Only .replay, .csv and .folded "
+                  "files are supported.");
+}
+
+saveResult FileService::saveSession(const std::string& bytes, File file) {
+  if (file.empty()) {
+    return saveResult(
+        fileError(ErrType::emptyPath, "File path is empty.", SaveError{file}));
+  }
+
+  if (file.extension() != ".session") {
+    return saveResult(fileError(
+        ErrType::invalidExtension,
+        "Invalid file extension. Sessions must be saved as .session files.",
+        SaveError{file}));
+  }
+
+  File parentDir = file.parent_path();
+  if (!parentDir.empty() && !fs::exists(parentDir)) {
+    return saveResult(
+        fileError(ErrType::directoryNotFound,
+                  "Directory does not exist: " + parentDir.string(),
+                  SaveError{file}));
+  }
+
+  // Write aside and rename, so the old session survives a failed save
+  File temp = file;
+  temp += ".tmp";
+  std::ofstream outFile(temp,
+                        std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!outFile.is_open()) {
+    return saveResult(
+        fileError(ErrType::openFailed,
+                  "Could not open file for writing: " + temp.string(),
+                  SaveError{file}));
+  }
+
+  outFile.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  outFile.close();
+  std::error_code ec;
+  if (outFile.fail()) {
+    fs::remove(temp, ec);
+    return saveResult(fileError(ErrType::writeFailed,
+                                "Failed to write to file: " + temp.string(),
+                                SaveError{file}));
+  }
+
+  fs::rename(temp, file, ec);
+  if (ec) {
+    fs::remove(temp, ec);
+    return saveResult(fileError(ErrType::writeFailed,
+                                "Failed to replace file: " + file.string(),
+                                SaveError{file}));
+  }
+  return saveResult();
+}
+
+SessionLoadResult FileService::loadSession(File file) {
+  return mapFile<SessionLoadResult>(
+      file, ".session",
+      "Invalid file extension. Only .session files hold sessions.");
+}
+
+TraceLoadResult FileService::loadTrace(File file) {
+  return mapFile<TraceLoadResult>(
+      file, ".nsbtrace",
+      "Invalid file extension. Only .nsbtrace files hold binary traces.");
+}
+
+StreamResult FileService::openStream(File file) {
+  if (file.empty()) {
+    return StreamResult(
+        fileError(ErrType::emptyPath, "File path is empty.", SaveError{file}));
+  }
+
+  if (file.extension() != ".json" && file.extension() != ".nsbtrace") {
+    return StreamResult(
+        fileError(ErrType::invalidExtension,
+                  "Invalid file extension. Traces must be saved as .json or "
+                  ".nsbtrace files.",
+                  SaveError{file}));
+  }
+
+  File parentDir = file.parent_path();
+  if (!parentDir.empty() && !fs::exists(parentDir)) {
+    return StreamResult(
+        fileError(ErrType::directoryNotFound,
+                  "Directory does not exist: " + parentDir.string(),
+                  SaveError{file}));
+  }
+
+  auto stream = std::make_shared<OutputFile>();
+  if (!stream->open(file)) {
+    return StreamResult(
+        fileError(ErrType::openFailed,
+                  "Could not open file for writing: " + file.string(),
+                  SaveError{file}));
+  }
+
+  StreamResult result;
+  result.stream = std::move(stream);
+  return result;
+}
+
 }  // namespace nsbaci::services
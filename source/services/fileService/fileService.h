@@ -10,6 +10,11 @@
  * The service handles:
  * - Saving source code to .nsb files with validation
  * - Loading source code from .nsb files with error checking
+ * - Saving and loading auxiliary text files: replay logs (.replay) and
+ *   profiles (.csv, .folded)
+ * - Saving and mapping binary session files (.session extension)
+ * - Opening trace files (.json and .nsbtrace extensions) to be written a part
+ *   at a time, and mapping binary traces
  * - Path validation
  *
  * @author Nicolás Serrano García
@@ -20,10 +25,14 @@
 #ifndef NSBACI_FILESERVICE_H
 #define NSBACI_FILESERVICE_H
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "baseResult.h"
 #include "fileTypes.h"
+#include "mappedFile.h"
+#include "outputFile.h"
 
 /**
  * @struct FileResult
@@ -136,6 +145,114 @@ struct LoadResult : FileResult {
   nsbaci::types::File fileName;  ///< The filename for display purposes.
 };
 
+/**
+ * @struct SessionLoadResult
+ * @brief Result type for session load operations.
+ *
+ * Holds the mapped file rather than a copy of it; the contents stay valid
+ * as long as any copy of the result does.
+ */
+struct SessionLoadResult : FileResult {
+  /**
+   * @brief Default constructor creates a successful but empty result.
+   */
+  SessionLoadResult() : FileResult() {}
+
+  /**
+   * @brief Constructs a result from a vector of errors.
+   * @param errs Vector of errors encountered during the load.
+   */
+  explicit SessionLoadResult(std::vector<nsbaci::Error> errs)
+      : FileResult(std::move(errs)) {}
+
+  /**
+   * @brief Constructs a failed result from a single error.
+   * @param error The error that caused the load to fail.
+   */
+  explicit SessionLoadResult(nsbaci::Error error)
+      : FileResult(std::move(error)) {}
+
+  SessionLoadResult(SessionLoadResult&&) noexcept = default;
+  SessionLoadResult& operator=(SessionLoadResult&&) noexcept = default;
+  SessionLoadResult(const SessionLoadResult&) = default;
+  SessionLoadResult& operator=(const SessionLoadResult&) = default;
+
+  /// @brief The mapped session file.
+  std::shared_ptr<const nsbaci::services::MappedFile> contents;
+  nsbaci::types::File fileName;  ///< The filename for display purposes.
+};
+
+/**
+ * @struct TraceLoadResult
+ * @brief Result type for binary trace load operations.
+ *
+ * Like SessionLoadResult, holds the mapped file; a trace of gigabytes is
+ * paged in only where it is read.
+ */
+struct TraceLoadResult : FileResult {
+  /**
+   * @brief Default constructor creates a successful but empty result.
+   */
+  TraceLoadResult() : FileResult() {}
+
+  /**
+   * @brief Constructs a result from a vector of errors.
+   * @param errs Vector of errors encountered during the load.
+   */
+  explicit TraceLoadResult(std::vector<nsbaci::Error> errs)
+      : FileResult(std::move(errs)) {}
+
+  /**
+   * @brief Constructs a failed result from a single error.
+   * @param error The error that caused the load to fail.
+   */
+  explicit TraceLoadResult(nsbaci::Error error)
+      : FileResult(std::move(error)) {}
+
+  TraceLoadResult(TraceLoadResult&&) noexcept = default;
+  TraceLoadResult& operator=(TraceLoadResult&&) noexcept = default;
+  TraceLoadResult(const TraceLoadResult&) = default;
+  TraceLoadResult& operator=(const TraceLoadResult&) = default;
+
+  /// @brief The mapped trace file.
+  std::shared_ptr<const nsbaci::services::MappedFile> contents;
+  nsbaci::types::File fileName;  ///< The filename for display purposes.
+};
+
+/**
+ * @struct StreamResult
+ * @brief Result type for opening a file to be written a part at a time.
+ *
+ * Holds the open file; it is closed once every copy of the result is gone.
+ */
+struct StreamResult : FileResult {
+  /**
+   * @brief Default constructor creates a successful but empty result.
+   */
+  StreamResult() : FileResult() {}
+
+  /**
+   * @brief Constructs a result from a vector of errors.
+   * @param errs Vector of errors encountered while opening.
+   */
+  explicit StreamResult(std::vector<nsbaci::Error> errs)
+      : FileResult(std::move(errs)) {}
+
+  /**
+   * @brief Constructs a failed result from a single error.
+   * @param error The error that caused the open to fail.
+   */
+  explicit StreamResult(nsbaci::Error error) : FileResult(std::move(error)) {}
+
+  StreamResult(StreamResult&&) noexcept = default;
+  StreamResult& operator=(StreamResult&&) noexcept = default;
+  StreamResult(const StreamResult&) = default;
+  StreamResult& operator=(const StreamResult&) = default;
+
+  /// @brief The open file.
+  std::shared_ptr<nsbaci::services::OutputFile> stream;
+};
+
 /**
  * @namespace nsbaci::services
  * @brief Services namespace containing all backend service implementations.
@@ -150,11 +267,13 @@ namespace nsbaci::services {
  * @brief Service for handling file system operations on BACI source files.
  *
  * FileService provides methods for saving and loading BACI source code files.
- * It enforces the .nsb file extension and provides detailed error reporting
- * for various failure scenarios including:
+ * It enforces the .nsb file extension (.replay for replay logs, .csv and
+ * .folded for profiles, .session for binary sessions, .json and .nsbtrace
+ * for traces) and
+ * provides detailed error reporting for various failure scenarios including:
  *
  * - Empty or invalid file paths
- * - Invalid file extensions (must be .nsb)
+ * - Invalid file extensions
  * - Non-existent directories or files
  * - Permission and I/O errors
  *
@@ -207,6 +326,76 @@ class FileService {
    */
   LoadResult load(nsbaci::types::File file);
 
+  /**
+   * @brief Saves an auxiliary text file, such as a replay log or a profile.
+   *
+   * Same checks as save(), but for the files the runtime tools write next
+   * to a source instead of the source itself.
+   *
+   * @param contents The text to save.
+   * @param file The target file path (must have .replay, .csv or .folded
+   * extension).
+   * @return saveResult indicating success or containing error details.
+   */
+  saveResult saveAuxiliary(nsbaci::types::Text contents,
+                           nsbaci::types::File file);
+
+  /**
+   * @brief Loads an auxiliary text file, such as a replay log.
+   * @param file The file path to load (must have .replay, .csv or .folded
+   * extension).
+   * @return LoadResult containing file contents on success, or error details
+   * on failure.
+   */
+  LoadResult loadAuxiliary(nsbaci::types::File file);
+
+  /**
+   * @brief Saves a binary session to a file.
+   *
+   * The bytes go to a temporary file next to the target, which then
+   * replaces it, so an interrupted save never leaves a truncated session.
+   *
+   * @param bytes The encoded session (see runtime::Session::serialize()).
+   * @param file The target file path (must have .session extension).
+   * @return saveResult indicating success or containing error details.
+   */
+  saveResult saveSession(const std::string& bytes, nsbaci::types::File file);
+
+  /**
+   * @brief Maps a binary session file into memory.
+   *
+   * Nothing is read up front; pages are loaded as the session is parsed.
+   *
+   * @param file The session file path (must have .session extension).
+   * @return SessionLoadResult holding the mapping on success, or error
+   * details on failure.
+   */
+  SessionLoadResult loadSession(nsbaci::types::File file);
+
+  /**
+   * @brief Maps a binary trace file into memory.
+   *
+   * Nothing is read up front; see runtime::BinaryTraceReader.
+   *
+   * @param file The trace file path (must have .nsbtrace extension).
+   * @return TraceLoadResult holding the mapping on success, or error
+   * details on failure.
+   */
+  TraceLoadResult loadTrace(nsbaci::types::File file);
+
+  /**
+   * @brief Creates a trace file to be written a part at a time.
+   *
+   * Any existing file is truncated. Unlike save(), nothing has to be in
+   * memory up front; see OutputFile.
+   *
+   * @param file The target file path (must have .json or .nsbtrace
+   * extension).
+   * @return StreamResult holding the open file on success, or error
+   * details on failure.
+   */
+  StreamResult openStream(nsbaci::types::File file);
+
   /**
    * @brief Default constructor.
    */
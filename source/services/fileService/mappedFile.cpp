@@ -0,0 +1,141 @@
+/**
+ * @file mappedFile.cpp
+ * @brief Implementation of the MappedFile class for nsbaci.
+ *
+ * Uses mmap on POSIX systems and file mapping objects on Windows.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "mappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nsbaci::services {
+
+MappedFile::~MappedFile() { close(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+  *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    close();
+    base = std::exchange(other.base, nullptr);
+    length = std::exchange(other.length, 0);
+#ifdef _WIN32
+    fileHandle = std::exchange(other.fileHandle, nullptr);
+    mapping = std::exchange(other.mapping, nullptr);
+#endif
+  }
+  return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const nsbaci::types::File& file) {
+  close();
+  HANDLE f = CreateFileW(file.wstring().c_str(), GENERIC_READ,
+                         FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (f == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  fileHandle = f;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(f, &size)) {
+    close();
+    return false;
+  }
+  if (size.QuadPart == 0) {
+    return true;  // Empty files cannot be mapped, and need not be
+  }
+
+  HANDLE m = CreateFileMappingW(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!m) {
+    close();
+    return false;
+  }
+  mapping = m;
+
+  void* view = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+  if (!view) {
+    close();
+    return false;
+  }
+  base = static_cast<const char*>(view);
+  length = static_cast<size_t>(size.QuadPart);
+  return true;
+}
+
+void MappedFile::close() {
+  if (base) {
+    UnmapViewOfFile(base);
+  }
+  if (mapping) {
+    CloseHandle(static_cast<HANDLE>(mapping));
+  }
+  if (fileHandle) {
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+  }
+  base = nullptr;
+  length = 0;
+  mapping = nullptr;
+  fileHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const nsbaci::types::File& file) {
+  close();
+  int fd = ::open(file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    ::close(fd);
+    return false;
+  }
+  if (info.st_size == 0) {
+    ::close(fd);
+    return true;  // Empty files cannot be mapped, and need not be
+  }
+
+  // The mapping keeps the file alive; the descriptor is no longer needed
+  void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ,
+                    MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (view == MAP_FAILED) {
+    return false;
+  }
+  base = static_cast<const char*>(view);
+  length = static_cast<size_t>(info.st_size);
+  return true;
+}
+
+void MappedFile::close() {
+  if (base) {
+    munmap(const_cast<char*>(base), length);
+  }
+  base = nullptr;
+  length = 0;
+}
+
+#endif
+
+}  // namespace nsbaci::services
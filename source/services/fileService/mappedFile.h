@@ -0,0 +1,89 @@
+/**
+ * @file mappedFile.h
+ * @brief MappedFile class declaration for nsbaci.
+ *
+ * This module defines a read-only memory mapping of a whole file, used to
+ * read large binary files such as saved sessions without copying them into
+ * a buffer first.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_MAPPEDFILE_H
+#define NSBACI_MAPPEDFILE_H
+
+#include <cstddef>
+
+#include "fileTypes.h"
+
+/**
+ * @namespace nsbaci::services
+ * @brief Services namespace containing all backend service implementations.
+ */
+namespace nsbaci::services {
+
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of a file.
+ *
+ * The operating system pages the contents in on first access, so opening
+ * costs the same whatever the size of the file. The mapping is private to
+ * this process: later changes to the file are not guaranteed to be seen.
+ * Move-only; the mapping is released on destruction.
+ */
+class MappedFile {
+ public:
+  /**
+   * @brief Default constructor creates a closed mapping.
+   */
+  MappedFile() = default;
+
+  /**
+   * @brief Releases the mapping, if any.
+   */
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  /**
+   * @brief Maps a whole file, releasing any earlier mapping.
+   * @param file Path of the file.
+   * @return False if the file could not be opened or mapped.
+   */
+  bool open(const nsbaci::types::File& file);
+
+  /**
+   * @brief Releases the mapping.
+   */
+  void close();
+
+  /**
+   * @brief Gets the start of the contents.
+   * @return Pointer to the first byte, or nullptr if empty or closed.
+   */
+  const char* data() const { return base; }
+
+  /**
+   * @brief Gets the size of the contents.
+   * @return Size in bytes.
+   */
+  size_t size() const { return length; }
+
+ private:
+  const char* base = nullptr;  ///< Start of the mapping.
+  size_t length = 0;           ///< Size of the mapping.
+#ifdef _WIN32
+  void* fileHandle = nullptr;  ///< Open file (HANDLE).
+  void* mapping = nullptr;     ///< File mapping object (HANDLE).
+#endif
+};
+
+}  // namespace nsbaci::services
+
+#endif  // NSBACI_MAPPEDFILE_H
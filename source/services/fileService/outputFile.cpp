@@ -0,0 +1,46 @@
+/**
+ * @file outputFile.cpp
+ * @brief Implementation of the OutputFile class for nsbaci.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "outputFile.h"
+
+namespace nsbaci::services {
+
+OutputFile::~OutputFile() { close(); }
+
+bool OutputFile::open(const nsbaci::types::File& file) {
+  close();
+  stream.open(file, std::ios::out | std::ios::trunc | std::ios::binary);
+  written = 0;
+  failed = !stream.is_open();
+  return !failed;
+}
+
+bool OutputFile::write(const std::string& bytes) {
+  if (!stream.is_open() || failed) {
+    return false;
+  }
+  stream.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  if (stream.fail()) {
+    failed = true;
+    return false;
+  }
+  written += bytes.size();
+  return true;
+}
+
+bool OutputFile::close() {
+  if (!stream.is_open()) {
+    return !failed;
+  }
+  stream.close();
+  failed = failed || stream.fail();
+  return !failed;
+}
+
+}  // namespace nsbaci::services
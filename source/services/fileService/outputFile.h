@@ -0,0 +1,95 @@
+/**
+ * @file outputFile.h
+ * @brief OutputFile class declaration for nsbaci.
+ *
+ * This module defines a file written a part at a time, used for reports
+ * such as execution traces that are too large to build in memory before
+ * saving them.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_OUTPUTFILE_H
+#define NSBACI_OUTPUTFILE_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "fileTypes.h"
+
+/**
+ * @namespace nsbaci::services
+ * @brief Services namespace containing all backend service implementations.
+ */
+namespace nsbaci::services {
+
+/**
+ * @class OutputFile
+ * @brief File open for appending binary data.
+ *
+ * Meant for callers that buffer their own output and hand over large
+ * parts at once; each write goes straight to the stream. Move-only; the
+ * file is closed on destruction.
+ */
+class OutputFile {
+ public:
+  /**
+   * @brief Default constructor creates a closed file.
+   */
+  OutputFile() = default;
+
+  /**
+   * @brief Closes the file, if open.
+   */
+  ~OutputFile();
+
+  OutputFile(const OutputFile&) = delete;
+  OutputFile& operator=(const OutputFile&) = delete;
+
+  OutputFile(OutputFile&&) = default;
+  OutputFile& operator=(OutputFile&&) = default;
+
+  /**
+   * @brief Creates or truncates a file, closing any earlier one.
+   * @param file Path of the file.
+   * @return False if the file could not be opened.
+   */
+  bool open(const nsbaci::types::File& file);
+
+  /**
+   * @brief Appends bytes to the file.
+   * @param bytes The bytes.
+   * @return False if the file is closed or the write failed.
+   */
+  bool write(const std::string& bytes);
+
+  /**
+   * @brief Writes out what the stream buffered and closes the file.
+   * @return False if anything written since open() was lost.
+   */
+  bool close();
+
+  /**
+   * @brief Checks whether the file is open.
+   * @return True if open.
+   */
+  bool isOpen() const { return stream.is_open(); }
+
+  /**
+   * @brief Gets the number of bytes written.
+   * @return Bytes since open().
+   */
+  uint64_t size() const { return written; }
+
+ private:
+  std::ofstream stream;  ///< The open file.
+  uint64_t written = 0;  ///< Bytes written since open().
+  bool failed = false;   ///< A write failed since open().
+};
+
+}  // namespace nsbaci::services
+
+#endif  // NSBACI_OUTPUTFILE_H
@@ -0,0 +1,249 @@
+/**
+ * @file batchRunner.cpp
+ * @brief BatchRunner class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "batchRunner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <tuple>
+
+#include "workStealingPool.h"
+
+namespace nsbaci::services {
+
+namespace {
+
+// Seeds per pool task: large enough to amortise the task, small enough to
+// leave something to steal
+constexpr uint64_t SEEDS_PER_TASK = 16;
+
+/**
+ * @struct PartialResult
+ * @brief Aggregation kept by one worker, merged after the batch.
+ */
+struct PartialResult {
+  std::map<RunOutcome, OutcomeSummary> outcomes;
+  std::map<std::string, uint64_t> races;
+  uint64_t totalSteps = 0;
+};
+
+void record(PartialResult& partial, RunOutcome outcome, uint64_t seed,
+            uint64_t steps) {
+  partial.totalSteps += steps;
+  for (const auto& race : outcome.races) {
+    ++partial.races[race.describe()];
+  }
+  outcome.races.clear();
+
+  auto it = partial.outcomes.find(outcome);
+  if (it == partial.outcomes.end()) {
+    OutcomeSummary summary;
+    summary.outcome = outcome;
+    summary.count = 1;
+    summary.seed = seed;
+    partial.outcomes.emplace(std::move(outcome), std::move(summary));
+    return;
+  }
+  ++it->second.count;
+  it->second.seed = std::min(it->second.seed, seed);
+}
+
+}  // namespace
+
+const char* runStatusName(RunStatus status) {
+  switch (status) {
+    case RunStatus::Halted:
+      return "halted";
+    case RunStatus::Deadlock:
+      return "deadlock";
+    case RunStatus::Error:
+      return "error";
+    case RunStatus::StepLimit:
+      return "step limit";
+    case RunStatus::InputExhausted:
+      return "input exhausted";
+    case RunStatus::Livelock:
+      return "livelock";
+  }
+  return "unknown";
+}
+
+bool RunOutcome::operator<(const RunOutcome& other) const {
+  return std::tie(status, output, memory, error) <
+         std::tie(other.status, other.output, other.memory, other.error);
+}
+
+BatchRunner::BatchRunner(ServiceFactory f) : factory(std::move(f)) {}
+
+RunOutcome BatchRunner::runOne(
+    const std::shared_ptr<const runtime::CodeImage>& image, uint64_t seed,
+    const BatchOptions& options, uint64_t& steps) const {
+  RunOutcome outcome;
+  RuntimeService service = factory(seed);
+  service.setRaceDetection(options.detectRaces);
+  service.setOutputCallback(
+      [&outcome](const std::string& out) { outcome.output += out; });
+  service.loadProgram(image);
+
+  // Stack underflow and malformed operands surface as exceptions
+  try {
+    size_t nextInput = 0;
+    while (true) {
+      size_t budget = 0;
+      if (options.maxSteps > 0) {
+        if (service.getStepCount() >= options.maxSteps) {
+          outcome.status = RunStatus::StepLimit;
+          break;
+        }
+        budget = options.maxSteps - service.getStepCount();
+      }
+
+      RuntimeResult result = service.run(budget);
+      if (!result.ok) {
+        outcome.status = RunStatus::Error;
+        if (!result.errors.empty()) {
+          outcome.error = result.errors.front().basic.message;
+        }
+        break;
+      }
+
+      if (result.deadlock.has_value()) {
+        outcome.status = RunStatus::Deadlock;
+        outcome.error = result.deadlock->describe();
+        break;
+      }
+
+      if (result.halted) {
+        outcome.status = RunStatus::Halted;
+        break;
+      }
+
+      if (result.livelock) {
+        outcome.status = RunStatus::Livelock;
+        break;
+      }
+
+      if (result.needsInput) {
+        if (nextInput >= options.input.size()) {
+          outcome.status = RunStatus::InputExhausted;
+          break;
+        }
+        service.provideInput(options.input[nextInput++]);
+      }
+    }
+  } catch (const std::exception& e) {
+    outcome.status = RunStatus::Error;
+    outcome.error = e.what();
+  }
+
+  outcome.memory = service.getProgram().memory();
+  outcome.races = service.getRaces();
+  steps = service.getStepCount();
+  return outcome;
+}
+
+BatchResult BatchRunner::run(std::shared_ptr<const runtime::CodeImage> image,
+                             const BatchOptions& options) const {
+  if (!image || !factory) {
+    nsbaci::Error err;
+    err.basic.severity = nsbaci::types::ErrSeverity::Error;
+    err.basic.message = "Batch run needs a program and a runtime factory";
+    err.basic.type = nsbaci::types::ErrType::unknown;
+    err.payload = nsbaci::types::RuntimeError{};
+    return BatchResult(std::move(err));
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  runtime::WorkStealingPool pool(options.workers);
+  std::vector<PartialResult> partials(pool.workerCount());
+
+  for (uint64_t first = 0; first < options.runs; first += SEEDS_PER_TASK) {
+    uint64_t last = std::min(options.runs, first + SEEDS_PER_TASK);
+    pool.submit([&, first, last](size_t worker) {
+      for (uint64_t i = first; i < last; ++i) {
+        uint64_t seed = options.firstSeed + i;
+        uint64_t steps = 0;
+        RunOutcome outcome = runOne(image, seed, options, steps);
+        record(partials[worker], std::move(outcome), seed, steps);
+      }
+    });
+  }
+
+  try {
+    pool.wait();
+  } catch (const std::exception& e) {
+    nsbaci::Error err;
+    err.basic.severity = nsbaci::types::ErrSeverity::Error;
+    err.basic.message = std::string("Batch run failed: ") + e.what();
+    err.basic.type = nsbaci::types::ErrType::unknown;
+    err.payload = nsbaci::types::RuntimeError{};
+    return BatchResult(std::move(err));
+  }
+
+  // Merge the per-worker aggregations
+  PartialResult merged;
+  for (auto& partial : partials) {
+    merged.totalSteps += partial.totalSteps;
+    for (const auto& [race, count] : partial.races) {
+      merged.races[race] += count;
+    }
+    for (auto& [outcome, summary] : partial.outcomes) {
+      auto it = merged.outcomes.find(outcome);
+      if (it == merged.outcomes.end()) {
+        merged.outcomes.emplace(outcome, std::move(summary));
+      } else {
+        it->second.count += summary.count;
+        it->second.seed = std::min(it->second.seed, summary.seed);
+      }
+    }
+  }
+
+  BatchResult result;
+  result.runs = options.runs;
+  result.totalSteps = merged.totalSteps;
+  result.races = std::move(merged.races);
+  for (auto& [outcome, summary] : merged.outcomes) {
+    result.outputHistogram[outcome.output] += summary.count;
+    switch (outcome.status) {
+      case RunStatus::Halted:
+        result.halted += summary.count;
+        break;
+      case RunStatus::Deadlock:
+        result.deadlocks += summary.count;
+        break;
+      case RunStatus::Error:
+        result.runtimeErrors += summary.count;
+        break;
+      case RunStatus::StepLimit:
+        result.stepLimits += summary.count;
+        break;
+      case RunStatus::InputExhausted:
+        result.inputErrors += summary.count;
+        break;
+      case RunStatus::Livelock:
+        result.livelocks += summary.count;
+        break;
+    }
+    result.outcomes.push_back(std::move(summary));
+  }
+
+  std::stable_sort(result.outcomes.begin(), result.outcomes.end(),
+                   [](const OutcomeSummary& a, const OutcomeSummary& b) {
+                     return a.count > b.count;
+                   });
+
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return result;
+}
+
+}  // namespace nsbaci::services
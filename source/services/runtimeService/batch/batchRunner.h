@@ -0,0 +1,193 @@
+/**
+ * @file batchRunner.h
+ * @brief BatchRunner class declaration for nsbaci runtime service.
+ *
+ * This module defines the BatchRunner, which executes one compiled program
+ * under many scheduler seeds in parallel and aggregates the outcomes. Where
+ * the GUI shows a single random interleaving, a batch shows how often each
+ * distinct result happens and which seed reproduces it.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_BATCHRUNNER_H
+#define NSBACI_SERVICES_RUNTIME_BATCHRUNNER_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "baseResult.h"
+#include "codeImage.h"
+#include "runtimeService.h"
+
+/**
+ * @namespace nsbaci::services
+ * @brief Services namespace containing all backend service implementations.
+ */
+namespace nsbaci::services {
+
+/**
+ * @enum RunStatus
+ * @brief How a single run of a batch ended.
+ */
+enum class RunStatus {
+  Halted,          ///< Every thread terminated.
+  Deadlock,        ///< Some threads were blocked for good.
+  Error,           ///< The interpreter reported a runtime error.
+  StepLimit,       ///< The run exceeded BatchOptions::maxSteps.
+  InputExhausted,  ///< A Read found no input left.
+  Livelock,        ///< States kept repeating without any progress.
+};
+
+/**
+ * @brief Gets a printable name for a run status.
+ * @param status The status to name.
+ * @return Static string with the status name.
+ */
+const char* runStatusName(RunStatus status);
+
+/**
+ * @struct RunOutcome
+ * @brief Observable result of one run; equal outcomes are aggregated.
+ */
+struct RunOutcome {
+  RunStatus status = RunStatus::Halted;  ///< How the run ended.
+  std::string output;                    ///< Everything the program wrote.
+  nsbaci::types::Memory memory;          ///< Final global memory.
+  std::string error;                     ///< First error message, if any.
+  /// @brief Races found (BatchOptions::detectRaces); not compared, so runs
+  /// that differ only in races still aggregate
+  std::vector<runtime::Race> races;
+
+  bool operator<(const RunOutcome& other) const;
+};
+
+/**
+ * @struct OutcomeSummary
+ * @brief One distinct outcome together with how to reproduce it.
+ */
+struct OutcomeSummary {
+  RunOutcome outcome;  ///< The outcome itself.
+  uint64_t count = 0;  ///< Number of runs that ended this way.
+  uint64_t seed = 0;   ///< Smallest seed that reproduces it.
+};
+
+/**
+ * @struct BatchOptions
+ * @brief Parameters of a batch run.
+ */
+struct BatchOptions {
+  uint64_t firstSeed = 0;          ///< Seeds are firstSeed .. firstSeed+runs-1
+  uint64_t runs = 100;             ///< Number of runs.
+  uint64_t maxSteps = 1000000;     ///< Per-run step limit (0 = unlimited).
+  size_t workers = 0;              ///< Worker threads (0 = all cores).
+  std::vector<std::string> input;  ///< Values fed to Read, in order.
+  bool detectRaces = false;        ///< Run with data race detection on.
+};
+
+/**
+ * @struct BatchResult
+ * @brief Aggregated result of a batch run.
+ */
+struct BatchResult : nsbaci::BaseResult {
+  /**
+   * @brief Default constructor creates a successful empty result.
+   */
+  BatchResult() : BaseResult() {}
+
+  /**
+   * @brief Constructs a failed result from a single error.
+   * @param error The error that stopped the batch.
+   */
+  explicit BatchResult(nsbaci::Error error) : BaseResult(std::move(error)) {}
+
+  BatchResult(BatchResult&&) noexcept = default;
+  BatchResult& operator=(BatchResult&&) noexcept = default;
+  BatchResult(const BatchResult&) = default;
+  BatchResult& operator=(const BatchResult&) = default;
+
+  /// @brief Distinct outcomes, most common first.
+  std::vector<OutcomeSummary> outcomes;
+  /// @brief Number of runs that produced each output.
+  std::map<std::string, uint64_t> outputHistogram;
+  /// @brief Number of runs in which each data race was found, by
+  /// Race::describe()
+  std::map<std::string, uint64_t> races;
+  uint64_t runs = 0;           ///< Runs executed.
+  uint64_t halted = 0;         ///< Runs that halted normally.
+  uint64_t deadlocks = 0;      ///< Runs that ended in a deadlock.
+  uint64_t runtimeErrors = 0;  ///< Runs that ended in a runtime error.
+  uint64_t stepLimits = 0;     ///< Runs stopped by the step limit.
+  uint64_t inputErrors = 0;    ///< Runs that ran out of input.
+  uint64_t livelocks = 0;      ///< Runs stopped as a probable livelock.
+  uint64_t totalSteps = 0;     ///< Instructions executed over all runs.
+  double seconds = 0.0;        ///< Wall time of the whole batch.
+};
+
+/**
+ * @class BatchRunner
+ * @brief Runs one program under many scheduler seeds across all cores.
+ *
+ * Every run gets its own RuntimeService built by the factory for its seed,
+ * while all of them share the same CodeImage. Runs are spread over a
+ * work-stealing pool and each worker aggregates locally; the partial
+ * results are merged once at the end.
+ *
+ * Usage example:
+ * @code
+ * BatchRunner runner([](uint64_t seed) {
+ *   return RuntimeServiceFactory::createService(nsbaciRuntime, seed);
+ * });
+ * BatchOptions options;
+ * options.runs = 10000;
+ * auto result = runner.run(image, options);
+ * @endcode
+ */
+class BatchRunner {
+ public:
+  /// @brief Builds a runtime whose scheduler is seeded with the argument.
+  using ServiceFactory = std::function<RuntimeService(uint64_t)>;
+
+  /**
+   * @brief Constructs a runner.
+   * @param f Factory for seeded runtime services; called from worker threads.
+   */
+  explicit BatchRunner(ServiceFactory f);
+
+  /**
+   * @brief Runs the batch and waits for it to finish.
+   * @param image Compiled program shared by every run.
+   * @param options Seeds, limits and input.
+   * @return Aggregated outcomes.
+   */
+  BatchResult run(std::shared_ptr<const runtime::CodeImage> image,
+                  const BatchOptions& options) const;
+
+  /**
+   * @brief Executes a single run.
+   *
+   * Exposed so a reported seed can be replayed on its own.
+   *
+   * @param image Compiled program.
+   * @param seed Scheduler seed.
+   * @param options Step limit and input.
+   * @param steps Receives the number of executed instructions.
+   * @return The outcome of the run.
+   */
+  RunOutcome runOne(const std::shared_ptr<const runtime::CodeImage>& image,
+                    uint64_t seed, const BatchOptions& options,
+                    uint64_t& steps) const;
+
+ private:
+  ServiceFactory factory;  ///< Builds one runtime per run.
+};
+
+}  // namespace nsbaci::services
+
+#endif  // NSBACI_SERVICES_RUNTIME_BATCHRUNNER_H
@@ -0,0 +1,149 @@
+/**
+ * @file workStealingPool.cpp
+ * @brief WorkStealingPool class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "workStealingPool.h"
+
+#include <algorithm>
+
+namespace nsbaci::services::runtime {
+
+namespace {
+
+// Pool and worker index of the calling thread, if it is a pool worker
+thread_local const WorkStealingPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+
+}  // namespace
+
+WorkStealingPool::WorkStealingPool(size_t workers) {
+  if (workers == 0) {
+    workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  queues.reserve(workers);
+  for (size_t i = 0; i < workers; ++i) {
+    queues.push_back(std::make_unique<Worker>());
+  }
+
+  threads.reserve(workers);
+  for (size_t i = 0; i < workers; ++i) {
+    threads.emplace_back([this, i] { workerLoop(i); });
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> lock(idleMutex);
+    stopping = true;
+  }
+  idleCv.notify_all();
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+void WorkStealingPool::submit(Task task) {
+  size_t target = currentPool == this
+                      ? currentWorker
+                      : nextQueue.fetch_add(1) % queues.size();
+
+  // Count before publishing so wait() never sees a false zero and no worker
+  // decrements queued below zero
+  ++pending;
+  ++queued;
+  {
+    std::lock_guard<std::mutex> lock(queues[target]->mutex);
+    queues[target]->tasks.push_back(std::move(task));
+  }
+
+  // Taking the lock orders this against a worker about to sleep
+  { std::lock_guard<std::mutex> lock(idleMutex); }
+  idleCv.notify_one();
+}
+
+void WorkStealingPool::wait() {
+  {
+    std::unique_lock<std::mutex> lock(idleMutex);
+    doneCv.wait(lock, [this] { return pending == 0; });
+  }
+
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    std::swap(error, firstError);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+size_t WorkStealingPool::workerCount() const { return threads.size(); }
+
+void WorkStealingPool::workerLoop(size_t index) {
+  currentPool = this;
+  currentWorker = index;
+
+  while (true) {
+    Task task;
+    if (popLocal(index, task) || steal(index, task)) {
+      --queued;
+      try {
+        task(index);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!firstError) {
+          firstError = std::current_exception();
+        }
+      }
+      finishTask();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(idleMutex);
+    idleCv.wait(lock, [this] { return stopping || queued > 0; });
+    if (stopping && queued == 0) {
+      return;
+    }
+  }
+}
+
+bool WorkStealingPool::popLocal(size_t index, Task& out) {
+  Worker& w = *queues[index];
+  std::lock_guard<std::mutex> lock(w.mutex);
+  if (w.tasks.empty()) {
+    return false;
+  }
+  // Newest first: keeps the worker on the data it just produced
+  out = std::move(w.tasks.back());
+  w.tasks.pop_back();
+  return true;
+}
+
+bool WorkStealingPool::steal(size_t thief, Task& out) {
+  for (size_t k = 1; k < queues.size(); ++k) {
+    Worker& victim = *queues[(thief + k) % queues.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      // Oldest first: the victim keeps its hot end
+      out = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingPool::finishTask() {
+  if (--pending == 0) {
+    { std::lock_guard<std::mutex> lock(idleMutex); }
+    doneCv.notify_all();
+  }
+}
+
+}  // namespace nsbaci::services::runtime
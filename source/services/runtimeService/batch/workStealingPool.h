@@ -0,0 +1,131 @@
+/**
+ * @file workStealingPool.h
+ * @brief WorkStealingPool class declaration for nsbaci runtime service.
+ *
+ * This module defines a small fixed-size thread pool with one task deque per
+ * worker. Workers take tasks from the back of their own deque and steal from
+ * the front of other workers' deques when they run out, so uneven tasks (a
+ * run that takes a million steps next to one that halts immediately) still
+ * keep every core busy.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_WORKSTEALINGPOOL_H
+#define NSBACI_SERVICES_RUNTIME_WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @namespace nsbaci::services::runtime
+ * @brief Runtime services namespace for nsbaci.
+ */
+namespace nsbaci::services::runtime {
+
+/**
+ * @class WorkStealingPool
+ * @brief Fixed-size thread pool with per-worker deques and task stealing.
+ *
+ * Tasks receive the index of the worker running them, so callers can keep
+ * per-worker state (accumulators, runtimes) without locking. A task may
+ * submit further tasks; those go to the submitting worker's own deque.
+ *
+ * Usage example:
+ * @code
+ * WorkStealingPool pool;
+ * for (int i = 0; i < 100; ++i) {
+ *   pool.submit([i](size_t worker) { work(i, worker); });
+ * }
+ * pool.wait();
+ * @endcode
+ */
+class WorkStealingPool {
+ public:
+  /// @brief Unit of work; the argument is the running worker's index.
+  using Task = std::function<void(size_t)>;
+
+  /**
+   * @brief Starts the worker threads.
+   * @param workers Number of workers (0 = hardware concurrency).
+   */
+  explicit WorkStealingPool(size_t workers = 0);
+
+  /**
+   * @brief Finishes the queued tasks and joins every worker.
+   */
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  WorkStealingPool(WorkStealingPool&&) = delete;
+  WorkStealingPool& operator=(WorkStealingPool&&) = delete;
+
+  /**
+   * @brief Queues a task.
+   *
+   * From inside a task the new task goes to the current worker's deque;
+   * from outside the pool tasks are spread round-robin.
+   *
+   * @param task The task to run.
+   */
+  void submit(Task task);
+
+  /**
+   * @brief Blocks until every submitted task has finished.
+   *
+   * Must not be called from inside a task.
+   *
+   * @throws The first exception thrown by a task, if any.
+   */
+  void wait();
+
+  /**
+   * @brief Gets the number of workers.
+   * @return Worker thread count.
+   */
+  size_t workerCount() const;
+
+ private:
+  /**
+   * @struct Worker
+   * @brief Task deque owned by one worker.
+   */
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void workerLoop(size_t index);
+  bool popLocal(size_t index, Task& out);
+  bool steal(size_t thief, Task& out);
+  void finishTask();
+
+  std::vector<std::unique_ptr<Worker>> queues;  ///< One deque per worker
+  std::vector<std::thread> threads;             ///< Worker threads
+
+  std::mutex idleMutex;               ///< Guards sleeping and waiting
+  std::condition_variable idleCv;     ///< Wakes workers when tasks arrive
+  std::condition_variable doneCv;     ///< Wakes wait() when pending hits 0
+  std::atomic<size_t> pending{0};     ///< Submitted but not finished
+  std::atomic<size_t> queued{0};      ///< Sitting in some deque
+  std::atomic<size_t> nextQueue{0};   ///< Round-robin target for submit
+  std::atomic<bool> stopping{false};  ///< Set by the destructor
+
+  std::mutex errorMutex;          ///< Guards firstError
+  std::exception_ptr firstError;  ///< First exception thrown by a task
+};
+
+}  // namespace nsbaci::services::runtime
+
+#endif  // NSBACI_SERVICES_RUNTIME_WORKSTEALINGPOOL_H
@@ -0,0 +1,151 @@
+/**
+ * @file contentionProfiler.cpp
+ * @brief ContentionProfiler class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "contentionProfiler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace nsbaci::services::runtime {
+
+namespace {
+
+const char* kindName(const nsbaci::types::WaitResource& resource) {
+  return resource.kind == nsbaci::types::ResourceKind::Monitor ? "monitor"
+                                                               : "semaphore";
+}
+
+// Steps from since to step; a seek back may leave since ahead
+uint64_t stepsBetween(uint64_t since, uint64_t step) {
+  return step > since ? step - since : 0;
+}
+
+}  // namespace
+
+std::string ContentionReport::describe() const {
+  std::string text;
+  char numbers[96];
+  for (const auto& r : resources) {
+    std::snprintf(numbers, sizeof(numbers),
+                  " blocked (%.1f%%), wait %.1f average, %llu max steps",
+                  100.0 * r.blockedShare(), r.averageWait(),
+                  static_cast<unsigned long long>(r.maxWait));
+    text += std::string(kindName(r.resource)) + " @" +
+            std::to_string(r.resource.address) + ": " +
+            std::to_string(r.acquires) + " acquires, " +
+            std::to_string(r.blocked) + numbers +
+            ", queue up to " + std::to_string(r.maxQueue) + "\n";
+    for (const auto& site : r.sites) {
+      text += "  pc " + std::to_string(site.pc) + ": " +
+              std::to_string(site.waits) + " waits, " +
+              std::to_string(site.steps) + " steps\n";
+    }
+  }
+  return text;
+}
+
+std::string ContentionReport::csv() const {
+  std::string out =
+      "resource,address,acquires,blocked,total wait,max wait,max queue,"
+      "top pc\n";
+  for (const auto& r : resources) {
+    out += std::string(kindName(r.resource)) + ',' +
+           std::to_string(r.resource.address) + ',' +
+           std::to_string(r.acquires) + ',' + std::to_string(r.blocked) + ',' +
+           std::to_string(r.totalWait) + ',' + std::to_string(r.maxWait) +
+           ',' + std::to_string(r.maxQueue) + ',' +
+           (r.sites.empty() ? std::string() : std::to_string(r.sites[0].pc)) +
+           '\n';
+  }
+  return out;
+}
+
+void ContentionProfiler::reset() {
+  resources.clear();
+  waiting.clear();
+}
+
+void ContentionProfiler::blocked(nsbaci::types::ThreadID thread,
+                                 const nsbaci::types::WaitResource& resource,
+                                 uint32_t pc, uint64_t step, size_t queued) {
+  Entry& entry = resources[resource];
+  entry.counts.maxQueue = std::max(entry.counts.maxQueue, queued);
+
+  // Blocking again after a wakeup lost to another thread: same wait
+  auto it = waiting.find(thread);
+  if (it != waiting.end() && it->second.resource == resource) {
+    return;
+  }
+  waiting[thread] = OpenWait{resource, pc, step};
+  ++entry.counts.blocked;
+  WaitSite& site = entry.sites[pc];
+  site.pc = pc;
+  ++site.waits;
+}
+
+void ContentionProfiler::acquired(nsbaci::types::ThreadID thread,
+                                  const nsbaci::types::WaitResource& resource,
+                                  uint64_t step) {
+  Entry& entry = resources[resource];
+  ++entry.counts.acquires;
+
+  auto it = waiting.find(thread);
+  if (it == waiting.end()) {
+    return;
+  }
+  if (it->second.resource == resource) {
+    uint64_t wait = stepsBetween(it->second.since, step);
+    entry.counts.totalWait += wait;
+    entry.counts.maxWait = std::max(entry.counts.maxWait, wait);
+    entry.sites[it->second.pc].steps += wait;
+  }
+  waiting.erase(it);
+}
+
+ContentionReport ContentionProfiler::report(uint64_t step,
+                                            size_t topSites) const {
+  // Waits still open count up to now
+  std::map<nsbaci::types::WaitResource, Entry> closed = resources;
+  for (const auto& [thread, open] : waiting) {
+    uint64_t wait = stepsBetween(open.since, step);
+    Entry& entry = closed[open.resource];
+    entry.counts.totalWait += wait;
+    entry.counts.maxWait = std::max(entry.counts.maxWait, wait);
+    entry.sites[open.pc].steps += wait;
+  }
+
+  ContentionReport out;
+  out.steps = step;
+  for (auto& [resource, entry] : closed) {
+    ResourceContention counts = entry.counts;
+    counts.resource = resource;
+    for (const auto& [pc, site] : entry.sites) {
+      counts.sites.push_back(site);
+    }
+    std::sort(counts.sites.begin(), counts.sites.end(),
+              [](const WaitSite& a, const WaitSite& b) {
+                if (a.steps != b.steps) {
+                  return a.steps > b.steps;
+                }
+                return a.pc < b.pc;
+              });
+    if (counts.sites.size() > topSites) {
+      counts.sites.resize(topSites);
+    }
+    out.resources.push_back(std::move(counts));
+  }
+  std::stable_sort(out.resources.begin(), out.resources.end(),
+                   [](const ResourceContention& a,
+                      const ResourceContention& b) {
+                     return a.totalWait > b.totalWait;
+                   });
+  return out;
+}
+
+}  // namespace nsbaci::services::runtime
@@ -0,0 +1,171 @@
+/**
+ * @file contentionProfiler.h
+ * @brief ContentionProfiler class declaration for nsbaci runtime service.
+ *
+ * This module defines a profiler of synchronization contention: for each
+ * semaphore and monitor, how often it was taken, how often a thread had to
+ * wait for it, for how long, how many threads queued on it at once, and at
+ * which instructions they waited. Times are virtual: instructions executed
+ * by any thread while the waiter was blocked.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_CONTENTIONPROFILER_H
+#define NSBACI_SERVICES_RUNTIME_CONTENTIONPROFILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "runtimeTypes.h"
+
+/**
+ * @namespace nsbaci::services::runtime
+ * @brief Runtime services namespace for nsbaci.
+ */
+namespace nsbaci::services::runtime {
+
+/**
+ * @struct WaitSite
+ * @brief Waits for a resource that started at one instruction.
+ */
+struct WaitSite {
+  uint32_t pc = 0;     ///< Address of the Wait or EnterMonitor
+  uint64_t waits = 0;  ///< Waits that started there
+  uint64_t steps = 0;  ///< Steps spent in them
+};
+
+/**
+ * @struct ResourceContention
+ * @brief Contention of one semaphore or monitor.
+ */
+struct ResourceContention {
+  nsbaci::types::WaitResource resource;  ///< The semaphore or monitor
+  uint64_t acquires = 0;                 ///< Times a thread took it
+  uint64_t blocked = 0;    ///< Times a thread had to wait first
+  uint64_t totalWait = 0;  ///< Steps waited, summed over every wait
+  uint64_t maxWait = 0;    ///< Longest single wait, in steps
+  size_t maxQueue = 0;     ///< Most threads waiting at once
+  std::vector<WaitSite> sites;  ///< Top waiting sites, most steps first
+
+  /**
+   * @brief Gets the share of acquisitions that had to wait.
+   * @return Blocked over acquires, between 0 and 1.
+   */
+  double blockedShare() const {
+    return acquires ? double(blocked) / double(acquires) : 0.0;
+  }
+
+  /**
+   * @brief Gets the length of the average wait.
+   * @return Steps per wait.
+   */
+  double averageWait() const {
+    return blocked ? double(totalWait) / double(blocked) : 0.0;
+  }
+};
+
+/**
+ * @struct ContentionReport
+ * @brief Contention of every semaphore and monitor that was used.
+ */
+struct ContentionReport {
+  uint64_t steps = 0;  ///< Steps executed when the report was made
+  /// @brief Resources, the longest waited for first
+  std::vector<ResourceContention> resources;
+
+  /**
+   * @brief Human-readable description, one paragraph per resource.
+   * @return Text such as "semaphore @2: 900 acquires, 700 blocked (77.8%),
+   * ..." followed by a line per waiting site.
+   */
+  std::string describe() const;
+
+  /**
+   * @brief Writes the report as CSV, one row per resource.
+   * @return The report.
+   */
+  std::string csv() const;
+};
+
+/**
+ * @class ContentionProfiler
+ * @brief Follows every thread that blocks until it gets the resource.
+ *
+ * A thread woken from a semaphore or monitor retries its instruction and
+ * may block again if another thread got there first; its wait lasts from
+ * the first block to the acquisition that finally succeeds. Waits still
+ * open when a report is made count up to then.
+ */
+class ContentionProfiler {
+ public:
+  ContentionProfiler() = default;
+  ~ContentionProfiler() = default;
+
+  /**
+   * @brief Drops every count and open wait.
+   */
+  void reset();
+
+  /**
+   * @brief Notes a thread blocking on a resource.
+   * @param thread Thread that blocked.
+   * @param resource Semaphore or monitor it waits for.
+   * @param pc Address of the instruction that blocked.
+   * @param step Steps executed so far.
+   * @param queued Threads waiting for the resource, this one included.
+   */
+  void blocked(nsbaci::types::ThreadID thread,
+               const nsbaci::types::WaitResource& resource, uint32_t pc,
+               uint64_t step, size_t queued);
+
+  /**
+   * @brief Notes a thread taking a resource.
+   * @param thread Thread that took it.
+   * @param resource Semaphore or monitor taken.
+   * @param step Steps executed so far.
+   */
+  void acquired(nsbaci::types::ThreadID thread,
+                const nsbaci::types::WaitResource& resource, uint64_t step);
+
+  /**
+   * @brief Builds the report.
+   * @param step Steps executed so far, to close the open waits at.
+   * @param topSites Waiting sites kept per resource.
+   * @return The report.
+   */
+  ContentionReport report(uint64_t step, size_t topSites) const;
+
+ private:
+  /**
+   * @struct Entry
+   * @brief Counts of one resource, with every site.
+   */
+  struct Entry {
+    ResourceContention counts;                     ///< Sites left empty
+    std::unordered_map<uint32_t, WaitSite> sites;  ///< Sites by address
+  };
+
+  /**
+   * @struct OpenWait
+   * @brief A thread still waiting.
+   */
+  struct OpenWait {
+    nsbaci::types::WaitResource resource;  ///< What for
+    uint32_t pc = 0;                       ///< Where it started
+    uint64_t since = 0;                    ///< When it started
+  };
+
+  std::map<nsbaci::types::WaitResource, Entry> resources;  ///< By resource
+  std::unordered_map<nsbaci::types::ThreadID, OpenWait> waiting;  ///< By thread
+};
+
+}  // namespace nsbaci::services::runtime
+
+#endif  // NSBACI_SERVICES_RUNTIME_CONTENTIONPROFILER_H
@@ -0,0 +1,477 @@
+/**
+ * @file explorer.cpp
+ * @brief Explorer class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "explorer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "instruction.h"
+#include "visitedSet.h"
+#include "workStealingPool.h"
+
+namespace nsbaci::services {
+
+namespace {
+
+using nsbaci::types::ThreadID;
+using nsbaci::types::ThreadState;
+
+// splitmix64 finaliser: cheap and mixes every input bit into every output bit
+uint64_t mix(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+uint64_t combine(uint64_t h, uint64_t v) {
+  return mix(h ^ (v + 0x9e3779b97f4a7c15ULL));
+}
+
+// FNV-1a over the output produced so far
+uint64_t hashText(const std::string& text) {
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (unsigned char c : text) {
+    h = (h ^ c) * 0x100000001b3ULL;
+  }
+  return h;
+}
+
+// Appends a fixed-size value to a canonical state
+template <typename T>
+void put(std::string& out, T value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool isEnabled(const runtime::Thread& t) {
+  return t.getState() == ThreadState::Ready ||
+         t.getState() == ThreadState::Running;
+}
+
+/**
+ * @brief True if an instruction only touches its own thread's stack and pc.
+ *
+ * Such a step commutes with every step of every other thread, which is what
+ * makes running it alone a valid (ample) expansion.
+ */
+bool isLocal(nsbaci::compiler::Opcode op) {
+  using nsbaci::compiler::Opcode;
+  switch (op) {
+    case Opcode::PushLiteral:
+    case Opcode::LoadAddress:
+    case Opcode::Add:
+    case Opcode::Sub:
+    case Opcode::Mult:
+    case Opcode::Div:
+    case Opcode::Mod:
+    case Opcode::Negate:
+    case Opcode::And:
+    case Opcode::Or:
+    case Opcode::TestEQ:
+    case Opcode::TestNE:
+    case Opcode::TestLT:
+    case Opcode::TestLE:
+    case Opcode::TestGT:
+    case Opcode::TestGE:
+    case Opcode::Jump:
+    case Opcode::JumpZero:
+    case Opcode::Halt:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/**
+ * @struct Node
+ * @brief A state on the frontier and how it was reached.
+ */
+struct Node {
+  ExecutionState state;
+  Schedule schedule;
+  std::string output;
+  size_t inputPos = 0;
+};
+
+/**
+ * @struct Exploration
+ * @brief State shared by all workers of one explore() call.
+ */
+struct Exploration {
+  std::shared_ptr<const runtime::CodeImage> image;
+  const ExploreOptions* options = nullptr;
+  const Explorer::ServiceFactory* factory = nullptr;
+
+  runtime::VisitedSet visited;
+  std::vector<std::unique_ptr<RuntimeService>> services;  // One per worker
+  runtime::WorkStealingPool* pool = nullptr;
+
+  std::atomic<uint64_t> states{0};
+  std::atomic<uint64_t> transitions{0};
+  std::atomic<uint64_t> reduced{0};
+  std::atomic<bool> truncated{false};
+
+  std::mutex findingsMutex;
+  std::map<std::pair<FindingKind, std::string>, Finding> violations;
+  std::map<std::pair<nsbaci::types::Memory, std::string>, Finding> finals;
+};
+
+uint64_t nodeFingerprint(const Node& node) {
+  uint64_t h = fingerprint(node.state);
+  h = combine(h, hashText(node.output));
+  return combine(h, node.inputPos);
+}
+
+std::string nodeState(const Node& node) {
+  std::string bytes = canonicalState(node.state);
+  put(bytes, node.output.size());
+  bytes += node.output;
+  put(bytes, node.inputPos);
+  return bytes;
+}
+
+// Marks a node visited; false if it already was
+bool markVisited(Exploration& ex, const Node& node) {
+  return ex.visited.insert(nodeFingerprint(node), nodeState(node));
+}
+
+// Keeps the shortest schedule for each distinct finding
+void keepShortest(std::map<std::pair<FindingKind, std::string>, Finding>& m,
+                  Finding f) {
+  auto key = std::make_pair(f.kind, f.message);
+  auto it = m.find(key);
+  if (it == m.end()) {
+    m.emplace(std::move(key), std::move(f));
+  } else if (f.schedule.size() < it->second.schedule.size()) {
+    it->second = std::move(f);
+  }
+}
+
+void record(Exploration& ex, Finding f) {
+  std::lock_guard<std::mutex> lock(ex.findingsMutex);
+  if (f.kind != FindingKind::FinalState) {
+    keepShortest(ex.violations, std::move(f));
+    return;
+  }
+  auto key = std::make_pair(f.memory, f.output);
+  auto it = ex.finals.find(key);
+  if (it == ex.finals.end()) {
+    ex.finals.emplace(std::move(key), std::move(f));
+  } else if (f.schedule.size() < it->second.schedule.size()) {
+    it->second = std::move(f);
+  }
+}
+
+RuntimeService& serviceFor(Exploration& ex, size_t worker) {
+  auto& service = ex.services[worker];
+  if (!service) {
+    service = std::make_unique<RuntimeService>((*ex.factory)());
+    service->loadProgram(ex.image);
+  }
+  return *service;
+}
+
+void expand(Exploration& ex, const Node& node, size_t worker);
+
+/**
+ * @brief Runs one thread for one instruction from a node and files the
+ * successor.
+ * @return False only if the successor is a non-failing, already visited
+ * state (the case the reduction proviso cares about).
+ */
+bool visit(Exploration& ex, const Node& node, ThreadID thread,
+           size_t worker) {
+  if (node.schedule.size() >= ex.options->maxDepth) {
+    ex.truncated = true;
+    return true;
+  }
+
+  RuntimeService& service = serviceFor(ex, worker);
+  auto next = std::make_shared<Node>();
+  next->schedule = node.schedule;
+  next->schedule.push_back(thread);
+  next->output = node.output;
+  next->inputPos = node.inputPos;
+
+  Finding failure;
+  bool failed = false;
+  try {
+    service.restoreState(node.state);
+    RuntimeResult result = service.stepThread(thread);
+    if (result.needsInput) {
+      if (next->inputPos < ex.options->input.size()) {
+        service.provideInput(ex.options->input[next->inputPos++]);
+        result = service.stepThread(thread);
+      } else {
+        failed = true;
+        failure.kind = FindingKind::InputExhausted;
+        failure.message = "Program needs input but none is left";
+      }
+    }
+    if (!failed && !result.ok) {
+      failed = true;
+      failure.kind = FindingKind::RuntimeError;
+      failure.message =
+          result.errors.empty() ? "" : result.errors.front().basic.message;
+    }
+    if (!failed && result.deadlock.has_value()) {
+      failed = true;
+      failure.kind = FindingKind::Deadlock;
+      failure.message = result.deadlock->describe();
+    }
+    next->output += result.output;
+  } catch (const std::exception& e) {
+    failed = true;
+    failure.kind = FindingKind::RuntimeError;
+    failure.message = e.what();
+  }
+  ++ex.transitions;
+
+  if (failed) {
+    failure.schedule = std::move(next->schedule);
+    failure.output = std::move(next->output);
+    failure.memory = service.getProgram().memory();
+    record(ex, std::move(failure));
+    return true;
+  }
+
+  next->state = service.saveState();
+  if (!markVisited(ex, *next)) {
+    return false;
+  }
+  if (++ex.states > ex.options->maxStates) {
+    ex.truncated = true;
+    return true;
+  }
+
+  const auto& threads = next->state.threads.threads;
+  if (std::none_of(threads.begin(), threads.end(), isEnabled)) {
+    bool blocked =
+        std::any_of(threads.begin(), threads.end(), [](const auto& t) {
+          return t.getState() == ThreadState::Blocked;
+        });
+    Finding f;
+    f.kind = blocked ? FindingKind::Deadlock : FindingKind::FinalState;
+    if (blocked) {
+      runtime::DeadlockReport report;
+      report.global = true;
+      for (size_t idx : next->state.threads.blockedQueue) {
+        const auto* e =
+            next->state.threads.waitFor.edgeOf(threads[idx].getId());
+        if (e) {
+          report.edges.push_back(*e);
+        }
+      }
+      f.message = report.describe();
+    }
+    f.schedule = std::move(next->schedule);
+    f.output = std::move(next->output);
+    f.memory = std::move(next->state.memory);
+    record(ex, std::move(f));
+    return true;
+  }
+
+  ex.pool->submit([&ex, next](size_t w) { expand(ex, *next, w); });
+  return true;
+}
+
+void expand(Exploration& ex, const Node& node, size_t worker) {
+  std::vector<ThreadID> enabled;
+  for (const auto& t : node.state.threads.threads) {
+    if (isEnabled(t)) {
+      enabled.push_back(t.getId());
+    }
+  }
+
+  // Look for a thread whose next step is invisible to every other thread
+  auto ample = enabled.end();
+  if (ex.options->partialOrderReduction && enabled.size() > 1) {
+    ample = std::find_if(enabled.begin(), enabled.end(), [&](ThreadID id) {
+      for (const auto& t : node.state.threads.threads) {
+        if (t.getId() == id) {
+          return t.getPC() < ex.image->instructionCount() &&
+                 isLocal(ex.image->getInstruction(t.getPC()).opcode);
+        }
+      }
+      return false;
+    });
+  }
+
+  if (ample != enabled.end()) {
+    if (visit(ex, node, *ample, worker)) {
+      ++ex.reduced;
+      return;
+    }
+    // Proviso: the reduced successor closes a cycle, expand everything
+    for (ThreadID id : enabled) {
+      if (id != *ample) {
+        visit(ex, node, id, worker);
+      }
+    }
+    return;
+  }
+
+  for (ThreadID id : enabled) {
+    visit(ex, node, id, worker);
+  }
+}
+
+}  // namespace
+
+uint64_t fingerprint(const ExecutionState& state) {
+  uint64_t h = mix(state.memory.size());
+  for (int32_t word : state.memory) {
+    h = combine(h, static_cast<uint32_t>(word));
+  }
+
+  const runtime::SchedulerState& s = state.threads;
+  for (const auto& t : s.threads) {
+    // Running is Ready from the explorer's point of view
+    ThreadState ts = t.getState() == ThreadState::Running ? ThreadState::Ready
+                                                           : t.getState();
+    h = combine(h, t.getId());
+    h = combine(h, static_cast<uint64_t>(ts));
+    h = combine(h, t.getPC());
+    h = combine(h, t.getStack().size());
+    for (int32_t v : t.getStack()) {
+      h = combine(h, static_cast<uint32_t>(v));
+    }
+  }
+
+  // Waiting order decides who wakes first, so these queues hash in order
+  for (size_t idx : s.blockedQueue) {
+    h = combine(h, s.threads[idx].getId());
+  }
+  h = combine(h, ~uint64_t(0));
+  for (size_t idx : s.ioQueue) {
+    h = combine(h, s.threads[idx].getId());
+  }
+  return h;
+}
+
+std::string canonicalState(const ExecutionState& state) {
+  std::string bytes;
+  put(bytes, state.memory.size());
+  bytes.append(reinterpret_cast<const char*>(state.memory.data()),
+               state.memory.size() * sizeof(int32_t));
+
+  const runtime::SchedulerState& s = state.threads;
+  put(bytes, s.threads.size());
+  for (const auto& t : s.threads) {
+    ThreadState ts = t.getState() == ThreadState::Running ? ThreadState::Ready
+                                                           : t.getState();
+    put(bytes, t.getId());
+    put(bytes, static_cast<uint8_t>(ts));
+    put(bytes, t.getPC());
+    put(bytes, t.getStack().size());
+    for (int32_t v : t.getStack()) {
+      put(bytes, v);
+    }
+  }
+
+  put(bytes, s.blockedQueue.size());
+  for (size_t idx : s.blockedQueue) {
+    put(bytes, s.threads[idx].getId());
+  }
+  put(bytes, s.ioQueue.size());
+  for (size_t idx : s.ioQueue) {
+    put(bytes, s.threads[idx].getId());
+  }
+  return bytes;
+}
+
+Explorer::Explorer(ServiceFactory f) : factory(std::move(f)) {}
+
+ExploreResult Explorer::explore(std::shared_ptr<const runtime::CodeImage> image,
+                                const ExploreOptions& options) const {
+  if (!image || !factory) {
+    nsbaci::Error err;
+    err.basic.severity = nsbaci::types::ErrSeverity::Error;
+    err.basic.message = "Exploration needs a program and a runtime factory";
+    err.basic.type = nsbaci::types::ErrType::unknown;
+    err.payload = nsbaci::types::RuntimeError{};
+    return ExploreResult(std::move(err));
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  Exploration ex;
+  ex.image = image;
+  ex.options = &options;
+  ex.factory = &factory;
+
+  // Initial state: program loaded, main thread ready
+  auto root = std::make_shared<Node>();
+  {
+    RuntimeService service = factory();
+    service.loadProgram(image);
+    root->state = service.saveState();
+  }
+  markVisited(ex, *root);
+  ex.states = 1;
+
+  try {
+    runtime::WorkStealingPool pool(options.workers);
+    ex.pool = &pool;
+    ex.services.resize(pool.workerCount());
+    pool.submit([&ex, root](size_t w) { expand(ex, *root, w); });
+    pool.wait();
+  } catch (const std::exception& e) {
+    nsbaci::Error err;
+    err.basic.severity = nsbaci::types::ErrSeverity::Error;
+    err.basic.message = std::string("Exploration failed: ") + e.what();
+    err.basic.type = nsbaci::types::ErrType::unknown;
+    err.payload = nsbaci::types::RuntimeError{};
+    return ExploreResult(std::move(err));
+  }
+
+  ExploreResult result;
+  for (auto& [key, finding] : ex.violations) {
+    result.violations.push_back(std::move(finding));
+  }
+  for (auto& [key, finding] : ex.finals) {
+    result.finalStates.push_back(std::move(finding));
+  }
+  result.states = std::min<uint64_t>(ex.states, options.maxStates);
+  result.transitions = ex.transitions;
+  result.reduced = ex.reduced;
+  result.complete = !ex.truncated;
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return result;
+}
+
+RuntimeResult Explorer::replay(RuntimeService& service,
+                               const Schedule& schedule,
+                               const std::vector<std::string>& input) {
+  RuntimeResult result;
+  size_t inputPos = 0;
+  for (ThreadID thread : schedule) {
+    result = service.stepThread(thread);
+    if (result.needsInput && inputPos < input.size()) {
+      service.provideInput(input[inputPos++]);
+      result = service.stepThread(thread);
+    }
+    if (!result.ok || result.needsInput) {
+      break;
+    }
+  }
+  return result;
+}
+
+}  // namespace nsbaci::services
@@ -0,0 +1,186 @@
+/**
+ * @file explorer.h
+ * @brief Explorer class declaration for nsbaci runtime service.
+ *
+ * This module defines the Explorer, a model-checking mode that visits every
+ * reachable interleaving of a program instead of sampling random ones. Each
+ * report comes with the schedule (sequence of thread IDs) that reproduces
+ * it, so it can be replayed step by step in the runtime.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_EXPLORER_H
+#define NSBACI_SERVICES_RUNTIME_EXPLORER_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "baseResult.h"
+#include "codeImage.h"
+#include "runtimeService.h"
+
+/**
+ * @namespace nsbaci::services
+ * @brief Services namespace containing all backend service implementations.
+ */
+namespace nsbaci::services {
+
+/// @brief Sequence of thread IDs, one per executed instruction.
+using Schedule = std::vector<nsbaci::types::ThreadID>;
+
+/**
+ * @enum FindingKind
+ * @brief What an exploration report is about.
+ */
+enum class FindingKind {
+  RuntimeError,    ///< An instruction failed (division by zero, ...).
+  Deadlock,        ///< Some threads are blocked for good.
+  InputExhausted,  ///< A Read found no input left.
+  FinalState,      ///< Every thread terminated normally.
+};
+
+/**
+ * @struct Finding
+ * @brief One reachable outcome and the schedule that leads to it.
+ */
+struct Finding {
+  FindingKind kind = FindingKind::FinalState;  ///< Kind of finding.
+  std::string message;                         ///< Error text, if any.
+  Schedule schedule;                           ///< How to reproduce it.
+  std::string output;                          ///< Output along the path.
+  nsbaci::types::Memory memory;                ///< Global memory at the end.
+};
+
+/**
+ * @struct ExploreOptions
+ * @brief Limits and switches of an exploration.
+ */
+struct ExploreOptions {
+  uint64_t maxStates = 1000000;       ///< Stop after this many states.
+  uint64_t maxDepth = 100000;         ///< Do not follow longer schedules.
+  size_t workers = 0;                 ///< Worker threads (0 = all cores).
+  bool partialOrderReduction = true;  ///< Prune independent interleavings.
+  std::vector<std::string> input;     ///< Values fed to Read, in order.
+};
+
+/**
+ * @struct ExploreResult
+ * @brief Everything an exploration found.
+ */
+struct ExploreResult : nsbaci::BaseResult {
+  /**
+   * @brief Default constructor creates a successful empty result.
+   */
+  ExploreResult() : BaseResult() {}
+
+  /**
+   * @brief Constructs a failed result from a single error.
+   * @param error The error that stopped the exploration.
+   */
+  explicit ExploreResult(nsbaci::Error error) : BaseResult(std::move(error)) {}
+
+  ExploreResult(ExploreResult&&) noexcept = default;
+  ExploreResult& operator=(ExploreResult&&) noexcept = default;
+  ExploreResult(const ExploreResult&) = default;
+  ExploreResult& operator=(const ExploreResult&) = default;
+
+  /// @brief Errors, deadlocks and missing input, one per distinct message.
+  std::vector<Finding> violations;
+  /// @brief Distinct final states; more than one means the result depends
+  /// on the interleaving.
+  std::vector<Finding> finalStates;
+  uint64_t states = 0;       ///< Distinct states visited.
+  uint64_t transitions = 0;  ///< Instructions executed while exploring.
+  uint64_t reduced = 0;      ///< States expanded with a single thread.
+  bool complete = true;      ///< False if a limit cut the search short.
+  double seconds = 0.0;      ///< Wall time of the exploration.
+};
+
+/**
+ * @brief Fingerprints an execution state.
+ *
+ * Covers global memory and every thread's ID, state, pc and stack, plus the
+ * blocked and I/O queues in order. The ready queue is hashed as a set and
+ * the running thread as ready, since which one is picked next is exactly
+ * what the explorer enumerates.
+ *
+ * @param state The state to fingerprint.
+ * @return 64-bit fingerprint.
+ */
+uint64_t fingerprint(const ExecutionState& state);
+
+/**
+ * @brief Encodes what fingerprint() covers as bytes.
+ *
+ * Two states get the same bytes exactly when the explorer treats them as
+ * the same state, so a fingerprint collision can be told from a revisit.
+ *
+ * @param state The state to encode.
+ * @return Its canonical bytes.
+ */
+std::string canonicalState(const ExecutionState& state);
+
+/**
+ * @class Explorer
+ * @brief Exhaustive, parallel exploration of thread interleavings.
+ *
+ * States are expanded by restoring them into a per-worker RuntimeService
+ * and stepping one chosen thread. New states, detected through a shared
+ * VisitedSet, become tasks on a work-stealing pool, so the frontier spreads
+ * over every core. The set confirms every fingerprint hit against the
+ * state's canonical bytes, so a complete exploration has seen every
+ * reachable state.
+ *
+ * With partial-order reduction a state where some thread's next instruction
+ * only touches its own stack and pc is expanded with that thread alone,
+ * since running it first commutes with every other thread's step. If that
+ * single successor was already visited, the state is expanded fully so no
+ * interleaving is lost around a cycle.
+ */
+class Explorer {
+ public:
+  /// @brief Builds a fresh runtime; called once per worker thread.
+  using ServiceFactory = std::function<RuntimeService()>;
+
+  /**
+   * @brief Constructs an explorer.
+   * @param f Factory for runtime services.
+   */
+  explicit Explorer(ServiceFactory f);
+
+  /**
+   * @brief Explores every interleaving of a program.
+   * @param image Compiled program.
+   * @param options Limits, reduction and input.
+   * @return Violations and distinct final states with their schedules.
+   */
+  ExploreResult explore(std::shared_ptr<const runtime::CodeImage> image,
+                        const ExploreOptions& options) const;
+
+  /**
+   * @brief Replays a schedule on a freshly loaded service.
+   *
+   * Steps the given threads in order, feeding input to Read as needed.
+   *
+   * @param service Service with the program loaded and reset.
+   * @param schedule Thread to step at each instruction.
+   * @param input Values fed to Read, in order.
+   * @return Result of the last step, or the first failing one.
+   */
+  static RuntimeResult replay(RuntimeService& service,
+                              const Schedule& schedule,
+                              const std::vector<std::string>& input);
+
+ private:
+  ServiceFactory factory;  ///< Builds one runtime per worker.
+};
+
+}  // namespace nsbaci::services
+
+#endif  // NSBACI_SERVICES_RUNTIME_EXPLORER_H
@@ -0,0 +1,46 @@
+/**
+ * @file visitedSet.cpp
+ * @brief VisitedSet class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "visitedSet.h"
+
+#include <utility>
+
+namespace nsbaci::services::runtime {
+
+bool VisitedSet::insert(uint64_t fingerprint, std::string state) {
+  Shard& shard = shardFor(fingerprint);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.states.insert(Entry{fingerprint, std::move(state)}).second;
+}
+
+bool VisitedSet::contains(uint64_t fingerprint,
+                          const std::string& state) const {
+  const Shard& shard = shardFor(fingerprint);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.states.count(Entry{fingerprint, state}) != 0;
+}
+
+size_t VisitedSet::size() const {
+  size_t total = 0;
+  for (const auto& shard : shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    total += shard.states.size();
+  }
+  return total;
+}
+
+VisitedSet::Shard& VisitedSet::shardFor(uint64_t fingerprint) {
+  return shards[fingerprint >> (64 - SHARD_BITS)];
+}
+
+const VisitedSet::Shard& VisitedSet::shardFor(uint64_t fingerprint) const {
+  return shards[fingerprint >> (64 - SHARD_BITS)];
+}
+
+}  // namespace nsbaci::services::runtime
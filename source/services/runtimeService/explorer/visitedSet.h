@@ -0,0 +1,114 @@
+/**
+ * @file visitedSet.h
+ * @brief VisitedSet class declaration for nsbaci runtime service.
+ *
+ * This module defines a concurrent set of explored states, split into
+ * independently locked shards so that explorer workers rarely contend on
+ * the same lock.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_VISITEDSET_H
+#define NSBACI_SERVICES_RUNTIME_VISITEDSET_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+/**
+ * @namespace nsbaci::services::runtime
+ * @brief Runtime services namespace for nsbaci.
+ */
+namespace nsbaci::services::runtime {
+
+/**
+ * @class VisitedSet
+ * @brief Thread-safe set of states, hashed by their fingerprints.
+ *
+ * Each state is stored as its canonical bytes next to its 64-bit
+ * fingerprint. The fingerprint picks the shard (from its top bits, which
+ * are already well mixed) and the bucket, and a fingerprint hit is
+ * confirmed by comparing the bytes, so two states that collide are both
+ * kept and a search over the set stays exhaustive.
+ */
+class VisitedSet {
+ public:
+  VisitedSet() = default;
+  ~VisitedSet() = default;
+
+  VisitedSet(const VisitedSet&) = delete;
+  VisitedSet& operator=(const VisitedSet&) = delete;
+
+  /**
+   * @brief Inserts a state.
+   * @param fingerprint The state fingerprint.
+   * @param state The state's canonical bytes.
+   * @return True if it was not in the set yet.
+   */
+  bool insert(uint64_t fingerprint, std::string state);
+
+  /**
+   * @brief Checks for a state without inserting it.
+   * @param fingerprint The state fingerprint.
+   * @param state The state's canonical bytes.
+   * @return True if it is in the set.
+   */
+  bool contains(uint64_t fingerprint, const std::string& state) const;
+
+  /**
+   * @brief Gets the number of states stored.
+   * @return Total size over all shards.
+   */
+  size_t size() const;
+
+ private:
+  static constexpr size_t SHARD_BITS = 6;
+  static constexpr size_t SHARD_COUNT = size_t(1) << SHARD_BITS;
+
+  /**
+   * @struct Entry
+   * @brief A stored state.
+   */
+  struct Entry {
+    uint64_t fingerprint;  ///< Hash of the state
+    std::string state;     ///< Its canonical bytes
+
+    bool operator==(const Entry& other) const {
+      return fingerprint == other.fingerprint && state == other.state;
+    }
+  };
+
+  /**
+   * @struct EntryHash
+   * @brief Hashes an entry by its fingerprint.
+   */
+  struct EntryHash {
+    size_t operator()(const Entry& entry) const {
+      return static_cast<size_t>(entry.fingerprint);
+    }
+  };
+
+  /**
+   * @struct Shard
+   * @brief One independently locked part of the set.
+   */
+  struct Shard {
+    mutable std::mutex mutex;
+    std::unordered_set<Entry, EntryHash> states;
+  };
+
+  Shard& shardFor(uint64_t fingerprint);
+  const Shard& shardFor(uint64_t fingerprint) const;
+
+  std::array<Shard, SHARD_COUNT> shards;  ///< States, by fingerprint top bits
+};
+
+}  // namespace nsbaci::services::runtime
+
+#endif  // NSBACI_SERVICES_RUNTIME_VISITEDSET_H
@@ -0,0 +1,87 @@
+/**
+ * @file zobrist.h
+ * @brief Zobrist-style keys for incremental runtime state fingerprints.
+ *
+ * A state fingerprint is the XOR of one key per (component, slot, value)
+ * triple: memory word at an address, stack entry at a depth, a thread's pc.
+ * Changing one value is then two XORs, and the fingerprint of the whole
+ * runtime never needs a full scan. Keys are derived by hashing instead of
+ * looked up in random tables, since values span the whole int32 range.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_ZOBRIST_H
+#define NSBACI_SERVICES_RUNTIME_ZOBRIST_H
+
+#include <cstdint>
+
+/**
+ * @namespace nsbaci::services::runtime::zobrist
+ * @brief Key derivation for incremental fingerprints.
+ */
+namespace nsbaci::services::runtime::zobrist {
+
+/**
+ * @enum Component
+ * @brief Part of the runtime state a key belongs to.
+ */
+enum Component : uint64_t {
+  Memory = 1,  ///< Global memory word; slot is the address.
+  Stack,       ///< Thread stack entry; slot is (thread, depth).
+  Pc,          ///< Thread program counter; slot is the thread.
+  State,       ///< Thread scheduling state; slot is the thread.
+};
+
+/**
+ * @brief splitmix64 finaliser.
+ * @param x Value to mix.
+ * @return Well mixed 64-bit value.
+ */
+inline uint64_t mix(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+/**
+ * @brief Key of one value in one slot of one component.
+ * @param component Which part of the state.
+ * @param slot Address, depth or thread, depending on the component.
+ * @param value The value held in the slot.
+ * @return Pseudo-random 64-bit key.
+ */
+inline uint64_t key(Component component, uint64_t slot, uint64_t value) {
+  return mix(mix((uint64_t(component) << 58) ^ slot) ^
+             (value * 0x9e3779b97f4a7c15ULL));
+}
+
+/**
+ * @brief Key of a memory word.
+ * @param addr Memory address.
+ * @param value Word stored there.
+ * @return Key to XOR in or out of the memory fingerprint.
+ */
+inline uint64_t memoryKey(uint64_t addr, int32_t value) {
+  return key(Memory, addr, static_cast<uint32_t>(value));
+}
+
+/**
+ * @brief Key of a stack entry.
+ * @param thread Thread ID.
+ * @param depth Index of the entry, 0 being the bottom.
+ * @param value Value of the entry.
+ * @return Key to XOR in or out of the thread's stack fingerprint.
+ */
+inline uint64_t stackKey(uint64_t thread, uint64_t depth, int32_t value) {
+  return key(Stack, (thread << 32) ^ depth, static_cast<uint32_t>(value));
+}
+
+}  // namespace nsbaci::services::runtime::zobrist
+
+#endif  // NSBACI_SERVICES_RUNTIME_ZOBRIST_H
@@ -0,0 +1,70 @@
+/**
+ * @file memorySnapshot.cpp
+ * @brief MemorySnapshot class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "memorySnapshot.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace nsbaci::services::runtime {
+
+namespace {
+
+// Shared by every all-zero full page of every snapshot
+const std::shared_ptr<const std::vector<int32_t>>& zeroPage() {
+  static const auto page = std::make_shared<const std::vector<int32_t>>(
+      MemorySnapshot::PAGE_WORDS, 0);
+  return page;
+}
+
+bool allZero(const int32_t* words, size_t count) {
+  return std::all_of(words, words + count, [](int32_t w) { return w == 0; });
+}
+
+}  // namespace
+
+MemorySnapshot::MemorySnapshot(const nsbaci::types::Memory& memory,
+                               const MemorySnapshot* previous)
+    : words(memory.size()) {
+  bool comparable = previous && previous->words == words;
+  pages.reserve((words + PAGE_WORDS - 1) / PAGE_WORDS);
+
+  for (size_t at = 0; at < words; at += PAGE_WORDS) {
+    size_t count = std::min(PAGE_WORDS, words - at);
+    const int32_t* src = memory.data() + at;
+    size_t index = at / PAGE_WORDS;
+
+    if (comparable &&
+        std::memcmp(previous->pages[index]->data(), src,
+                    count * sizeof(int32_t)) == 0) {
+      pages.push_back(previous->pages[index]);
+    } else if (count == PAGE_WORDS && allZero(src, count)) {
+      pages.push_back(zeroPage());
+    } else {
+      pages.push_back(
+          std::make_shared<const std::vector<int32_t>>(src, src + count));
+      ownBytes += count * sizeof(int32_t);
+    }
+  }
+}
+
+nsbaci::types::Memory MemorySnapshot::restore() const {
+  nsbaci::types::Memory memory;
+  memory.reserve(words);
+  for (const auto& page : pages) {
+    memory.insert(memory.end(), page->begin(), page->end());
+  }
+  return memory;
+}
+
+size_t MemorySnapshot::bytes() const {
+  return sizeof(MemorySnapshot) + pages.size() * sizeof(Page) + ownBytes;
+}
+
+}  // namespace nsbaci::services::runtime
@@ -0,0 +1,76 @@
+/**
+ * @file memorySnapshot.h
+ * @brief MemorySnapshot class declaration for nsbaci runtime service.
+ *
+ * This module defines the paged copy of global memory kept by execution
+ * checkpoints. Memory is cut into fixed-size pages held by shared pointer;
+ * a snapshot shares every page that did not change since the previous one,
+ * and every all-zero page with a single common page, so a long run of
+ * checkpoints only pays for the pages actually written in between.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_MEMORYSNAPSHOT_H
+#define NSBACI_SERVICES_RUNTIME_MEMORYSNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "codeImage.h"
+
+/**
+ * @namespace nsbaci::services::runtime
+ * @brief Runtime services namespace for nsbaci.
+ */
+namespace nsbaci::services::runtime {
+
+/**
+ * @class MemorySnapshot
+ * @brief Copy-on-write snapshot of global memory.
+ *
+ * Pages are immutable once taken, so sharing them between snapshots is
+ * safe; a page is freed with the last snapshot using it.
+ */
+class MemorySnapshot {
+ public:
+  /// @brief Words per page.
+  static constexpr size_t PAGE_WORDS = 256;
+
+  MemorySnapshot() = default;
+
+  /**
+   * @brief Snapshots memory, sharing unchanged pages with an earlier one.
+   * @param memory The memory to copy.
+   * @param previous Snapshot to share pages with, or nullptr.
+   */
+  MemorySnapshot(const nsbaci::types::Memory& memory,
+                 const MemorySnapshot* previous);
+
+  /**
+   * @brief Rebuilds the memory the snapshot was taken from.
+   * @return Copy of the memory.
+   */
+  nsbaci::types::Memory restore() const;
+
+  /**
+   * @brief Gets the bytes this snapshot allocated itself.
+   * @return Size of the pages not shared when it was taken.
+   */
+  size_t bytes() const;
+
+ private:
+  using Page = std::shared_ptr<const std::vector<int32_t>>;
+
+  std::vector<Page> pages;  ///< Memory in PAGE_WORDS chunks, last one short.
+  size_t words = 0;         ///< Memory size.
+  size_t ownBytes = 0;      ///< Bytes of the pages allocated for it.
+};
+
+}  // namespace nsbaci::services::runtime
+
+#endif  // NSBACI_SERVICES_RUNTIME_MEMORYSNAPSHOT_H
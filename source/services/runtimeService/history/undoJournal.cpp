@@ -0,0 +1,63 @@
+/**
+ * @file undoJournal.cpp
+ * @brief UndoJournal class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "undoJournal.h"
+
+namespace nsbaci::services::runtime {
+
+size_t UndoRecord::bytes() const {
+  return sizeof(UndoRecord) + writes.size() * sizeof(MemoryWrite) +
+         stack.size() * sizeof(StackChange) +
+         (queues.readyQueue.size() + queues.blockedQueue.size() +
+          queues.ioQueue.size()) *
+             sizeof(size_t) +
+         queues.states.size() * sizeof(nsbaci::types::ThreadState) +
+         queues.waitFor.size() * sizeof(WaitEdge) * 2 + input.value.size();
+}
+
+void UndoJournal::setLimit(size_t bytes) {
+  limit = bytes;
+  trim();
+}
+
+void UndoJournal::push(UndoRecord record) {
+  used += record.bytes();
+  records.push_back(std::move(record));
+  trim();
+}
+
+std::optional<UndoRecord> UndoJournal::pop() {
+  if (records.empty()) {
+    return std::nullopt;
+  }
+  UndoRecord record = std::move(records.back());
+  records.pop_back();
+  used -= record.bytes();
+  return record;
+}
+
+bool UndoJournal::empty() const { return records.empty(); }
+
+size_t UndoJournal::size() const { return records.size(); }
+
+size_t UndoJournal::bytes() const { return used; }
+
+void UndoJournal::clear() {
+  records.clear();
+  used = 0;
+}
+
+void UndoJournal::trim() {
+  while (used > limit && !records.empty()) {
+    used -= records.front().bytes();
+    records.pop_front();
+  }
+}
+
+}  // namespace nsbaci::services::runtime
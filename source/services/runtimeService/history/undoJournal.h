@@ -0,0 +1,128 @@
+/**
+ * @file undoJournal.h
+ * @brief UndoJournal class declaration for nsbaci runtime service.
+ *
+ * This module defines the journal that makes stepping backwards possible.
+ * Before every step the runtime notes the scheduler queues and pending
+ * input; during the step the program and the running thread log the old
+ * value of every memory word written and every push and pop. Undoing the
+ * step applies those inverse operations newest first.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_UNDOJOURNAL_H
+#define NSBACI_SERVICES_RUNTIME_UNDOJOURNAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+#include "interpreter.h"
+#include "program.h"
+#include "scheduler.h"
+#include "thread.h"
+
+/**
+ * @namespace nsbaci::services::runtime
+ * @brief Runtime services namespace for nsbaci.
+ */
+namespace nsbaci::services::runtime {
+
+/**
+ * @struct UndoRecord
+ * @brief Everything needed to take back one step.
+ */
+struct UndoRecord {
+  nsbaci::types::ThreadID thread = 0;  ///< Thread that ran.
+  uint32_t pc = 0;                     ///< Its registers before the step.
+  uint32_t bp = 0;
+  uint32_t sp = 0;
+  std::vector<MemoryWrite> writes;  ///< Old values, oldest write first.
+  std::vector<StackChange> stack;   ///< Its pushes and pops, in order.
+  SchedulerQueues queues;           ///< Queues before the pick.
+  InputState input;                 ///< Pending input before the step.
+  uint64_t stepCount = 0;           ///< Instructions executed before it.
+  uint64_t picks = 0;               ///< Replay log picks before it.
+  size_t inputs = 0;                ///< Replay log inputs before it.
+  bool spun = false;                ///< It went round a spin loop.
+  uint32_t spinJumpPc = 0;          ///< If so, its spin watch before.
+  uint64_t spinThreadHash = 0;
+  uint64_t spinReadsHash = 0;
+
+  /**
+   * @brief Approximate heap and inline size, for the journal's limit.
+   * @return Size in bytes.
+   */
+  size_t bytes() const;
+};
+
+/**
+ * @class UndoJournal
+ * @brief Newest-last queue of undo records within a byte budget.
+ *
+ * Pushing past the budget drops the oldest records, so the journal always
+ * covers the most recent steps; anything older has to be rebuilt from a
+ * checkpoint.
+ */
+class UndoJournal {
+ public:
+  /**
+   * @brief Sets the byte budget, dropping old records to fit.
+   * @param bytes Budget; 0 keeps nothing.
+   */
+  void setLimit(size_t bytes);
+
+  /**
+   * @brief Appends the record of the step just taken.
+   * @param record The record.
+   */
+  void push(UndoRecord record);
+
+  /**
+   * @brief Removes the record of the most recent step.
+   * @return The record, or nullopt if the journal is empty.
+   */
+  std::optional<UndoRecord> pop();
+
+  /**
+   * @brief Checks whether any step can be undone from the journal.
+   * @return True if there are no records.
+   */
+  bool empty() const;
+
+  /**
+   * @brief Gets the number of records.
+   * @return Steps the journal can undo.
+   */
+  size_t size() const;
+
+  /**
+   * @brief Gets the space the records take.
+   * @return Sum of UndoRecord::bytes() over every record.
+   */
+  size_t bytes() const;
+
+  /**
+   * @brief Forgets every record.
+   */
+  void clear();
+
+ private:
+  /**
+   * @brief Drops the oldest records until the rest fit the budget.
+   */
+  void trim();
+
+  std::deque<UndoRecord> records;  ///< Oldest first.
+  size_t used = 0;                 ///< Bytes of every record.
+  size_t limit = 0;                ///< Byte budget.
+};
+
+}  // namespace nsbaci::services::runtime
+
+#endif  // NSBACI_SERVICES_RUNTIME_UNDOJOURNAL_H
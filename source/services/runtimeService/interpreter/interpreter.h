@@ -18,7 +18,10 @@
 #include <string>
 
 #include "baseResult.h"
+#include "instruction.h"
 #include "program.h"
+#include "raceDetector.h"
+#include "runtimeTypes.h"
 #include "thread.h"
 
 struct InterpreterResult : nsbaci::BaseResult {
@@ -37,6 +40,32 @@ struct InterpreterResult : nsbaci::BaseResult {
   bool needsInput = false;  ///< Thread is waiting for input
   std::string inputPrompt;  ///< Prompt to show for input
   std::string output;       ///< Output produced by this instruction
+
+  /// @brief Resource the thread must block on; the instruction is retried
+  /// once the thread is woken
+  std::optional<nsbaci::types::WaitResource> blockedOn;
+  /// @brief Thread holding blockedOn, for owned resources
+  std::optional<nsbaci::types::ThreadID> holder;
+  /// @brief Resource made available; one of its waiters should be woken
+  std::optional<nsbaci::types::WaitResource> released;
+  /// @brief Semaphore or monitor taken by the instruction
+  std::optional<nsbaci::types::WaitResource> acquired;
+  /// @brief Stopped at a Trap; nothing was executed and the pc is unchanged
+  bool trapped = false;
+};
+
+struct EvaluationResult : nsbaci::BaseResult {
+  EvaluationResult() : BaseResult() {}
+  explicit EvaluationResult(nsbaci::Error error)
+      : BaseResult(std::move(error)) {}
+
+  EvaluationResult(EvaluationResult&&) noexcept = default;
+  EvaluationResult& operator=(EvaluationResult&&) noexcept = default;
+
+  EvaluationResult(const EvaluationResult&) = default;
+  EvaluationResult& operator=(const EvaluationResult&) = default;
+
+  int32_t value = 0;  ///< Value the expression left on the stack
 };
 
 /**
@@ -51,6 +80,16 @@ using OutputCallback = std::function<void(const std::string&)>;
 /// @brief Callback type for input requests
 using InputRequestCallback = std::function<void(const std::string&)>;
 
+/**
+ * @struct InputState
+ * @brief Input an interpreter is waiting for or holding.
+ */
+struct InputState {
+  bool waiting = false;    ///< A Read asked for input.
+  bool available = false;  ///< Input was provided but not consumed yet.
+  std::string value;       ///< The provided input.
+};
+
 /**
  * @class Interpreter
  * @brief Executes instructions for threads within a program context.
@@ -71,6 +110,20 @@ class Interpreter {
    */
   virtual InterpreterResult executeInstruction(Thread& t, Program& program) = 0;
 
+  /**
+   * @brief Evaluates a compiled expression against the program's memory.
+   *
+   * The code runs on a scratch thread from its first instruction to its
+   * Halt, unseen by the race detector. It must be a pure expression, as
+   * CompilerService::compileExpression() produces: it only reads memory.
+   *
+   * @param code The expression, ending in a Halt.
+   * @param program The program whose memory it reads.
+   * @return The value left on top of the stack, or the error it raised.
+   */
+  virtual EvaluationResult evaluate(
+      const nsbaci::compiler::InstructionStream& code, Program& program) = 0;
+
   /**
    * @brief Provide input to a thread waiting for input.
    * @param input The input string.
@@ -83,11 +136,45 @@ class Interpreter {
    */
   virtual bool isWaitingForInput() const = 0;
 
+  /**
+   * @brief Drop any pending or requested input so a rerun starts clean.
+   */
+  virtual void reset() = 0;
+
+  /**
+   * @brief Copy out the pending input, so a step can be undone.
+   * @return Input state that restoreInput() accepts.
+   */
+  virtual InputState saveInput() const = 0;
+
+  /**
+   * @brief Put back input state saved by saveInput().
+   * @param s The state to restore.
+   */
+  virtual void restoreInput(const InputState& s) = 0;
+
   /**
    * @brief Set the output callback for print operations.
    * @param callback Function to call when output is produced.
    */
   virtual void setOutputCallback(OutputCallback callback) = 0;
+
+  /**
+   * @brief Report memory accesses and synchronization to a race detector.
+   * @param detector Detector to feed (not owned), or nullptr to stop.
+   */
+  void setRaceDetector(RaceDetector* detector) { raceDetector = detector; }
+
+  /**
+   * @brief Let the next Trap executed run the instruction it replaced.
+   *
+   * Used to resume a thread stopped at a breakpoint; later Traps stop again.
+   */
+  void passTrap() { trapPassed = true; }
+
+ protected:
+  RaceDetector* raceDetector = nullptr;  ///< Null while detection is off
+  bool trapPassed = false;               ///< The next Trap is passed
 };
 
 }  // namespace nsbaci::services::runtime
@@ -9,15 +9,30 @@
 
 #include "nsbaciInterpreter.h"
 
+#include <string>
+#include <utility>
+
 #include "instruction.h"
 
 namespace nsbaci::services::runtime {
 
+namespace {
+
+// A direct operand outside the data segment
+InterpreterResult outOfBounds(uint32_t addr) {
+  nsbaci::Error err;
+  err.basic.severity = nsbaci::types::ErrSeverity::Error;
+  err.basic.message =
+      "Memory address " + std::to_string(addr) + " out of bounds";
+  err.basic.type = nsbaci::types::ErrType::unknown;
+  err.payload = nsbaci::types::RuntimeError{};
+  return InterpreterResult(std::move(err));
+}
+
+}  // namespace
+
 InterpreterResult NsbaciInterpreter::executeInstruction(Thread& t,
                                                         Program& program) {
-  using namespace nsbaci::compiler;
-  InterpreterResult result;
-
   // Fetch instruction
   const uint32_t pc = t.getPC();
   if (pc >= program.instructionCount()) {
@@ -29,7 +44,52 @@ InterpreterResult NsbaciInterpreter::executeInstruction(Thread& t,
     return InterpreterResult(std::move(err));
   }
 
-  const Instruction& instr = program.getInstruction(pc);
+  return execute(t, program, program.getInstruction(pc));
+}
+
+EvaluationResult NsbaciInterpreter::evaluate(
+    const nsbaci::compiler::InstructionStream& code, Program& program) {
+  using namespace nsbaci::compiler;
+  // The reads are the debugger's, not the program's
+  RaceDetector* detector = std::exchange(raceDetector, nullptr);
+  EvaluationResult result;
+
+  scratch.setPC(0);
+  scratch.setState(nsbaci::types::ThreadState::Running);
+  while (scratch.getState() != nsbaci::types::ThreadState::Terminated) {
+    const uint32_t pc = scratch.getPC();
+    if (pc >= code.size()) {
+      nsbaci::Error err;
+      err.basic.severity = nsbaci::types::ErrSeverity::Error;
+      err.basic.message = "Expression has no Halt";
+      err.basic.type = nsbaci::types::ErrType::unknown;
+      err.payload = nsbaci::types::RuntimeError{};
+      result = EvaluationResult(std::move(err));
+      break;
+    }
+    InterpreterResult step = execute(scratch, program, code[pc]);
+    if (!step.ok) {
+      result = EvaluationResult(std::move(step.errors.front()));
+      break;
+    }
+  }
+
+  if (result.ok && !scratch.getStack().empty()) {
+    result.value = scratch.top();
+  }
+  // Empty the stack for the next evaluation, keeping its storage
+  while (!scratch.getStack().empty()) {
+    scratch.pop();
+  }
+  raceDetector = detector;
+  return result;
+}
+
+InterpreterResult NsbaciInterpreter::execute(
+    Thread& t, Program& program, const nsbaci::compiler::Instruction& instr) {
+  using namespace nsbaci::compiler;
+  InterpreterResult result;
+  const uint32_t pc = t.getPC();
   bool advancePC = true;  // Most instructions advance PC
 
   // Decode and execute
@@ -44,33 +104,41 @@ InterpreterResult NsbaciInterpreter::executeInstruction(Thread& t,
     case Opcode::Store: {
       // Address is in operand1, value is on stack
       uint32_t addr = std::get<uint32_t>(instr.operand1);
+      if (addr >= program.dataSize()) {
+        return outOfBounds(addr);
+      }
       int32_t value = t.pop();
-      if (addr >= program.memory().size()) {
-        program.memory().resize(addr + 1, 0);
+      if (raceDetector) {
+        raceDetector->write(t.getId(), addr, pc);
       }
-      program.memory()[addr] = value;
+      program.store(addr, value);
       break;
     }
 
     case Opcode::StoreKeep: {
       // Like Store but keeps the value on the stack
       uint32_t addr = std::get<uint32_t>(instr.operand1);
+      if (addr >= program.dataSize()) {
+        return outOfBounds(addr);
+      }
       int32_t value = t.top();
-      if (addr >= program.memory().size()) {
-        program.memory().resize(addr + 1, 0);
+      if (raceDetector) {
+        raceDetector->write(t.getId(), addr, pc);
       }
-      program.memory()[addr] = value;
+      program.store(addr, value);
       break;
     }
 
     case Opcode::LoadValue: {
       // Address is in operand1
       uint32_t addr = std::get<uint32_t>(instr.operand1);
-      if (addr >= program.memory().size()) {
-        t.push(0);  // Uninitialized memory reads as 0
-      } else {
-        t.push(program.memory()[addr]);
+      if (addr >= program.dataSize()) {
+        return outOfBounds(addr);
+      }
+      if (raceDetector) {
+        raceDetector->read(t.getId(), addr, pc);
       }
+      t.push(program.memory()[addr]);
       break;
     }
 
@@ -86,11 +154,38 @@ InterpreterResult NsbaciInterpreter::executeInstruction(Thread& t,
       if (addr >= program.memory().size()) {
         t.push(0);
       } else {
+        if (raceDetector) {
+          raceDetector->read(t.getId(), addr, pc);
+        }
         t.push(program.memory()[addr]);
       }
       break;
     }
 
+    case Opcode::CopyBlock: {
+      // Stack: [dst, src], block size in operand1
+      uint32_t count = std::get<uint32_t>(instr.operand1);
+      uint32_t src = static_cast<uint32_t>(t.pop());
+      uint32_t dst = static_cast<uint32_t>(t.pop());
+      if (!program.containsBlock(src, count) ||
+          !program.containsBlock(dst, count)) {
+        nsbaci::Error err;
+        err.basic.severity = nsbaci::types::ErrSeverity::Error;
+        err.basic.message = "Block copy out of bounds";
+        err.basic.type = nsbaci::types::ErrType::unknown;
+        err.payload = nsbaci::types::RuntimeError{};
+        return InterpreterResult(std::move(err));
+      }
+      if (raceDetector) {
+        for (uint32_t i = 0; i < count; ++i) {
+          raceDetector->read(t.getId(), src + i, pc);
+          raceDetector->write(t.getId(), dst + i, pc);
+        }
+      }
+      program.copyBlock(dst, src, count);
+      break;
+    }
+
     // ============== Arithmetic Operations ==============
     case Opcode::Add: {
       int32_t b = t.pop();
@@ -233,14 +328,104 @@ InterpreterResult NsbaciInterpreter::executeInstruction(Thread& t,
 
     // ============== Concurrency - Semaphores ==============
     case Opcode::Wait: {
-      // TODO: Implement semaphore wait
-      // Get semaphore address, decrement, block if < 0
+      // Semaphore address is on the stack. It stays there while the thread
+      // is blocked, so the retried Wait finds it again
+      uint32_t addr = static_cast<uint32_t>(t.top());
+      if (addr >= program.dataSize()) {
+        nsbaci::Error err;
+        err.basic.severity = nsbaci::types::ErrSeverity::Error;
+        err.basic.message = "Semaphore address out of bounds";
+        err.basic.type = nsbaci::types::ErrType::unknown;
+        err.payload = nsbaci::types::RuntimeError{};
+        return InterpreterResult(std::move(err));
+      }
+      int32_t value = program.memory()[addr];
+      if (value > 0) {
+        t.pop();
+        program.store(addr, value - 1);
+        if (raceDetector) {
+          raceDetector->acquire(t.getId(), addr);
+        }
+        result.acquired =
+            nsbaci::types::WaitResource{nsbaci::types::ResourceKind::Semaphore,
+                                        addr};
+      } else {
+        result.blockedOn =
+            nsbaci::types::WaitResource{nsbaci::types::ResourceKind::Semaphore,
+                                        addr};
+        advancePC = false;
+      }
       break;
     }
 
     case Opcode::Signal: {
-      // TODO: Implement semaphore signal
-      // Get semaphore address, increment, wake waiting thread if any
+      uint32_t addr = static_cast<uint32_t>(t.pop());
+      if (addr >= program.dataSize()) {
+        nsbaci::Error err;
+        err.basic.severity = nsbaci::types::ErrSeverity::Error;
+        err.basic.message = "Semaphore address out of bounds";
+        err.basic.type = nsbaci::types::ErrType::unknown;
+        err.payload = nsbaci::types::RuntimeError{};
+        return InterpreterResult(std::move(err));
+      }
+      if (raceDetector) {
+        raceDetector->release(t.getId(), addr);
+      }
+      program.store(addr, program.memory()[addr] + 1);
+      result.released =
+          nsbaci::types::WaitResource{nsbaci::types::ResourceKind::Semaphore,
+                                      addr};
+      break;
+    }
+
+    // ============== Concurrency - Monitors ==============
+    case Opcode::EnterMonitor: {
+      // The monitor's lock word (operand1) holds 0 when free, otherwise the
+      // owner's thread ID + 1. Monitors are not reentrant
+      uint32_t addr = std::get<uint32_t>(instr.operand1);
+      if (addr >= program.dataSize()) {
+        return outOfBounds(addr);
+      }
+      int32_t owner = program.memory()[addr];
+      if (owner == 0) {
+        program.store(addr, static_cast<int32_t>(t.getId() + 1));
+        if (raceDetector) {
+          raceDetector->acquire(t.getId(), addr);
+        }
+        result.acquired =
+            nsbaci::types::WaitResource{nsbaci::types::ResourceKind::Monitor,
+                                        addr};
+      } else {
+        result.blockedOn =
+            nsbaci::types::WaitResource{nsbaci::types::ResourceKind::Monitor,
+                                        addr};
+        result.holder = static_cast<nsbaci::types::ThreadID>(owner - 1);
+        advancePC = false;
+      }
+      break;
+    }
+
+    case Opcode::ExitMonitor: {
+      uint32_t addr = std::get<uint32_t>(instr.operand1);
+      if (addr >= program.dataSize()) {
+        return outOfBounds(addr);
+      }
+      if (program.memory()[addr] != static_cast<int32_t>(t.getId() + 1)) {
+        nsbaci::Error err;
+        err.basic.severity = nsbaci::types::ErrSeverity::Error;
+        err.basic.message = "Thread " + std::to_string(t.getId()) +
+                            " left a monitor it is not inside";
+        err.basic.type = nsbaci::types::ErrType::unknown;
+        err.payload = nsbaci::types::RuntimeError{};
+        return InterpreterResult(std::move(err));
+      }
+      if (raceDetector) {
+        raceDetector->release(t.getId(), addr);
+      }
+      program.store(addr, 0);
+      result.released =
+          nsbaci::types::WaitResource{nsbaci::types::ResourceKind::Monitor,
+                                      addr};
       break;
     }
 
@@ -309,6 +494,17 @@ InterpreterResult NsbaciInterpreter::executeInstruction(Thread& t,
       break;
     }
 
+    // ============== Breakpoints ==============
+    case Opcode::Trap: {
+      // Stop before the replaced instruction, unless told to go past it
+      if (!trapPassed) {
+        result.trapped = true;
+        return result;
+      }
+      trapPassed = false;
+      return execute(t, program, program.originalInstruction(pc));
+    }
+
     // ============== Default ==============
     default: {
       nsbaci::Error err;
@@ -335,6 +531,23 @@ void NsbaciInterpreter::provideInput(const std::string& input) {
 
 bool NsbaciInterpreter::isWaitingForInput() const { return waitingForInput; }
 
+void NsbaciInterpreter::reset() {
+  waitingForInput = false;
+  trapPassed = false;
+  pendingInput.clear();
+  hasInput = false;
+}
+
+InputState NsbaciInterpreter::saveInput() const {
+  return {waitingForInput, hasInput, pendingInput};
+}
+
+void NsbaciInterpreter::restoreInput(const InputState& s) {
+  waitingForInput = s.waiting;
+  hasInput = s.available;
+  pendingInput = s.value;
+}
+
 void NsbaciInterpreter::setOutputCallback(OutputCallback callback) {
   outputCallback = std::move(callback);
 }
@@ -42,15 +42,32 @@ class NsbaciInterpreter final : public Interpreter {
    */
   InterpreterResult executeInstruction(Thread& t, Program& program) override;
 
+  EvaluationResult evaluate(const nsbaci::compiler::InstructionStream& code,
+                            Program& program) override;
+
   void provideInput(const std::string& input) override;
   bool isWaitingForInput() const override;
+  void reset() override;
+  InputState saveInput() const override;
+  void restoreInput(const InputState& s) override;
   void setOutputCallback(OutputCallback callback) override;
 
  private:
+  /**
+   * @brief Executes an already fetched instruction of the given thread.
+   * @param t The thread at the instruction.
+   * @param program The program context.
+   * @param instr The instruction at the thread's pc.
+   * @return InterpreterResult indicating success or any errors encountered.
+   */
+  InterpreterResult execute(Thread& t, Program& program,
+                            const nsbaci::compiler::Instruction& instr);
+
   OutputCallback outputCallback;
   bool waitingForInput = false;
   std::string pendingInput;
   bool hasInput = false;
+  Thread scratch;  ///< Runs evaluate(); kept for its stack storage
 };
 
 }  // namespace nsbaci::services::runtime
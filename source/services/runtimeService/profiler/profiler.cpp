@@ -0,0 +1,144 @@
+/**
+ * @file profiler.cpp
+ * @brief Profiler class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "profiler.h"
+
+#include <cstdio>
+
+namespace nsbaci::services::runtime {
+
+void Profiler::reset(size_t instructionCount) {
+  size = instructionCount;
+  byThread.clear();
+  executed = 0;
+}
+
+std::vector<uint64_t> Profiler::pcCounts() const {
+  std::vector<uint64_t> counts(size, 0);
+  for (const auto& thread : byThread) {
+    for (size_t pc = 0; pc < thread.size(); ++pc) {
+      counts[pc] += thread[pc];
+    }
+  }
+  return counts;
+}
+
+std::vector<uint64_t> Profiler::lineCounts(
+    const nsbaci::compiler::LineTable& lines) const {
+  std::vector<uint64_t> counts;
+  if (lines.empty()) {
+    return counts;
+  }
+  auto byPc = pcCounts();
+
+  // Walk the runs instead of looking each address up
+  const auto& runs = lines.runs();
+  for (size_t r = 0; r < runs.size(); ++r) {
+    uint32_t end = r + 1 < runs.size() ? runs[r + 1].pc
+                                       : lines.instructionCount();
+    uint64_t sum = 0;
+    for (uint32_t pc = runs[r].pc; pc < end && pc < byPc.size(); ++pc) {
+      sum += byPc[pc];
+    }
+    if (runs[r].line >= counts.size()) {
+      counts.resize(runs[r].line + 1, 0);
+    }
+    counts[runs[r].line] += sum;
+  }
+  return counts;
+}
+
+std::vector<uint64_t> Profiler::threadTotals() const {
+  std::vector<uint64_t> totals(byThread.size(), 0);
+  for (size_t t = 0; t < byThread.size(); ++t) {
+    for (uint64_t count : byThread[t]) {
+      totals[t] += count;
+    }
+  }
+  return totals;
+}
+
+std::string Profiler::csv(const CodeImage& image) const {
+  const auto& lines = image.lines();
+  bool byLine = !lines.empty();
+
+  // Threads that ran, in ID order
+  std::vector<size_t> threads;
+  for (size_t t = 0; t < byThread.size(); ++t) {
+    if (!byThread[t].empty()) {
+      threads.push_back(t);
+    }
+  }
+
+  std::string out = byLine ? "line" : "pc";
+  out += ",instructions,share";
+  for (size_t t : threads) {
+    out += ",thread " + std::to_string(t);
+  }
+  out += '\n';
+
+  // One column per thread: its counts folded onto lines, or as they are
+  std::vector<std::vector<uint64_t>> columns;
+  for (size_t t : threads) {
+    if (!byLine) {
+      columns.push_back(byThread[t]);
+      continue;
+    }
+    std::vector<uint64_t> column;
+    for (size_t pc = 0; pc < byThread[t].size(); ++pc) {
+      uint32_t line = lines.lineAt(static_cast<uint32_t>(pc));
+      if (line >= column.size()) {
+        column.resize(line + 1, 0);
+      }
+      column[line] += byThread[t][pc];
+    }
+    columns.push_back(std::move(column));
+  }
+
+  auto totals = byLine ? lineCounts(lines) : pcCounts();
+  char share[32];
+  for (size_t row = 0; row < totals.size(); ++row) {
+    if (totals[row] == 0) {
+      continue;
+    }
+    std::snprintf(share, sizeof(share), "%.4f",
+                  double(totals[row]) / double(executed));
+    out += std::to_string(row) + ',' + std::to_string(totals[row]) + ',' +
+           share;
+    for (const auto& column : columns) {
+      out += ',' + std::to_string(row < column.size() ? column[row] : 0);
+    }
+    out += '\n';
+  }
+  return out;
+}
+
+std::string Profiler::folded(const CodeImage& image) const {
+  const auto& lines = image.lines();
+  std::string out;
+  for (size_t t = 0; t < byThread.size(); ++t) {
+    const auto& counts = byThread[t];
+    for (size_t pc = 0; pc < counts.size(); ++pc) {
+      if (counts[pc] == 0) {
+        continue;
+      }
+      auto at = static_cast<uint32_t>(pc);
+      out += "thread " + std::to_string(t) + ';';
+      if (uint32_t line = lines.lineAt(at)) {
+        out += "line " + std::to_string(line) + ';';
+      }
+      out += std::to_string(pc) + ' ' +
+             nsbaci::compiler::opcodeName(image.original(at).opcode) + ' ' +
+             std::to_string(counts[pc]) + '\n';
+    }
+  }
+  return out;
+}
+
+}  // namespace nsbaci::services::runtime
@@ -0,0 +1,126 @@
+/**
+ * @file profiler.h
+ * @brief Profiler class declaration for nsbaci runtime service.
+ *
+ * This module defines an execution profiler that counts how many times each
+ * thread executes each instruction, and turns the counts into per-line and
+ * per-thread totals and into reports for spreadsheets and flame graphs.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_PROFILER_H
+#define NSBACI_SERVICES_RUNTIME_PROFILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "codeImage.h"
+#include "runtimeTypes.h"
+
+/**
+ * @namespace nsbaci::services::runtime
+ * @brief Runtime services namespace for nsbaci.
+ */
+namespace nsbaci::services::runtime {
+
+/**
+ * @class Profiler
+ * @brief Execution counts by thread and instruction address.
+ *
+ * Each thread gets a flat array with one counter per instruction, allocated
+ * the first time it runs, so recording a step is an index and an increment.
+ * Everything else (per-address totals, per-line totals, reports) is derived
+ * from these arrays on demand.
+ */
+class Profiler {
+ public:
+  Profiler() = default;
+  ~Profiler() = default;
+
+  /**
+   * @brief Drops every count and sizes the counters for a program.
+   * @param instructionCount Number of instructions in the program.
+   */
+  void reset(size_t instructionCount);
+
+  /**
+   * @brief Counts one execution of an instruction.
+   * @param thread Thread that executed it.
+   * @param pc Address of the instruction; below the reset size.
+   */
+  void record(nsbaci::types::ThreadID thread, uint32_t pc) {
+    if (thread >= byThread.size()) {
+      byThread.resize(thread + 1);
+    }
+    auto& counts = byThread[thread];
+    if (counts.empty()) {
+      counts.assign(size, 0);
+    }
+    ++counts[pc];
+    ++executed;
+  }
+
+  /**
+   * @brief Gets the number of instructions counted.
+   * @return Executions over every thread and address.
+   */
+  uint64_t total() const { return executed; }
+
+  /**
+   * @brief Gets the executions of each instruction by every thread.
+   * @return Counts indexed by address.
+   */
+  std::vector<uint64_t> pcCounts() const;
+
+  /**
+   * @brief Gets the executions of each source line by every thread.
+   * @param lines Line table of the program profiled.
+   * @return Counts indexed by line (index 0 holds code with no line); empty
+   * if the table is.
+   */
+  std::vector<uint64_t> lineCounts(
+      const nsbaci::compiler::LineTable& lines) const;
+
+  /**
+   * @brief Gets the instructions each thread executed.
+   * @return Totals indexed by thread ID.
+   */
+  std::vector<uint64_t> threadTotals() const;
+
+  /**
+   * @brief Writes the counts as CSV.
+   *
+   * One row per source line that ran, with its total, its share of the run
+   * and a column per thread. Programs without a line table get one row per
+   * instruction instead.
+   *
+   * @param image The program profiled.
+   * @return The report.
+   */
+  std::string csv(const CodeImage& image) const;
+
+  /**
+   * @brief Writes the counts as folded stacks.
+   *
+   * One line per thread and instruction executed, "thread;line;instruction
+   * count", as read by flame graph tools.
+   *
+   * @param image The program profiled.
+   * @return The report.
+   */
+  std::string folded(const CodeImage& image) const;
+
+ private:
+  size_t size = 0;                              ///< Instructions per thread.
+  std::vector<std::vector<uint64_t>> byThread;  ///< Counts by thread, pc.
+  uint64_t executed = 0;                        ///< Sum of every count.
+};
+
+}  // namespace nsbaci::services::runtime
+
+#endif  // NSBACI_SERVICES_RUNTIME_PROFILER_H
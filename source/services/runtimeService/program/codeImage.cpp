@@ -0,0 +1,284 @@
+/**
+ * @file codeImage.cpp
+ * @brief CodeImage class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "codeImage.h"
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+
+#include "zobrist.h"
+
+namespace nsbaci::services::runtime {
+
+namespace {
+
+// Instructions that touch nothing but the stack, the pc and global reads
+bool isSpinSafe(nsbaci::compiler::Opcode op) {
+  using nsbaci::compiler::Opcode;
+  switch (op) {
+    case Opcode::LoadValue:
+    case Opcode::LoadAddress:
+    case Opcode::PushLiteral:
+    case Opcode::Add:
+    case Opcode::Sub:
+    case Opcode::Mult:
+    case Opcode::Div:
+    case Opcode::Mod:
+    case Opcode::Negate:
+    case Opcode::Complement:
+    case Opcode::And:
+    case Opcode::Or:
+    case Opcode::TestEQ:
+    case Opcode::TestNE:
+    case Opcode::TestLT:
+    case Opcode::TestLE:
+    case Opcode::TestGT:
+    case Opcode::TestGE:
+    case Opcode::TestEqualKeep:
+    case Opcode::Jump:
+    case Opcode::JumpZero:
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::optional<int32_t> jumpTarget(const nsbaci::compiler::Instruction& instr) {
+  using nsbaci::compiler::Opcode;
+  if ((instr.opcode == Opcode::Jump || instr.opcode == Opcode::JumpZero) &&
+      std::holds_alternative<int32_t>(instr.operand1)) {
+    return std::get<int32_t>(instr.operand1);
+  }
+  return std::nullopt;
+}
+
+// Instructions whose successors are not known from the code alone
+bool hasUnknownSuccessors(nsbaci::compiler::Opcode op) {
+  using nsbaci::compiler::Opcode;
+  switch (op) {
+    case Opcode::Call:
+    case Opcode::ShortCall:
+    case Opcode::ShortReturn:
+    case Opcode::ExitProc:
+    case Opcode::ExitFunction:
+    case Opcode::Create:
+    case Opcode::Revive:
+    case Opcode::Trap:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+CodeImage::CodeImage(nsbaci::compiler::InstructionStream i,
+                     nsbaci::types::SymbolTable s,
+                     nsbaci::compiler::LineTable l)
+    : code(std::move(i)), symbolTable(std::move(s)), lineTable(std::move(l)) {
+  using nsbaci::compiler::Opcode;
+
+  // Extent of the symbol table: one past the last declared word
+  size_t size = 0;
+  for (const auto& [name, info] : symbolTable) {
+    size = std::max<size_t>(size, size_t(info.address) + info.size);
+  }
+
+  initialImage.assign(size, 0);
+  for (size_t addr = 0; addr < size; ++addr) {
+    initialHash ^= zobrist::memoryKey(addr, 0);
+  }
+
+  // Spin loops: a backward jump whose body is spin-safe and never jumps to
+  // before its start (jumping past its end just leaves the loop)
+  for (uint32_t pc = 0; pc < code.size(); ++pc) {
+    auto target = jumpTarget(code[pc]);
+    if (!target || *target < 0 || uint32_t(*target) > pc) {
+      continue;
+    }
+    SpinLoop loop;
+    loop.start = uint32_t(*target);
+    bool safe = true;
+    for (uint32_t at = loop.start; at <= pc && safe; ++at) {
+      const auto& instr = code[at];
+      auto inner = jumpTarget(instr);
+      safe = isSpinSafe(instr.opcode) &&
+             (!inner || (*inner >= 0 && uint32_t(*inner) >= loop.start)) &&
+             (instr.opcode != Opcode::LoadValue ||
+              (std::holds_alternative<uint32_t>(instr.operand1) &&
+               std::get<uint32_t>(instr.operand1) < size));
+      if (safe && instr.opcode == Opcode::LoadValue) {
+        loop.reads.push_back(std::get<uint32_t>(instr.operand1));
+      }
+    }
+    // A loop reading nothing can never be woken; leave it to the livelock
+    // check
+    if (!safe || loop.reads.empty()) {
+      continue;
+    }
+    std::sort(loop.reads.begin(), loop.reads.end());
+    loop.reads.erase(std::unique(loop.reads.begin(), loop.reads.end()),
+                     loop.reads.end());
+    spinLoops.emplace(pc, std::move(loop));
+  }
+
+  findSignals();
+}
+
+void CodeImage::findSignals() {
+  using nsbaci::compiler::Opcode;
+  const size_t n = code.size();
+
+  // The address a Signal pops is known when the instruction before pushes
+  // a constant, unless a jump can reach the Signal with another stack
+  std::vector<bool> jumpedTo(n, false);
+  for (const auto& instr : code) {
+    auto target = jumpTarget(instr);
+    if (target && *target >= 0 && size_t(*target) < n) {
+      jumpedTo[*target] = true;
+    }
+  }
+  std::vector<std::optional<uint32_t>> named(n);
+  for (size_t pc = 1; pc < n; ++pc) {
+    const auto& prev = code[pc - 1];
+    if (code[pc].opcode != Opcode::Signal || jumpedTo[pc]) {
+      continue;
+    }
+    if (prev.opcode == Opcode::LoadAddress &&
+        std::holds_alternative<uint32_t>(prev.operand1)) {
+      named[pc] = std::get<uint32_t>(prev.operand1);
+    } else if (prev.opcode == Opcode::PushLiteral &&
+               std::holds_alternative<int32_t>(prev.operand1) &&
+               std::get<int32_t>(prev.operand1) >= 0) {
+      named[pc] = uint32_t(std::get<int32_t>(prev.operand1));
+    }
+    if (named[pc]) {
+      signalled.push_back(*named[pc]);
+    }
+  }
+  std::sort(signalled.begin(), signalled.end());
+  signalled.erase(std::unique(signalled.begin(), signalled.end()),
+                  signalled.end());
+
+  signalWords = (signalled.size() + 1 + 63) / 64;
+  signalReach.assign(n * signalWords, 0);
+  auto set = [this](size_t pc, size_t bit) {
+    signalReach[pc * signalWords + bit / 64] |= uint64_t(1) << (bit % 64);
+  };
+  for (size_t pc = 0; pc < n; ++pc) {
+    if (code[pc].opcode == Opcode::Signal) {
+      if (named[pc]) {
+        auto at = std::lower_bound(signalled.begin(), signalled.end(),
+                                   *named[pc]);
+        set(pc, size_t(at - signalled.begin()) + 1);
+      } else {
+        set(pc, 0);
+      }
+    } else if (hasUnknownSuccessors(code[pc].opcode)) {
+      set(pc, 0);
+    }
+  }
+
+  // Each instruction can reach what its successors reach; backward passes
+  // until nothing changes, one more per loop nesting level
+  auto merge = [this](size_t pc, size_t from, bool& changed) {
+    for (size_t w = 0; w < signalWords; ++w) {
+      uint64_t& to = signalReach[pc * signalWords + w];
+      uint64_t bits = to | signalReach[from * signalWords + w];
+      changed = changed || bits != to;
+      to = bits;
+    }
+  };
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (size_t pc = n; pc-- > 0;) {
+      Opcode op = code[pc].opcode;
+      auto target = jumpTarget(code[pc]);
+      if (target && *target >= 0 && size_t(*target) < n) {
+        merge(pc, size_t(*target), changed);
+      }
+      if (op != Opcode::Halt && op != Opcode::Jump && pc + 1 < n) {
+        merge(pc, pc + 1, changed);
+      }
+    }
+  }
+}
+
+const nsbaci::compiler::Instruction& CodeImage::getInstruction(
+    uint32_t addr) const {
+  if (addr >= code.size()) {
+    throw std::out_of_range("Instruction address out of bounds");
+  }
+  return code[addr];
+}
+
+size_t CodeImage::instructionCount() const { return code.size(); }
+
+const nsbaci::compiler::InstructionStream& CodeImage::instructions() const {
+  return code;
+}
+
+const nsbaci::types::SymbolTable& CodeImage::symbols() const {
+  return symbolTable;
+}
+
+const nsbaci::compiler::LineTable& CodeImage::lines() const {
+  return lineTable;
+}
+
+size_t CodeImage::dataSize() const { return initialImage.size(); }
+
+const nsbaci::types::Memory& CodeImage::initialMemory() const {
+  return initialImage;
+}
+
+uint64_t CodeImage::initialFingerprint() const { return initialHash; }
+
+const SpinLoop* CodeImage::spinLoop(uint32_t jumpPc) const {
+  auto it = spinLoops.find(jumpPc);
+  return it == spinLoops.end() ? nullptr : &it->second;
+}
+
+bool CodeImage::maySignal(uint32_t pc, uint32_t semaphore) const {
+  if (pc >= code.size()) {
+    return false;
+  }
+  const uint64_t* row = &signalReach[pc * signalWords];
+  if (row[0] & 1) {
+    return true;
+  }
+  auto at = std::lower_bound(signalled.begin(), signalled.end(), semaphore);
+  if (at == signalled.end() || *at != semaphore) {
+    return false;
+  }
+  size_t bit = size_t(at - signalled.begin()) + 1;
+  return (row[bit / 64] >> (bit % 64)) & 1;
+}
+
+std::shared_ptr<const CodeImage> CodeImage::withTraps(
+    const std::vector<uint32_t>& pcs) const {
+  auto patched = std::make_shared<CodeImage>(*this);
+  for (uint32_t pc : pcs) {
+    if (pc >= code.size() || patched->trapped.count(pc)) {
+      continue;
+    }
+    patched->trapped.emplace(pc, original(pc));
+    patched->code[pc] =
+        nsbaci::compiler::Instruction(nsbaci::compiler::Opcode::Trap);
+  }
+  return patched;
+}
+
+const nsbaci::compiler::Instruction& CodeImage::original(uint32_t addr) const {
+  auto it = trapped.find(addr);
+  return it == trapped.end() ? getInstruction(addr) : it->second;
+}
+
+}  // namespace nsbaci::services::runtime
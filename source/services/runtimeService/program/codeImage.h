@@ -0,0 +1,211 @@
+/**
+ * @file codeImage.h
+ * @brief CodeImage class declaration for nsbaci runtime service.
+ *
+ * This module defines the CodeImage class, the immutable part of a compiled
+ * program: instructions, symbol table and data segment layout. A CodeImage is
+ * shared through std::shared_ptr between every execution of the same program.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_CODEIMAGE_H
+#define NSBACI_SERVICES_RUNTIME_CODEIMAGE_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "compilerTypes.h"
+#include "instruction.h"
+#include "lineTable.h"
+
+/**
+ * @namespace nsbaci::types
+ * @brief Type definitions namespace for nsbaci (runtime-specific).
+ */
+namespace nsbaci::types {
+
+/// @brief Stack value type (can hold int or address)
+using StackValue = int32_t;
+
+/// @brief Runtime stack
+using Stack = std::vector<StackValue>;
+
+/// @brief Memory block for runtime data
+using Memory = std::vector<int32_t>;
+
+}  // namespace nsbaci::types
+
+/**
+ * @namespace nsbaci::services::runtime
+ * @brief Runtime services namespace for nsbaci.
+ */
+namespace nsbaci::services::runtime {
+
+/**
+ * @struct SpinLoop
+ * @brief Loop whose body only reads global memory and works on the stack.
+ *
+ * Once one iteration leaves the thread's stack and the words it read as
+ * they were, every further iteration does the same until one of those words
+ * changes: the thread is busy-waiting.
+ */
+struct SpinLoop {
+  uint32_t start = 0;           ///< First instruction of the body.
+  std::vector<uint32_t> reads;  ///< Global words the body reads, sorted.
+};
+
+/**
+ * @class CodeImage
+ * @brief Immutable, shareable image of a compiled program.
+ *
+ * Holds everything about a program that does not change while it runs: the
+ * instruction stream, the symbol table, the source line table and the
+ * initial data segment. The data segment spans the extent of the symbol
+ * table (every declared word); direct operands outside it are a runtime
+ * error, reported by the interpreter when the instruction runs.
+ *
+ * String literals stay inline in their instructions; there is no separate
+ * constant pool.
+ */
+class CodeImage {
+ public:
+  CodeImage() = default;
+  explicit CodeImage(nsbaci::compiler::InstructionStream i,
+                     nsbaci::types::SymbolTable s = {},
+                     nsbaci::compiler::LineTable l = {});
+  ~CodeImage() = default;
+
+  CodeImage(const CodeImage&) = default;
+  CodeImage& operator=(const CodeImage&) = default;
+
+  CodeImage(CodeImage&&) = default;
+  CodeImage& operator=(CodeImage&&) = default;
+
+  /**
+   * @brief Gets instruction at the given address.
+   * @param addr The instruction address.
+   * @return Reference to the instruction.
+   * @throws std::out_of_range if addr is past the end of the program.
+   */
+  const nsbaci::compiler::Instruction& getInstruction(uint32_t addr) const;
+
+  /**
+   * @brief Gets the total number of instructions.
+   * @return Number of instructions in the program.
+   */
+  size_t instructionCount() const;
+
+  /**
+   * @brief Access to the whole instruction stream.
+   * @return Const reference to the instructions.
+   */
+  const nsbaci::compiler::InstructionStream& instructions() const;
+
+  /**
+   * @brief Access to symbol table.
+   * @return Const reference to symbol table.
+   */
+  const nsbaci::types::SymbolTable& symbols() const;
+
+  /**
+   * @brief Access to the source line table.
+   * @return Const reference to the line table; empty if the program was not
+   * compiled from source.
+   */
+  const nsbaci::compiler::LineTable& lines() const;
+
+  /**
+   * @brief Gets the size of the data segment.
+   * @return Number of addressable memory words.
+   */
+  size_t dataSize() const;
+
+  /**
+   * @brief Memory contents every execution starts from.
+   * @return Const reference to the initial data segment.
+   */
+  const nsbaci::types::Memory& initialMemory() const;
+
+  /**
+   * @brief Zobrist fingerprint of the initial memory.
+   * @return Fingerprint a Program starts from after a reset.
+   */
+  uint64_t initialFingerprint() const;
+
+  /**
+   * @brief Gets the spin loop closed by a backward jump.
+   * @param jumpPc Address of the jump back to the start of the loop.
+   * @return The loop, or nullptr if its body may do more than read memory.
+   */
+  const SpinLoop* spinLoop(uint32_t jumpPc) const;
+
+  /**
+   * @brief Checks whether a thread could still signal a semaphore.
+   *
+   * Conservative: true if a Signal of the semaphore is reachable from the
+   * address, and also if a Signal whose address is only known when it
+   * runs, or an instruction whose successors are not known, is reachable.
+   *
+   * @param pc Where the thread stands.
+   * @param semaphore Address of the semaphore.
+   * @return False only if the thread can never signal it.
+   */
+  bool maySignal(uint32_t pc, uint32_t semaphore) const;
+
+  /**
+   * @brief Copies the image with a Trap instruction at each given address.
+   *
+   * The replaced instructions are kept in a side table of the copy, see
+   * original(). Everything else, spin loops included, is the same as in
+   * this image, which is left untouched.
+   *
+   * @param pcs Addresses to patch; those past the end are ignored.
+   * @return The patched copy.
+   */
+  std::shared_ptr<const CodeImage> withTraps(
+      const std::vector<uint32_t>& pcs) const;
+
+  /**
+   * @brief Gets the instruction a Trap replaced.
+   * @param addr The instruction address.
+   * @return The original instruction, or getInstruction(addr) if the
+   * address was not patched.
+   */
+  const nsbaci::compiler::Instruction& original(uint32_t addr) const;
+
+ private:
+  /**
+   * @brief Computes which semaphores each instruction can reach a Signal of.
+   */
+  void findSignals();
+
+  // Instruction stream
+  nsbaci::compiler::InstructionStream code;
+  // Global symbol table
+  nsbaci::types::SymbolTable symbolTable;
+  // Source line of each instruction
+  nsbaci::compiler::LineTable lineTable;
+  // Data segment at load time
+  nsbaci::types::Memory initialImage;
+  // Fingerprint of initialImage, computed once
+  uint64_t initialHash = 0;
+  // Read-only loops, by address of their backward jump
+  std::unordered_map<uint32_t, SpinLoop> spinLoops;
+  // Semaphores signalled through an address known before the Signal runs,
+  // sorted
+  std::vector<uint32_t> signalled;
+  // signalWords words per instruction: bit 0 if anything may be signalled
+  // from it, bit i + 1 if signalled[i] may be
+  std::vector<uint64_t> signalReach;
+  size_t signalWords = 0;
+  // Instructions replaced by a Trap, by address
+  std::unordered_map<uint32_t, nsbaci::compiler::Instruction> trapped;
+};
+
+}  // namespace nsbaci::services::runtime
+
+#endif  // NSBACI_SERVICES_RUNTIME_CODEIMAGE_H
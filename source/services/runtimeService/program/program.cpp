@@ -9,37 +9,76 @@
 
 #include "program.h"
 
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 
 namespace nsbaci::services::runtime {
 
+namespace {
+
+// Shared by every default-constructed Program
+const std::shared_ptr<const CodeImage>& emptyImage() {
+  static const auto empty = std::make_shared<const CodeImage>();
+  return empty;
+}
+
+}  // namespace
+
+Program::Program() : image(emptyImage()), executed(image) {}
+
 Program::Program(nsbaci::compiler::InstructionStream i)
-    : instructions(std::move(i)) {}
+    : Program(std::make_shared<const CodeImage>(std::move(i))) {}
 
 Program::Program(nsbaci::compiler::InstructionStream i,
                  nsbaci::types::SymbolTable s)
-    : instructions(std::move(i)), symbolTable(std::move(s)) {}
+    : Program(std::make_shared<const CodeImage>(std::move(i), std::move(s))) {}
+
+Program::Program(std::shared_ptr<const CodeImage> img)
+    : image(img ? std::move(img) : emptyImage()),
+      executed(image),
+      globalMemory(image->initialMemory()),
+      memoryHash(image->initialFingerprint()) {}
 
 const nsbaci::compiler::Instruction& Program::getInstruction(
     uint32_t addr) const {
-  if (addr >= instructions.size()) {
-    throw std::out_of_range("Instruction address out of bounds");
-  }
-  return instructions[addr];
+  return executed->getInstruction(addr);
 }
 
-size_t Program::instructionCount() const { return instructions.size(); }
+const nsbaci::compiler::Instruction& Program::originalInstruction(
+    uint32_t addr) const {
+  return executed->original(addr);
+}
 
-nsbaci::types::Memory& Program::memory() { return globalMemory; }
+size_t Program::instructionCount() const {
+  return executed->instructionCount();
+}
+
+const std::shared_ptr<const CodeImage>& Program::codeImage() const {
+  return image;
+}
+
+void Program::setTraps(const std::vector<uint32_t>& pcs) {
+  executed = pcs.empty() ? image : image->withTraps(pcs);
+}
 
 const nsbaci::types::Memory& Program::memory() const { return globalMemory; }
 
 const nsbaci::types::SymbolTable& Program::symbols() const {
-  return symbolTable;
+  return image->symbols();
 }
 
 void Program::addSymbol(nsbaci::types::SymbolInfo info) {
-  symbolTable[info.name] = std::move(info);
+  // Copy on write: other Programs sharing the image keep the old one
+  nsbaci::types::SymbolTable symbols = image->symbols();
+  symbols[info.name] = std::move(info);
+  image = std::make_shared<const CodeImage>(
+      image->instructions(), std::move(symbols), image->lines());
+  executed = image;  // Traps are set after loading
+  for (size_t addr = globalMemory.size(); addr < image->dataSize(); ++addr) {
+    globalMemory.push_back(0);
+    memoryHash ^= zobrist::memoryKey(addr, 0);
+  }
 }
 
 int32_t Program::readMemory(nsbaci::types::MemoryAddr addr) const {
@@ -51,9 +90,84 @@ int32_t Program::readMemory(nsbaci::types::MemoryAddr addr) const {
 
 void Program::writeMemory(nsbaci::types::MemoryAddr addr, int32_t value) {
   if (addr >= globalMemory.size()) {
-    globalMemory.resize(addr + 1, 0);
+    throw std::out_of_range("Memory address out of bounds");
+  }
+  store(addr, value);
+}
+
+void Program::resetMemory() {
+  const nsbaci::types::Memory& initial = image->initialMemory();
+  if (!initial.empty()) {
+    std::memcpy(globalMemory.data(), initial.data(),
+                initial.size() * sizeof(int32_t));
+  }
+  memoryHash = image->initialFingerprint();
+}
+
+void Program::restoreMemory(const nsbaci::types::Memory& snapshot) {
+  if (snapshot.size() != globalMemory.size()) {
+    throw std::invalid_argument("Memory snapshot size mismatch");
+  }
+  if (!snapshot.empty()) {
+    std::memcpy(globalMemory.data(), snapshot.data(),
+                snapshot.size() * sizeof(int32_t));
+  }
+  memoryHash = 0;
+  for (size_t addr = 0; addr < globalMemory.size(); ++addr) {
+    memoryHash ^= zobrist::memoryKey(addr, globalMemory[addr]);
+  }
+}
+
+size_t Program::dataSize() const { return globalMemory.size(); }
+
+bool Program::containsBlock(nsbaci::types::MemoryAddr addr,
+                            size_t count) const {
+  return addr <= globalMemory.size() && count <= globalMemory.size() - addr;
+}
+
+void Program::copyBlock(nsbaci::types::MemoryAddr dst,
+                        nsbaci::types::MemoryAddr src, size_t count) {
+  if (!containsBlock(dst, count) || !containsBlock(src, count)) {
+    throw std::out_of_range("Memory block out of bounds");
+  }
+  if (count == 0 || dst == src) {
+    return;
+  }
+  // Hash out the old destination words, move, then hash in the new ones;
+  // two passes keep this correct when the blocks overlap
+  for (size_t i = 0; i < count; ++i) {
+    memoryHash ^= zobrist::memoryKey(dst + i, globalMemory[dst + i]);
+    if (barrier) {
+      noteWrite(static_cast<nsbaci::types::MemoryAddr>(dst + i),
+                globalMemory[dst + i]);
+    }
+  }
+  std::memmove(globalMemory.data() + dst, globalMemory.data() + src,
+               count * sizeof(int32_t));
+  for (size_t i = 0; i < count; ++i) {
+    memoryHash ^= zobrist::memoryKey(dst + i, globalMemory[dst + i]);
+  }
+}
+
+void Program::watch(nsbaci::types::MemoryAddr addr, size_t count) {
+  if (watchBits.empty()) {
+    watchBits.assign((globalMemory.size() + 63) / 64, 0);
+  }
+  size_t end = std::min<size_t>(globalMemory.size(), size_t(addr) + count);
+  for (size_t a = addr; a < end; ++a) {
+    watchBits[a / 64] |= uint64_t(1) << (a % 64);
+  }
+}
+
+void Program::clearWatches() { watchBits.clear(); }
+
+void Program::noteWrite(nsbaci::types::MemoryAddr addr, int32_t old) {
+  if (writeLog) {
+    writeLog->push_back({addr, old});
+  }
+  if (watchLog && isWatched(addr)) {
+    watchLog->push_back({addr, old});
   }
-  globalMemory[addr] = value;
 }
 
 }  // namespace nsbaci::services::runtime
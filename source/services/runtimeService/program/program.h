@@ -13,29 +13,15 @@
 #ifndef NSBACI_SERVICES_RUNTIME_PROGRAM_H
 #define NSBACI_SERVICES_RUNTIME_PROGRAM_H
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "codeImage.h"
 #include "compilerTypes.h"
 #include "instruction.h"
-
-/**
- * @namespace nsbaci::types
- * @brief Type definitions namespace for nsbaci (runtime-specific).
- */
-namespace nsbaci::types {
-
-/// @brief Stack value type (can hold int or address)
-using StackValue = int32_t;
-
-/// @brief Runtime stack
-using Stack = std::vector<StackValue>;
-
-/// @brief Memory block for runtime data
-using Memory = std::vector<int32_t>;
-
-}  // namespace nsbaci::types
+#include "zobrist.h"
 
 /**
  * @namespace nsbaci::services::runtime
@@ -43,33 +29,59 @@ using Memory = std::vector<int32_t>;
  */
 namespace nsbaci::services::runtime {
 
+/**
+ * @struct MemoryWrite
+ * @brief A global word and the value it held before a write.
+ */
+struct MemoryWrite {
+  nsbaci::types::MemoryAddr addr = 0;  ///< Word written.
+  int32_t old = 0;                     ///< Value it held before.
+};
+
 /**
  * @class Program
  * @brief Represents a compiled program ready for execution.
  *
- * The Program class contains the instruction vector, memory tables,
- * and other data structures needed for program execution.
+ * A Program pairs a shared, immutable CodeImage (instructions and symbols)
+ * with the global memory of one execution. Copying a Program shares the code
+ * and clones only the data segment, so several runs of the same compiled
+ * program cost one copy of the code plus O(memory size) each.
+ *
+ * Global memory is a fixed-size data segment allocated once at load time
+ * from the image's initial memory (see CodeImage for how it is sized).
  */
 class Program {
  public:
-  Program() = default;
+  Program();
   explicit Program(nsbaci::compiler::InstructionStream i);
   Program(nsbaci::compiler::InstructionStream i, nsbaci::types::SymbolTable s);
+  explicit Program(std::shared_ptr<const CodeImage> image);
   ~Program() = default;
 
-  Program(const Program&) = delete;
-  Program& operator=(const Program&) = delete;
+  Program(const Program&) = default;
+  Program& operator=(const Program&) = default;
 
   Program(Program&&) = default;
   Program& operator=(Program&&) = default;
 
   /**
-   * @brief Gets instruction at the given address.
+   * @brief Gets the instruction to execute at the given address.
+   *
+   * This is a Trap where setTraps() patched one in.
+   *
    * @param addr The instruction address.
    * @return Reference to the instruction.
    */
   const nsbaci::compiler::Instruction& getInstruction(uint32_t addr) const;
 
+  /**
+   * @brief Gets the compiled instruction at the given address.
+   * @param addr The instruction address.
+   * @return The instruction, as it was before any Trap replaced it.
+   */
+  const nsbaci::compiler::Instruction& originalInstruction(
+      uint32_t addr) const;
+
   /**
    * @brief Gets the total number of instructions.
    * @return Number of instructions in the program.
@@ -77,12 +89,58 @@ class Program {
   size_t instructionCount() const;
 
   /**
-   * @brief Access to global memory.
-   * @return Reference to memory.
+   * @brief Access to the shared code image.
+   * @return Shared pointer to the immutable code.
+   */
+  const std::shared_ptr<const CodeImage>& codeImage() const;
+
+  /**
+   * @brief Executes a Trap instead of the instructions at some addresses.
+   *
+   * The shared code image is not modified: a patched copy is built from it
+   * (see CodeImage::withTraps()) and only getInstruction() sees it;
+   * codeImage() still returns the compiled code. Costs one copy of the code
+   * per call, and nothing per executed instruction.
+   *
+   * @param pcs Addresses to trap, or empty to execute the compiled code.
+   */
+  void setTraps(const std::vector<uint32_t>& pcs);
+
+  /**
+   * @brief Read-only access to global memory.
+   *
+   * Writes go through store(), writeMemory() or copyBlock() so that the
+   * memory fingerprint stays current.
+   *
+   * @return Const reference to memory.
    */
-  nsbaci::types::Memory& memory();
   const nsbaci::types::Memory& memory() const;
 
+  /**
+   * @brief Store a word at an address known to be inside the data segment.
+   *
+   * Unchecked fast path for operands the interpreter has bounds-checked.
+   * Updates the fingerprint with two XORs.
+   *
+   * @param addr Memory address to write to.
+   * @param value Value to write.
+   */
+  void store(nsbaci::types::MemoryAddr addr, int32_t value) {
+    int32_t& word = globalMemory[addr];
+    if (barrier) {
+      noteWrite(addr, word);
+    }
+    memoryHash ^=
+        zobrist::memoryKey(addr, word) ^ zobrist::memoryKey(addr, value);
+    word = value;
+  }
+
+  /**
+   * @brief Zobrist fingerprint of global memory, maintained on every write.
+   * @return 64-bit fingerprint.
+   */
+  uint64_t fingerprint() const { return memoryHash; }
+
   /**
    * @brief Access to symbol table.
    * @return Const reference to symbol table.
@@ -91,6 +149,11 @@ class Program {
 
   /**
    * @brief Add a symbol to the symbol table.
+   *
+   * Grows the data segment if the symbol lies beyond it. Meant for load time,
+   * not for use while the program runs. The code image is copied first if it
+   * is shared with another Program.
+   *
    * @param info The symbol information to add.
    */
   void addSymbol(nsbaci::types::SymbolInfo info);
@@ -106,16 +169,131 @@ class Program {
    * @brief Write a value to memory.
    * @param addr Memory address to write to.
    * @param value Value to write.
+   * @throws std::out_of_range if addr is outside the data segment.
    */
   void writeMemory(nsbaci::types::MemoryAddr addr, int32_t value);
 
+  /**
+   * @brief Restores global memory to the image captured at load time.
+   *
+   * The initial image has the same size as the data segment, so this is a
+   * single memcpy and never reallocates.
+   */
+  void resetMemory();
+
+  /**
+   * @brief Replaces global memory with a previously saved snapshot.
+   * @param snapshot Memory contents, as returned by memory().
+   * @throws std::invalid_argument if the snapshot size differs from the data
+   * segment size.
+   */
+  void restoreMemory(const nsbaci::types::Memory& snapshot);
+
+  /**
+   * @brief Gets the size of the data segment.
+   * @return Number of addressable memory words.
+   */
+  size_t dataSize() const;
+
+  /**
+   * @brief Check whether a block of words lies inside global memory.
+   * @param addr First address of the block.
+   * @param count Number of words in the block.
+   * @return True if [addr, addr + count) is addressable.
+   */
+  bool containsBlock(nsbaci::types::MemoryAddr addr, size_t count) const;
+
+  /**
+   * @brief Copy a block of words inside global memory.
+   *
+   * Source and destination may overlap. The whole block is bounds-checked
+   * once and then moved with a single memmove.
+   *
+   * @param dst First destination address.
+   * @param src First source address.
+   * @param count Number of words to copy.
+   */
+  void copyBlock(nsbaci::types::MemoryAddr dst, nsbaci::types::MemoryAddr src,
+                 size_t count);
+
+  /**
+   * @brief Log the old value of every word written from now on.
+   *
+   * Used to undo a step: restoring the logged values in reverse order puts
+   * memory back as it was. The pointer is not owned and is copied along
+   * with the program, so set it only around the writes to be logged.
+   *
+   * @param log Vector to append to, or nullptr to stop logging.
+   */
+  void setWriteLog(std::vector<MemoryWrite>* log) {
+    writeLog = log;
+    barrier = writeLog || watchLog;
+  }
+
+  /**
+   * @brief Marks a block of words as watched.
+   *
+   * Watched words are kept in a bitmap with one bit per word of the data
+   * segment. Words outside the data segment are ignored.
+   *
+   * @param addr First address of the block.
+   * @param count Number of words in the block.
+   */
+  void watch(nsbaci::types::MemoryAddr addr, size_t count);
+
+  /**
+   * @brief Unmarks every watched word.
+   */
+  void clearWatches();
+
+  /**
+   * @brief Checks whether a word is watched.
+   * @param addr Memory address.
+   * @return True if marked by watch().
+   */
+  bool isWatched(nsbaci::types::MemoryAddr addr) const {
+    return addr < watchBits.size() * 64 &&
+           (watchBits[addr / 64] >> (addr % 64)) & 1;
+  }
+
+  /**
+   * @brief Log the old value of every watched word written from now on.
+   *
+   * Like setWriteLog(), and sharing its single check on the write path:
+   * while neither log is set, stores test nothing else, so watched words
+   * cost nothing until a watch log is set.
+   *
+   * @param log Vector to append to, or nullptr to stop logging.
+   */
+  void setWatchLog(std::vector<MemoryWrite>* log) {
+    watchLog = log;
+    barrier = writeLog || watchLog;
+  }
+
  private:
-  // Instruction stream - read-only after construction
-  nsbaci::compiler::InstructionStream instructions;
-  // Global symbol table
-  nsbaci::types::SymbolTable symbolTable;
-  // Global memory
+  /**
+   * @brief Slow path of a write while a log is set.
+   * @param addr Word about to be written.
+   * @param old Value it holds.
+   */
+  void noteWrite(nsbaci::types::MemoryAddr addr, int32_t old);
+
+  // Immutable code, shared between every copy of this program
+  std::shared_ptr<const CodeImage> image;
+  // Image getInstruction() reads: image itself, or a copy with traps
+  std::shared_ptr<const CodeImage> executed;
+  // Global memory of this execution
   nsbaci::types::Memory globalMemory;
+  // Fingerprint of globalMemory
+  uint64_t memoryHash = 0;
+  // Receives the old value of each write while set
+  std::vector<MemoryWrite>* writeLog = nullptr;
+  // Receives the old value of each write to a watched word while set
+  std::vector<MemoryWrite>* watchLog = nullptr;
+  // Either log is set: the only check stores make on the fast path
+  bool barrier = false;
+  // One bit per watched word of the data segment
+  std::vector<uint64_t> watchBits;
 };
 
 }  // namespace nsbaci::services::runtime
@@ -0,0 +1,209 @@
+/**
+ * @file raceDetector.cpp
+ * @brief RaceDetector class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "raceDetector.h"
+
+#include <algorithm>
+
+namespace nsbaci::services::runtime {
+
+namespace {
+
+std::string describeAccess(const Access& a) {
+  return "thread " + std::to_string(a.thread) + (a.write ? " write" : " read") +
+         " at pc " + std::to_string(a.pc);
+}
+
+// Component-wise maximum, growing into to fit from
+void joinInto(std::vector<uint32_t>& into, const std::vector<uint32_t>& from) {
+  if (into.size() < from.size()) {
+    into.resize(from.size(), 0);
+  }
+  for (size_t i = 0; i < from.size(); ++i) {
+    into[i] = std::max(into[i], from[i]);
+  }
+}
+
+}  // namespace
+
+std::string Race::describe() const {
+  return "@" + std::to_string(address) + ": " + describeAccess(first) + ", " +
+         describeAccess(second);
+}
+
+void RaceDetector::read(nsbaci::types::ThreadID thread, uint32_t address,
+                        uint32_t pc) {
+  uint32_t t = static_cast<uint32_t>(thread);
+  const VectorClock& now = clockOf(t);
+  Epoch e = makeEpoch(t, now[t]);
+  Shadow& s = shadowOf(address);
+
+  // Same thread, no synchronization since its last read: nothing new
+  if (s.read == e) {
+    return;
+  }
+
+  if (s.write != 0 && !happensBefore(s.write, now)) {
+    report(address, {epochThread(s.write), s.writePc, true}, {t, pc, false});
+  }
+
+  if (s.read == SHARED) {
+    SharedReads& reads = sharedReads[s.shared];
+    if (reads.clocks.size() <= t) {
+      reads.clocks.resize(t + 1, 0);
+      reads.pcs.resize(t + 1, 0);
+    }
+    reads.clocks[t] = now[t];
+    reads.pcs[t] = pc;
+  } else if (s.read == 0 || happensBefore(s.read, now)) {
+    // Reads still totally ordered: the newest one is enough
+    s.read = e;
+    s.readPc = pc;
+  } else {
+    // Two concurrent readers: keep a clock per thread from now on
+    uint32_t idx;
+    if (!freeShared.empty()) {
+      idx = freeShared.back();
+      freeShared.pop_back();
+    } else {
+      idx = static_cast<uint32_t>(sharedReads.size());
+      sharedReads.emplace_back();
+    }
+    SharedReads& reads = sharedReads[idx];
+    uint32_t other = epochThread(s.read);
+    size_t size = std::max(other, t) + size_t(1);
+    reads.clocks.assign(size, 0);
+    reads.pcs.assign(size, 0);
+    reads.clocks[other] = epochClock(s.read);
+    reads.pcs[other] = s.readPc;
+    reads.clocks[t] = now[t];
+    reads.pcs[t] = pc;
+    s.read = SHARED;
+    s.shared = idx;
+  }
+}
+
+void RaceDetector::write(nsbaci::types::ThreadID thread, uint32_t address,
+                         uint32_t pc) {
+  uint32_t t = static_cast<uint32_t>(thread);
+  const VectorClock& now = clockOf(t);
+  Epoch e = makeEpoch(t, now[t]);
+  Shadow& s = shadowOf(address);
+
+  if (s.write == e) {
+    s.writePc = pc;
+    return;
+  }
+
+  if (s.write != 0 && !happensBefore(s.write, now)) {
+    report(address, {epochThread(s.write), s.writePc, true}, {t, pc, true});
+  }
+
+  if (s.read == SHARED) {
+    const SharedReads& reads = sharedReads[s.shared];
+    for (uint32_t u = 0; u < reads.clocks.size(); ++u) {
+      Clock seen = u < now.size() ? now[u] : 0;
+      if (reads.clocks[u] > seen) {
+        report(address, {u, reads.pcs[u], false}, {t, pc, true});
+      }
+    }
+    freeShared.push_back(s.shared);
+  } else if (s.read != 0 && !happensBefore(s.read, now)) {
+    report(address, {epochThread(s.read), s.readPc, false}, {t, pc, true});
+  }
+
+  // Any later access racing with the old reads also races with this write
+  s.read = 0;
+  s.write = e;
+  s.writePc = pc;
+}
+
+void RaceDetector::acquire(nsbaci::types::ThreadID thread, uint32_t sync) {
+  VectorClock& now = clockOf(static_cast<uint32_t>(thread));
+  auto it = syncClocks.find(sync);
+  if (it != syncClocks.end()) {
+    joinInto(now, it->second);
+  }
+}
+
+void RaceDetector::release(nsbaci::types::ThreadID thread, uint32_t sync) {
+  uint32_t t = static_cast<uint32_t>(thread);
+  VectorClock& now = clockOf(t);
+  joinInto(syncClocks[sync], now);
+  ++now[t];
+}
+
+void RaceDetector::fork(nsbaci::types::ThreadID parent,
+                        nsbaci::types::ThreadID child) {
+  uint32_t p = static_cast<uint32_t>(parent);
+  uint32_t c = static_cast<uint32_t>(child);
+  clockOf(p);
+  clockOf(c);  // May grow threadClocks; take references afterwards
+  joinInto(threadClocks[c], threadClocks[p]);
+  ++threadClocks[p][p];
+}
+
+void RaceDetector::join(nsbaci::types::ThreadID parent,
+                        nsbaci::types::ThreadID child) {
+  uint32_t p = static_cast<uint32_t>(parent);
+  uint32_t c = static_cast<uint32_t>(child);
+  clockOf(p);
+  clockOf(c);
+  joinInto(threadClocks[p], threadClocks[c]);
+  ++threadClocks[c][c];
+}
+
+const std::vector<Race>& RaceDetector::races() const { return found; }
+
+void RaceDetector::clear() {
+  threadClocks.clear();
+  shadow.clear();
+  sharedReads.clear();
+  freeShared.clear();
+  syncClocks.clear();
+  found.clear();
+  reported.clear();
+}
+
+RaceDetector::VectorClock& RaceDetector::clockOf(uint32_t thread) {
+  if (threadClocks.size() <= thread) {
+    threadClocks.resize(thread + size_t(1));
+  }
+  VectorClock& vc = threadClocks[thread];
+  if (vc.size() <= thread) {
+    vc.resize(thread + size_t(1), 0);
+  }
+  if (vc[thread] == 0) {
+    vc[thread] = 1;  // Clock 0 is reserved for "no access"
+  }
+  return vc;
+}
+
+RaceDetector::Shadow& RaceDetector::shadowOf(uint32_t address) {
+  if (shadow.size() <= address) {
+    shadow.resize(address + size_t(1));
+  }
+  return shadow[address];
+}
+
+bool RaceDetector::happensBefore(Epoch e, const VectorClock& now) {
+  uint32_t u = epochThread(e);
+  Clock seen = u < now.size() ? now[u] : 0;
+  return epochClock(e) <= seen;
+}
+
+void RaceDetector::report(uint32_t address, Access first, Access second) {
+  auto key = std::make_tuple(address, std::min(first.pc, second.pc),
+                             std::max(first.pc, second.pc));
+  if (reported.insert(key).second) {
+    found.push_back({address, first, second});
+  }
+}
+
+}  // namespace nsbaci::services::runtime
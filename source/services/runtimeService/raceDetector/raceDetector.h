@@ -0,0 +1,203 @@
+/**
+ * @file raceDetector.h
+ * @brief RaceDetector class declaration for nsbaci runtime service.
+ *
+ * This module defines a dynamic data race detector in the style of
+ * FastTrack. Every thread carries a vector clock, semaphores and monitors
+ * carry the clock of their last release, and every global memory word has
+ * shadow state recording its last write and reads. Two accesses to the same
+ * word, at least one a write, race when neither happens before the other.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_RACEDETECTOR_H
+#define NSBACI_SERVICES_RUNTIME_RACEDETECTOR_H
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "runtimeTypes.h"
+
+/**
+ * @namespace nsbaci::services::runtime
+ * @brief Runtime services namespace for nsbaci.
+ */
+namespace nsbaci::services::runtime {
+
+/**
+ * @struct Access
+ * @brief One side of a race: who touched the word, where and how.
+ */
+struct Access {
+  nsbaci::types::ThreadID thread = 0;  ///< Accessing thread
+  uint32_t pc = 0;                     ///< Instruction that accessed it
+  bool write = false;                  ///< True for a write
+};
+
+/**
+ * @struct Race
+ * @brief Two unordered accesses to the same word, at least one a write.
+ */
+struct Race {
+  uint32_t address = 0;  ///< Global memory word
+  Access first;          ///< Earlier access
+  Access second;         ///< Access that exposed the race
+
+  /**
+   * @brief Human-readable description.
+   * @return Text such as "@3: thread 1 write at pc 5, thread 2 read at pc 9".
+   */
+  std::string describe() const;
+};
+
+/**
+ * @class RaceDetector
+ * @brief FastTrack-style happens-before race detector.
+ *
+ * The last write of a word is kept as a single epoch (thread, clock), and
+ * so are its reads while they are totally ordered; only reads by several
+ * concurrent threads fall back to a full vector clock. Most accesses are
+ * therefore checked in constant time and without allocation.
+ *
+ * Each (address, pc, pc) race is reported once.
+ */
+class RaceDetector {
+ public:
+  RaceDetector() = default;
+  ~RaceDetector() = default;
+
+  /**
+   * @brief Checks and records a read.
+   * @param thread Reading thread.
+   * @param address Global memory word.
+   * @param pc Instruction performing the read.
+   */
+  void read(nsbaci::types::ThreadID thread, uint32_t address, uint32_t pc);
+
+  /**
+   * @brief Checks and records a write.
+   * @param thread Writing thread.
+   * @param address Global memory word.
+   * @param pc Instruction performing the write.
+   */
+  void write(nsbaci::types::ThreadID thread, uint32_t address, uint32_t pc);
+
+  /**
+   * @brief A thread passed a Wait or entered a monitor.
+   *
+   * Everything released earlier on the same object happens before what the
+   * thread does next.
+   *
+   * @param thread Acquiring thread.
+   * @param sync Address of the semaphore or monitor lock word.
+   */
+  void acquire(nsbaci::types::ThreadID thread, uint32_t sync);
+
+  /**
+   * @brief A thread signalled a semaphore or left a monitor.
+   * @param thread Releasing thread.
+   * @param sync Address of the semaphore or monitor lock word.
+   */
+  void release(nsbaci::types::ThreadID thread, uint32_t sync);
+
+  /**
+   * @brief A thread started another; the parent's past happens before it.
+   * @param parent Starting thread.
+   * @param child Started thread.
+   */
+  void fork(nsbaci::types::ThreadID parent, nsbaci::types::ThreadID child);
+
+  /**
+   * @brief A thread waited for another to finish.
+   * @param parent Waiting thread.
+   * @param child Finished thread.
+   */
+  void join(nsbaci::types::ThreadID parent, nsbaci::types::ThreadID child);
+
+  /**
+   * @brief Gets every race found so far, in discovery order.
+   * @return Const reference to the races.
+   */
+  const std::vector<Race>& races() const;
+
+  /**
+   * @brief Forgets all clocks, shadow state and races.
+   */
+  void clear();
+
+ private:
+  using Clock = uint32_t;
+  using VectorClock = std::vector<Clock>;
+
+  /// @brief Packed (thread, clock); 0 means "no access yet".
+  using Epoch = uint64_t;
+
+  /// @brief Read epoch marking a word read by several concurrent threads.
+  static constexpr Epoch SHARED = ~Epoch(0);
+
+  /**
+   * @struct Shadow
+   * @brief Last accesses of one memory word.
+   */
+  struct Shadow {
+    Epoch write = 0;       ///< Last write
+    Epoch read = 0;        ///< Last read, or SHARED
+    uint32_t writePc = 0;  ///< Instruction of the last write
+    uint32_t readPc = 0;   ///< Instruction of the last read (not SHARED)
+    uint32_t shared = 0;   ///< Index into sharedReads when read is SHARED
+  };
+
+  /**
+   * @struct SharedReads
+   * @brief Concurrent reads of a word: one clock and pc per thread.
+   */
+  struct SharedReads {
+    VectorClock clocks;         ///< Read clock of each thread (0 = none)
+    std::vector<uint32_t> pcs;  ///< Instruction of each thread's read
+  };
+
+  static Epoch makeEpoch(uint32_t thread, Clock clock) {
+    return (Epoch(thread) << 32) | clock;
+  }
+  static uint32_t epochThread(Epoch e) { return uint32_t(e >> 32); }
+  static Clock epochClock(Epoch e) { return Clock(e); }
+
+  /**
+   * @brief Gets a thread's vector clock, creating it on first use.
+   */
+  VectorClock& clockOf(uint32_t thread);
+
+  /**
+   * @brief Gets a word's shadow state, growing the shadow memory as needed.
+   */
+  Shadow& shadowOf(uint32_t address);
+
+  /**
+   * @brief Checks whether an epoch happens before a thread's present.
+   */
+  static bool happensBefore(Epoch e, const VectorClock& now);
+
+  /**
+   * @brief Records a race unless the same pair of pcs was reported before.
+   */
+  void report(uint32_t address, Access first, Access second);
+
+  std::vector<VectorClock> threadClocks;  ///< By thread ID
+  std::vector<Shadow> shadow;             ///< By global address
+  std::vector<SharedReads> sharedReads;   ///< Referenced from Shadow::shared
+  std::vector<uint32_t> freeShared;       ///< Unused sharedReads slots
+  std::unordered_map<uint32_t, VectorClock> syncClocks;  ///< By sync address
+  std::vector<Race> found;  ///< Races in discovery order
+  std::set<std::tuple<uint32_t, uint32_t, uint32_t>> reported;  ///< Dedup
+};
+
+}  // namespace nsbaci::services::runtime
+
+#endif  // NSBACI_SERVICES_RUNTIME_RACEDETECTOR_H
@@ -0,0 +1,231 @@
+/**
+ * @file replayLog.cpp
+ * @brief ReplayLog class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "replayLog.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace nsbaci::services::runtime {
+
+namespace {
+
+constexpr const char* HEADER = "nsbaci-replay 1";
+
+ReplayLogResult malformed(size_t line, const std::string& what) {
+  nsbaci::Error err;
+  err.basic.severity = nsbaci::types::ErrSeverity::Error;
+  err.basic.message =
+      "Replay log line " + std::to_string(line) + ": " + what;
+  err.basic.type = nsbaci::types::ErrType::unknown;
+  err.payload = nsbaci::types::RuntimeError{};
+  return ReplayLogResult(std::move(err));
+}
+
+// Reads "<keyword> <count>"
+bool readSection(const std::string& line, const std::string& keyword,
+                 uint64_t& count) {
+  std::istringstream in(line);
+  std::string word;
+  return in >> word >> count && word == keyword && (in >> std::ws).eof();
+}
+
+}  // namespace
+
+void ReplayLog::recordPick(nsbaci::types::ThreadID thread) {
+  if (!runs.empty() && runs.back().thread == thread) {
+    ++runs.back().count;
+  } else {
+    runs.push_back({thread, 1});
+  }
+  ++total;
+}
+
+void ReplayLog::recordInput(const std::string& value) {
+  values.push_back(value);
+}
+
+const std::vector<ScheduleRun>& ReplayLog::schedule() const { return runs; }
+
+const std::vector<std::string>& ReplayLog::inputs() const { return values; }
+
+uint64_t ReplayLog::picks() const { return total; }
+
+bool ReplayLog::empty() const { return runs.empty() && values.empty(); }
+
+void ReplayLog::clear() {
+  runs.clear();
+  values.clear();
+  total = 0;
+}
+
+void ReplayLog::truncate(uint64_t picks, size_t inputs) {
+  if (values.size() > inputs) {
+    values.resize(inputs);
+  }
+  while (total > picks && !runs.empty()) {
+    uint64_t drop = std::min(total - picks, runs.back().count);
+    runs.back().count -= drop;
+    total -= drop;
+    if (runs.back().count == 0) {
+      runs.pop_back();
+    }
+  }
+}
+
+void ReplayLog::extendTo(const ReplayLog& other, uint64_t picks,
+                         size_t inputs) {
+  picks = std::min(picks, other.total);
+  if (total < picks) {
+    // Truncation may have shortened the last run shared with other
+    size_t next = runs.size();
+    if (next > 0 && runs.back().count < other.runs[next - 1].count) {
+      uint64_t add =
+          std::min(other.runs[next - 1].count - runs.back().count, picks - total);
+      runs.back().count += add;
+      total += add;
+    }
+    for (; total < picks && next < other.runs.size(); ++next) {
+      ScheduleRun r = other.runs[next];
+      r.count = std::min(r.count, picks - total);
+      runs.push_back(r);
+      total += r.count;
+    }
+  }
+
+  inputs = std::min(inputs, other.values.size());
+  for (size_t i = values.size(); i < inputs; ++i) {
+    values.push_back(other.values[i]);
+  }
+}
+
+std::string ReplayLog::serialize() const {
+  std::ostringstream out;
+  out << HEADER << "\n";
+  out << "schedule " << runs.size() << "\n";
+  for (const auto& r : runs) {
+    out << r.thread << " " << r.count << "\n";
+  }
+  out << "inputs " << values.size() << "\n";
+  for (const auto& v : values) {
+    out << v << "\n";
+  }
+  return out.str();
+}
+
+ReplayLogResult ReplayLog::parse(const std::string& text) {
+  std::istringstream in(text);
+  std::string line;
+  size_t lineNo = 0;
+  auto next = [&]() {
+    ++lineNo;
+    if (!std::getline(in, line)) {
+      return false;
+    }
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();  // Saved on Windows
+    }
+    return true;
+  };
+
+  if (!next() || line != HEADER) {
+    return malformed(lineNo, "not an nsbaci replay log");
+  }
+
+  ReplayLogResult result;
+  ReplayLog& log = result.log;
+
+  uint64_t count = 0;
+  if (!next() || !readSection(line, "schedule", count)) {
+    return malformed(lineNo, "expected \"schedule <runs>\"");
+  }
+  for (uint64_t i = 0; i < count; ++i) {
+    ScheduleRun r;
+    if (!next()) {
+      return malformed(lineNo, "schedule ends early");
+    }
+    std::istringstream fields(line);
+    if (!(fields >> r.thread >> r.count) || r.count == 0 ||
+        !(fields >> std::ws).eof()) {
+      return malformed(lineNo, "expected \"<thread> <steps>\"");
+    }
+    log.runs.push_back(r);
+    log.total += r.count;
+  }
+
+  if (!next() || !readSection(line, "inputs", count)) {
+    return malformed(lineNo, "expected \"inputs <values>\"");
+  }
+  for (uint64_t i = 0; i < count; ++i) {
+    if (!next()) {
+      return malformed(lineNo, "inputs end early");
+    }
+    log.values.push_back(line);
+  }
+  return result;
+}
+
+ReplayCursor::ReplayCursor(ReplayLog l) : log(std::move(l)) {}
+
+std::optional<nsbaci::types::ThreadID> ReplayCursor::nextPick() {
+  const auto& runs = log.schedule();
+  if (run >= runs.size()) {
+    return std::nullopt;
+  }
+  nsbaci::types::ThreadID thread = runs[run].thread;
+  ++taken;
+  if (++inRun == runs[run].count) {
+    ++run;
+    inRun = 0;
+  }
+  return thread;
+}
+
+std::optional<std::string> ReplayCursor::nextInput() {
+  const auto& values = log.inputs();
+  if (input >= values.size()) {
+    return std::nullopt;
+  }
+  return values[input++];
+}
+
+bool ReplayCursor::done() const { return run >= log.schedule().size(); }
+
+uint64_t ReplayCursor::position() const { return taken; }
+
+void ReplayCursor::seek(uint64_t picks, size_t inputs) {
+  const auto& runs = log.schedule();
+  picks = std::min(picks, log.picks());
+
+  // Back to the start of the run holding the target, then forward
+  uint64_t start = taken - inRun;
+  while (run > 0 && start > picks) {
+    --run;
+    start -= runs[run].count;
+  }
+  taken = start;
+  inRun = 0;
+  while (run < runs.size() && taken + runs[run].count <= picks) {
+    taken += runs[run].count;
+    ++run;
+  }
+  inRun = picks - taken;
+  taken = picks;
+  input = std::min(inputs, log.inputs().size());
+}
+
+void ReplayCursor::unpick() {
+  if (taken > 0) {
+    seek(taken - 1, input);
+  }
+}
+
+const ReplayLog& ReplayCursor::getLog() const { return log; }
+
+}  // namespace nsbaci::services::runtime
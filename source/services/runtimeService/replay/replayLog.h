@@ -0,0 +1,241 @@
+/**
+ * @file replayLog.h
+ * @brief ReplayLog class declaration for nsbaci runtime service.
+ *
+ * This module defines the record of every nondeterministic decision of a
+ * run: which thread the scheduler picked at each step and which values were
+ * given to Read instructions. Replaying the log from a reset reproduces the
+ * run exactly, whatever scheduler or seed produced it.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_REPLAYLOG_H
+#define NSBACI_SERVICES_RUNTIME_REPLAYLOG_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "baseResult.h"
+#include "runtimeTypes.h"
+
+/**
+ * @namespace nsbaci::services::runtime
+ * @brief Runtime services namespace for nsbaci.
+ */
+namespace nsbaci::services::runtime {
+
+/**
+ * @struct ScheduleRun
+ * @brief Consecutive steps picked for the same thread.
+ */
+struct ScheduleRun {
+  nsbaci::types::ThreadID thread = 0;  ///< Thread picked.
+  uint64_t count = 0;                  ///< Steps in a row it was picked for.
+};
+
+struct ReplayLogResult;
+
+/**
+ * @class ReplayLog
+ * @brief Run-length encoded schedule plus the input values of a run.
+ *
+ * Every step the runtime executes is one pick, including Reads that had to
+ * wait for input and Waits that blocked, since those are retried by the
+ * same pick later. Runs of the same thread collapse into one entry, so a
+ * thread running through a long computation costs a single entry.
+ *
+ * The text form, as written by serialize(), is meant to be saved next to
+ * the program:
+ * @code
+ * nsbaci-replay 1
+ * schedule 2
+ * 0 15
+ * 1 3
+ * inputs 1
+ * 42
+ * @endcode
+ */
+class ReplayLog {
+ public:
+  /**
+   * @brief Records that a thread was picked for one step.
+   * @param thread The thread.
+   */
+  void recordPick(nsbaci::types::ThreadID thread);
+
+  /**
+   * @brief Records a value given to a Read.
+   * @param value The value, as typed.
+   */
+  void recordInput(const std::string& value);
+
+  /**
+   * @brief Gets the schedule.
+   * @return Runs of picks in execution order.
+   */
+  const std::vector<ScheduleRun>& schedule() const;
+
+  /**
+   * @brief Gets the input values.
+   * @return Values in the order they were given.
+   */
+  const std::vector<std::string>& inputs() const;
+
+  /**
+   * @brief Gets the number of steps recorded.
+   * @return Sum of the counts of every run.
+   */
+  uint64_t picks() const;
+
+  /**
+   * @brief Checks whether anything was recorded.
+   * @return True if there are no picks and no inputs.
+   */
+  bool empty() const;
+
+  /**
+   * @brief Forgets every pick and input.
+   */
+  void clear();
+
+  /**
+   * @brief Forgets everything after a point of the run.
+   *
+   * Used when steps are undone, so the log keeps describing the run that
+   * leads to the current state.
+   *
+   * @param picks Picks to keep.
+   * @param inputs Input values to keep.
+   */
+  void truncate(uint64_t picks, size_t inputs);
+
+  /**
+   * @brief Catches up with a longer log this one is a prefix of.
+   *
+   * The inverse of truncate(): copies the decisions of other that follow
+   * this log's end, up to a point. Costs only what is copied.
+   *
+   * @param other Log that starts with this one.
+   * @param picks Picks to have afterwards.
+   * @param inputs Input values to have afterwards.
+   */
+  void extendTo(const ReplayLog& other, uint64_t picks, size_t inputs);
+
+  /**
+   * @brief Converts the log to its text form.
+   * @return Text accepted by parse().
+   */
+  std::string serialize() const;
+
+  /**
+   * @brief Reads a log from its text form.
+   * @param text Text produced by serialize().
+   * @return The log, or an error describing the first malformed line.
+   */
+  static ReplayLogResult parse(const std::string& text);
+
+ private:
+  std::vector<ScheduleRun> runs;    ///< Schedule, run-length encoded.
+  std::vector<std::string> values;  ///< Input values.
+  uint64_t total = 0;               ///< Picks over every run.
+};
+
+/**
+ * @struct ReplayLogResult
+ * @brief Result of reading a replay log.
+ */
+struct ReplayLogResult : nsbaci::BaseResult {
+  /**
+   * @brief Default constructor creates a successful result.
+   */
+  ReplayLogResult() : BaseResult() {}
+
+  /**
+   * @brief Constructs a failed result from a single error.
+   * @param error Why the log could not be read.
+   */
+  explicit ReplayLogResult(nsbaci::Error error)
+      : BaseResult(std::move(error)) {}
+
+  ReplayLogResult(ReplayLogResult&&) noexcept = default;
+  ReplayLogResult& operator=(ReplayLogResult&&) noexcept = default;
+  ReplayLogResult(const ReplayLogResult&) = default;
+  ReplayLogResult& operator=(const ReplayLogResult&) = default;
+
+  ReplayLog log;  ///< The log read.
+};
+
+/**
+ * @class ReplayCursor
+ * @brief Walks a replay log one decision at a time.
+ */
+class ReplayCursor {
+ public:
+  /**
+   * @brief Starts at the first decision of a log.
+   * @param l The log to replay.
+   */
+  explicit ReplayCursor(ReplayLog l);
+
+  /**
+   * @brief Takes the thread to pick for the next step.
+   * @return The thread, or nullopt once the schedule is exhausted.
+   */
+  std::optional<nsbaci::types::ThreadID> nextPick();
+
+  /**
+   * @brief Takes the next input value.
+   * @return The value, or nullopt if every value was used.
+   */
+  std::optional<std::string> nextInput();
+
+  /**
+   * @brief Checks whether every pick was taken.
+   * @return True once the schedule is exhausted.
+   */
+  bool done() const;
+
+  /**
+   * @brief Gets the number of picks taken so far.
+   * @return Picks taken.
+   */
+  uint64_t position() const;
+
+  /**
+   * @brief Moves to a point of the log, as if that many decisions had been
+   * taken.
+   *
+   * Walks from the current position, so short moves either way are cheap.
+   *
+   * @param picks Picks to skip.
+   * @param inputs Input values to skip.
+   */
+  void seek(uint64_t picks, size_t inputs);
+
+  /**
+   * @brief Gives back the pick just taken, for a step that did not run.
+   */
+  void unpick();
+
+  /**
+   * @brief Gets the log being replayed.
+   * @return Const reference to the whole log.
+   */
+  const ReplayLog& getLog() const;
+
+ private:
+  ReplayLog log;       ///< Log being replayed.
+  size_t run = 0;      ///< Current run of the schedule.
+  uint64_t inRun = 0;  ///< Picks taken from the current run.
+  size_t input = 0;    ///< Next input value.
+  uint64_t taken = 0;  ///< Picks taken over every run.
+};
+
+}  // namespace nsbaci::services::runtime
+
+#endif  // NSBACI_SERVICES_RUNTIME_REPLAYLOG_H
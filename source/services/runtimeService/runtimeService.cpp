@@ -9,8 +9,89 @@
 
 #include "runtimeService.h"
 
+#include <algorithm>
+#include <variant>
+
+#include "zobrist.h"
+
 namespace nsbaci::services {
 
+namespace {
+
+/**
+ * @brief Checks that code is a side-effect free expression.
+ *
+ * Only loads, literals and operators may appear, each with the stack
+ * depth it needs, followed by a single Halt that leaves the value alone on
+ * the stack. Such code can be evaluated at any time without changing the
+ * run.
+ */
+bool isPureExpression(const nsbaci::compiler::InstructionStream& code) {
+  using nsbaci::compiler::Opcode;
+  size_t depth = 0;
+  for (size_t i = 0; i < code.size(); ++i) {
+    const auto& instr = code[i];
+    switch (instr.opcode) {
+      case Opcode::PushLiteral:
+        if (!std::holds_alternative<int32_t>(instr.operand1)) {
+          return false;
+        }
+        ++depth;
+        break;
+      case Opcode::LoadValue:
+        if (!std::holds_alternative<uint32_t>(instr.operand1)) {
+          return false;
+        }
+        ++depth;
+        break;
+      case Opcode::LoadIndirect:
+      case Opcode::Negate:
+        if (depth < 1) {
+          return false;
+        }
+        break;
+      case Opcode::Add:
+      case Opcode::Sub:
+      case Opcode::Mult:
+      case Opcode::Div:
+      case Opcode::Mod:
+      case Opcode::And:
+      case Opcode::Or:
+      case Opcode::TestEQ:
+      case Opcode::TestNE:
+      case Opcode::TestLT:
+      case Opcode::TestLE:
+      case Opcode::TestGT:
+      case Opcode::TestGE:
+        if (depth < 2) {
+          return false;
+        }
+        --depth;
+        break;
+      case Opcode::Halt:
+        return depth == 1 && i + 1 == code.size();
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Builds the error for a condition that is not a pure expression.
+ */
+nsbaci::Error conditionError(const Condition& condition) {
+  nsbaci::Error err;
+  err.basic.severity = nsbaci::types::ErrSeverity::Error;
+  err.basic.message =
+      "Condition '" + condition.text + "' is not a compiled expression";
+  err.basic.type = nsbaci::types::ErrType::unknown;
+  err.payload = nsbaci::types::RuntimeError{};
+  return err;
+}
+
+}  // namespace
+
 RuntimeService::RuntimeService(std::unique_ptr<runtime::Interpreter> i,
                                std::unique_ptr<runtime::Scheduler> s)
     : interpreter(std::move(i)),
@@ -19,23 +100,136 @@ RuntimeService::RuntimeService(std::unique_ptr<runtime::Interpreter> i,
 
 void RuntimeService::loadProgram(runtime::Program&& p) {
   program = std::move(p);
+
+  // Build the main thread once; every reset copies it
+  mainThread = runtime::Thread(0);  // The main thread is always ID 0
+  mainThread.setPC(0);  // Start at instruction 0
+
+  program.setTraps(breakpointAddresses());
+  applyWatchpoints();
   reset();
 }
 
+void RuntimeService::loadProgram(
+    std::shared_ptr<const runtime::CodeImage> image) {
+  loadProgram(runtime::Program(std::move(image)));
+}
+
 void RuntimeService::reset() {
+  program.resetMemory();
+
+  if (interpreter) {
+    interpreter->reset();
+  }
+
   if (scheduler) {
-    // Clear all existing threads
+    // Clear all existing threads (the scheduler keeps its storage)
     scheduler->clear();
-
-    // Create main thread and add to scheduler
-    runtime::Thread mainThread;
-    mainThread.setPC(0);  // Start at instruction 0
-    scheduler->addThread(std::move(mainThread));
+    scheduler->addThread(mainThread);
+  }
+  stepCount = 0;
+  markProgress();
+  if (raceDetector) {
+    raceDetector->clear();
+    racesReported = 0;
+  }
+  spinWatches.clear();
+  parked.clear();
+  parkedMemoryHash = program.fingerprint();
+  spinStats = SpinStats{};
+  if (profiler) {
+    profiler->reset(program.instructionCount());
+  }
+  stats.reset();
+  if (contention) {
+    contention->reset();
+  }
+  if (tracer) {
+    tracer->restart(program.codeImage(), 0);
+  }
+  if (binaryTracer) {
+    binaryTracer->restart(0);
   }
+  stopped.clear();
+  staleConditions();
+  replayLog.clear();
+  replay.reset();
   state = RuntimeState::Paused;
+  restartHistory();
 }
 
 RuntimeResult RuntimeService::step() {
+  if (state == RuntimeState::Halted || !scheduler || !interpreter) {
+    return execute(nullptr);
+  }
+
+  beginUndo();
+  RuntimeResult result;
+  if (replay) {
+    result = replayStep();
+  } else {
+    // Pick next thread to run
+    result = execute(scheduler->pickNext());
+  }
+  finishUndo();
+  return result;
+}
+
+RuntimeResult RuntimeService::replayStep() {
+  nsbaci::types::ThreadID threadId = *replay->nextPick();
+  runtime::Thread* thread = scheduler->pickThread(threadId);
+  if (!thread) {
+    uint64_t at = replay->position();
+    replay.reset();
+    state = RuntimeState::Paused;
+    nsbaci::Error err;
+    err.basic.severity = nsbaci::types::ErrSeverity::Error;
+    err.basic.message = "Replay diverged at step " + std::to_string(at) +
+                        ": thread " + std::to_string(threadId) +
+                        " is not ready to run";
+    err.basic.type = nsbaci::types::ErrType::unknown;
+    err.payload = nsbaci::types::RuntimeError{};
+    return RuntimeResult(std::move(err));
+  }
+
+  RuntimeResult result = execute(thread);
+  if (replay && replay->done()) {
+    replay.reset();
+    result.replayEnded = true;
+  }
+  return result;
+}
+
+RuntimeResult RuntimeService::stepThread(nsbaci::types::ThreadID threadId) {
+  if (state == RuntimeState::Halted || !scheduler || !interpreter) {
+    return execute(nullptr);
+  }
+
+  // Choosing the thread by hand leaves the logged schedule behind
+  replay.reset();
+
+  beginUndo();
+  runtime::Thread* thread = scheduler->pickThread(threadId);
+  if (!thread) {
+    finishUndo();
+    if (!scheduler->hasThreads()) {
+      // Nothing left to run at all, same as step()
+      return execute(nullptr);
+    }
+    nsbaci::Error err;
+    err.basic.severity = nsbaci::types::ErrSeverity::Warning;
+    err.basic.message =
+        "Thread " + std::to_string(threadId) + " is not ready to run";
+    err.basic.type = nsbaci::types::ErrType::unknown;
+    err.payload = nsbaci::types::RuntimeError{};
+    return RuntimeResult(std::move(err));
+  }
+  RuntimeResult result = execute(thread);
+  finishUndo();
+  return result;
+}
+
+RuntimeResult RuntimeService::execute(runtime::Thread* thread) {
   RuntimeResult result;
 
   if (state == RuntimeState::Halted) {
@@ -52,18 +246,69 @@ RuntimeResult RuntimeService::step() {
     return RuntimeResult(std::move(err));
   }
 
-  // Pick next thread to run
-  runtime::Thread* thread = scheduler->pickNext();
   if (!thread) {
-    // No threads left - program halted
+    // No threads left - program halted, or every remaining one is blocked
     state = RuntimeState::Halted;
     result.halted = true;
+    result.deadlock = scheduler->globalDeadlock();
     return result;
   }
 
-  // Execute one instruction
+  // Execute one instruction, journalling what it changes
+  uint32_t pc = thread->getPC();
+  if (undoOpen) {
+    undoPending.thread = thread->getId();
+    undoPending.pc = pc;
+    undoPending.bp = thread->getBP();
+    undoPending.sp = thread->getSP();
+    program.setWriteLog(&undoPending.writes);
+    thread->setStackLog(&undoPending.stack);
+  } else if (binaryTracer && stopsArmed) {
+    traceLog.clear();
+    program.setWriteLog(&traceLog);
+  }
+  if (watching) {
+    watchWrites.clear();
+    program.setWatchLog(&watchWrites);
+  }
   InterpreterResult interpResult =
       interpreter->executeInstruction(*thread, program);
+  bool passed = interpResult.trapped && !stopsAt(*thread, pc);
+  if (passed) {
+    interpreter->passTrap();
+    interpResult = interpreter->executeInstruction(*thread, program);
+  }
+  program.setWriteLog(nullptr);
+  thread->setStackLog(nullptr);
+  if (watching) {
+    program.setWatchLog(nullptr);
+  }
+
+  // Stopped at a breakpoint: the pick is given back, so the timeline does
+  // not depend on which breakpoints are set
+  if (interpResult.trapped) {
+    stopped.push_back({thread->getId(), pc});
+    if (replay) {
+      replay->unpick();
+    }
+    result.breakpoint = stopped.back();
+    return result;
+  }
+
+  if (recording) {
+    replayLog.recordPick(thread->getId());
+  }
+
+  // Past a breakpoint for good once its instruction completes; a Read or
+  // Wait that is retried does not stop again
+  if (passed && !interpResult.needsInput &&
+      !interpResult.blockedOn.has_value()) {
+    stopped.erase(std::remove_if(stopped.begin(), stopped.end(),
+                                 [&](const BreakpointHit& hit) {
+                                   return hit.thread == thread->getId();
+                                 }),
+                  stopped.end());
+  }
 
   if (!interpResult.ok) {
     result.ok = false;
@@ -72,29 +317,150 @@ RuntimeResult RuntimeService::step() {
     return result;
   }
 
+  // A Read waiting for input or a blocked Wait did not execute and will be
+  // retried
+  if (!interpResult.needsInput && !interpResult.blockedOn.has_value()) {
+    if (tracer && stopsArmed) {
+      tracer->ran(thread->getId(), pc, stepCount);
+    }
+    if (binaryTracer && stopsArmed) {
+      traceWrites.clear();
+      for (const auto& write : undoOpen ? undoPending.writes : traceLog) {
+        traceWrites.push_back({write.addr, program.readMemory(write.addr)});
+      }
+      binaryTracer->record(stepCount, thread->getId(), pc,
+                           program.codeImage()->instructions()[pc].opcode,
+                           traceWrites);
+    }
+    ++stepCount;
+    if (profiler && stopsArmed) {
+      profiler->record(thread->getId(), pc);
+    }
+    if constexpr (runtime::RUNTIME_STATS) {
+      if (stopsArmed) {
+        stats.record(thread->getId(),
+                     program.codeImage()->instructions()[pc].opcode,
+                     scheduler->readyCount());
+      }
+    }
+  }
+
+  if (watching && !watchWrites.empty()) {
+    if (!watchpoints.empty()) {
+      checkWatches(*thread, pc, result);
+    }
+    checkConditions(*thread, pc, result);
+  }
+
   // Propagate I/O info
   result.needsInput = interpResult.needsInput;
   result.inputPrompt = std::move(interpResult.inputPrompt);
   result.output = std::move(interpResult.output);
 
+  // A replayed Read gets its logged value and is retried by the next pick
+  if (result.needsInput && replay) {
+    if (auto value = replay->nextInput()) {
+      provideInput(*value);
+      result.needsInput = false;
+      result.inputPrompt.clear();
+    }
+  }
+  if (tracer && stopsArmed && result.needsInput) {
+    tracer->waitingInput(thread->getId(), stepCount);
+  }
+
+  if (raceDetector && raceDetector->races().size() > racesReported) {
+    const auto& races = raceDetector->races();
+    result.races.assign(races.begin() + racesReported, races.end());
+    racesReported = races.size();
+  }
+
+  // Semaphores and monitors: update the scheduler's wait-for graph
+  if (stopsArmed && interpResult.acquired.has_value()) {
+    if (contention) {
+      contention->acquired(thread->getId(), *interpResult.acquired, stepCount);
+    }
+    if (tracer) {
+      tracer->acquired(thread->getId(), *interpResult.acquired, stepCount - 1);
+    }
+  }
+  if (interpResult.released.has_value()) {
+    auto woken = scheduler->wakeOne(*interpResult.released);
+    if constexpr (runtime::RUNTIME_STATS) {
+      if (woken.has_value() && stopsArmed) {
+        stats.recordWakeup();
+      }
+    }
+    if (tracer && stopsArmed) {
+      tracer->released(thread->getId(), *interpResult.released, stepCount - 1);
+      if (woken.has_value()) {
+        tracer->woken(*woken, stepCount);
+      }
+    }
+  }
+  if (interpResult.blockedOn.has_value()) {
+    if constexpr (runtime::RUNTIME_STATS) {
+      if (stopsArmed) {
+        stats.recordBlock();
+      }
+    }
+    result.deadlock = scheduler->blockCurrentOn(
+        *interpResult.blockedOn, interpResult.holder,
+        [this](const runtime::Thread& t,
+               const nsbaci::types::WaitResource& resource) {
+          return program.codeImage()->maySignal(t.getPC(), resource.address);
+        });
+    if (contention && stopsArmed) {
+      contention->blocked(
+          thread->getId(), *interpResult.blockedOn, pc, stepCount,
+          scheduler->waitForGraph().waiterCount(*interpResult.blockedOn));
+    }
+    if (tracer && stopsArmed) {
+      tracer->blocked(thread->getId(), *interpResult.blockedOn, stepCount);
+    }
+    if (result.deadlock.has_value() && result.deadlock->global) {
+      state = RuntimeState::Halted;
+      result.halted = true;
+    }
+  }
+
+  // Busy-waiting: wake parked threads whose loop would now see a change,
+  // park this one if it just went round a loop for nothing
+  if (!parked.empty()) {
+    spinStats.parkedSteps += parked.size();
+    if (program.fingerprint() != parkedMemoryHash) {
+      wakeParked();
+    }
+  }
+  if (spinParking && thread->getPC() <= pc &&
+      thread->getState() == nsbaci::types::ThreadState::Running) {
+    checkSpin(*thread, pc, result);
+  }
+
+  if (livelockThreshold > 0 && !result.needsInput) {
+    if (!result.output.empty()) {
+      markProgress();
+    } else {
+      result.livelock = checkLivelock();
+    }
+  }
+
   // Check if thread terminated
   if (thread->getState() == nsbaci::types::ThreadState::Terminated) {
     // Thread finished execution
+    if (tracer && stopsArmed) {
+      tracer->exited(thread->getId(), stepCount);
+    }
     if (!scheduler->hasThreads()) {
       state = RuntimeState::Halted;
       result.halted = true;
+      result.deadlock = scheduler->globalDeadlock();
     }
   }
 
   return result;
 }
 
-RuntimeResult RuntimeService::stepThread(nsbaci::types::ThreadID threadId) {
-  // TODO: Implement stepping a specific thread
-  // For now, just do a regular step
-  return step();
-}
-
 RuntimeResult RuntimeService::run(size_t maxSteps) {
   RuntimeResult result;
   state = RuntimeState::Running;
@@ -107,6 +473,15 @@ RuntimeResult RuntimeService::run(size_t maxSteps) {
       break;
     }
 
+    // Stop where the caller has to act: input, livelock, deadlock, the end
+    // of a replay, a breakpoint, a watchpoint or a broken invariant
+    if (result.needsInput || result.livelock || result.deadlock.has_value() ||
+        result.replayEnded || result.breakpoint.has_value() ||
+        !result.watchpoints.empty() || !result.invariants.empty()) {
+      state = RuntimeState::Paused;
+      break;
+    }
+
     ++steps;
     if (maxSteps > 0 && steps >= maxSteps) {
       state = RuntimeState::Paused;
@@ -127,6 +502,45 @@ RuntimeState RuntimeService::getState() const { return state; }
 
 bool RuntimeService::isHalted() const { return state == RuntimeState::Halted; }
 
+uint64_t RuntimeService::getStepCount() const { return stepCount; }
+
+uint64_t RuntimeService::fingerprint() const {
+  uint64_t h = program.fingerprint();
+  if (scheduler) {
+    h ^= scheduler->fingerprint();
+  }
+  return h;
+}
+
+void RuntimeService::setLivelockThreshold(uint64_t threshold) {
+  livelockThreshold = threshold;
+  markProgress();
+}
+
+void RuntimeService::markProgress() {
+  ++progressEpoch;
+  revisits = 0;
+}
+
+bool RuntimeService::checkLivelock() {
+  if (recentStates.empty()) {
+    recentStates.resize(RECENT_STATES);
+  }
+
+  uint64_t h = fingerprint();
+  RecentState& slot = recentStates[h & (RECENT_STATES - 1)];
+  if (slot.epoch == progressEpoch && slot.fingerprint == h) {
+    if (++revisits >= livelockThreshold) {
+      revisits = 0;  // Report again only after another full window
+      return true;
+    }
+    return false;
+  }
+  slot.fingerprint = h;
+  slot.epoch = progressEpoch;
+  return false;
+}
+
 size_t RuntimeService::threadCount() const {
   if (!scheduler) {
     return 0;
@@ -144,10 +558,107 @@ const std::vector<runtime::Thread>& RuntimeService::getThreads() const {
 
 const runtime::Program& RuntimeService::getProgram() const { return program; }
 
+std::shared_ptr<const runtime::CodeImage> RuntimeService::getCodeImage()
+    const {
+  return program.codeImage();
+}
+
+ExecutionState RuntimeService::saveState() const {
+  ExecutionState s;
+  s.memory = program.memory();
+  if (scheduler) {
+    s.threads = scheduler->saveState();
+  }
+  s.state = state;
+  return s;
+}
+
+void RuntimeService::restoreState(const ExecutionState& s) {
+  program.restoreMemory(s.memory);
+  if (interpreter) {
+    interpreter->reset();
+  }
+  if (scheduler) {
+    scheduler->restoreState(s.threads);
+  }
+  markProgress();
+  spinWatches.clear();
+  rebuildParked();
+  stopped.clear();
+  staleConditions();
+  replay.reset();
+  if (raceDetector) {
+    // Clocks describe the abandoned history; start over from here
+    raceDetector->clear();
+    racesReported = 0;
+  }
+  state = s.state;
+  restartHistory();
+}
+
+runtime::Session RuntimeService::saveSession() const {
+  runtime::Session s;
+  s.image = program.codeImage();
+  s.memory = program.memory();
+  if (scheduler) {
+    s.threads = scheduler->saveState();
+    s.randomState = scheduler->saveRandomState();
+  }
+  if (interpreter) {
+    s.input = interpreter->saveInput();
+  }
+  s.stepCount = stepCount;
+  s.halted = state == RuntimeState::Halted;
+  return s;
+}
+
+RuntimeResult RuntimeService::restoreSession(const runtime::Session& s) {
+  if (!scheduler || !interpreter || !s.image ||
+      s.memory.size() != s.image->dataSize()) {
+    nsbaci::Error err;
+    err.basic.severity = nsbaci::types::ErrSeverity::Error;
+    err.basic.message = !scheduler || !interpreter
+                            ? "Runtime not properly initialized"
+                            : "Session memory does not match its code";
+    err.basic.type = nsbaci::types::ErrType::unknown;
+    err.payload = nsbaci::types::RuntimeError{};
+    return RuntimeResult(std::move(err));
+  }
+
+  // Start from a clean load, then overwrite what the run changed
+  loadProgram(s.image);
+  program.restoreMemory(s.memory);
+  staleConditions();
+  scheduler->restoreState(s.threads);
+  bool seeded = scheduler->restoreRandomState(s.randomState);
+  interpreter->restoreInput(s.input);
+  stepCount = s.stepCount;
+  spinWatches.clear();
+  rebuildParked();
+  state = s.halted ? RuntimeState::Halted : RuntimeState::Paused;
+  restartHistory();
+
+  if (!seeded) {
+    nsbaci::Error err;
+    err.basic.severity = nsbaci::types::ErrSeverity::Warning;
+    err.basic.message =
+        "Session was saved by another scheduler; its random state was not "
+        "restored";
+    err.basic.type = nsbaci::types::ErrType::unknown;
+    err.payload = nsbaci::types::RuntimeError{};
+    return RuntimeResult(std::move(err));
+  }
+  return RuntimeResult();
+}
+
 void RuntimeService::provideInput(const std::string& input) {
   if (interpreter) {
     interpreter->provideInput(input);
   }
+  if (recording) {
+    replayLog.recordInput(input);
+  }
+  markProgress();
   // Note: Thread stays in Running state during I/O wait, so no need to unblock
 }
 
@@ -159,8 +670,791 @@ bool RuntimeService::isWaitingForInput() const {
 }
 
 void RuntimeService::setOutputCallback(runtime::OutputCallback callback) {
+  outputCallback = std::move(callback);
   if (interpreter) {
-    interpreter->setOutputCallback(std::move(callback));
+    interpreter->setOutputCallback(outputCallback);
+  }
+}
+
+void RuntimeService::setRaceDetection(bool enabled) {
+  if (enabled == (raceDetector != nullptr)) {
+    return;
+  }
+  raceDetector = enabled ? std::make_unique<runtime::RaceDetector>() : nullptr;
+  racesReported = 0;
+  if (interpreter) {
+    interpreter->setRaceDetector(raceDetector.get());
+  }
+}
+
+bool RuntimeService::isRaceDetectionEnabled() const {
+  return raceDetector != nullptr;
+}
+
+const std::vector<runtime::Race>& RuntimeService::getRaces() const {
+  static const std::vector<runtime::Race> empty;
+  if (!raceDetector) {
+    return empty;
+  }
+  return raceDetector->races();
+}
+
+void RuntimeService::setSpinParking(bool enabled) {
+  bool changed = enabled != spinParking;
+  spinParking = enabled;
+  if (!enabled && scheduler) {
+    for (const auto& p : parked) {
+      scheduler->unblock(p.id);
+    }
+  }
+  if (!enabled) {
+    parked.clear();
+  }
+  spinWatches.clear();
+  if (changed) {
+    // Steps recorded with the old setting would not re-execute the same
+    replay.reset();
+    restartHistory();
+  }
+}
+
+const SpinStats& RuntimeService::getSpinStats() const { return spinStats; }
+
+void RuntimeService::setProfiling(bool enabled) {
+  if (!enabled) {
+    profiler.reset();
+  } else if (!profiler) {
+    profiler = std::make_unique<runtime::Profiler>();
+    profiler->reset(program.instructionCount());
+  }
+}
+
+void RuntimeService::setContentionProfiling(bool enabled) {
+  if (!enabled) {
+    contention.reset();
+  } else if (!contention) {
+    contention = std::make_unique<runtime::ContentionProfiler>();
+  }
+}
+
+bool RuntimeService::isContentionProfilingEnabled() const {
+  return contention != nullptr;
+}
+
+runtime::ContentionReport RuntimeService::getContentionReport(
+    size_t topSites) const {
+  return contention ? contention->report(stepCount, topSites)
+                    : runtime::ContentionReport{};
+}
+
+void RuntimeService::startTrace(runtime::TraceWriter::Sink sink) {
+  stopTrace();
+  tracer = std::make_unique<runtime::TraceWriter>(std::move(sink));
+  tracer->restart(program.codeImage(), stepCount);
+}
+
+bool RuntimeService::stopTrace() {
+  if (!tracer) {
+    return true;
+  }
+  bool ok = tracer->finish(stepCount);
+  tracer.reset();
+  return ok;
+}
+
+bool RuntimeService::isTracing() const { return tracer != nullptr; }
+
+void RuntimeService::startBinaryTrace(runtime::BinaryTraceWriter::Sink sink) {
+  stopBinaryTrace();
+  binaryTracer = std::make_unique<runtime::BinaryTraceWriter>(std::move(sink));
+}
+
+bool RuntimeService::stopBinaryTrace() {
+  if (!binaryTracer) {
+    return true;
+  }
+  bool ok = binaryTracer->finish();
+  binaryTracer.reset();
+  return ok;
+}
+
+bool RuntimeService::isBinaryTracing() const {
+  return binaryTracer != nullptr;
+}
+
+const runtime::RuntimeStats& RuntimeService::getStats() const {
+  return stats.get();
+}
+
+bool RuntimeService::isProfilingEnabled() const { return profiler != nullptr; }
+
+const runtime::Profiler& RuntimeService::getProfile() const {
+  static const runtime::Profiler empty;
+  return profiler ? *profiler : empty;
+}
+
+uint64_t RuntimeService::readsFingerprint(
+    const runtime::SpinLoop& loop) const {
+  const auto& mem = program.memory();
+  uint64_t h = 0;
+  for (uint32_t addr : loop.reads) {
+    int32_t value = addr < mem.size() ? mem[addr] : 0;
+    h ^= runtime::zobrist::memoryKey(addr, value);
+  }
+  return h;
+}
+
+void RuntimeService::checkSpin(runtime::Thread& thread, uint32_t jumpPc,
+                               RuntimeResult& result) {
+  const runtime::SpinLoop* loop = program.codeImage()->spinLoop(jumpPc);
+  if (!loop) {
+    return;
+  }
+
+  size_t id = static_cast<size_t>(thread.getId());
+  if (spinWatches.size() <= id) {
+    spinWatches.resize(id + 1);
+  }
+  SpinWatch& watch = spinWatches[id];
+  if (undoOpen && !undoPending.spun) {
+    undoPending.spun = true;
+    undoPending.spinJumpPc = watch.jumpPc;
+    undoPending.spinThreadHash = watch.threadHash;
+    undoPending.spinReadsHash = watch.readsHash;
+  }
+  uint64_t threadHash = thread.fingerprint();
+  uint64_t readsHash = readsFingerprint(*loop);
+
+  if (watch.jumpPc != jumpPc || watch.threadHash != threadHash ||
+      watch.readsHash != readsHash) {
+    // First time round with these values; one more identical pass proves
+    // the iteration has no effect
+    watch = {jumpPc, threadHash, readsHash};
+    return;
+  }
+
+  watch = SpinWatch{};
+  ++spinStats.parks;
+  parked.push_back({thread.getId(), jumpPc, readsHash});
+  parkedMemoryHash = program.fingerprint();
+  auto deadlock =
+      scheduler->blockCurrentOn({nsbaci::types::ResourceKind::Spin, jumpPc});
+  if (deadlock.has_value()) {
+    result.deadlock = std::move(deadlock);
+    if (result.deadlock->global) {
+      state = RuntimeState::Halted;
+      result.halted = true;
+    }
+  }
+}
+
+void RuntimeService::wakeParked() {
+  const runtime::CodeImage& image = *program.codeImage();
+  for (size_t i = 0; i < parked.size();) {
+    const runtime::SpinLoop* loop = image.spinLoop(parked[i].jumpPc);
+    if (loop && readsFingerprint(*loop) == parked[i].readsHash) {
+      ++i;
+      continue;
+    }
+    scheduler->unblock(parked[i].id);
+    ++spinStats.wakeups;
+    parked.erase(parked.begin() + i);  // Keep wakeups in parking order
+  }
+  parkedMemoryHash = program.fingerprint();
+}
+
+void RuntimeService::rebuildParked() {
+  parked.clear();
+  parkedMemoryHash = program.fingerprint();
+  if (!scheduler) {
+    return;
+  }
+
+  const runtime::CodeImage* image = program.codeImage().get();
+  const runtime::WaitForGraph& graph = scheduler->waitForGraph();
+  for (const auto& t : scheduler->getThreads()) {
+    const runtime::WaitEdge* edge = graph.edgeOf(t.getId());
+    if (!edge || edge->resource.kind != nsbaci::types::ResourceKind::Spin) {
+      continue;
+    }
+    const runtime::SpinLoop* loop =
+        image ? image->spinLoop(edge->resource.address) : nullptr;
+    parked.push_back({t.getId(), edge->resource.address,
+                      loop ? readsFingerprint(*loop) : 0});
+  }
+}
+
+void RuntimeService::setRecording(bool enabled) {
+  if (enabled && !recording) {
+    replayLog.clear();
+    restartHistory();  // Stepping back re-executes from the log
+  }
+  // Reverse stepping needs the log to rebuild old steps
+  recording = enabled || undoLimit > 0;
+}
+
+bool RuntimeService::isRecording() const { return recording; }
+
+const runtime::ReplayLog& RuntimeService::getReplayLog() const {
+  return replayLog;
+}
+
+void RuntimeService::startReplay(runtime::ReplayLog log) {
+  reset();
+  if (!log.schedule().empty()) {
+    replay.emplace(std::move(log));
+  }
+}
+
+bool RuntimeService::isReplaying() const { return replay.has_value(); }
+
+void RuntimeService::setUndoJournalLimit(size_t bytes) {
+  bool wasOn = undoLimit > 0;
+  undoLimit = bytes;
+  undoJournal.setLimit(bytes / 2);
+  if (bytes == 0) {
+    restartHistory();
+    return;
+  }
+  if (!recording) {
+    setRecording(true);  // Starts the history
+  } else if (!wasOn) {
+    restartHistory();
+  }
+}
+
+bool RuntimeService::canStepBack() const {
+  if (undoLimit == 0 || replayLog.picks() == 0) {
+    return false;
+  }
+  if (!undoJournal.empty()) {
+    return true;
+  }
+  return !checkpoints.empty() && checkpoints.front().picks < replayLog.picks();
+}
+
+RuntimeResult RuntimeService::stepBack() {
+  if (!scheduler || !interpreter) {
+    nsbaci::Error err;
+    err.basic.severity = nsbaci::types::ErrSeverity::Error;
+    err.basic.message = "Runtime not properly initialized";
+    err.basic.type = nsbaci::types::ErrType::unknown;
+    err.payload = nsbaci::types::RuntimeError{};
+    return RuntimeResult(std::move(err));
+  }
+
+  if (!canStepBack() || (undoJournal.empty() && !rebuildJournal())) {
+    nsbaci::Error err;
+    err.basic.severity = nsbaci::types::ErrSeverity::Warning;
+    err.basic.message = undoLimit == 0 ? "Reverse stepping is off"
+                                       : "No earlier step to go back to";
+    err.basic.type = nsbaci::types::ErrType::unknown;
+    err.payload = nsbaci::types::RuntimeError{};
+    return RuntimeResult(std::move(err));
+  }
+
+  // The undone step stays on the timeline, ready to be redone
+  if (!replay) {
+    replay.emplace(replayLog);
+  }
+  runtime::UndoRecord record = *undoJournal.pop();
+  undo(record);
+  undoneThread = record.thread;
+  replay->seek(record.picks, record.inputs);
+  return RuntimeResult();
+}
+
+RuntimeResult RuntimeService::runBackward(
+    const std::vector<uint32_t>& stopAt, size_t maxSteps) {
+  RuntimeResult result;
+  size_t steps = 0;
+  while (canStepBack()) {
+    result = stepBack();
+    if (!result.ok) {
+      break;
+    }
+
+    // Stop with the breakpoint's instruction about to run again
+    const runtime::Thread* t = scheduler->findThread(undoneThread);
+    if (t && std::find(stopAt.begin(), stopAt.end(), t->getPC()) !=
+                 stopAt.end()) {
+      break;
+    }
+    ++steps;
+    if (maxSteps > 0 && steps >= maxSteps) {
+      break;
+    }
+  }
+  return result;
+}
+
+void RuntimeService::beginUndo() {
+  if (undoLimit == 0 || !scheduler || !interpreter) {
+    return;
+  }
+  undoPending.writes.clear();
+  undoPending.stack.clear();
+  undoPending.queues = scheduler->saveQueues();
+  undoPending.input = interpreter->saveInput();
+  undoPending.stepCount = stepCount;
+  undoPending.picks = replayLog.picks();
+  undoPending.inputs = replayLog.inputs().size();
+  undoPending.spun = false;
+  undoOnTimeline = replay.has_value();
+  undoOpen = true;
+}
+
+void RuntimeService::finishUndo() {
+  if (!undoOpen) {
+    return;
+  }
+  undoOpen = false;
+  if (replayLog.picks() == undoPending.picks) {
+    return;  // No thread was picked, nothing changed
+  }
+
+  // A step off the timeline starts a new future; the old one's checkpoints
+  // no longer apply
+  if (!undoOnTimeline) {
+    while (!checkpoints.empty() &&
+           checkpoints.back().picks > undoPending.picks) {
+      checkpointBytes -= checkpoints.back().bytes;
+      checkpoints.pop_back();
+    }
+  }
+
+  undoJournal.push(std::move(undoPending));
+  undoPending = runtime::UndoRecord{};
+  uint64_t now = replayLog.picks();
+  if (checkpoints.empty() || (checkpoints.back().picks < now &&
+                              now >= checkpoints.back().picks +
+                                         checkpointInterval)) {
+    takeCheckpoint();
+  }
+}
+
+void RuntimeService::undo(const runtime::UndoRecord& record) {
+  for (auto it = record.writes.rbegin(); it != record.writes.rend(); ++it) {
+    program.writeMemory(it->addr, it->old);
+  }
+
+  scheduler->restoreQueues(record.queues);
+  if (runtime::Thread* t = scheduler->findThread(record.thread)) {
+    // Pop what was pushed and push back what was popped, so the stack
+    // fingerprint follows along
+    for (auto it = record.stack.rbegin(); it != record.stack.rend(); ++it) {
+      if (it->push) {
+        t->pop();
+      } else {
+        t->push(it->value);
+      }
+    }
+    t->setPC(record.pc);
+    t->setBP(record.bp);
+    t->setSP(record.sp);
+  }
+  if (record.spun && record.thread < spinWatches.size()) {
+    spinWatches[record.thread] = {record.spinJumpPc, record.spinThreadHash,
+                                  record.spinReadsHash};
+  }
+
+  interpreter->restoreInput(record.input);
+  stepCount = record.stepCount;
+  replayLog.truncate(record.picks, record.inputs);
+  if (raceDetector) {
+    raceDetector->clear();
+    racesReported = 0;
+  }
+  markProgress();
+  rebuildParked();
+  stopped.clear();
+  staleConditions();
+  state = RuntimeState::Paused;
+}
+
+void RuntimeService::takeCheckpoint() {
+  Checkpoint cp;
+  cp.memory = runtime::MemorySnapshot(
+      program.memory(),
+      checkpoints.empty() ? nullptr : &checkpoints.back().memory);
+  cp.threads = scheduler->saveState();
+  cp.input = interpreter->saveInput();
+  cp.spinWatches = spinWatches;
+  cp.stepCount = stepCount;
+  cp.picks = replayLog.picks();
+  cp.inputs = replayLog.inputs().size();
+  cp.bytes = sizeof(Checkpoint) + cp.memory.bytes() +
+             cp.spinWatches.size() * sizeof(SpinWatch);
+  for (const auto& t : cp.threads.threads) {
+    cp.bytes += sizeof(runtime::Thread) + t.getStack().size() * sizeof(int32_t);
+  }
+
+  if (!checkpoints.empty() && checkpoints.back().picks == cp.picks) {
+    checkpointBytes -= checkpoints.back().bytes;
+    checkpoints.pop_back();
+  }
+  checkpointBytes += cp.bytes;
+  checkpoints.push_back(std::move(cp));
+
+  // Over budget: keep the first and every other one after it, and take
+  // them half as often from now on
+  while (checkpointBytes > undoLimit / 2 && checkpoints.size() > 1) {
+    std::vector<Checkpoint> kept;
+    checkpointBytes = 0;
+    for (size_t i = 0; i < checkpoints.size(); i += 2) {
+      checkpointBytes += checkpoints[i].bytes;
+      kept.push_back(std::move(checkpoints[i]));
+    }
+    checkpoints = std::move(kept);
+    checkpointInterval *= 2;
+  }
+}
+
+void RuntimeService::restoreCheckpoint(const Checkpoint& cp) {
+  program.restoreMemory(cp.memory.restore());
+  scheduler->restoreState(cp.threads);
+  interpreter->restoreInput(cp.input);
+  stepCount = cp.stepCount;
+  replayLog.truncate(cp.picks, cp.inputs);
+  undoJournal.clear();
+  if (raceDetector) {
+    raceDetector->clear();
+    racesReported = 0;
+  }
+  markProgress();
+  spinWatches = cp.spinWatches;
+  rebuildParked();
+  stopped.clear();
+  staleConditions();
+  state = RuntimeState::Paused;
+}
+
+bool RuntimeService::rebuildJournal() {
+  uint64_t target = replayLog.picks();
+  auto cp = checkpoints.rbegin();
+  while (cp != checkpoints.rend() && cp->picks >= target) {
+    ++cp;
+  }
+  if (cp == checkpoints.rend()) {
+    return false;
+  }
+  return fastForward(&*cp, target) && !undoJournal.empty();
+}
+
+bool RuntimeService::fastForward(const Checkpoint* from, uint64_t target) {
+  if (from) {
+    // Leaving the present: what lies ahead becomes the timeline to follow
+    if (!replay) {
+      replay.emplace(replayLog);
+    }
+    // Jumping ahead: the steps skipped join the record
+    replayLog.extendTo(replay->getLog(), from->picks, from->inputs);
+    restoreCheckpoint(*from);
+    replay->seek(from->picks, from->inputs);
+  }
+
+  // Threads park as they did when the steps were recorded, since the spin
+  // watches and parked threads were restored along with the state; output
+  // was already shown once
+  stopsArmed = false;
+  interpreter->setOutputCallback(nullptr);
+
+  while (replay && replayLog.picks() < target) {
+    RuntimeResult r = step();
+    if (!r.ok || r.halted) {
+      break;
+    }
+  }
+
+  stopsArmed = true;
+  interpreter->setOutputCallback(outputCallback);
+  state = RuntimeState::Paused;
+  return replayLog.picks() == target;
+}
+
+void RuntimeService::restartHistory() {
+  undoJournal.clear();
+  undoPending = runtime::UndoRecord{};
+  undoOpen = false;
+  checkpoints.clear();
+  checkpointBytes = 0;
+  checkpointInterval = checkpointEvery;
+  if (undoLimit > 0 && scheduler && interpreter) {
+    takeCheckpoint();
+  }
+}
+
+void RuntimeService::setCheckpointInterval(uint64_t picks) {
+  checkpointEvery = picks > 0 ? picks : 1;
+  checkpointInterval = checkpointEvery;
+}
+
+uint64_t RuntimeService::timelinePosition() const { return replayLog.picks(); }
+
+uint64_t RuntimeService::timelineLength() const {
+  return replay ? replay->getLog().picks() : replayLog.picks();
+}
+
+RuntimeResult RuntimeService::seekTo(uint64_t position) {
+  if (!scheduler || !interpreter || undoLimit == 0) {
+    nsbaci::Error err;
+    err.basic.severity = nsbaci::types::ErrSeverity::Warning;
+    err.basic.message = "Seeking needs reverse stepping to be on";
+    err.basic.type = nsbaci::types::ErrType::unknown;
+    err.payload = nsbaci::types::RuntimeError{};
+    return RuntimeResult(std::move(err));
+  }
+
+  position = std::min(position, timelineLength());
+  uint64_t now = replayLog.picks();
+
+  // Close behind: the journal is cheaper than any checkpoint
+  if (position < now && now - position <= undoJournal.size()) {
+    while (replayLog.picks() > position) {
+      RuntimeResult r = stepBack();
+      if (!r.ok) {
+        return r;
+      }
+    }
+    return RuntimeResult();
+  }
+
+  // Restore the nearest checkpoint unless going on from here is closer
+  const Checkpoint* from = nullptr;
+  for (auto cp = checkpoints.rbegin(); cp != checkpoints.rend(); ++cp) {
+    if (cp->picks <= position) {
+      if (position < now || cp->picks > now) {
+        from = &*cp;
+      }
+      break;
+    }
+  }
+
+  if ((position < now && !from) || !fastForward(from, position)) {
+    nsbaci::Error err;
+    err.basic.severity = nsbaci::types::ErrSeverity::Error;
+    err.basic.message =
+        "Could not reach step " + std::to_string(position) + " of the run";
+    err.basic.type = nsbaci::types::ErrType::unknown;
+    err.payload = nsbaci::types::RuntimeError{};
+    return RuntimeResult(std::move(err));
+  }
+  return RuntimeResult();
+}
+
+RuntimeResult RuntimeService::setBreakpoint(
+    uint32_t pc, std::vector<nsbaci::types::ThreadID> threads,
+    std::optional<Condition> condition) {
+  if (condition && !isPureExpression(condition->code)) {
+    return RuntimeResult(conditionError(*condition));
+  }
+  breakpoints[pc] = std::move(threads);
+  if (condition) {
+    breakpointConditions[pc] = CachedCondition{std::move(*condition)};
+  } else {
+    breakpointConditions.erase(pc);
+  }
+  program.setTraps(breakpointAddresses());
+  applyWatchpoints();
+  return RuntimeResult();
+}
+
+void RuntimeService::clearBreakpoint(uint32_t pc) {
+  if (breakpoints.erase(pc) > 0) {
+    program.setTraps(breakpointAddresses());
+  }
+  if (breakpointConditions.erase(pc) > 0) {
+    applyWatchpoints();
+  }
+}
+
+void RuntimeService::clearBreakpoints() {
+  breakpoints.clear();
+  breakpointConditions.clear();
+  program.setTraps({});
+  applyWatchpoints();
+}
+
+const std::map<uint32_t, std::vector<nsbaci::types::ThreadID>>&
+RuntimeService::getBreakpoints() const {
+  return breakpoints;
+}
+
+std::vector<uint32_t> RuntimeService::breakpointAddresses() const {
+  std::vector<uint32_t> pcs;
+  pcs.reserve(breakpoints.size());
+  for (const auto& [pc, threads] : breakpoints) {
+    pcs.push_back(pc);
+  }
+  return pcs;
+}
+
+const Condition* RuntimeService::getBreakpointCondition(uint32_t pc) const {
+  auto it = breakpointConditions.find(pc);
+  return it != breakpointConditions.end() ? &it->second.condition : nullptr;
+}
+
+bool RuntimeService::stopsAt(const runtime::Thread& thread, uint32_t pc) {
+  // Resuming: the thread already stopped here and goes on this time
+  auto resumed = std::find_if(
+      stopped.begin(), stopped.end(), [&](const BreakpointHit& hit) {
+        return hit.thread == thread.getId() && hit.pc == pc;
+      });
+  if (resumed != stopped.end()) {
+    return false;
+  }
+
+  auto it = breakpoints.find(pc);
+  if (!stopsArmed || it == breakpoints.end()) {
+    return false;
+  }
+  const auto& only = it->second;
+  if (!only.empty() &&
+      std::find(only.begin(), only.end(), thread.getId()) == only.end()) {
+    return false;
+  }
+  auto cond = breakpointConditions.find(pc);
+  return cond == breakpointConditions.end() || conditionHolds(cond->second);
+}
+
+void RuntimeService::setWatchpoint(Watchpoint watch) {
+  watchpoints[watch.addr] = std::move(watch);
+  applyWatchpoints();
+}
+
+void RuntimeService::clearWatchpoint(nsbaci::types::MemoryAddr addr) {
+  if (watchpoints.erase(addr) > 0) {
+    applyWatchpoints();
+  }
+}
+
+void RuntimeService::clearWatchpoints() {
+  watchpoints.clear();
+  applyWatchpoints();
+}
+
+const std::map<nsbaci::types::MemoryAddr, Watchpoint>&
+RuntimeService::getWatchpoints() const {
+  return watchpoints;
+}
+
+void RuntimeService::applyWatchpoints() {
+  program.clearWatches();
+  for (const auto& [addr, watch] : watchpoints) {
+    program.watch(addr, watch.count);
+  }
+  for (const auto& [pc, cached] : breakpointConditions) {
+    for (nsbaci::types::MemoryAddr addr : cached.condition.reads) {
+      program.watch(addr, 1);
+    }
+  }
+  for (const auto& [text, invariant] : invariants) {
+    for (nsbaci::types::MemoryAddr addr : invariant.reads) {
+      program.watch(addr, 1);
+    }
+  }
+  watching = !watchpoints.empty() || !breakpointConditions.empty() ||
+             !invariants.empty();
+}
+
+void RuntimeService::checkWatches(const runtime::Thread& thread, uint32_t pc,
+                                  RuntimeResult& result) {
+  if (!stopsArmed) {
+    return;
+  }
+  for (const auto& write : watchWrites) {
+    int32_t now = program.memory()[write.addr];
+    // Watchpoints are few; any of them may cover the word
+    for (const auto& [addr, watch] : watchpoints) {
+      if (write.addr < addr || write.addr - addr >= watch.count ||
+          (watch.onChange && write.old == now)) {
+        continue;
+      }
+      const auto& only = watch.threads;
+      if (only.empty() || std::find(only.begin(), only.end(),
+                                    thread.getId()) != only.end()) {
+        result.watchpoints.push_back(
+            {thread.getId(), pc, write.addr, write.old, now});
+        break;
+      }
+    }
+  }
+}
+
+RuntimeResult RuntimeService::setInvariant(Condition invariant) {
+  if (!isPureExpression(invariant.code)) {
+    return RuntimeResult(conditionError(invariant));
+  }
+  std::string text = invariant.text;
+  invariants[std::move(text)] = std::move(invariant);
+  applyWatchpoints();
+  return RuntimeResult();
+}
+
+void RuntimeService::clearInvariant(const std::string& text) {
+  if (invariants.erase(text) > 0) {
+    applyWatchpoints();
+  }
+}
+
+void RuntimeService::clearInvariants() {
+  invariants.clear();
+  applyWatchpoints();
+}
+
+const std::map<std::string, Condition>& RuntimeService::getInvariants()
+    const {
+  return invariants;
+}
+
+bool RuntimeService::conditionHolds(CachedCondition& cached) {
+  if (cached.stale) {
+    auto value = interpreter->evaluate(cached.condition.code, program);
+    cached.holds = !value.ok || value.value != 0;
+    cached.stale = false;
+  }
+  return cached.holds;
+}
+
+void RuntimeService::staleConditions() {
+  for (auto& [pc, cached] : breakpointConditions) {
+    cached.stale = true;
+  }
+}
+
+void RuntimeService::checkConditions(const runtime::Thread& thread,
+                                     uint32_t pc, RuntimeResult& result) {
+  // Reads are sorted; a step writes a word or two
+  auto reads = [this](const Condition& condition) {
+    for (const auto& write : watchWrites) {
+      if (std::binary_search(condition.reads.begin(), condition.reads.end(),
+                             write.addr)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  for (auto& [at, cached] : breakpointConditions) {
+    if (!cached.stale && reads(cached.condition)) {
+      cached.stale = true;
+    }
+  }
+
+  if (!stopsArmed) {
+    return;
+  }
+  for (const auto& [text, invariant] : invariants) {
+    if (!reads(invariant)) {
+      continue;
+    }
+    auto value = interpreter->evaluate(invariant.code, program);
+    if (!value.ok) {
+      result.invariants.push_back(
+          {text, thread.getId(), pc, value.errors.front().basic.message});
+    } else if (value.value == 0) {
+      result.invariants.push_back({text, thread.getId(), pc, {}});
+    }
   }
 }
 
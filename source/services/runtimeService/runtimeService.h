@@ -15,12 +15,28 @@
 #ifndef NSBACI_RUNTIMESERVICE_H
 #define NSBACI_RUNTIMESERVICE_H
 
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include "baseResult.h"
+#include "binaryTraceWriter.h"
+#include "contentionProfiler.h"
+#include "instruction.h"
 #include "interpreter.h"
+#include "memorySnapshot.h"
+#include "profiler.h"
 #include "program.h"
+#include "raceDetector.h"
+#include "replayLog.h"
+#include "runtimeStats.h"
 #include "scheduler.h"
+#include "session.h"
+#include "traceWriter.h"
+#include "undoJournal.h"
 
 /**
  * @namespace nsbaci::services
@@ -28,6 +44,63 @@
  */
 namespace nsbaci::services {
 
+/**
+ * @struct BreakpointHit
+ * @brief A thread stopped at a breakpoint, before executing its instruction.
+ */
+struct BreakpointHit {
+  nsbaci::types::ThreadID thread = 0;  ///< Thread that stopped.
+  uint32_t pc = 0;                     ///< Breakpoint address.
+};
+
+/**
+ * @struct Watchpoint
+ * @brief A block of global memory to stop on writes to.
+ */
+struct Watchpoint {
+  nsbaci::types::MemoryAddr addr = 0;  ///< First word watched.
+  size_t count = 1;                    ///< Number of words watched.
+  /// @brief Threads whose writes stop, or empty for every thread
+  std::vector<nsbaci::types::ThreadID> threads;
+  bool onChange = false;  ///< Ignore writes of the value already there.
+};
+
+/**
+ * @struct WatchpointHit
+ * @brief A write to a watched word, after the instruction that made it.
+ */
+struct WatchpointHit {
+  nsbaci::types::ThreadID thread = 0;  ///< Thread that wrote.
+  uint32_t pc = 0;                     ///< Instruction that wrote.
+  nsbaci::types::MemoryAddr addr = 0;  ///< Word written.
+  int32_t oldValue = 0;                ///< Value before the write.
+  int32_t newValue = 0;                ///< Value after the instruction.
+};
+
+/**
+ * @struct Condition
+ * @brief An nsbaci expression over global memory, compiled for the runtime.
+ *
+ * Built from CompilerService::compileExpression(). Nonzero is true.
+ */
+struct Condition {
+  std::string text;                          ///< Source, for reports.
+  nsbaci::compiler::InstructionStream code;  ///< Pure expression code.
+  /// @brief Words the value depends on; see ExpressionResult::reads
+  std::vector<nsbaci::types::MemoryAddr> reads;
+};
+
+/**
+ * @struct InvariantFailure
+ * @brief An invariant left false by a step, after the instruction.
+ */
+struct InvariantFailure {
+  std::string text;                    ///< The invariant.
+  nsbaci::types::ThreadID thread = 0;  ///< Thread that broke it.
+  uint32_t pc = 0;                     ///< Instruction that broke it.
+  std::string error;  ///< Why it could not be evaluated, if it could not.
+};
+
 /**
  * @struct RuntimeResult
  * @brief Result of a runtime operation (step, run, etc.).
@@ -60,6 +133,18 @@ struct RuntimeResult : nsbaci::BaseResult {
   bool needsInput = false;  ///< True if waiting for user input
   std::string inputPrompt;  ///< Prompt to show for input
   std::string output;       ///< Output produced by this step
+  bool livelock = false;    ///< True if states keep repeating with no progress
+  /// @brief Deadlock formed by this step. A global one also halts the program
+  std::optional<runtime::DeadlockReport> deadlock;
+  /// @brief Data races first found on this step (race detection only)
+  std::vector<runtime::Race> races;
+  bool replayEnded = false;  ///< True if this step took a replay's last pick
+  /// @brief Breakpoint this step stopped at; nothing was executed
+  std::optional<BreakpointHit> breakpoint;
+  /// @brief Watched words this step wrote
+  std::vector<WatchpointHit> watchpoints;
+  /// @brief Invariants this step left false
+  std::vector<InvariantFailure> invariants;
 };
 
 /**
@@ -79,6 +164,31 @@ enum class RuntimeState {
   Halted    ///< Program has finished execution.
 };
 
+/**
+ * @struct ExecutionState
+ * @brief Mutable state of one execution, separate from the shared code.
+ *
+ * Global memory plus every thread and scheduler queue. Saving and restoring
+ * it costs O(memory size + stack sizes); the CodeImage is never copied.
+ */
+struct ExecutionState {
+  nsbaci::types::Memory memory;             ///< Global memory contents.
+  runtime::SchedulerState threads;          ///< Threads and scheduler queues.
+  RuntimeState state = RuntimeState::Idle;  ///< Runtime lifecycle state.
+};
+
+/**
+ * @struct SpinStats
+ * @brief What parking busy-waiting threads saved.
+ */
+struct SpinStats {
+  uint64_t parks = 0;    ///< Times a busy-waiting thread was parked.
+  uint64_t wakeups = 0;  ///< Times a write woke a parked thread.
+  /// @brief Sum over steps of the number of parked threads: spin iterations
+  /// the scheduler could otherwise have dispatched.
+  uint64_t parkedSteps = 0;
+};
+
 /**
  * @class RuntimeService
  * @brief Service that manages program execution.
@@ -144,10 +254,22 @@ class RuntimeService {
   void loadProgram(runtime::Program&& p);
 
   /**
-   * @brief Resets the runtime to initial state.
+   * @brief Loads a shared code image for execution.
+   *
+   * Like loadProgram(), but the instructions and symbols are shared with
+   * every other service running the same image; only memory is allocated.
    *
-   * Clears all threads, resets memory, and sets state to Idle.
-   * The program must be reloaded before execution can continue.
+   * @param image The compiled code to run.
+   */
+  void loadProgram(std::shared_ptr<const runtime::CodeImage> image);
+
+  /**
+   * @brief Resets the runtime to the state right after loadProgram().
+   *
+   * Restores global memory from the program's initial image, drops pending
+   * input and recreates the main thread from a template built at load time.
+   * Nothing is recompiled, so repeated runs of the same program are cheap.
+   * Leaves the state as Paused.
    */
   void reset();
 
@@ -164,7 +286,8 @@ class RuntimeService {
   /**
    * @brief Executes a single instruction for a specific thread.
    *
-   * Allows targeted debugging by stepping only the specified thread.
+   * Allows targeted debugging by stepping only the specified thread. The
+   * scheduler's policy is bypassed for this step only.
    *
    * @param threadId The ID of the thread to step.
    * @return RuntimeResult with execution outcome.
@@ -179,6 +302,7 @@ class RuntimeService {
    * - An error occurs
    * - The maximum step count is reached
    * - Input is required
+   * - A replay reaches the end of its log
    *
    * @param maxSteps Maximum instructions to execute (0 = unlimited).
    * @return RuntimeResult with final execution state.
@@ -204,6 +328,33 @@ class RuntimeService {
    */
   bool isHalted() const;
 
+  /**
+   * @brief Gets the number of instructions executed since the last reset.
+   * @return Executed instruction count.
+   */
+  uint64_t getStepCount() const;
+
+  /**
+   * @brief Zobrist fingerprint of memory and every thread.
+   *
+   * Maintained incrementally, so this costs O(number of threads).
+   *
+   * @return 64-bit fingerprint of the current execution state.
+   */
+  uint64_t fingerprint() const;
+
+  /**
+   * @brief Sets how many revisited states make a probable livelock.
+   *
+   * After every step the state fingerprint is looked up in a small
+   * direct-mapped table of recent states. Output and input count as
+   * progress and start a new window. Once a window collects this many
+   * revisits, the step reports RuntimeResult::livelock and run() pauses.
+   *
+   * @param threshold Revisits to report, or 0 to turn detection off.
+   */
+  void setLivelockThreshold(uint64_t threshold);
+
   /**
    * @brief Gets the number of active threads.
    * @return Count of threads in the scheduler.
@@ -223,6 +374,58 @@ class RuntimeService {
    */
   const runtime::Program& getProgram() const;
 
+  /**
+   * @brief Gets the code image of the loaded program.
+   * @return Shared pointer that other services can load to run the same code.
+   */
+  std::shared_ptr<const runtime::CodeImage> getCodeImage() const;
+
+  /**
+   * @brief Captures the current execution state.
+   *
+   * Pending input is not part of the snapshot; restoring drops it.
+   *
+   * @return Memory, threads and runtime state.
+   */
+  ExecutionState saveState() const;
+
+  /**
+   * @brief Restores a state previously returned by saveState().
+   *
+   * The state must come from a service running the same code image.
+   *
+   * @param s The state to restore.
+   * @throws std::invalid_argument if the memory size does not match.
+   */
+  void restoreState(const ExecutionState& s);
+
+  /**
+   * @brief Captures everything needed to resume the run elsewhere.
+   *
+   * Unlike saveState(), the session also holds the code image, the pending
+   * input, the step count and the scheduler's random state, so
+   * Session::serialize() can write it to disk and another process can
+   * carry on exactly where this one stopped.
+   *
+   * @return The complete session.
+   */
+  runtime::Session saveSession() const;
+
+  /**
+   * @brief Loads the code of a session and resumes it.
+   *
+   * The recorded log, races, busy-wait statistics and history start over
+   * at the restored step; the step count carries on. If the scheduler is
+   * of a different kind than the one that saved the session, it keeps its
+   * own random state and the schedule from here on differs.
+   *
+   * @param s Session from saveSession() or Session::parse().
+   * @return RuntimeResult with an error if the session has no code or its
+   * memory does not fit the code, or a warning if the random state was not
+   * restored. The session is resumed in the latter case.
+   */
+  RuntimeResult restoreSession(const runtime::Session& s);
+
   /**
    * @brief Provides input to the runtime.
    *
@@ -249,7 +452,512 @@ class RuntimeService {
    */
   void setOutputCallback(runtime::OutputCallback callback);
 
+  /**
+   * @brief Turns data race detection on or off.
+   *
+   * While on, the interpreter reports every global memory access and every
+   * semaphore and monitor operation to a RaceDetector, and each step lists
+   * the races it found in RuntimeResult::races. Turning it off drops the
+   * detector and everything it found.
+   *
+   * @param enabled True to detect races.
+   */
+  void setRaceDetection(bool enabled);
+
+  /**
+   * @brief Checks whether data race detection is on.
+   * @return True if a race detector is attached.
+   */
+  bool isRaceDetectionEnabled() const;
+
+  /**
+   * @brief Gets every race found since the last reset.
+   * @return Races in discovery order; empty while detection is off.
+   */
+  const std::vector<runtime::Race>& getRaces() const;
+
+  /**
+   * @brief Turns execution profiling on or off (off by default).
+   *
+   * While on, every instruction executed is counted against its thread and
+   * address; see getProfile() for totals per line and reports. Counting
+   * starts again at every reset, and instructions re-executed to seek or
+   * step back are not counted twice. Turning it off drops the counts.
+   *
+   * @param enabled True to profile.
+   */
+  void setProfiling(bool enabled);
+
+  /**
+   * @brief Checks whether execution profiling is on.
+   * @return True if a profiler is attached.
+   */
+  bool isProfilingEnabled() const;
+
+  /**
+   * @brief Gets the execution counts since the last reset.
+   * @return Const reference to the profile; empty while profiling is off.
+   */
+  const runtime::Profiler& getProfile() const;
+
+  /**
+   * @brief Turns contention profiling on or off (off by default).
+   *
+   * While on, every semaphore and monitor acquisition and every block is
+   * followed to measure how long threads wait for each resource; see
+   * getContentionReport(). Counting starts again at every reset, and steps
+   * re-executed to seek or step back are not counted twice. Turning it off
+   * drops the counts.
+   *
+   * @param enabled True to profile contention.
+   */
+  void setContentionProfiling(bool enabled);
+
+  /**
+   * @brief Checks whether contention profiling is on.
+   * @return True if a contention profiler is attached.
+   */
+  bool isContentionProfilingEnabled() const;
+
+  /**
+   * @brief Reports the contention of every semaphore and monitor since the
+   * last reset, waits still open counting up to the current step.
+   * @param topSites Waiting instructions kept per resource.
+   * @return The report; empty while contention profiling is off.
+   */
+  runtime::ContentionReport getContentionReport(size_t topSites = 5) const;
+
+  /**
+   * @brief Starts writing the thread schedule as a Chrome trace.
+   *
+   * From now on every quantum, wait, semaphore and monitor operation is
+   * streamed to the sink as Chrome Trace Event JSON, timed in executed
+   * steps (see runtime::TraceWriter). Each reset, and each step back, starts
+   * a new run in the trace; steps re-executed to seek are not traced. Stops
+   * any trace already being written.
+   *
+   * @param sink Receives the document a part at a time.
+   */
+  void startTrace(runtime::TraceWriter::Sink sink);
+
+  /**
+   * @brief Ends the trace being written, if any, and completes the
+   * document.
+   * @return False if the sink failed at any point.
+   */
+  bool stopTrace();
+
+  /**
+   * @brief Checks whether a trace is being written.
+   * @return True between startTrace() and stopTrace().
+   */
+  bool isTracing() const;
+
+  /**
+   * @brief Starts recording every executed instruction as a binary trace.
+   *
+   * From now on each step is encoded with its thread, pc, opcode and the
+   * global words it wrote (see runtime::BinaryTraceWriter), a few bytes a
+   * step, and handed to the sink in large blocks. Like startTrace(), each
+   * reset and each step back starts a new run, and steps re-executed to
+   * seek are not recorded. Stops any binary trace already being written.
+   *
+   * @param sink Receives the file a part at a time.
+   */
+  void startBinaryTrace(runtime::BinaryTraceWriter::Sink sink);
+
+  /**
+   * @brief Ends the binary trace being written, if any, and hands the last
+   * block to the sink.
+   * @return False if the sink failed at any point.
+   */
+  bool stopBinaryTrace();
+
+  /**
+   * @brief Checks whether a binary trace is being written.
+   * @return True between startBinaryTrace() and stopBinaryTrace().
+   */
+  bool isBinaryTracing() const;
+
+  /**
+   * @brief Gets the execution statistics since the last reset.
+   *
+   * Kept only in builds with NSBACI_RUNTIME_STATS (see
+   * runtime::RUNTIME_STATS); otherwise every count stays at zero. Like the
+   * profile, steps re-executed to seek or step back are not counted again.
+   *
+   * @return Const reference to the statistics.
+   */
+  const runtime::RuntimeStats& getStats() const;
+
+  /**
+   * @brief Turns parking of busy-waiting threads on or off (on by default).
+   *
+   * When a thread jumps back to the start of a CodeImage::spinLoop() and the
+   * iteration left its stack and every word the loop reads unchanged, it
+   * is blocked instead of spinning again, and woken as soon as one of those
+   * words changes. Other threads see the same behaviour, minus the wasted
+   * iterations. Turning parking off wakes every parked thread.
+   *
+   * Steps re-executed when stepping back or seeking must park exactly as
+   * they did the first time, so changing the setting drops the history and
+   * the timeline ahead, as restoreState() does.
+   *
+   * @param enabled True to park busy-waiting threads.
+   */
+  void setSpinParking(bool enabled);
+
+  /**
+   * @brief Gets the busy-wait statistics since the last reset.
+   * @return Const reference to the statistics.
+   */
+  const SpinStats& getSpinStats() const;
+
+  /**
+   * @brief Turns recording of scheduling and input decisions on or off.
+   *
+   * The log always starts at the last reset (or load), so turn recording on
+   * before running for the log to be replayable. Turning it on clears the
+   * log; turning it off keeps it. Off by default: with a scheduler that
+   * switches thread every step the log grows by one entry per step.
+   *
+   * @param enabled True to record.
+   */
+  void setRecording(bool enabled);
+
+  /**
+   * @brief Checks whether decisions are being recorded.
+   * @return True if recording.
+   */
+  bool isRecording() const;
+
+  /**
+   * @brief Gets the decisions recorded since the last reset.
+   * @return Const reference to the log.
+   */
+  const runtime::ReplayLog& getReplayLog() const;
+
+  /**
+   * @brief Resets the program and replays a recorded run.
+   *
+   * Until the log's schedule is exhausted, step() picks the logged thread
+   * instead of asking the scheduler, and a Read that needs input gets the
+   * next logged value without returning needsInput. The step taking the
+   * last pick returns replayEnded; execution then carries on under the
+   * scheduler. A logged thread that is not ready (the program changed)
+   * ends the replay with an error. stepThread(), reset() and restoreState()
+   * abandon it.
+   *
+   * @param log Log recorded from a reset of the same program.
+   */
+  void startReplay(runtime::ReplayLog log);
+
+  /**
+   * @brief Checks whether a replay is in progress.
+   * @return True if step() follows a log.
+   */
+  bool isReplaying() const;
+
+  /**
+   * @brief Turns reverse stepping on or off and sets its memory budget.
+   *
+   * While on, every step is journalled as the inverse of what it did (old
+   * memory values, pushes and pops, registers, queues and pending input),
+   * and a full snapshot is taken every so often. Half the budget goes to
+   * the journal, which keeps the most recent steps; the other half to the
+   * snapshots, which are thinned out as the run grows. Stepping back past
+   * the journal restores the nearest snapshot and re-executes the recorded
+   * decisions up to the wanted step. Turning it on also turns recording on
+   * (see setRecording()) and starts the history at the current state.
+   *
+   * @param bytes Memory budget, or 0 to turn reverse stepping off.
+   */
+  void setUndoJournalLimit(size_t bytes);
+
+  /**
+   * @brief Checks whether there is a step to go back to.
+   * @return True if reverse stepping is on and a step has been taken.
+   */
+  bool canStepBack() const;
+
+  /**
+   * @brief Undoes the most recent step.
+   *
+   * Memory, threads, queues, pending input, the step count and the
+   * recorded log go back to how they were before it; output already
+   * produced is not taken back. A thread parked on a busy-wait loop may
+   * come back ready, and races found so far are forgotten. Leaves the
+   * state as Paused.
+   *
+   * The undone steps stay on the timeline: step() redoes them, replaying
+   * the same picks and inputs, until the end of the timeline or until
+   * stepThread() chooses differently.
+   *
+   * @return RuntimeResult with a warning if there was nothing to undo.
+   */
+  RuntimeResult stepBack();
+
+  /**
+   * @brief Steps back until a breakpoint is about to execute.
+   *
+   * Stops after undoing a step whose thread is then at one of the given
+   * addresses, at the start of the history, or after maxSteps steps.
+   *
+   * @param stopAt Instruction addresses to stop at, such as
+   * breakpointAddresses().
+   * @param maxSteps Maximum steps to undo (0 = unlimited).
+   * @return RuntimeResult of the last step back.
+   */
+  RuntimeResult runBackward(const std::vector<uint32_t>& stopAt,
+                            size_t maxSteps = 0);
+
+  /**
+   * @brief Sets how often checkpoints are taken while history is on.
+   *
+   * Seeking costs at most this many steps of re-execution, until the
+   * checkpoints outgrow their budget and are thinned out.
+   *
+   * @param picks Steps between checkpoints (at least 1).
+   */
+  void setCheckpointInterval(uint64_t picks);
+
+  /**
+   * @brief Gets the current position on the timeline.
+   *
+   * Positions count picks: every step a thread was given, including a Read
+   * or Wait that could not complete and is retried later.
+   *
+   * @return Picks since the last reset.
+   */
+  uint64_t timelinePosition() const;
+
+  /**
+   * @brief Gets the length of the timeline.
+   * @return The furthest position reached, including steps undone since.
+   */
+  uint64_t timelineLength() const;
+
+  /**
+   * @brief Jumps to a position of the timeline.
+   *
+   * Nearby positions behind are reached by undoing steps; anything else
+   * restores the nearest checkpoint at or before the position and
+   * re-executes the recorded decisions from there with output muted.
+   * Leaves the state as Paused.
+   *
+   * @param position Target position, clamped to timelineLength().
+   * @return RuntimeResult with an error if the position is unreachable.
+   */
+  RuntimeResult seekTo(uint64_t position);
+
+  /**
+   * @brief Sets a breakpoint, replacing any other at the same address.
+   *
+   * The instruction at the address is swapped for a Trap in the code that
+   * executes (see Program::setTraps()), so breakpoints cost nothing on the
+   * instructions that do not have one. A thread the breakpoint applies to
+   * stops before executing the instruction: the step returns breakpoint
+   * and takes no pick, so the timeline and the recorded log are the same
+   * as without breakpoints. From the next time that thread is picked it
+   * goes past the breakpoint, including Read or Wait retries, until the
+   * instruction completes; other threads reaching it stop as usual.
+   * Breakpoints stay set when a program is loaded.
+   *
+   * A condition makes the breakpoint stop only while it is true. Its value
+   * is kept and evaluated again only once a word it reads has been
+   * written, so a thread spinning past the breakpoint does not evaluate
+   * it on every pass. A condition that cannot be evaluated stops.
+   *
+   * @param pc Instruction address.
+   * @param threads Threads to stop, or empty for every thread.
+   * @param condition Condition to stop on, if any.
+   * @return RuntimeResult with an error, and nothing set, if the condition
+   * is not a pure expression.
+   */
+  RuntimeResult setBreakpoint(
+      uint32_t pc, std::vector<nsbaci::types::ThreadID> threads = {},
+      std::optional<Condition> condition = std::nullopt);
+
+  /**
+   * @brief Removes the breakpoint at an address, if any.
+   * @param pc Instruction address.
+   */
+  void clearBreakpoint(uint32_t pc);
+
+  /**
+   * @brief Removes every breakpoint.
+   */
+  void clearBreakpoints();
+
+  /**
+   * @brief Gets the breakpoints set.
+   * @return Threads to stop by address; an empty list stops every thread.
+   */
+  const std::map<uint32_t, std::vector<nsbaci::types::ThreadID>>&
+  getBreakpoints() const;
+
+  /**
+   * @brief Gets the addresses of the breakpoints set, for runBackward().
+   * @return Addresses in increasing order.
+   */
+  std::vector<uint32_t> breakpointAddresses() const;
+
+  /**
+   * @brief Gets the condition of a breakpoint.
+   * @param pc Instruction address.
+   * @return The condition, or nullptr if there is no conditional breakpoint
+   * at the address.
+   */
+  const Condition* getBreakpointCondition(uint32_t pc) const;
+
+  /**
+   * @brief Sets a watchpoint, replacing any other starting at the same word.
+   *
+   * Watched words are marked in a bitmap of global memory. Stores check it
+   * only while a watchpoint is set, so an unwatched run pays nothing. A step
+   * whose instruction writes a watched word executes in full and then
+   * returns the writes in watchpoints; run() pauses after it.
+   * Re-execution for seeking and stepping back ignores watchpoints.
+   *
+   * @param watch The words to watch and the writes to stop on.
+   */
+  void setWatchpoint(Watchpoint watch);
+
+  /**
+   * @brief Removes the watchpoint starting at a word, if any.
+   * @param addr First word of the watchpoint.
+   */
+  void clearWatchpoint(nsbaci::types::MemoryAddr addr);
+
+  /**
+   * @brief Removes every watchpoint.
+   */
+  void clearWatchpoints();
+
+  /**
+   * @brief Gets the watchpoints set.
+   * @return Watchpoints by first word.
+   */
+  const std::map<nsbaci::types::MemoryAddr, Watchpoint>& getWatchpoints()
+      const;
+
+  /**
+   * @brief Adds an invariant, a condition that must hold for the whole run.
+   *
+   * The words it reads are marked in the watch bitmap, and it is evaluated
+   * after each step whose instruction writes one of them, never after the
+   * others. A step that leaves it false returns it in invariants; run()
+   * pauses after it. Re-execution for seeking and stepping back does not
+   * check invariants.
+   *
+   * @param invariant The condition, replacing any other with the same text.
+   * @return RuntimeResult with an error, and nothing added, if the
+   * condition is not a pure expression.
+   */
+  RuntimeResult setInvariant(Condition invariant);
+
+  /**
+   * @brief Removes an invariant, if set.
+   * @param text Text of the invariant.
+   */
+  void clearInvariant(const std::string& text);
+
+  /**
+   * @brief Removes every invariant.
+   */
+  void clearInvariants();
+
+  /**
+   * @brief Gets the invariants set.
+   * @return Invariants by text.
+   */
+  const std::map<std::string, Condition>& getInvariants() const;
+
  private:
+  /**
+   * @brief Executes one instruction of an already picked thread.
+   * @param thread The thread to run, or nullptr if none could be picked.
+   * @return RuntimeResult with execution outcome.
+   */
+  RuntimeResult execute(runtime::Thread* thread);
+
+  /**
+   * @brief Executes the next step of the replay log.
+   * @return RuntimeResult with execution outcome.
+   */
+  RuntimeResult replayStep();
+
+  /**
+   * @struct SpinWatch
+   * @brief A thread's last pass through the backward jump of a spin loop.
+   */
+  struct SpinWatch {
+    uint32_t jumpPc = UINT32_MAX;  ///< Backward jump it took.
+    uint64_t threadHash = 0;       ///< Thread fingerprint after the jump.
+    uint64_t readsHash = 0;        ///< Fingerprint of the words read.
+  };
+
+  /**
+   * @struct Checkpoint
+   * @brief Full snapshot of the run that stepping back can restart from.
+   */
+  struct Checkpoint {
+    runtime::MemorySnapshot memory;      ///< Global memory.
+    runtime::SchedulerState threads;     ///< Threads and queues.
+    runtime::InputState input;           ///< Pending input.
+    std::vector<SpinWatch> spinWatches;  ///< Spin loop passes under way.
+    uint64_t stepCount = 0;     ///< Instructions executed.
+    uint64_t picks = 0;         ///< Replay log picks taken.
+    size_t inputs = 0;          ///< Replay log inputs given.
+    size_t bytes = 0;           ///< Approximate size.
+  };
+
+  /**
+   * @brief Starts the undo record of the step about to be taken.
+   */
+  void beginUndo();
+
+  /**
+   * @brief Journals the step just taken, if a thread was picked.
+   */
+  void finishUndo();
+
+  /**
+   * @brief Applies the inverse of a journalled step.
+   */
+  void undo(const runtime::UndoRecord& record);
+
+  /**
+   * @brief Snapshots the current state as a checkpoint.
+   */
+  void takeCheckpoint();
+
+  /**
+   * @brief Restores a checkpoint; the journal is left empty.
+   */
+  void restoreCheckpoint(const Checkpoint& cp);
+
+  /**
+   * @brief Refills the journal up to the current step from a checkpoint.
+   * @return False if no checkpoint precedes it or the re-execution
+   * diverged.
+   */
+  bool rebuildJournal();
+
+  /**
+   * @brief Re-executes the timeline up to a position, output muted.
+   * @param from Checkpoint to restore first, or nullptr to go on from the
+   * current state along the timeline.
+   * @param target Position to stop at.
+   * @return True if the position was reached.
+   */
+  bool fastForward(const Checkpoint* from, uint64_t target);
+
+  /**
+   * @brief Drops all history and starts it again at the current state.
+   */
+  void restartHistory();
+
   runtime::Program
       program;  ///< The loaded program with instructions and memory.
   std::unique_ptr<runtime::Interpreter>
@@ -257,6 +965,178 @@ class RuntimeService {
   std::unique_ptr<runtime::Scheduler>
       scheduler;                            ///< Manages thread scheduling.
   RuntimeState state = RuntimeState::Idle;  ///< Current execution state.
+  runtime::Thread mainThread;  ///< Template the main thread is reset from.
+  uint64_t stepCount = 0;      ///< Instructions executed since last reset.
+
+  /**
+   * @struct RecentState
+   * @brief Slot of the direct-mapped table of recently seen states.
+   */
+  struct RecentState {
+    uint64_t fingerprint = 0;  ///< State fingerprint.
+    uint64_t epoch = 0;        ///< Progress window it was seen in.
+  };
+
+  /// @brief Slots in the recent state table (power of two).
+  static constexpr size_t RECENT_STATES = 1024;
+
+  /**
+   * @brief Starts a new progress window; earlier states no longer count.
+   */
+  void markProgress();
+
+  /**
+   * @brief Records the current state and checks the revisit threshold.
+   * @return True if the threshold was just reached.
+   */
+  bool checkLivelock();
+
+  std::vector<RecentState> recentStates;  ///< Direct-mapped, by fingerprint.
+  uint64_t progressEpoch = 1;             ///< Current progress window.
+  uint64_t revisits = 0;                  ///< Revisits in this window.
+  uint64_t livelockThreshold = 10000;     ///< 0 disables detection.
+
+  std::unique_ptr<runtime::RaceDetector>
+      raceDetector;          ///< Null while race detection is off.
+  size_t racesReported = 0;  ///< Races already returned in a RuntimeResult.
+
+  std::unique_ptr<runtime::Profiler> profiler;  ///< Null while not profiling.
+  /// @brief Null while not profiling contention
+  std::unique_ptr<runtime::ContentionProfiler> contention;
+  std::unique_ptr<runtime::TraceWriter> tracer;  ///< Null while not tracing.
+  /// @brief Null while not writing a binary trace
+  std::unique_ptr<runtime::BinaryTraceWriter> binaryTracer;
+  /// @brief Old values written by the step being traced, if not journalled
+  std::vector<runtime::MemoryWrite> traceLog;
+  std::vector<runtime::TraceWrite> traceWrites;  ///< Its writes, new values.
+  runtime::StatsCounter stats;  ///< Used if runtime::RUNTIME_STATS.
+
+  /**
+   * @struct ParkedThread
+   * @brief A thread blocked on a spin loop until its reads change.
+   */
+  struct ParkedThread {
+    nsbaci::types::ThreadID id = 0;  ///< Parked thread.
+    uint32_t jumpPc = 0;             ///< Backward jump of its loop.
+    uint64_t readsHash = 0;          ///< Words read when it was parked.
+  };
+
+  /**
+   * @brief Fingerprints the current values of the words a loop reads.
+   */
+  uint64_t readsFingerprint(const runtime::SpinLoop& loop) const;
+
+  /**
+   * @brief Parks a thread that just went round a spin loop with no effect.
+   * @param thread The thread that took the backward jump.
+   * @param jumpPc Address of the jump.
+   * @param result Receives a deadlock report if parking formed one.
+   */
+  void checkSpin(runtime::Thread& thread, uint32_t jumpPc,
+                 RuntimeResult& result);
+
+  /**
+   * @brief Wakes every parked thread whose reads changed.
+   */
+  void wakeParked();
+
+  /**
+   * @brief Rebuilds the parked list from the scheduler after a restore.
+   *
+   * Spin watches are left alone; the caller restores or clears them.
+   */
+  void rebuildParked();
+
+  bool spinParking = true;             ///< Park busy-waiting threads.
+  std::vector<SpinWatch> spinWatches;  ///< By thread ID.
+  std::vector<ParkedThread> parked;    ///< Threads parked on spin loops.
+  uint64_t parkedMemoryHash = 0;       ///< Memory when parked was checked.
+  SpinStats spinStats;                 ///< Busy-wait statistics.
+
+  bool recording = false;                       ///< Record decisions.
+  runtime::ReplayLog replayLog;                 ///< Decisions since reset.
+  std::optional<runtime::ReplayCursor> replay;  ///< Set while replaying.
+
+  /// @brief Picks between checkpoints when history starts.
+  static constexpr uint64_t CHECKPOINT_INTERVAL = 256;
+
+  size_t undoLimit = 0;              ///< Reverse stepping budget (0 = off).
+  runtime::UndoJournal undoJournal;  ///< Most recent steps.
+  runtime::UndoRecord undoPending;   ///< Record of the step in progress.
+  bool undoOpen = false;             ///< undoPending is being filled.
+  bool undoOnTimeline = false;       ///< The step follows the timeline.
+  std::vector<Checkpoint> checkpoints;  ///< Oldest first.
+  size_t checkpointBytes = 0;           ///< Size of every checkpoint.
+  uint64_t checkpointEvery = CHECKPOINT_INTERVAL;     ///< Configured interval.
+  uint64_t checkpointInterval = CHECKPOINT_INTERVAL;  ///< After thinning.
+  runtime::OutputCallback outputCallback;  ///< Muted while rebuilding.
+  nsbaci::types::ThreadID undoneThread = 0;  ///< Thread of the last undo.
+
+  /**
+   * @brief Decides whether a thread at a Trap stops there.
+   * @return False if the breakpoint does not apply to the thread, or the
+   * thread is resuming from it.
+   */
+  bool stopsAt(const runtime::Thread& thread, uint32_t pc);
+
+  /// @brief Threads to stop by breakpoint address (empty = every thread)
+  std::map<uint32_t, std::vector<nsbaci::types::ThreadID>> breakpoints;
+  std::vector<BreakpointHit> stopped;  ///< Threads going past one.
+  bool stopsArmed = true;  ///< Off while re-executing history.
+
+  /**
+   * @brief Marks the words of every watchpoint and the words every
+   * condition reads in the program's bitmap.
+   */
+  void applyWatchpoints();
+
+  /**
+   * @brief Turns the watched writes of a step into hits.
+   * @param thread Thread that executed the step.
+   * @param pc Address of the instruction executed.
+   * @param result Receives the writes that stop.
+   */
+  void checkWatches(const runtime::Thread& thread, uint32_t pc,
+                    RuntimeResult& result);
+
+  /// @brief Watchpoints by first word
+  std::map<nsbaci::types::MemoryAddr, Watchpoint> watchpoints;
+  std::vector<runtime::MemoryWrite> watchWrites;  ///< Of the current step.
+  bool watching = false;  ///< Stores are logged for watchpoints or conditions.
+
+  /**
+   * @struct CachedCondition
+   * @brief A breakpoint condition and its value until a word it reads changes.
+   */
+  struct CachedCondition {
+    Condition condition;  ///< The condition.
+    bool stale = true;    ///< A word it reads was written since evaluated.
+    bool holds = false;   ///< Last value.
+  };
+
+  /**
+   * @brief Evaluates a breakpoint condition, if stale.
+   * @return Its value; true if it cannot be evaluated.
+   */
+  bool conditionHolds(CachedCondition& cached);
+
+  /**
+   * @brief Marks every breakpoint condition stale, after memory is replaced.
+   */
+  void staleConditions();
+
+  /**
+   * @brief Updates the conditions that read the watched writes of a step.
+   * @param thread Thread that executed the step.
+   * @param pc Address of the instruction executed.
+   * @param result Receives the invariants left false.
+   */
+  void checkConditions(const runtime::Thread& thread, uint32_t pc,
+                       RuntimeResult& result);
+
+  /// @brief Breakpoint conditions by address
+  std::map<uint32_t, CachedCondition> breakpointConditions;
+  std::map<std::string, Condition> invariants;  ///< By text.
 };
 
 }  // namespace nsbaci::services
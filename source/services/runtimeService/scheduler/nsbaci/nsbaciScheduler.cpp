@@ -9,27 +9,17 @@
 
 #include "nsbaciScheduler.h"
 
-#include <random>
+#include <algorithm>
+#include <sstream>
 
 namespace nsbaci::services::runtime {
 
+NsbaciScheduler::NsbaciScheduler() : gen(std::random_device{}()) {}
+
+NsbaciScheduler::NsbaciScheduler(uint64_t seed) : gen(seed) {}
+
 Thread* NsbaciScheduler::pickNext() {
-  // If there's a running thread, handle its state
-  if (runningIndex.has_value()) {
-    Thread& current = threads[runningIndex.value()];
-    auto currentState = current.getState();
-
-    if (currentState == nsbaci::types::ThreadState::Running) {
-      // Put back in ready queue
-      current.setState(nsbaci::types::ThreadState::Ready);
-      readyQueue.push_back(runningIndex.value());
-    } else if (currentState == nsbaci::types::ThreadState::IO) {
-      // Thread is waiting for I/O - put in IO queue
-      ioQueue.push_back(runningIndex.value());
-    }
-    // Other states (Blocked, Terminated) are handled elsewhere
-    runningIndex = std::nullopt;
-  }
+  requeueCurrent();
 
   // No threads ready
   if (readyQueue.empty()) {
@@ -37,15 +27,47 @@ Thread* NsbaciScheduler::pickNext() {
   }
 
   // BACI uses random selection to simulate non-determinism
-  static std::random_device rd;
-  static std::mt19937 gen(rd());
   std::uniform_int_distribution<size_t> dist(0, readyQueue.size() - 1);
+  return runFromReadyQueue(dist(gen));
+}
+
+Thread* NsbaciScheduler::pickThread(nsbaci::types::ThreadID threadId) {
+  requeueCurrent();
 
-  size_t randomIdx = dist(gen);
-  size_t nextIndex = readyQueue[randomIdx];
+  for (size_t pos = 0; pos < readyQueue.size(); ++pos) {
+    if (threads[readyQueue[pos]].getId() == threadId) {
+      return runFromReadyQueue(pos);
+    }
+  }
+  return nullptr;
+}
+
+void NsbaciScheduler::requeueCurrent() {
+  // If there's a running thread, handle its state
+  if (!runningIndex.has_value()) {
+    return;
+  }
+
+  Thread& current = threads[runningIndex.value()];
+  auto currentState = current.getState();
+
+  if (currentState == nsbaci::types::ThreadState::Running) {
+    // Put back in ready queue
+    current.setState(nsbaci::types::ThreadState::Ready);
+    readyQueue.push_back(runningIndex.value());
+  } else if (currentState == nsbaci::types::ThreadState::IO) {
+    // Thread is waiting for I/O - put in IO queue
+    ioQueue.push_back(runningIndex.value());
+  }
+  // Other states (Blocked, Terminated) are handled elsewhere
+  runningIndex = std::nullopt;
+}
+
+Thread* NsbaciScheduler::runFromReadyQueue(size_t queuePos) {
+  size_t nextIndex = readyQueue[queuePos];
 
   // Remove selected element by swapping with last and popping
-  readyQueue[randomIdx] = readyQueue.back();
+  readyQueue[queuePos] = readyQueue.back();
   readyQueue.pop_back();
 
   runningIndex = nextIndex;
@@ -55,6 +77,7 @@ Thread* NsbaciScheduler::pickNext() {
 }
 
 void NsbaciScheduler::addThread(Thread thread) {
+  nextThreadId = std::max(nextThreadId, thread.getId() + 1);
   thread.setState(nsbaci::types::ThreadState::Ready);
   size_t index = threads.size();
   threads.push_back(std::move(thread));
@@ -73,6 +96,8 @@ void NsbaciScheduler::blockCurrent() {
 }
 
 void NsbaciScheduler::unblock(nsbaci::types::ThreadID threadId) {
+  waitFor.remove(threadId);
+
   // Search in blocked queue and move to ready
   for (auto it = blockedQueue.begin(); it != blockedQueue.end(); ++it) {
     if (threads[*it].getId() == threadId) {
@@ -123,6 +148,8 @@ void NsbaciScheduler::clear() {
   blockedQueue.clear();
   ioQueue.clear();
   runningIndex = std::nullopt;
+  nextThreadId = 0;
+  waitFor.clear();
 }
 
 void NsbaciScheduler::unblockIO() {
@@ -138,6 +165,23 @@ const std::vector<Thread>& NsbaciScheduler::getThreads() const {
   return threads;
 }
 
+std::string NsbaciScheduler::saveRandomState() const {
+  std::ostringstream out;
+  out << "nsbaci " << gen;
+  return out.str();
+}
+
+bool NsbaciScheduler::restoreRandomState(const std::string& s) {
+  std::istringstream in(s);
+  std::string kind;
+  std::mt19937_64 engine;
+  if (!(in >> kind >> engine) || kind != "nsbaci" || !(in >> std::ws).eof()) {
+    return false;
+  }
+  gen = engine;
+  return true;
+}
+
 std::optional<size_t> NsbaciScheduler::findThreadIndex(
     nsbaci::types::ThreadID threadId) const {
   for (size_t i = 0; i < threads.size(); ++i) {
@@ -13,6 +13,9 @@
 #ifndef NSBACI_SERVICES_RUNTIME_NSBACI_SCHEDULER_H
 #define NSBACI_SERVICES_RUNTIME_NSBACI_SCHEDULER_H
 
+#include <cstdint>
+#include <random>
+
 #include "scheduler.h"
 
 /**
@@ -28,14 +31,30 @@ namespace nsbaci::services::runtime {
  * NsbaciScheduler implements a round-robin scheduling algorithm
  * with support for blocked, ready, running, and I/O waiting states.
  * Threads are selected randomly from the ready queue to simulate
- * non-deterministic concurrent execution.
+ * non-deterministic concurrent execution. Each scheduler owns its random
+ * engine; constructing it with an explicit seed makes the interleaving
+ * reproducible.
+ *
+ * Schedulers that only change how the next ready thread is chosen derive
+ * from it and reuse its queue handling.
  */
-class NsbaciScheduler final : public Scheduler {
+class NsbaciScheduler : public Scheduler {
  public:
-  NsbaciScheduler() = default;
+  /**
+   * @brief Constructs a scheduler seeded from std::random_device.
+   */
+  NsbaciScheduler();
+
+  /**
+   * @brief Constructs a scheduler with a fixed seed.
+   * @param seed Seed for the random engine; equal seeds give equal schedules.
+   */
+  explicit NsbaciScheduler(uint64_t seed);
+
   ~NsbaciScheduler() override = default;
 
   Thread* pickNext() override;
+  Thread* pickThread(nsbaci::types::ThreadID threadId) override;
   void addThread(Thread thread) override;
   void blockCurrent() override;
   void unblock(nsbaci::types::ThreadID threadId) override;
@@ -46,14 +65,30 @@ class NsbaciScheduler final : public Scheduler {
   void clear() override;
   void unblockIO() override;
   const std::vector<Thread>& getThreads() const override;
+  std::string saveRandomState() const override;
+  bool restoreRandomState(const std::string& s) override;
+
+ protected:
+  /**
+   * @brief Move the running thread to the queue matching its state.
+   */
+  void requeueCurrent();
+
+  /**
+   * @brief Take a ready thread out of the ready queue and run it.
+   * @param queuePos Position of the thread in the ready queue.
+   * @return Pointer to the now running thread.
+   */
+  Thread* runFromReadyQueue(size_t queuePos);
 
- private:
   /**
    * @brief Find thread index by ID.
    * @param threadId The thread ID to search for.
    * @return Index of the thread, or nullopt if not found.
    */
   std::optional<size_t> findThreadIndex(nsbaci::types::ThreadID threadId) const;
+
+  std::mt19937_64 gen;  ///< Random engine used to pick the next thread
 };
 
 }  // namespace nsbaci::services::runtime
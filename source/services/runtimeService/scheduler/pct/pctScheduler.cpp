@@ -0,0 +1,137 @@
+/**
+ * @file pctScheduler.cpp
+ * @brief PctScheduler class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "pctScheduler.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace nsbaci::services::runtime {
+
+PctScheduler::PctScheduler(uint64_t seed, uint32_t d, uint64_t k)
+    : NsbaciScheduler(seed),
+      depth(std::max<uint32_t>(d, 1)),
+      steps(std::max<uint64_t>(k, 1)) {
+  drawChangePoints();
+}
+
+Thread* PctScheduler::pickNext() {
+  // The thread that ran a change-point step drops below every other thread
+  while (nextChange < changePoints.size() &&
+         changePoints[nextChange].first <= taken) {
+    if (lastIndex.has_value()) {
+      priorityOf(*lastIndex);
+      priorities[*lastIndex] = changePoints[nextChange].second;
+    }
+    ++nextChange;
+  }
+
+  requeueCurrent();
+  if (readyQueue.empty()) {
+    return nullptr;
+  }
+
+  // Highest priority wins; ties (practically impossible) go to the first
+  size_t best = 0;
+  for (size_t pos = 1; pos < readyQueue.size(); ++pos) {
+    if (priorityOf(readyQueue[pos]) > priorityOf(readyQueue[best])) {
+      best = pos;
+    }
+  }
+  lastIndex = readyQueue[best];
+  ++taken;
+  return runFromReadyQueue(best);
+}
+
+void PctScheduler::addThread(Thread thread) {
+  NsbaciScheduler::addThread(std::move(thread));
+  priorityOf(threads.size() - 1);
+}
+
+void PctScheduler::clear() {
+  NsbaciScheduler::clear();
+  priorities.clear();
+  taken = 0;
+  lastIndex = std::nullopt;
+  drawChangePoints();
+}
+
+std::string PctScheduler::saveRandomState() const {
+  std::ostringstream out;
+  out << "pct " << gen << " " << taken << " "
+      << (lastIndex.has_value() ? *lastIndex + 1 : 0) << " "
+      << priorities.size();
+  for (uint64_t p : priorities) {
+    out << " " << p;
+  }
+  out << " " << changePoints.size();
+  for (const auto& [step, priority] : changePoints) {
+    out << " " << step << " " << priority;
+  }
+  out << " " << nextChange;
+  return out.str();
+}
+
+bool PctScheduler::restoreRandomState(const std::string& s) {
+  std::istringstream in(s);
+  std::string kind;
+  std::mt19937_64 engine;
+  uint64_t restoredTaken = 0;
+  size_t last = 0;
+  size_t count = 0;
+  // Every number takes at least two characters, which bounds the counts
+  if (!(in >> kind >> engine >> restoredTaken >> last >> count) ||
+      kind != "pct" || count > s.size()) {
+    return false;
+  }
+  std::vector<uint64_t> restoredPriorities(count);
+  for (auto& p : restoredPriorities) {
+    in >> p;
+  }
+  if (!(in >> count) || count > s.size()) {
+    return false;
+  }
+  std::vector<std::pair<uint64_t, uint64_t>> restoredChanges(count);
+  for (auto& [step, priority] : restoredChanges) {
+    in >> step >> priority;
+  }
+  size_t restoredNext = 0;
+  if (!(in >> restoredNext) || !(in >> std::ws).eof() ||
+      restoredNext > restoredChanges.size()) {
+    return false;
+  }
+
+  gen = engine;
+  taken = restoredTaken;
+  lastIndex = last > 0 ? std::optional<size_t>(last - 1) : std::nullopt;
+  priorities = std::move(restoredPriorities);
+  changePoints = std::move(restoredChanges);
+  nextChange = restoredNext;
+  return true;
+}
+
+void PctScheduler::drawChangePoints() {
+  std::uniform_int_distribution<uint64_t> dist(1, steps);
+  changePoints.clear();
+  for (uint32_t i = 1; i < depth; ++i) {
+    changePoints.emplace_back(dist(gen), i);
+  }
+  std::sort(changePoints.begin(), changePoints.end());
+  nextChange = 0;
+}
+
+uint64_t PctScheduler::priorityOf(size_t index) {
+  while (priorities.size() <= index) {
+    // Initial priorities start at depth, above every change-point priority
+    priorities.push_back(depth + (gen() >> 2));
+  }
+  return priorities[index];
+}
+
+}  // namespace nsbaci::services::runtime
@@ -0,0 +1,108 @@
+/**
+ * @file pctScheduler.h
+ * @brief PctScheduler class declaration for nsbaci runtime service.
+ *
+ * This module provides a scheduler implementing probabilistic concurrency
+ * testing (PCT): threads run strictly by random priority, and the priority
+ * of the running thread is lowered at a few randomly chosen steps. Unlike
+ * uniform random picking, every run has a known lower bound on the chance
+ * of exposing any given ordering bug of small depth.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_PCT_SCHEDULER_H
+#define NSBACI_SERVICES_RUNTIME_PCT_SCHEDULER_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nsbaciScheduler.h"
+
+/**
+ * @namespace nsbaci::services::runtime
+ * @brief Runtime services namespace for nsbaci.
+ */
+namespace nsbaci::services::runtime {
+
+/**
+ * @class PctScheduler
+ * @brief Scheduler for the PCT algorithm of Burckhardt et al.
+ *
+ * Every thread gets a distinct random priority when it is added, above
+ * d - 1. Before the run, d - 1 change points are drawn uniformly from the
+ * first k steps; when step k_i is reached, the thread that ran it drops to
+ * priority i, below every initial priority. pickNext() always runs the
+ * ready thread with the highest priority.
+ *
+ * For a program with n threads and k steps, each run exposes any bug that
+ * needs d specific orderings with probability at least 1 / (n * k^(d-1)).
+ * k only needs to be an estimate: change points beyond the real length of
+ * the run are simply never reached.
+ *
+ * The scheduler is deterministic for a given seed, and clear() draws new
+ * change points so a reset runs a fresh schedule.
+ */
+class PctScheduler final : public NsbaciScheduler {
+ public:
+  /**
+   * @brief Constructs a PCT scheduler.
+   * @param seed Seed for priorities and change points.
+   * @param d Bug depth to target (at least 1; 1 means no changes).
+   * @param k Estimated number of steps of a run.
+   */
+  PctScheduler(uint64_t seed, uint32_t d, uint64_t k);
+
+  ~PctScheduler() override = default;
+
+  Thread* pickNext() override;
+  void addThread(Thread thread) override;
+  void clear() override;
+
+  /**
+   * @brief Saves the random engine, the priorities and the change points.
+   * @return Opaque text that restoreRandomState() accepts.
+   */
+  std::string saveRandomState() const override;
+
+  /**
+   * @brief Puts back state saved by saveRandomState() of a PCT scheduler.
+   * @param s The saved text.
+   * @return False, leaving the state unchanged, if s is not from one.
+   */
+  bool restoreRandomState(const std::string& s) override;
+
+ private:
+  /**
+   * @brief Draws the change points of a new run.
+   */
+  void drawChangePoints();
+
+  /**
+   * @brief Gets the priority of a thread, drawing it on first use.
+   *
+   * Threads restored from a snapshot of another scheduler have none yet.
+   *
+   * @param index Index of the thread.
+   * @return Its priority.
+   */
+  uint64_t priorityOf(size_t index);
+
+  uint32_t depth;                    ///< Bug depth d.
+  uint64_t steps;                    ///< Estimated run length k.
+  uint64_t taken = 0;                ///< Steps picked since the last clear().
+  std::optional<size_t> lastIndex;   ///< Thread picked for the last step.
+  std::vector<uint64_t> priorities;  ///< By thread index; higher runs first.
+  /// @brief (step, new priority) pairs, soonest first.
+  std::vector<std::pair<uint64_t, uint64_t>> changePoints;
+  size_t nextChange = 0;  ///< First change point not yet reached.
+};
+
+}  // namespace nsbaci::services::runtime
+
+#endif  // NSBACI_SERVICES_RUNTIME_PCT_SCHEDULER_H
@@ -0,0 +1,80 @@
+/**
+ * @file scheduler.cpp
+ * @brief Scheduler class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "scheduler.h"
+
+namespace nsbaci::services::runtime {
+
+std::optional<DeadlockReport> Scheduler::blockCurrentOn(
+    nsbaci::types::WaitResource resource,
+    std::optional<nsbaci::types::ThreadID> holder,
+    const MayRelease& mayRelease) {
+  Thread* running = current();
+  if (!running) {
+    return std::nullopt;
+  }
+
+  nsbaci::types::ThreadID id = running->getId();
+  blockCurrent();
+  waitFor.add({id, resource, holder});
+
+  // Threads only each other could wake are deadlocked even if others run
+  // on. A semaphore can be signalled by any live thread that may still
+  // reach a Signal of it
+  auto releasers = [&](const WaitEdge& e)
+      -> std::optional<std::vector<nsbaci::types::ThreadID>> {
+    if (e.resource.kind != nsbaci::types::ResourceKind::Semaphore ||
+        !mayRelease) {
+      return std::nullopt;
+    }
+    std::vector<nsbaci::types::ThreadID> ids;
+    for (const auto& t : threads) {
+      if (t.getId() != e.waiter &&
+          t.getState() != nsbaci::types::ThreadState::Terminated &&
+          mayRelease(t, e.resource)) {
+        ids.push_back(t.getId());
+      }
+    }
+    return ids;
+  };
+  std::vector<WaitEdge> stuck = waitFor.findDeadlock(id, releasers);
+  if (!stuck.empty()) {
+    DeadlockReport report;
+    report.global = !hasThreads() && ioQueue.empty();
+    report.edges = std::move(stuck);
+    return report;
+  }
+  return globalDeadlock();
+}
+
+std::optional<nsbaci::types::ThreadID> Scheduler::wakeOne(
+    const nsbaci::types::WaitResource& resource) {
+  auto waiter = waitFor.firstWaiter(resource);
+  if (waiter.has_value()) {
+    unblock(*waiter);
+  }
+  return waiter;
+}
+
+std::optional<DeadlockReport> Scheduler::globalDeadlock() const {
+  if (hasThreads() || !ioQueue.empty() || blockedQueue.empty()) {
+    return std::nullopt;
+  }
+
+  DeadlockReport report;
+  report.global = true;
+  for (size_t idx : blockedQueue) {
+    if (const WaitEdge* e = waitFor.edgeOf(threads[idx].getId())) {
+      report.edges.push_back(*e);
+    }
+  }
+  return report;
+}
+
+}  // namespace nsbaci::services::runtime
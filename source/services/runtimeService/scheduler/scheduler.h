@@ -13,10 +13,13 @@
 #ifndef NSBACI_SERVICES_RUNTIME_SCHEDULER_H
 #define NSBACI_SERVICES_RUNTIME_SCHEDULER_H
 
+#include <functional>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "thread.h"
+#include "waitForGraph.h"
 
 /**
  * @namespace nsbaci::services::runtime
@@ -24,6 +27,40 @@
  */
 namespace nsbaci::services::runtime {
 
+/**
+ * @struct SchedulerState
+ * @brief Snapshot of every thread and queue owned by a scheduler.
+ *
+ * Plain value type, so a saved state can be copied and restored into any
+ * scheduler of the same kind.
+ */
+struct SchedulerState {
+  std::vector<Thread> threads;               ///< All threads, in order
+  std::vector<size_t> readyQueue;            ///< Indices of ready threads
+  std::vector<size_t> blockedQueue;          ///< Indices of blocked threads
+  std::vector<size_t> ioQueue;               ///< Indices of I/O waiting threads
+  std::optional<size_t> runningIndex;        ///< Index of running thread
+  nsbaci::types::ThreadID nextThreadId = 0;  ///< Next ID to hand out
+  WaitForGraph waitFor;                      ///< What blocked threads wait for
+};
+
+/**
+ * @struct SchedulerQueues
+ * @brief The queues and thread states of a scheduler, without the stacks.
+ *
+ * What one step can change besides the running thread's stack and
+ * registers; cheap enough to save before every step.
+ */
+struct SchedulerQueues {
+  std::vector<size_t> readyQueue;            ///< Indices of ready threads
+  std::vector<size_t> blockedQueue;          ///< Indices of blocked threads
+  std::vector<size_t> ioQueue;               ///< Indices of I/O waiting threads
+  std::optional<size_t> runningIndex;        ///< Index of running thread
+  nsbaci::types::ThreadID nextThreadId = 0;  ///< Next ID to hand out
+  WaitForGraph waitFor;                      ///< What blocked threads wait for
+  std::vector<nsbaci::types::ThreadState> states;  ///< State of each thread
+};
+
 /**
  * @class Scheduler
  * @brief Manages thread scheduling and state transitions.
@@ -34,6 +71,11 @@ namespace nsbaci::services::runtime {
  */
 class Scheduler {
  public:
+  /// @brief Checks whether a thread, from where it stands, could still
+  /// release a resource without an owner.
+  using MayRelease = std::function<bool(const Thread&,
+                                        const nsbaci::types::WaitResource&)>;
+
   Scheduler() = default;
   virtual ~Scheduler() = default;
 
@@ -43,8 +85,21 @@ class Scheduler {
    */
   virtual Thread* pickNext() = 0;
 
+  /**
+   * @brief Run a specific thread next instead of letting the policy choose.
+   *
+   * The running thread is requeued exactly as in pickNext().
+   *
+   * @param threadId The ID of the thread to run.
+   * @return Pointer to the thread, or nullptr if it is not ready.
+   */
+  virtual Thread* pickThread(nsbaci::types::ThreadID threadId) = 0;
+
   /**
    * @brief Add a new thread to the scheduler.
+   *
+   * allocateThreadId() never returns the ID of a thread added this way.
+   *
    * @param thread The thread to add.
    */
   virtual void addThread(Thread thread) = 0;
@@ -56,6 +111,9 @@ class Scheduler {
 
   /**
    * @brief Move a thread from blocked to ready state.
+   *
+   * Also drops the thread's edge from the wait-for graph.
+   *
    * @param threadId The ID of the thread to unblock.
    */
   virtual void unblock(nsbaci::types::ThreadID threadId) = 0;
@@ -99,12 +157,182 @@ class Scheduler {
    */
   virtual const std::vector<Thread>& getThreads() const = 0;
 
+  /**
+   * @brief Save the policy state that decides future picks.
+   *
+   * Queues and threads are saved with saveState(); this covers what a
+   * policy keeps on top of them, such as its random engine. The base
+   * policy has none.
+   *
+   * @return Opaque text that restoreRandomState() accepts.
+   */
+  virtual std::string saveRandomState() const { return {}; }
+
+  /**
+   * @brief Put back policy state saved by saveRandomState().
+   * @param s The saved text.
+   * @return False, leaving the state unchanged, if s comes from another
+   * kind of scheduler or is malformed.
+   */
+  virtual bool restoreRandomState(const std::string& s) { return s.empty(); }
+
+  /**
+   * @brief Block the running thread on a resource and check for deadlock.
+   *
+   * Adds the thread's edge to the wait-for graph and searches it from
+   * there: through holders, and for semaphores through every live thread
+   * mayRelease accepts. Only the edges reached are visited.
+   *
+   * @param resource What the thread waits for.
+   * @param holder Thread owning the resource, for owned resources.
+   * @param mayRelease Who could still signal a semaphore; without it a
+   * semaphore wait is never part of a partial deadlock.
+   * @return The deadlock this block just formed, if any.
+   */
+  std::optional<DeadlockReport> blockCurrentOn(
+      nsbaci::types::WaitResource resource,
+      std::optional<nsbaci::types::ThreadID> holder = std::nullopt,
+      const MayRelease& mayRelease = {});
+
+  /**
+   * @brief Wake the longest-waiting thread of a resource.
+   * @param resource The resource that became available.
+   * @return The thread woken, or nullopt if nobody waited.
+   */
+  std::optional<nsbaci::types::ThreadID> wakeOne(
+      const nsbaci::types::WaitResource& resource);
+
+  /**
+   * @brief Check whether every live thread is blocked for good.
+   *
+   * True when nothing is ready, running or waiting for I/O but some thread
+   * is blocked. Constant time unless a report has to be built.
+   *
+   * @return Report naming every blocked thread, or nullopt.
+   */
+  std::optional<DeadlockReport> globalDeadlock() const;
+
+  /**
+   * @brief Get the number of threads waiting to run.
+   * @return Length of the ready queue.
+   */
+  size_t readyCount() const { return readyQueue.size(); }
+
+  /**
+   * @brief Get the wait-for graph.
+   * @return Const reference to the graph.
+   */
+  const WaitForGraph& waitForGraph() const { return waitFor; }
+
+  /**
+   * @brief Hand out a thread ID unused by this scheduler.
+   *
+   * IDs are per scheduler, so several runtimes can run concurrently without
+   * sharing a counter. clear() starts the numbering again.
+   *
+   * @return The new thread ID.
+   */
+  nsbaci::types::ThreadID allocateThreadId() { return nextThreadId++; }
+
+  /**
+   * @brief Fingerprint of every thread's stack, pc and state.
+   *
+   * Queue membership follows from each thread's state, so a transition
+   * between queues changes the fingerprint through Thread::fingerprint().
+   * O(number of threads); no stack or memory is scanned.
+   *
+   * @return 64-bit fingerprint.
+   */
+  uint64_t fingerprint() const {
+    uint64_t h = 0;
+    for (const auto& t : threads) {
+      h ^= t.fingerprint();
+    }
+    return h;
+  }
+
+  /**
+   * @brief Copy out the threads and queues.
+   * @return Snapshot that restoreState() accepts.
+   */
+  SchedulerState saveState() const {
+    return {threads,      readyQueue,   blockedQueue, ioQueue,
+            runningIndex, nextThreadId, waitFor};
+  }
+
+  /**
+   * @brief Replace the threads and queues with a saved snapshot.
+   * @param s Snapshot previously returned by saveState().
+   */
+  void restoreState(const SchedulerState& s) {
+    threads = s.threads;
+    readyQueue = s.readyQueue;
+    blockedQueue = s.blockedQueue;
+    ioQueue = s.ioQueue;
+    runningIndex = s.runningIndex;
+    nextThreadId = s.nextThreadId;
+    waitFor = s.waitFor;
+  }
+
+  /**
+   * @brief Copy out the queues and thread states, but no stacks.
+   * @return Snapshot that restoreQueues() accepts.
+   */
+  SchedulerQueues saveQueues() const {
+    SchedulerQueues q{readyQueue,   blockedQueue, ioQueue, runningIndex,
+                      nextThreadId, waitFor,      {}};
+    q.states.reserve(threads.size());
+    for (const auto& t : threads) {
+      q.states.push_back(t.getState());
+    }
+    return q;
+  }
+
+  /**
+   * @brief Put back queues saved by saveQueues().
+   *
+   * Threads added since are dropped; the stacks and registers of the
+   * others are left as they are.
+   *
+   * @param q Snapshot previously returned by saveQueues().
+   */
+  void restoreQueues(const SchedulerQueues& q) {
+    if (threads.size() > q.states.size()) {
+      threads.erase(threads.begin() + q.states.size(), threads.end());
+    }
+    for (size_t i = 0; i < threads.size(); ++i) {
+      threads[i].setState(q.states[i]);
+    }
+    readyQueue = q.readyQueue;
+    blockedQueue = q.blockedQueue;
+    ioQueue = q.ioQueue;
+    runningIndex = q.runningIndex;
+    nextThreadId = q.nextThreadId;
+    waitFor = q.waitFor;
+  }
+
+  /**
+   * @brief Find a thread by ID.
+   * @param threadId The ID to look for.
+   * @return Pointer to the thread, or nullptr if there is none.
+   */
+  Thread* findThread(nsbaci::types::ThreadID threadId) {
+    for (auto& t : threads) {
+      if (t.getId() == threadId) {
+        return &t;
+      }
+    }
+    return nullptr;
+  }
+
  protected:
-  std::vector<Thread> threads;         ///< All threads owned by scheduler
-  std::vector<size_t> readyQueue;      ///< Indices of ready threads
-  std::vector<size_t> blockedQueue;    ///< Indices of blocked threads
-  std::vector<size_t> ioQueue;         ///< Indices of I/O waiting threads
-  std::optional<size_t> runningIndex;  ///< Index of currently running thread
+  std::vector<Thread> threads;               ///< All threads owned
+  std::vector<size_t> readyQueue;            ///< Indices of ready threads
+  std::vector<size_t> blockedQueue;          ///< Indices of blocked threads
+  std::vector<size_t> ioQueue;               ///< Indices of I/O waiting threads
+  std::optional<size_t> runningIndex;        ///< Index of running thread
+  nsbaci::types::ThreadID nextThreadId = 0;  ///< Next ID to hand out
+  WaitForGraph waitFor;                      ///< What blocked threads wait for
 };
 
 }  // namespace nsbaci::services::runtime
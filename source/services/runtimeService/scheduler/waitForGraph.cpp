@@ -0,0 +1,148 @@
+/**
+ * @file waitForGraph.cpp
+ * @brief WaitForGraph class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "waitForGraph.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace nsbaci::services::runtime {
+
+namespace {
+
+const char* resourceName(nsbaci::types::ResourceKind kind) {
+  switch (kind) {
+    case nsbaci::types::ResourceKind::Semaphore:
+      return "semaphore";
+    case nsbaci::types::ResourceKind::Monitor:
+      return "monitor";
+    case nsbaci::types::ResourceKind::Spin:
+      return "spin";
+  }
+  return "resource";
+}
+
+}  // namespace
+
+std::string DeadlockReport::describe() const {
+  std::string text;
+  for (const auto& e : edges) {
+    if (!text.empty()) {
+      text += "\n";
+    }
+    if (e.resource.kind == nsbaci::types::ResourceKind::Spin) {
+      text += "thread " + std::to_string(e.waiter) +
+              " busy-waits in the loop at pc " +
+              std::to_string(e.resource.address);
+      continue;
+    }
+    text += "thread " + std::to_string(e.waiter) + " waits for " +
+            resourceName(e.resource.kind) + " @" +
+            std::to_string(e.resource.address);
+    if (e.holder.has_value()) {
+      text += " held by thread " + std::to_string(*e.holder);
+    }
+  }
+  return text;
+}
+
+void WaitForGraph::add(WaitEdge edge) {
+  remove(edge.waiter);
+  waiters[edge.resource].push_back(edge.waiter);
+  edges[edge.waiter] = std::move(edge);
+}
+
+void WaitForGraph::remove(nsbaci::types::ThreadID waiter) {
+  auto it = edges.find(waiter);
+  if (it == edges.end()) {
+    return;
+  }
+
+  auto queue = waiters.find(it->second.resource);
+  if (queue != waiters.end()) {
+    auto& ids = queue->second;
+    ids.erase(std::find(ids.begin(), ids.end(), waiter));
+    if (ids.empty()) {
+      waiters.erase(queue);
+    }
+  }
+  edges.erase(it);
+}
+
+std::optional<nsbaci::types::ThreadID> WaitForGraph::firstWaiter(
+    const nsbaci::types::WaitResource& resource) const {
+  auto it = waiters.find(resource);
+  if (it == waiters.end() || it->second.empty()) {
+    return std::nullopt;
+  }
+  return it->second.front();
+}
+
+size_t WaitForGraph::waiterCount(
+    const nsbaci::types::WaitResource& resource) const {
+  auto it = waiters.find(resource);
+  return it == waiters.end() ? 0 : it->second.size();
+}
+
+const WaitEdge* WaitForGraph::edgeOf(nsbaci::types::ThreadID waiter) const {
+  auto it = edges.find(waiter);
+  return it == edges.end() ? nullptr : &it->second;
+}
+
+std::vector<WaitEdge> WaitForGraph::findDeadlock(
+    nsbaci::types::ThreadID from, const Releasers& releasers) const {
+  std::vector<WaitEdge> stuck;
+  std::vector<nsbaci::types::ThreadID> reached{from};
+  std::unordered_set<nsbaci::types::ThreadID> seen{from};
+
+  for (size_t next = 0; next < reached.size(); ++next) {
+    const WaitEdge* e = edgeOf(reached[next]);
+    if (!e) {
+      return {};  // Not blocked, so it can still wake the others
+    }
+    stuck.push_back(*e);
+
+    std::vector<nsbaci::types::ThreadID> wakers;
+    if (e->holder.has_value()) {
+      wakers.push_back(*e->holder);
+    } else {
+      auto named = releasers ? releasers(*e) : std::nullopt;
+      if (!named.has_value()) {
+        return {};
+      }
+      wakers = std::move(*named);
+    }
+    for (auto id : wakers) {
+      if (seen.insert(id).second) {
+        reached.push_back(id);
+      }
+    }
+  }
+  return stuck;
+}
+
+size_t WaitForGraph::size() const { return edges.size(); }
+
+std::vector<WaitEdge> WaitForGraph::allEdges() const {
+  std::vector<WaitEdge> all;
+  all.reserve(edges.size());
+  for (const auto& [resource, ids] : waiters) {
+    for (auto waiter : ids) {
+      all.push_back(edges.at(waiter));
+    }
+  }
+  return all;
+}
+
+void WaitForGraph::clear() {
+  edges.clear();
+  waiters.clear();
+}
+
+}  // namespace nsbaci::services::runtime
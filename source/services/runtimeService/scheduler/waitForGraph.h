@@ -0,0 +1,168 @@
+/**
+ * @file waitForGraph.h
+ * @brief WaitForGraph class declaration for nsbaci runtime service.
+ *
+ * This module defines the wait-for graph kept by every scheduler: one edge
+ * per blocked thread, from the thread to the resource it waits for and, for
+ * owned resources such as monitors, on to the thread holding it. Resources
+ * without an owner, such as semaphores, lead on to every thread that could
+ * still release them. The graph is updated as threads block and wake, so
+ * deadlocks are found when they form instead of by scanning the program
+ * afterwards.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_WAITFORGRAPH_H
+#define NSBACI_SERVICES_RUNTIME_WAITFORGRAPH_H
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "runtimeTypes.h"
+
+/**
+ * @namespace nsbaci::services::runtime
+ * @brief Runtime services namespace for nsbaci.
+ */
+namespace nsbaci::services::runtime {
+
+/**
+ * @struct WaitEdge
+ * @brief A blocked thread, what it waits for and who holds it.
+ */
+struct WaitEdge {
+  nsbaci::types::ThreadID waiter = 0;             ///< Blocked thread
+  nsbaci::types::WaitResource resource;           ///< Resource waited for
+  std::optional<nsbaci::types::ThreadID> holder;  ///< Owner, if any
+};
+
+/**
+ * @struct DeadlockReport
+ * @brief Threads that can never run again and why.
+ *
+ * A partial deadlock is a set of blocked threads that only threads of the
+ * set could wake, while other threads keep running; edges holds them
+ * starting at the thread that blocked last. A global deadlock means no
+ * thread can run at all; edges then holds every blocked thread in blocking
+ * order.
+ */
+struct DeadlockReport {
+  bool global = false;          ///< True if no thread can run at all
+  std::vector<WaitEdge> edges;  ///< The cycle, or every blocked thread
+
+  /**
+   * @brief Human-readable description, one line per edge, no final newline.
+   * @return Text such as "thread 1 waits for monitor @4 held by thread 2".
+   */
+  std::string describe() const;
+};
+
+/**
+ * @class WaitForGraph
+ * @brief Incrementally maintained wait-for graph.
+ *
+ * Each thread waits for at most one resource. An owned resource has at
+ * most one holder; one without an owner can be released by any of the
+ * threads the caller names, so the graph is searched from a new waiter
+ * through every thread that could wake it, visiting only what it reaches.
+ * Waiters of a resource are kept in blocking order so wakeups are FIFO.
+ *
+ * Plain value type, so it is saved and restored with the scheduler.
+ */
+class WaitForGraph {
+ public:
+  /// @brief Names the threads that could still release the resource of an
+  /// edge without a holder, or nullopt if that cannot be known.
+  using Releasers =
+      std::function<std::optional<std::vector<nsbaci::types::ThreadID>>(
+          const WaitEdge&)>;
+
+  /**
+   * @brief Records that a thread is now blocked.
+   * @param edge The new edge; replaces any earlier edge of the same waiter.
+   */
+  void add(WaitEdge edge);
+
+  /**
+   * @brief Forgets the edge of a thread that no longer waits.
+   * @param waiter The thread that woke up.
+   */
+  void remove(nsbaci::types::ThreadID waiter);
+
+  /**
+   * @brief Gets the longest-waiting thread of a resource.
+   * @param resource The resource.
+   * @return Its first waiter, or nullopt if nobody waits for it.
+   */
+  std::optional<nsbaci::types::ThreadID> firstWaiter(
+      const nsbaci::types::WaitResource& resource) const;
+
+  /**
+   * @brief Gets the edge of a blocked thread.
+   * @param waiter The thread.
+   * @return Pointer to its edge, or nullptr if it waits for nothing.
+   */
+  const WaitEdge* edgeOf(nsbaci::types::ThreadID waiter) const;
+
+  /**
+   * @brief Counts the threads waiting for a resource.
+   * @param resource The resource.
+   * @return Number of its waiters.
+   */
+  size_t waiterCount(const nsbaci::types::WaitResource& resource) const;
+
+  /**
+   * @brief Finds the deadlock a blocked thread is part of, if any.
+   *
+   * Follows the thread's edge to the holder of its resource, or to every
+   * thread releasers() names, and on from each of those. If every thread
+   * reached is blocked, none of them can ever be woken.
+   *
+   * @param from Thread whose edge was just added.
+   * @param releasers Names who could release resources without a holder.
+   * @return The edges of the threads reached, starting at from, or empty
+   * if one of them can still run.
+   */
+  std::vector<WaitEdge> findDeadlock(nsbaci::types::ThreadID from,
+                                     const Releasers& releasers) const;
+
+  /**
+   * @brief Gets the number of edges.
+   * @return Number of threads waiting for a resource.
+   */
+  size_t size() const;
+
+  /**
+   * @brief Gets every edge, each resource's waiters longest waiting first.
+   *
+   * Adding the edges to an empty graph in this order rebuilds this one,
+   * wakeup order included.
+   *
+   * @return All edges.
+   */
+  std::vector<WaitEdge> allEdges() const;
+
+  /**
+   * @brief Removes every edge.
+   */
+  void clear();
+
+ private:
+  /// @brief Edge of each blocked thread.
+  std::unordered_map<nsbaci::types::ThreadID, WaitEdge> edges;
+  /// @brief Waiters of each resource, longest waiting first.
+  std::map<nsbaci::types::WaitResource, std::deque<nsbaci::types::ThreadID>>
+      waiters;
+};
+
+}  // namespace nsbaci::services::runtime
+
+#endif  // NSBACI_SERVICES_RUNTIME_WAITFORGRAPH_H
@@ -0,0 +1,619 @@
+/**
+ * @file session.cpp
+ * @brief Session struct implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "session.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace nsbaci::services::runtime {
+
+namespace {
+
+constexpr char MAGIC[8] = {'N', 'S', 'B', 'A', 'C', 'I', 'V', 'M'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t ENDIAN_MARK = 0x01020304;
+
+/// @brief Header: magic, version, byte-order mark, section count, padding.
+constexpr size_t HEADER_SIZE = 24;
+/// @brief Section table entry: kind, padding, offset, size.
+constexpr size_t ENTRY_SIZE = 24;
+
+enum class SectionKind : uint32_t {
+  Code = 1,     ///< Instructions and symbol table
+  Memory = 2,   ///< Global memory words
+  Threads = 3,  ///< Registers, state and stack of every thread
+  Queues = 4,   ///< Scheduler queues and wait-for graph
+  Random = 5,   ///< Scheduler policy state
+  Runtime = 6,  ///< Step count, halted flag and pending input
+  Lines = 7,    ///< Source line table of the code, optional
+};
+
+SessionResult malformed(const std::string& what) {
+  nsbaci::Error err;
+  err.basic.severity = nsbaci::types::ErrSeverity::Error;
+  err.basic.message = "Session file: " + what;
+  err.basic.type = nsbaci::types::ErrType::unknown;
+  err.payload = nsbaci::types::RuntimeError{};
+  return SessionResult(std::move(err));
+}
+
+// Appends values in host byte order, which the header records
+class Writer {
+ public:
+  template <typename T>
+  void put(T value) {
+    static_assert(std::is_arithmetic_v<T>, "fixed-size values only");
+    bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void putString(const std::string& s) {
+    put(static_cast<uint32_t>(s.size()));
+    bytes += s;
+  }
+
+  void putRaw(const void* data, size_t size) {
+    bytes.append(static_cast<const char*>(data), size);
+  }
+
+  void align() { bytes.resize((bytes.size() + 7) & ~size_t(7), '\0'); }
+
+  std::string bytes;
+};
+
+// Bounds-checked reads; after the first failure every read fails
+class Reader {
+ public:
+  Reader(const char* d, size_t n) : data(d), size(n) {}
+
+  template <typename T>
+  T get() {
+    T value{};
+    if (const char* p = take(sizeof(T))) {
+      std::memcpy(&value, p, sizeof(T));
+    }
+    return value;
+  }
+
+  std::string getString() {
+    auto length = get<uint32_t>();
+    const char* p = take(length);
+    return p ? std::string(p, length) : std::string();
+  }
+
+  const char* take(size_t bytes) {
+    if (failed || size - pos < bytes) {
+      failed = true;
+      return nullptr;
+    }
+    const char* p = data + pos;
+    pos += bytes;
+    return p;
+  }
+
+  // Checks that count items of at least each bytes are left, before
+  // anything is allocated for them
+  bool fits(uint64_t count, size_t each) {
+    if (failed || count > (size - pos) / each) {
+      failed = true;
+    }
+    return !failed;
+  }
+
+  bool ok() const { return !failed; }
+
+ private:
+  const char* data;
+  size_t size;
+  size_t pos = 0;
+  bool failed = false;
+};
+
+void putOperand(Writer& w, const nsbaci::compiler::Operand& op) {
+  w.put(static_cast<uint8_t>(op.index()));
+  if (auto* i = std::get_if<int32_t>(&op)) {
+    w.put(*i);
+  } else if (auto* u = std::get_if<uint32_t>(&op)) {
+    w.put(*u);
+  } else if (auto* s = std::get_if<std::string>(&op)) {
+    w.putString(*s);
+  }
+}
+
+// Whether an instruction has the operands the interpreter reads from it,
+// with its direct address, if any, inside the data segment
+bool wellFormed(const nsbaci::compiler::Instruction& instr, size_t dataSize) {
+  using nsbaci::compiler::Opcode;
+  const auto& op = instr.operand1;
+  if (!std::holds_alternative<std::monostate>(instr.operand2)) {
+    return false;
+  }
+  switch (instr.opcode) {
+    case Opcode::LoadValue:
+    case Opcode::Store:
+    case Opcode::StoreKeep:
+    case Opcode::EnterMonitor:
+    case Opcode::ExitMonitor:
+      return std::holds_alternative<uint32_t>(op) &&
+             std::get<uint32_t>(op) < dataSize;
+    case Opcode::LoadAddress:
+    case Opcode::CopyBlock:
+      return std::holds_alternative<uint32_t>(op);
+    case Opcode::PushLiteral:
+    case Opcode::Jump:
+    case Opcode::JumpZero:
+      return std::holds_alternative<int32_t>(op);
+    case Opcode::WriteRawString:
+      return std::holds_alternative<std::string>(op);
+    case Opcode::Trap:
+      return false;  // Patched in by the runtime, never saved
+    default:
+      return std::holds_alternative<std::monostate>(op);
+  }
+}
+
+bool getOperand(Reader& r, nsbaci::compiler::Operand& op) {
+  switch (r.get<uint8_t>()) {
+    case 0:
+      op = std::monostate{};
+      break;
+    case 1:
+      op = r.get<int32_t>();
+      break;
+    case 2:
+      op = r.get<uint32_t>();
+      break;
+    case 3:
+      op = r.getString();
+      break;
+    default:
+      return false;
+  }
+  return r.ok();
+}
+
+void putIndices(Writer& w, const std::vector<size_t>& indices) {
+  w.put(static_cast<uint32_t>(indices.size()));
+  for (size_t i : indices) {
+    w.put(static_cast<uint64_t>(i));
+  }
+}
+
+bool getIndices(Reader& r, std::vector<size_t>& indices, size_t threads) {
+  auto count = r.get<uint32_t>();
+  if (!r.fits(count, sizeof(uint64_t))) {
+    return false;
+  }
+  indices.resize(count);
+  for (auto& i : indices) {
+    auto index = r.get<uint64_t>();
+    if (index >= threads) {
+      return false;
+    }
+    i = static_cast<size_t>(index);
+  }
+  return r.ok();
+}
+
+std::string writeCode(const CodeImage& image) {
+  Writer w;
+  const auto& code = image.instructions();
+  w.put(static_cast<uint32_t>(code.size()));
+  for (const auto& instr : code) {
+    w.put(static_cast<uint8_t>(instr.opcode));
+    putOperand(w, instr.operand1);
+    putOperand(w, instr.operand2);
+  }
+
+  // Sorted, so equal sessions give equal files
+  std::vector<const nsbaci::types::SymbolInfo*> symbols;
+  for (const auto& [name, info] : image.symbols()) {
+    symbols.push_back(&info);
+  }
+  std::sort(symbols.begin(), symbols.end(),
+            [](const auto* a, const auto* b) { return a->name < b->name; });
+  w.put(static_cast<uint32_t>(symbols.size()));
+  for (const auto* info : symbols) {
+    w.putString(info->name);
+    w.put(info->address);
+    w.putString(info->type);
+    w.put(static_cast<uint8_t>(info->isGlobal));
+    w.put(info->size);
+  }
+  return std::move(w.bytes);
+}
+
+bool readCode(Reader& r, Session& s) {
+  using nsbaci::compiler::Opcode;
+  nsbaci::compiler::InstructionStream code;
+  auto count = r.get<uint32_t>();
+  if (!r.fits(count, 3)) {
+    return false;
+  }
+  code.resize(count);
+  for (auto& instr : code) {
+    auto opcode = r.get<uint8_t>();
+    if (opcode >= static_cast<uint8_t>(Opcode::_Count) ||
+        !getOperand(r, instr.operand1) || !getOperand(r, instr.operand2)) {
+      return false;
+    }
+    instr.opcode = static_cast<Opcode>(opcode);
+  }
+
+  nsbaci::types::SymbolTable symbols;
+  count = r.get<uint32_t>();
+  if (!r.fits(count, 17)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < count; ++i) {
+    nsbaci::types::SymbolInfo info;
+    info.name = r.getString();
+    info.address = r.get<uint32_t>();
+    info.type = r.getString();
+    info.isGlobal = r.get<uint8_t>() != 0;
+    info.size = r.get<uint32_t>();
+    symbols[info.name] = std::move(info);
+  }
+  if (!r.ok()) {
+    return false;
+  }
+
+  // The image sizes its data segment from the symbol table, and the
+  // interpreter trusts operand types: both are checked before it is built,
+  // against the memory section read first
+  size_t extent = 0;
+  for (const auto& [name, info] : symbols) {
+    extent = std::max<size_t>(extent, size_t(info.address) + info.size);
+  }
+  if (extent != s.memory.size()) {
+    return false;
+  }
+  for (const auto& instr : code) {
+    if (!wellFormed(instr, extent)) {
+      return false;
+    }
+  }
+
+  s.image =
+      std::make_shared<const CodeImage>(std::move(code), std::move(symbols));
+  return true;
+}
+
+std::string writeLines(const nsbaci::compiler::LineTable& lines) {
+  Writer w;
+  w.put(lines.instructionCount());
+  w.put(static_cast<uint32_t>(lines.runs().size()));
+  for (const auto& run : lines.runs()) {
+    w.put(run.pc);
+    w.put(run.line);
+  }
+  return std::move(w.bytes);
+}
+
+// Read after the code image, which is rebuilt with the table attached
+bool readLines(Reader& r, Session& s) {
+  auto end = r.get<uint32_t>();
+  auto count = r.get<uint32_t>();
+  if (!r.fits(count, 8) || end != s.image->instructionCount()) {
+    return false;
+  }
+  nsbaci::compiler::LineTable lines;
+  uint32_t last = 0;
+  for (uint32_t i = 0; i < count; ++i) {
+    auto pc = r.get<uint32_t>();
+    auto line = r.get<uint32_t>();
+    if (pc >= end || (i > 0 && pc <= last)) {
+      return false;
+    }
+    lines.mark(pc, line);
+    last = pc;
+  }
+  lines.finish(end);
+  s.image = std::make_shared<const CodeImage>(
+      s.image->instructions(), s.image->symbols(), std::move(lines));
+  return r.ok();
+}
+
+std::string writeMemory(const nsbaci::types::Memory& memory) {
+  Writer w;
+  w.put(static_cast<uint64_t>(memory.size()));
+  w.putRaw(memory.data(), memory.size() * sizeof(int32_t));
+  return std::move(w.bytes);
+}
+
+bool readMemory(Reader& r, Session& s) {
+  auto words = r.get<uint64_t>();
+  if (!r.fits(words, sizeof(int32_t))) {
+    return false;
+  }
+  const char* p = r.take(words * sizeof(int32_t));
+  s.memory.resize(words);
+  if (words > 0) {
+    std::memcpy(s.memory.data(), p, words * sizeof(int32_t));
+  }
+  return true;
+}
+
+std::string writeThreads(const std::vector<Thread>& threads) {
+  Writer w;
+  w.put(static_cast<uint32_t>(threads.size()));
+  for (const auto& t : threads) {
+    w.put(static_cast<uint64_t>(t.getId()));
+    w.put(static_cast<uint8_t>(t.getState()));
+    w.put(static_cast<uint64_t>(t.getPriority()));
+    w.put(t.getPC());
+    w.put(t.getBP());
+    w.put(t.getSP());
+    const auto& stack = t.getStack();
+    w.put(static_cast<uint32_t>(stack.size()));
+    w.putRaw(stack.data(), stack.size() * sizeof(int32_t));
+  }
+  return std::move(w.bytes);
+}
+
+bool readThreads(Reader& r, Session& s) {
+  using nsbaci::types::ThreadState;
+  auto count = r.get<uint32_t>();
+  if (!r.fits(count, 33)) {
+    return false;
+  }
+  auto& threads = s.threads.threads;
+  threads.reserve(count);
+  std::vector<int32_t> stack;
+  std::vector<nsbaci::types::ThreadID> ids;
+  for (uint32_t i = 0; i < count; ++i) {
+    Thread t(r.get<uint64_t>());
+    ids.push_back(t.getId());
+    auto state = r.get<uint8_t>();
+    if (state > static_cast<uint8_t>(ThreadState::Terminated)) {
+      return false;
+    }
+    t.setState(static_cast<ThreadState>(state));
+    t.setPriority(static_cast<nsbaci::types::Priority>(r.get<uint64_t>()));
+    t.setPC(r.get<uint32_t>());
+    t.setBP(r.get<uint32_t>());
+    auto sp = r.get<uint32_t>();
+
+    // The stack pointer counts the words on the stack
+    auto depth = r.get<uint32_t>();
+    if (t.getPC() >= s.image->instructionCount() || sp != depth ||
+        !r.fits(depth, sizeof(int32_t))) {
+      return false;
+    }
+    stack.resize(depth);
+    if (depth > 0) {
+      std::memcpy(stack.data(), r.take(depth * sizeof(int32_t)),
+                  depth * sizeof(int32_t));
+    }
+    t.pushBlock(stack.data(), stack.size());
+    t.setSP(sp);
+    threads.push_back(std::move(t));
+  }
+  std::sort(ids.begin(), ids.end());
+  return r.ok() && std::adjacent_find(ids.begin(), ids.end()) == ids.end();
+}
+
+std::string writeQueues(const SchedulerState& st) {
+  Writer w;
+  putIndices(w, st.readyQueue);
+  putIndices(w, st.blockedQueue);
+  putIndices(w, st.ioQueue);
+  w.put(static_cast<uint8_t>(st.runningIndex.has_value()));
+  w.put(static_cast<uint64_t>(st.runningIndex.value_or(0)));
+  w.put(static_cast<uint64_t>(st.nextThreadId));
+
+  auto edges = st.waitFor.allEdges();
+  w.put(static_cast<uint32_t>(edges.size()));
+  for (const auto& e : edges) {
+    w.put(static_cast<uint64_t>(e.waiter));
+    w.put(static_cast<uint8_t>(e.resource.kind));
+    w.put(e.resource.address);
+    w.put(static_cast<uint8_t>(e.holder.has_value()));
+    w.put(static_cast<uint64_t>(e.holder.value_or(0)));
+  }
+  return std::move(w.bytes);
+}
+
+bool readQueues(Reader& r, Session& s) {
+  using nsbaci::types::ResourceKind;
+  auto& st = s.threads;
+  size_t threads = st.threads.size();
+  if (!getIndices(r, st.readyQueue, threads) ||
+      !getIndices(r, st.blockedQueue, threads) ||
+      !getIndices(r, st.ioQueue, threads)) {
+    return false;
+  }
+  bool running = r.get<uint8_t>() != 0;
+  auto runningIndex = r.get<uint64_t>();
+  if (running) {
+    if (runningIndex >= threads) {
+      return false;
+    }
+    st.runningIndex = static_cast<size_t>(runningIndex);
+  }
+  st.nextThreadId = r.get<uint64_t>();
+
+  // Edges name threads by ID, and new threads must not reuse one
+  std::vector<nsbaci::types::ThreadID> ids;
+  for (const auto& t : st.threads) {
+    ids.push_back(t.getId());
+  }
+  std::sort(ids.begin(), ids.end());
+  auto exists = [&ids](nsbaci::types::ThreadID id) {
+    return std::binary_search(ids.begin(), ids.end(), id);
+  };
+  if (!ids.empty() && st.nextThreadId <= ids.back()) {
+    return false;
+  }
+
+  auto count = r.get<uint32_t>();
+  if (!r.fits(count, 22)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < count; ++i) {
+    WaitEdge e;
+    e.waiter = r.get<uint64_t>();
+    auto kind = r.get<uint8_t>();
+    if (!exists(e.waiter) || kind > static_cast<uint8_t>(ResourceKind::Spin)) {
+      return false;
+    }
+    e.resource.kind = static_cast<ResourceKind>(kind);
+    e.resource.address = r.get<uint32_t>();
+    bool held = r.get<uint8_t>() != 0;
+    auto holder = r.get<uint64_t>();
+    if (held) {
+      if (!exists(holder)) {
+        return false;
+      }
+      e.holder = holder;
+    }
+    st.waitFor.add(std::move(e));
+  }
+  return r.ok();
+}
+
+std::string writeRuntime(const Session& s) {
+  Writer w;
+  w.put(s.stepCount);
+  w.put(static_cast<uint8_t>(s.halted));
+  w.put(static_cast<uint8_t>(s.input.waiting));
+  w.put(static_cast<uint8_t>(s.input.available));
+  w.putString(s.input.value);
+  return std::move(w.bytes);
+}
+
+bool readRuntime(Reader& r, Session& s) {
+  s.stepCount = r.get<uint64_t>();
+  s.halted = r.get<uint8_t>() != 0;
+  s.input.waiting = r.get<uint8_t>() != 0;
+  s.input.available = r.get<uint8_t>() != 0;
+  s.input.value = r.getString();
+  return r.ok();
+}
+
+}  // namespace
+
+std::string Session::serialize() const {
+  std::vector<std::pair<SectionKind, std::string>> sections;
+  sections.emplace_back(SectionKind::Code,
+                        image ? writeCode(*image) : writeCode(CodeImage()));
+  sections.emplace_back(SectionKind::Memory, writeMemory(memory));
+  sections.emplace_back(SectionKind::Threads, writeThreads(threads.threads));
+  sections.emplace_back(SectionKind::Queues, writeQueues(threads));
+  sections.emplace_back(SectionKind::Random, randomState);
+  sections.emplace_back(SectionKind::Runtime, writeRuntime(*this));
+  if (image && !image->lines().empty()) {
+    sections.emplace_back(SectionKind::Lines, writeLines(image->lines()));
+  }
+
+  Writer w;
+  w.putRaw(MAGIC, sizeof(MAGIC));
+  w.put(VERSION);
+  w.put(ENDIAN_MARK);
+  w.put(static_cast<uint32_t>(sections.size()));
+  w.put(uint32_t(0));
+
+  // Section table, then every section at an 8-byte boundary
+  uint64_t offset = HEADER_SIZE + ENTRY_SIZE * sections.size();
+  for (const auto& [kind, bytes] : sections) {
+    w.put(static_cast<uint32_t>(kind));
+    w.put(uint32_t(0));
+    w.put(offset);
+    w.put(static_cast<uint64_t>(bytes.size()));
+    offset = (offset + bytes.size() + 7) & ~uint64_t(7);
+  }
+  for (const auto& section : sections) {
+    w.bytes += section.second;
+    w.align();
+  }
+  return std::move(w.bytes);
+}
+
+SessionResult Session::parse(const char* data, size_t size) {
+  Reader header(data, size);
+  const char* magic = header.take(sizeof(MAGIC));
+  if (!magic || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+    return malformed("not an nsbaci session");
+  }
+  auto version = header.get<uint32_t>();
+  if (header.get<uint32_t>() != ENDIAN_MARK) {
+    return malformed("saved on a machine with a different byte order");
+  }
+  if (version == 0 || version > VERSION) {
+    return malformed("format version " + std::to_string(version) +
+                     " is not supported");
+  }
+  auto count = header.get<uint32_t>();
+  header.get<uint32_t>();
+  if (!header.fits(count, ENTRY_SIZE)) {
+    return malformed("section table is truncated");
+  }
+
+  using Reading = bool (*)(Reader&, Session&);
+  struct Known {
+    SectionKind kind;
+    Reading read;
+    const char* name;
+    bool required;
+    bool seen;
+  };
+  Known known[] = {
+      {SectionKind::Memory, readMemory, "memory", true, false},
+      {SectionKind::Code, readCode, "code image", true, false},
+      {SectionKind::Lines, readLines, "line table", false, false},
+      {SectionKind::Threads, readThreads, "thread table", true, false},
+      {SectionKind::Queues, readQueues, "queues", true, false},
+      {SectionKind::Random, nullptr, "random state", true, false},
+      {SectionKind::Runtime, readRuntime, "runtime", true, false},
+  };
+
+  // Locate every section first: each is read against those before it in
+  // known, the code against the memory and the queues against the threads
+  std::vector<std::pair<const char*, size_t>> found(std::size(known));
+  for (uint32_t i = 0; i < count; ++i) {
+    auto kind = header.get<uint32_t>();
+    header.get<uint32_t>();
+    auto offset = header.get<uint64_t>();
+    auto length = header.get<uint64_t>();
+    if (offset > size || length > size - offset) {
+      return malformed("section " + std::to_string(i) +
+                       " lies outside the file");
+    }
+    for (size_t k = 0; k < std::size(known); ++k) {
+      if (static_cast<uint32_t>(known[k].kind) == kind) {
+        found[k] = {data + offset, static_cast<size_t>(length)};
+        known[k].seen = true;
+      }
+    }
+  }
+
+  SessionResult result;
+  Session& s = result.session;
+  for (size_t k = 0; k < std::size(known); ++k) {
+    if (!known[k].seen) {
+      if (!known[k].required) {
+        continue;
+      }
+      return malformed(std::string("missing ") + known[k].name + " section");
+    }
+    Reader r(found[k].first, found[k].second);
+    if (!known[k].read) {
+      s.randomState.assign(found[k].first, found[k].second);
+    } else if (!known[k].read(r, s)) {
+      return malformed(std::string("corrupt ") + known[k].name + " section");
+    }
+  }
+  return result;
+}
+
+}  // namespace nsbaci::services::runtime
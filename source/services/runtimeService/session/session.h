@@ -0,0 +1,112 @@
+/**
+ * @file session.h
+ * @brief Session struct declaration for nsbaci runtime service.
+ *
+ * This module defines a complete, resumable snapshot of a run and its
+ * binary file format. A session holds everything that decides how the run
+ * goes on: the code, global memory, every thread, the scheduler queues and
+ * wait-for graph, the scheduler's random state and the pending input.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_SESSION_H
+#define NSBACI_SERVICES_RUNTIME_SESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "baseResult.h"
+#include "codeImage.h"
+#include "interpreter.h"
+#include "scheduler.h"
+
+/**
+ * @namespace nsbaci::services::runtime
+ * @brief Runtime services namespace for nsbaci.
+ */
+namespace nsbaci::services::runtime {
+
+struct SessionResult;
+
+/**
+ * @struct Session
+ * @brief Everything needed to resume a run in another process.
+ *
+ * The file format is versioned and little-endian, and laid out so that a
+ * memory-mapped file can be parsed in place:
+ *
+ * - a 24-byte header: the magic "NSBACIVM", the format version, a
+ *   byte-order mark and the number of sections;
+ * - a table with the kind, offset and size of each section;
+ * - the sections, each starting at a multiple of 8 bytes: code image,
+ *   memory, thread table, queues, random state and runtime counters, plus
+ *   the source line table when the code was compiled from source.
+ *
+ * Global memory is stored as a raw array of words after its length, so
+ * restoring it is a single copy out of the mapping. Readers skip section
+ * kinds they do not know, so later versions can add sections without
+ * breaking older files.
+ */
+struct Session {
+  std::shared_ptr<const CodeImage> image;  ///< Code and symbols.
+  nsbaci::types::Memory memory;            ///< Global memory.
+  SchedulerState threads;                  ///< Threads, queues and waits.
+  std::string randomState;   ///< See Scheduler::saveRandomState().
+  InputState input;          ///< Pending input.
+  uint64_t stepCount = 0;    ///< Instructions executed so far.
+  bool halted = false;       ///< True if the program had finished.
+
+  /**
+   * @brief Encodes the session in the binary format.
+   * @return The file contents.
+   */
+  std::string serialize() const;
+
+  /**
+   * @brief Decodes a session written by serialize().
+   *
+   * Every count and index is checked against the data, so a truncated or
+   * corrupt file gives an error rather than a bad session. So are the
+   * operands of every instruction, the data segment against the memory,
+   * and the pc, stack and ID of every thread, before anything is built
+   * from them.
+   *
+   * @param data Start of the file contents, typically a mapping of the file.
+   * @param size Size of the contents in bytes.
+   * @return The session, or an error describing what is wrong.
+   */
+  static SessionResult parse(const char* data, size_t size);
+};
+
+/**
+ * @struct SessionResult
+ * @brief Result of reading a session file.
+ */
+struct SessionResult : nsbaci::BaseResult {
+  /**
+   * @brief Default constructor creates a successful result.
+   */
+  SessionResult() : BaseResult() {}
+
+  /**
+   * @brief Constructs a failed result from a single error.
+   * @param error Why the session could not be read.
+   */
+  explicit SessionResult(nsbaci::Error error) : BaseResult(std::move(error)) {}
+
+  SessionResult(SessionResult&&) noexcept = default;
+  SessionResult& operator=(SessionResult&&) noexcept = default;
+  SessionResult(const SessionResult&) = default;
+  SessionResult& operator=(const SessionResult&) = default;
+
+  Session session;  ///< The session read.
+};
+
+}  // namespace nsbaci::services::runtime
+
+#endif  // NSBACI_SERVICES_RUNTIME_SESSION_H
@@ -0,0 +1,47 @@
+/**
+ * @file runtimeStats.cpp
+ * @brief StatsCounter class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "runtimeStats.h"
+
+namespace nsbaci::services::runtime {
+
+void StatsCounter::reset() {
+  stats = RuntimeStats{};
+  lastThread = 0;
+  sampleCount = 0;
+}
+
+void StatsCounter::sampleClock() {
+  Sample now{Clock::now(), stats.instructions};
+  if (sampleCount > 0) {
+    const Sample& last = samples[(sampleCount - 1) % WINDOW];
+    if (now.time - last.time < SAMPLE_PERIOD) {
+      return;
+    }
+    // A pause between runs is not slow running: start a new window
+    if (now.time - last.time > SAMPLE_PERIOD * WINDOW) {
+      sampleCount = 0;
+    }
+  }
+  samples[sampleCount % WINDOW] = now;
+  ++sampleCount;
+
+  // Rate from the oldest sample still in the window
+  if (sampleCount > 1) {
+    size_t oldest = sampleCount > WINDOW ? sampleCount % WINDOW : 0;
+    const Sample& first = samples[oldest];
+    std::chrono::duration<double> span = now.time - first.time;
+    if (span.count() > 0) {
+      stats.instructionsPerSecond =
+          double(now.instructions - first.instructions) / span.count();
+    }
+  }
+}
+
+}  // namespace nsbaci::services::runtime
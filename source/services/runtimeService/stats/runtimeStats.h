@@ -0,0 +1,154 @@
+/**
+ * @file runtimeStats.h
+ * @brief RuntimeStats struct and StatsCounter class declaration for nsbaci
+ * runtime service.
+ *
+ * This module defines the execution statistics the runtime keeps: what was
+ * executed, by whom, how often the scheduler switched and blocked threads,
+ * and how fast the interpreter is going. They are built in when the
+ * NSBACI_RUNTIME_STATS flag is defined (the CMake option of the same name,
+ * on by default); otherwise every counter is compiled out.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_RUNTIMESTATS_H
+#define NSBACI_SERVICES_RUNTIME_RUNTIMESTATS_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "instruction.h"
+#include "runtimeTypes.h"
+
+/**
+ * @namespace nsbaci::services::runtime
+ * @brief Runtime services namespace for nsbaci.
+ */
+namespace nsbaci::services::runtime {
+
+/// @brief True if the runtime keeps statistics (NSBACI_RUNTIME_STATS).
+#ifdef NSBACI_RUNTIME_STATS
+inline constexpr bool RUNTIME_STATS = true;
+#else
+inline constexpr bool RUNTIME_STATS = false;
+#endif
+
+/**
+ * @struct RuntimeStats
+ * @brief Execution statistics since the last reset.
+ */
+struct RuntimeStats {
+  /// @brief Instructions executed, by opcode
+  std::array<uint64_t, static_cast<size_t>(nsbaci::compiler::Opcode::_Count)>
+      byOpcode{};
+  std::vector<uint64_t> byThread;  ///< Instructions executed, by thread ID.
+  uint64_t instructions = 0;       ///< Instructions executed.
+  uint64_t contextSwitches = 0;    ///< Steps by another thread than before.
+  uint64_t blocks = 0;             ///< Blocks on a semaphore or monitor.
+  uint64_t wakeups = 0;            ///< Wakeups by a signal or monitor exit.
+  uint64_t readySum = 0;           ///< Ready queue length summed over steps.
+  /// @brief Instructions per second over the last second or so of running
+  double instructionsPerSecond = 0;
+
+  /**
+   * @brief Gets the average number of threads waiting to run.
+   * @return Ready queue length averaged over the steps executed.
+   */
+  double averageReady() const {
+    return instructions ? double(readySum) / double(instructions) : 0.0;
+  }
+};
+
+/**
+ * @class StatsCounter
+ * @brief Maintains RuntimeStats with plain increments.
+ *
+ * The rate is measured over a sliding window of clock samples. The clock is
+ * read once every CLOCK_EVERY instructions, and a sample kept at most every
+ * SAMPLE_PERIOD, so timing costs nothing per step.
+ */
+class StatsCounter {
+ public:
+  /// @brief Instructions between two reads of the clock (power of two).
+  static constexpr uint64_t CLOCK_EVERY = 4096;
+  /// @brief Clock samples in the window.
+  static constexpr size_t WINDOW = 8;
+  /// @brief Least time between two samples.
+  static constexpr std::chrono::milliseconds SAMPLE_PERIOD{125};
+
+  /**
+   * @brief Drops every count.
+   */
+  void reset();
+
+  /**
+   * @brief Counts one executed instruction.
+   * @param thread Thread that executed it.
+   * @param opcode Its opcode.
+   * @param ready Threads in the ready queue after the step.
+   */
+  void record(nsbaci::types::ThreadID thread, nsbaci::compiler::Opcode opcode,
+              size_t ready) {
+    ++stats.byOpcode[static_cast<size_t>(opcode)];
+    if (thread >= stats.byThread.size()) {
+      stats.byThread.resize(thread + 1, 0);
+    }
+    ++stats.byThread[thread];
+    if (thread != lastThread && stats.instructions > 0) {
+      ++stats.contextSwitches;
+    }
+    lastThread = thread;
+    stats.readySum += ready;
+    if ((++stats.instructions & (CLOCK_EVERY - 1)) == 0) {
+      sampleClock();
+    }
+  }
+
+  /**
+   * @brief Counts a thread blocking on a semaphore or monitor.
+   */
+  void recordBlock() { ++stats.blocks; }
+
+  /**
+   * @brief Counts a thread woken by a semaphore or monitor.
+   */
+  void recordWakeup() { ++stats.wakeups; }
+
+  /**
+   * @brief Access to the statistics.
+   * @return Const reference to the statistics.
+   */
+  const RuntimeStats& get() const { return stats; }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @struct Sample
+   * @brief Instructions executed by a point in time.
+   */
+  struct Sample {
+    Clock::time_point time;     ///< When it was taken.
+    uint64_t instructions = 0;  ///< Count then.
+  };
+
+  /**
+   * @brief Reads the clock and updates the rate.
+   */
+  void sampleClock();
+
+  RuntimeStats stats;                      ///< The counts.
+  nsbaci::types::ThreadID lastThread = 0;  ///< Thread of the last step.
+  std::array<Sample, WINDOW> samples{};    ///< Ring of clock samples.
+  size_t sampleCount = 0;                  ///< Samples in the window.
+};
+
+}  // namespace nsbaci::services::runtime
+
+#endif  // NSBACI_SERVICES_RUNTIME_RUNTIMESTATS_H
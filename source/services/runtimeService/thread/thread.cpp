@@ -15,8 +15,6 @@ using namespace nsbaci::types;
 
 namespace nsbaci::services::runtime {
 
-ThreadID Thread::nextThreadId = 0;
-
 ThreadID Thread::getId() const { return id; }
 
 ThreadState Thread::getState() const { return state; }
@@ -28,6 +26,10 @@ Priority Thread::getPriority() const { return priority; }
 void Thread::setPriority(Priority newPriority) { priority = newPriority; }
 
 void Thread::push(int32_t value) {
+  if (stackLog) {
+    stackLog->push_back({true, value});
+  }
+  stackHash ^= zobrist::stackKey(id, stack.size(), value);
   stack.push_back(value);
   ++sp;
 }
@@ -37,11 +39,26 @@ int32_t Thread::pop() {
     throw std::runtime_error("Stack underflow");
   }
   int32_t value = stack.back();
+  if (stackLog) {
+    stackLog->push_back({false, value});
+  }
   stack.pop_back();
+  stackHash ^= zobrist::stackKey(id, stack.size(), value);
   --sp;
   return value;
 }
 
+void Thread::pushBlock(const int32_t* values, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    stackHash ^= zobrist::stackKey(id, stack.size() + i, values[i]);
+    if (stackLog) {
+      stackLog->push_back({true, values[i]});
+    }
+  }
+  stack.insert(stack.end(), values, values + count);
+  sp += static_cast<uint32_t>(count);
+}
+
 int32_t Thread::top() const {
   if (stack.empty()) {
     throw std::runtime_error("Stack is empty");
@@ -10,11 +10,13 @@
 #ifndef NSBACI_SERVICES_RUNTIME_THREAD_H
 #define NSBACI_SERVICES_RUNTIME_THREAD_H
 
+#include <cstddef>
 #include <cstdint>
 #include <queue>
 #include <vector>
 
 #include "runtimeTypes.h"
+#include "zobrist.h"
 
 /**
  * @namespace nsbaci::services::runtime
@@ -22,6 +24,15 @@
  */
 namespace nsbaci::services::runtime {
 
+/**
+ * @struct StackChange
+ * @brief One push or pop on a thread's stack.
+ */
+struct StackChange {
+  bool push = false;  ///< True for a push, false for a pop.
+  int32_t value = 0;  ///< Value pushed or popped.
+};
+
 /**
  * @class Thread
  * @brief Represents a thread in the runtime service.
@@ -30,8 +41,16 @@ namespace nsbaci::services::runtime {
  */
 class Thread {
  public:
-  Thread()
-      : id(nextThreadId++),
+  /**
+   * @brief Constructs a ready thread.
+   *
+   * IDs are unique per scheduler, not per process, so that independent
+   * runtimes can run side by side; see Scheduler::allocateThreadId().
+   *
+   * @param threadId Identifier of the thread (0 is the main thread).
+   */
+  explicit Thread(nsbaci::types::ThreadID threadId = 0)
+      : id(threadId),
         state(nsbaci::types::ThreadState::Ready),
         priority(0),
         pc(0),
@@ -81,11 +100,41 @@ class Thread {
    */
   int32_t pop();
 
+  /**
+   * @brief Push a contiguous block of values onto the thread's stack.
+   * @param values Pointer to the first value.
+   * @param count Number of values to push.
+   */
+  void pushBlock(const int32_t* values, size_t count);
+
   /**
    * @brief Peek at the top of the stack without removing.
    */
   int32_t top() const;
 
+  /**
+   * @brief Read-only view of the whole stack, bottom first.
+   */
+  const std::vector<int32_t>& getStack() const { return stack; }
+
+  /**
+   * @brief Zobrist fingerprint of this thread.
+   *
+   * The stack part is maintained on every push and pop; pc and state are
+   * folded in here, which is cheaper than rehashing them on every step.
+   * Running counts as Ready, since the scheduler flips between the two
+   * without changing what the thread will do next.
+   *
+   * @return 64-bit fingerprint.
+   */
+  uint64_t fingerprint() const {
+    auto s = state == nsbaci::types::ThreadState::Running
+                 ? nsbaci::types::ThreadState::Ready
+                 : state;
+    return stackHash ^ zobrist::key(zobrist::Pc, id, pc) ^
+           zobrist::key(zobrist::State, id, static_cast<uint64_t>(s));
+  }
+
   // ============== Program Counter ==============
 
   /**
@@ -111,6 +160,17 @@ class Thread {
   uint32_t getSP() const { return sp; }
   void setSP(uint32_t addr) { sp = addr; }
 
+  /**
+   * @brief Log every push and pop from now on.
+   *
+   * Used to undo a step: replaying the log backwards (pop for each push,
+   * push for each pop) restores the stack. Not owned and copied along with
+   * the thread, so set it only around the operations to be logged.
+   *
+   * @param log Vector to append to, or nullptr to stop logging.
+   */
+  void setStackLog(std::vector<StackChange>* log) { stackLog = log; }
+
  private:
   nsbaci::types::ThreadID id;
   nsbaci::types::ThreadState state;
@@ -125,8 +185,10 @@ class Thread {
 
   // Thread-local stack
   std::vector<int32_t> stack;
-
-  static nsbaci::types::ThreadID nextThreadId;
+  // Fingerprint of the stack contents
+  uint64_t stackHash = 0;
+  // Receives every push and pop while set
+  std::vector<StackChange>* stackLog = nullptr;
 
   // friend the scheduler
 };
@@ -0,0 +1,636 @@
+/**
+ * @file main.cpp
+ * @brief Headless CLI that compiles and runs an nsbaci program.
+ *
+ * Compiles a .nsb file and executes it with the runtime service, without
+ * starting the Qt application. Program output goes to stdout; diagnostics
+ * and the execution summary (steps, wall time, instructions per second) go
+ * to stderr, so stdout can be compared directly against expected output.
+ *
+ * Usage:
+ * @code
+ * nsbaci-run [--scheduler nsbaci|pct [--pct-depth D] [--pct-steps K]]
+ *            [--seed N] [--input FILE] [--record LOG] [--replay LOG]
+ *            [--max-steps N] [--runs N [--jobs N]] [--explore]
+ *            [--save-session FILE] [--binary-trace FILE]
+ *            (program.nsb | --resume FILE)
+ * nsbaci-run --dump-trace FILE [--from STEP]
+ * @endcode
+ *
+ * With --runs N the program runs under seeds seed .. seed+N-1 in parallel
+ * and stdout gets a summary of the distinct outcomes instead of the output.
+ * --scheduler pct makes every run a PCT run (see PctScheduler), which finds
+ * ordering bugs of depth D in far fewer runs than uniform random picking.
+ * With --explore every interleaving is searched instead, and each finding is
+ * printed with the schedule that reproduces it.
+ *
+ * --record LOG saves every scheduling and input decision of a single run to
+ * LOG; --replay LOG reruns exactly those decisions, whatever the scheduler
+ * and seed, and then carries on normally.
+ *
+ * --save-session FILE writes the whole state of a single run to FILE when it
+ * stops, for example at the step limit; --resume FILE carries on from there
+ * instead of compiling a program, with the same scheduler random state. The
+ * step count carries on too, so --max-steps counts from the original start.
+ *
+ * --binary-trace FILE records every instruction of a single run, with the
+ * global words it wrote, as a compact binary trace (see BinaryTraceWriter).
+ * --dump-trace FILE prints such a trace as text instead of running anything,
+ * one instruction per line; --from STEP seeks straight to that step.
+ *
+ * Exit status: 0 if the program halted (every run, with --runs), 1 on a
+ * load, compile or runtime error, 2 on bad usage, 3 if the step limit was
+ * reached, 4 if the run kept revisiting states (probable livelock), 5 on a
+ * deadlock.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "batchRunner.h"
+#include "binaryTraceReader.h"
+#include "explorer.h"
+#include "fileService.h"
+#include "nsbaciCompiler.h"
+#include "runtimeServiceFactory.h"
+
+namespace {
+
+/**
+ * @struct Options
+ * @brief Command-line options of the runner.
+ */
+struct Options {
+  std::string file;                  ///< Program to run.
+  std::string scheduler = "nsbaci";  ///< Scheduler name.
+  uint64_t seed = 0;                 ///< Scheduler seed.
+  bool hasSeed = false;              ///< True if --seed was given.
+  std::string input;                 ///< Input file, stdin if empty.
+  uint64_t maxSteps = 0;             ///< Step limit, 0 = unlimited.
+  uint64_t runs = 1;                 ///< Number of seeds to run.
+  uint64_t jobs = 0;                 ///< Batch workers, 0 = all cores.
+  bool explore = false;              ///< Search every interleaving.
+  bool races = false;                ///< Detect data races.
+  bool spinParking = true;           ///< Park busy-waiting threads.
+  uint64_t pctDepth = 3;             ///< Bug depth targeted by pct.
+  uint64_t pctSteps = 1000;          ///< Run length estimate for pct.
+  std::string record;                ///< Replay log to write, if any.
+  std::string replay;                ///< Replay log to follow, if any.
+  std::string saveSession;           ///< Session file to write, if any.
+  std::string resume;                ///< Session file to resume, if any.
+  std::string binaryTrace;           ///< Binary trace to write, if any.
+  std::string dumpTrace;             ///< Binary trace to print, if any.
+  uint64_t from = 0;                 ///< First step printed.
+};
+
+void printUsage(std::ostream& os) {
+  os << "Usage: nsbaci-run [options] (program.nsb | --resume FILE)\n"
+     << "       nsbaci-run --dump-trace FILE [--from STEP]\n"
+     << "  --scheduler NAME  scheduler to use (nsbaci, pct)\n"
+     << "  --pct-depth D     bug depth targeted by pct (default 3)\n"
+     << "  --pct-steps K     estimated run length for pct (default 1000)\n"
+     << "  --seed N          seed for the scheduler (random if omitted)\n"
+     << "  --input FILE      read program input from FILE instead of stdin\n"
+     << "  --record LOG      save the run's scheduling and input decisions\n"
+     << "  --replay LOG      rerun the decisions saved in LOG\n"
+     << "  --save-session F  save the whole run to F (.session) when it stops\n"
+     << "  --resume F        carry on the run saved in F instead of a program\n"
+     << "  --binary-trace F  record every instruction to F (.nsbtrace)\n"
+     << "  --dump-trace F    print the binary trace F as text\n"
+     << "  --from STEP       with --dump-trace, start at STEP\n"
+     << "  --max-steps N     stop after N instructions (0 = unlimited)\n"
+     << "  --runs N          run N seeds in parallel and summarise outcomes\n"
+     << "  --jobs N          worker threads for --runs/--explore (0 = all)\n"
+     << "  --explore         search every interleaving (--max-steps bounds "
+        "depth)\n"
+     << "  --races           report data races on global variables\n"
+     << "  --no-spin-park    let busy-waiting threads spin instead of "
+        "parking\n";
+}
+
+bool parseUnsigned(const std::string& text, uint64_t& out) {
+  try {
+    size_t used = 0;
+    out = std::stoull(text, &used);
+    return used == text.size() && text.find('-') == std::string::npos;
+  } catch (...) {
+    return false;
+  }
+}
+
+bool parseOptions(int argc, char* argv[], Options& opts) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+
+    if (arg == "-h" || arg == "--help") {
+      return false;
+    } else if (arg == "--scheduler" && hasValue) {
+      opts.scheduler = argv[++i];
+    } else if (arg == "--pct-depth" && hasValue) {
+      if (!parseUnsigned(argv[++i], opts.pctDepth) || opts.pctDepth == 0 ||
+          opts.pctDepth > UINT32_MAX) {
+        return false;
+      }
+    } else if (arg == "--pct-steps" && hasValue) {
+      if (!parseUnsigned(argv[++i], opts.pctSteps) || opts.pctSteps == 0) {
+        return false;
+      }
+    } else if (arg == "--seed" && hasValue) {
+      if (!parseUnsigned(argv[++i], opts.seed)) {
+        return false;
+      }
+      opts.hasSeed = true;
+    } else if (arg == "--input" && hasValue) {
+      opts.input = argv[++i];
+    } else if (arg == "--record" && hasValue) {
+      opts.record = argv[++i];
+    } else if (arg == "--replay" && hasValue) {
+      opts.replay = argv[++i];
+    } else if (arg == "--save-session" && hasValue) {
+      opts.saveSession = argv[++i];
+    } else if (arg == "--resume" && hasValue) {
+      opts.resume = argv[++i];
+    } else if (arg == "--binary-trace" && hasValue) {
+      opts.binaryTrace = argv[++i];
+    } else if (arg == "--dump-trace" && hasValue) {
+      opts.dumpTrace = argv[++i];
+    } else if (arg == "--from" && hasValue) {
+      if (!parseUnsigned(argv[++i], opts.from)) {
+        return false;
+      }
+    } else if (arg == "--max-steps" && hasValue) {
+      if (!parseUnsigned(argv[++i], opts.maxSteps)) {
+        return false;
+      }
+    } else if (arg == "--runs" && hasValue) {
+      if (!parseUnsigned(argv[++i], opts.runs) || opts.runs == 0) {
+        return false;
+      }
+    } else if (arg == "--jobs" && hasValue) {
+      if (!parseUnsigned(argv[++i], opts.jobs)) {
+        return false;
+      }
+    } else if (arg == "--explore") {
+      opts.explore = true;
+    } else if (arg == "--races") {
+      opts.races = true;
+    } else if (arg == "--no-spin-park") {
+      opts.spinParking = false;
+    } else if (!arg.empty() && arg[0] != '-' && opts.file.empty()) {
+      opts.file = arg;
+    } else {
+      return false;
+    }
+  }
+  if (!opts.dumpTrace.empty()) {
+    // Nothing is run
+    return opts.file.empty() && opts.resume.empty();
+  }
+  if (!opts.binaryTrace.empty() && (opts.explore || opts.runs > 1)) {
+    return false;
+  }
+  if (!opts.resume.empty()) {
+    // A session is a single run that is already under way
+    return opts.file.empty() && !opts.explore && opts.runs == 1 &&
+           opts.replay.empty();
+  }
+  return !opts.file.empty();
+}
+
+nsbaci::services::RuntimeService makeService(const Options& opts,
+                                             uint64_t seed) {
+  using namespace nsbaci::factories;
+  if (opts.scheduler == "pct") {
+    return RuntimeServiceFactory::createService(
+        pctRuntime, seed, static_cast<uint32_t>(opts.pctDepth), opts.pctSteps);
+  }
+  return RuntimeServiceFactory::createService(nsbaciRuntime, seed);
+}
+
+void printErrors(const std::vector<nsbaci::Error>& errors) {
+  for (const auto& err : errors) {
+    std::cerr << "error: " << err.basic.message << std::endl;
+  }
+}
+
+int runBatch(const Options& opts, std::istream& input,
+             nsbaci::compiler::CompilerResult compileResult) {
+  using namespace nsbaci::services;
+
+  BatchOptions batch;
+  batch.firstSeed = opts.seed;
+  batch.runs = opts.runs;
+  batch.maxSteps = opts.maxSteps;
+  batch.workers = static_cast<size_t>(opts.jobs);
+  batch.detectRaces = opts.races;
+  for (std::string value; input >> value;) {
+    batch.input.push_back(value);
+  }
+
+  BatchRunner runner(
+      [&opts](uint64_t seed) { return makeService(opts, seed); });
+  auto image = std::make_shared<const runtime::CodeImage>(
+      std::move(compileResult.instructions), std::move(compileResult.symbols));
+  auto result = runner.run(image, batch);
+  if (!result.ok) {
+    printErrors(result.errors);
+    return 1;
+  }
+
+  std::cout << result.outcomes.size() << " distinct outcome(s) in "
+            << result.runs << " run(s)\n";
+  for (const auto& summary : result.outcomes) {
+    std::cout << "\n[" << summary.count << " run(s), seed " << summary.seed
+              << "] " << runStatusName(summary.outcome.status);
+    if (!summary.outcome.error.empty()) {
+      std::cout << ": " << summary.outcome.error;
+    }
+    std::cout << "\n" << summary.outcome.output;
+    if (!summary.outcome.output.empty() &&
+        summary.outcome.output.back() != '\n') {
+      std::cout << "\n";
+    }
+  }
+  if (!result.races.empty()) {
+    std::cout << "\n" << result.races.size() << " data race(s)\n";
+    for (const auto& [race, count] : result.races) {
+      std::cout << "[" << count << " run(s)] " << race << "\n";
+    }
+  }
+  std::cout.flush();
+
+  std::cerr << "halted: " << result.halted << "\n"
+            << "deadlocks: " << result.deadlocks << "\n"
+            << "errors: " << result.runtimeErrors << "\n"
+            << "step limits: " << result.stepLimits << "\n"
+            << "input exhausted: " << result.inputErrors << "\n"
+            << "livelocks: " << result.livelocks << "\n"
+            << "steps: " << result.totalSteps << "\n"
+            << "time: " << result.seconds * 1000.0 << " ms\n"
+            << "ips: "
+            << (result.seconds > 0 ? result.totalSteps / result.seconds : 0.0)
+            << std::endl;
+
+  if (result.halted == result.runs) {
+    return 0;
+  }
+  if (result.stepLimits > 0) {
+    return 3;
+  }
+  if (result.livelocks > 0) {
+    return 4;
+  }
+  return result.deadlocks > 0 ? 5 : 1;
+}
+
+void printFinding(const nsbaci::services::Finding& f) {
+  using nsbaci::services::FindingKind;
+  switch (f.kind) {
+    case FindingKind::RuntimeError:
+      std::cout << "error: " << f.message;
+      break;
+    case FindingKind::Deadlock:
+      std::cout << "deadlock: " << f.message;
+      break;
+    case FindingKind::InputExhausted:
+      std::cout << "input exhausted";
+      break;
+    case FindingKind::FinalState:
+      std::cout << "final state";
+      break;
+  }
+  std::cout << "\n  schedule:";
+  for (auto id : f.schedule) {
+    std::cout << ' ' << id;
+  }
+  std::cout << "\n  output: " << f.output << "\n";
+}
+
+int runExplore(const Options& opts, std::istream& input,
+               nsbaci::compiler::CompilerResult compileResult) {
+  using namespace nsbaci::services;
+
+  ExploreOptions explore;
+  if (opts.maxSteps > 0) {
+    explore.maxDepth = opts.maxSteps;
+  }
+  explore.workers = static_cast<size_t>(opts.jobs);
+  for (std::string value; input >> value;) {
+    explore.input.push_back(value);
+  }
+
+  Explorer explorer([] {
+    return nsbaci::factories::RuntimeServiceFactory::createService(
+        nsbaci::factories::nsbaciRuntime);
+  });
+  auto image = std::make_shared<const runtime::CodeImage>(
+      std::move(compileResult.instructions), std::move(compileResult.symbols));
+  auto result = explorer.explore(image, explore);
+  if (!result.ok) {
+    printErrors(result.errors);
+    return 1;
+  }
+
+  std::cout << result.violations.size() << " violation(s), "
+            << result.finalStates.size() << " distinct final state(s)\n";
+  for (const auto& f : result.violations) {
+    printFinding(f);
+  }
+  for (const auto& f : result.finalStates) {
+    printFinding(f);
+  }
+  std::cout.flush();
+
+  std::cerr << "states: " << result.states << "\n"
+            << "transitions: " << result.transitions << "\n"
+            << "reduced: " << result.reduced << "\n"
+            << "complete: " << (result.complete ? "yes" : "no") << "\n"
+            << "time: " << result.seconds * 1000.0 << " ms" << std::endl;
+
+  if (!result.violations.empty()) {
+    return 1;
+  }
+  return result.complete ? 0 : 3;
+}
+
+int dumpTrace(const Options& opts) {
+  using namespace nsbaci::services::runtime;
+
+  // Mapped, so only the blocks printed are read
+  nsbaci::services::FileService fileService;
+  auto traceFile = fileService.loadTrace(opts.dumpTrace);
+  if (!traceFile.ok) {
+    printErrors(traceFile.errors);
+    return 1;
+  }
+  auto parsed = BinaryTraceReader::parse(traceFile.contents->data(),
+                                         traceFile.contents->size());
+  if (!parsed.ok) {
+    printErrors(parsed.errors);
+    return 1;
+  }
+
+  auto cursor = parsed.reader.seek(0, opts.from);
+  TraceRecord record;
+  uint32_t run = 0;
+  while (cursor.next(record)) {
+    if (record.run != run) {
+      run = record.run;
+      std::cout << "run " << run << "\n";
+    }
+    std::cout << record.step << " thread " << record.thread << " pc "
+              << record.pc << ' '
+              << nsbaci::compiler::opcodeName(record.opcode);
+    for (const auto& write : record.writes) {
+      std::cout << " @" << write.address << '=' << write.value;
+    }
+    std::cout << '\n';
+  }
+  std::cout.flush();
+
+  if (cursor.corrupt()) {
+    std::cerr << "error: binary trace is corrupt after step " << record.step
+              << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options opts;
+  if (!parseOptions(argc, argv, opts)) {
+    printUsage(std::cerr);
+    return 2;
+  }
+
+  if (!opts.dumpTrace.empty()) {
+    return dumpTrace(opts);
+  }
+
+  if (opts.scheduler != "nsbaci" && opts.scheduler != "pct") {
+    std::cerr << "error: unknown scheduler: " << opts.scheduler << std::endl;
+    return 2;
+  }
+
+  // Load and compile, unless a saved session brings its own code
+  nsbaci::services::FileService fileService;
+  nsbaci::compiler::CompilerResult compileResult;
+  if (opts.resume.empty()) {
+    auto loadResult = fileService.load(opts.file);
+    if (!loadResult.ok) {
+      printErrors(loadResult.errors);
+      return 1;
+    }
+
+    nsbaci::compiler::NsbaciCompiler compiler;
+    compileResult = compiler.compile(loadResult.contents);
+    if (!compileResult.ok) {
+      printErrors(compileResult.errors);
+      return 1;
+    }
+  }
+
+  // Input source
+  std::ifstream inputFile;
+  if (!opts.input.empty()) {
+    inputFile.open(opts.input);
+    if (!inputFile.is_open()) {
+      std::cerr << "error: could not open input file: " << opts.input
+                << std::endl;
+      return 1;
+    }
+  }
+  std::istream& input = opts.input.empty() ? std::cin : inputFile;
+
+  // Always run seeded so any run can be reproduced from its report
+  if (!opts.hasSeed) {
+    opts.seed = std::random_device{}();
+  }
+
+  if (opts.explore) {
+    return runExplore(opts, input, std::move(compileResult));
+  }
+
+  if (opts.runs > 1) {
+    return runBatch(opts, input, std::move(compileResult));
+  }
+
+  nsbaci::services::runtime::ReplayLog replayLog;
+  if (!opts.replay.empty()) {
+    auto replayFile = fileService.loadAuxiliary(opts.replay);
+    if (!replayFile.ok) {
+      printErrors(replayFile.errors);
+      return 1;
+    }
+    auto parsed =
+        nsbaci::services::runtime::ReplayLog::parse(replayFile.contents);
+    if (!parsed.ok) {
+      printErrors(parsed.errors);
+      return 1;
+    }
+    replayLog = std::move(parsed.log);
+  }
+
+  auto runtimeService = makeService(opts, opts.seed);
+  runtimeService.setOutputCallback(
+      [](const std::string& out) { std::cout << out; });
+  runtimeService.setRaceDetection(opts.races);
+  runtimeService.setSpinParking(opts.spinParking);
+  runtimeService.setRecording(!opts.record.empty());
+
+  // Written as the run goes, a megabyte at a time
+  std::shared_ptr<nsbaci::services::OutputFile> traceFile;
+  if (!opts.binaryTrace.empty()) {
+    if (nsbaci::types::File(opts.binaryTrace).extension() != ".nsbtrace") {
+      std::cerr << "error: binary traces must be saved as .nsbtrace files"
+                << std::endl;
+      return 1;
+    }
+    auto opened = fileService.openStream(opts.binaryTrace);
+    if (!opened.ok) {
+      printErrors(opened.errors);
+      return 1;
+    }
+    traceFile = std::move(opened.stream);
+    runtimeService.startBinaryTrace([traceFile](const std::string& part) {
+      return traceFile->write(part);
+    });
+  }
+  if (opts.resume.empty()) {
+    runtimeService.loadProgram(nsbaci::services::runtime::Program(
+        std::move(compileResult.instructions),
+        std::move(compileResult.symbols)));
+  } else {
+    // Parsed straight out of the mapping; nothing is re-executed
+    auto sessionFile = fileService.loadSession(opts.resume);
+    if (!sessionFile.ok) {
+      printErrors(sessionFile.errors);
+      return 1;
+    }
+    auto parsed = nsbaci::services::runtime::Session::parse(
+        sessionFile.contents->data(), sessionFile.contents->size());
+    if (!parsed.ok) {
+      printErrors(parsed.errors);
+      return 1;
+    }
+    auto resumed = runtimeService.restoreSession(parsed.session);
+    for (const auto& err : resumed.errors) {
+      if (err.basic.severity != nsbaci::types::ErrSeverity::Warning) {
+        printErrors(resumed.errors);
+        return 1;
+      }
+      std::cerr << "warning: " << err.basic.message << std::endl;
+    }
+  }
+  if (!opts.replay.empty()) {
+    runtimeService.startReplay(std::move(replayLog));
+  }
+
+  // Execute, feeding input whenever a Read asks for it
+  int status = 0;
+  auto start = std::chrono::steady_clock::now();
+  while (true) {
+    size_t budget = 0;
+    if (opts.maxSteps > 0) {
+      if (runtimeService.getStepCount() >= opts.maxSteps) {
+        std::cerr << "error: step limit reached" << std::endl;
+        status = 3;
+        break;
+      }
+      budget = opts.maxSteps - runtimeService.getStepCount();
+    }
+
+    auto result = runtimeService.run(budget);
+    if (!result.ok) {
+      printErrors(result.errors);
+      status = 1;
+      break;
+    }
+    if (result.deadlock.has_value()) {
+      std::cerr << "error: deadlock\n"
+                << result.deadlock->describe() << std::endl;
+      status = 5;
+      break;
+    }
+    if (result.halted) {
+      break;
+    }
+    if (result.livelock) {
+      std::cerr << "error: probable livelock (states repeat without progress)"
+                << std::endl;
+      status = 4;
+      break;
+    }
+    if (result.needsInput) {
+      std::string value;
+      if (!(input >> value)) {
+        std::cerr << "error: program needs input but none is left"
+                  << std::endl;
+        status = 1;
+        break;
+      }
+      runtimeService.provideInput(value);
+    }
+  }
+  auto elapsed = std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+  std::cout.flush();
+
+  if (!opts.record.empty()) {
+    auto saved = fileService.saveAuxiliary(
+        runtimeService.getReplayLog().serialize(), opts.record);
+    if (!saved.ok) {
+      printErrors(saved.errors);
+      status = status == 0 ? 1 : status;
+    }
+  }
+
+  if (traceFile) {
+    bool written = runtimeService.stopBinaryTrace();
+    if (!traceFile->close() || !written) {
+      std::cerr << "error: could not write the whole binary trace"
+                << std::endl;
+      status = status == 0 ? 1 : status;
+    }
+  }
+
+  if (!opts.saveSession.empty()) {
+    auto saved = fileService.saveSession(
+        runtimeService.saveSession().serialize(), opts.saveSession);
+    if (!saved.ok) {
+      printErrors(saved.errors);
+      status = status == 0 ? 1 : status;
+    }
+  }
+
+  for (const auto& race : runtimeService.getRaces()) {
+    std::cerr << "race: " << race.describe() << "\n";
+  }
+  const auto& spin = runtimeService.getSpinStats();
+  if (spin.parks > 0) {
+    std::cerr << "spin parks: " << spin.parks << "\n"
+              << "spin wakeups: " << spin.wakeups << "\n"
+              << "parked steps: " << spin.parkedSteps << "\n";
+  }
+
+  uint64_t steps = runtimeService.getStepCount();
+  std::cerr << "seed: " << opts.seed << "\n"
+            << "steps: " << steps << "\n"
+            << "time: " << elapsed * 1000.0 << " ms\n"
+            << "ips: " << (elapsed > 0 ? steps / elapsed : 0.0) << std::endl;
+
+  return status;
+}
@@ -0,0 +1,209 @@
+/**
+ * @file binaryTrace.h
+ * @brief Binary execution trace format for nsbaci runtime service.
+ *
+ * This module defines the records of a binary execution trace and the
+ * layout of its file, shared by BinaryTraceWriter and BinaryTraceReader. A
+ * record is one executed instruction: its step, thread, address and opcode,
+ * and the global words it wrote with their new values. Records take two
+ * bytes when a thread runs straight on without writing memory.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_BINARYTRACE_H
+#define NSBACI_SERVICES_RUNTIME_BINARYTRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "compilerTypes.h"
+#include "instruction.h"
+#include "runtimeTypes.h"
+
+/**
+ * @namespace nsbaci::services::runtime
+ * @brief Runtime services namespace for nsbaci.
+ */
+namespace nsbaci::services::runtime {
+
+/**
+ * @struct TraceWrite
+ * @brief A global word written by a traced instruction.
+ */
+struct TraceWrite {
+  nsbaci::types::MemoryAddr address = 0;  ///< Word written.
+  int32_t value = 0;                      ///< Value it was given.
+};
+
+/**
+ * @struct TraceRecord
+ * @brief One executed instruction in a binary trace.
+ *
+ * An instruction that writes more than binarytrace::MAX_WRITES words is
+ * split over several records with the same step.
+ */
+struct TraceRecord {
+  uint32_t run = 0;                    ///< Run it belongs to, from 0.
+  uint64_t step = 0;                   ///< Steps executed before it.
+  nsbaci::types::ThreadID thread = 0;  ///< Thread that executed it.
+  uint32_t pc = 0;                     ///< Address of the instruction.
+  nsbaci::compiler::Opcode opcode{};   ///< Its opcode.
+  std::vector<TraceWrite> writes;      ///< Global words written, in order.
+};
+
+/**
+ * @namespace nsbaci::services::runtime::binarytrace
+ * @brief Layout of a binary trace file.
+ *
+ * The file is a 24-byte header (the magic "NSBACITR", the format version, a
+ * byte-order mark and the block size) followed by blocks of BLOCK_SIZE
+ * bytes; only the last one may be shorter. Fixed values are in host byte
+ * order, which the header records.
+ *
+ * Each block is a 32-byte header (the run and step of its first record,
+ * its last step, its record count and the bytes of records it holds)
+ * followed by the records. Every block is a sync point: the delta state
+ * starts afresh, so any block decodes on its own, and a block can be found
+ * by its header alone at a fixed offset.
+ *
+ * A record starts with a flags byte, and the fields its bits call for
+ * follow as varints in bit order. Bit 0 means the thread changed: its ID
+ * follows. Bit 1 means the step is not the previous one plus one: the
+ * difference follows. Bit 2 means the pc is not the one after the thread's
+ * previous pc (0 at a sync point, and always for IDs of PC_THREADS and up):
+ * the zigzag difference follows. Bits 3 to 7 hold the number of writes, or
+ * WRITES_FOLLOW if the count follows. Then come the opcode byte and each
+ * write, as the zigzag difference from the previous address written in the
+ * block and the zigzag value. Bits 3 to 7 set to CONTROL instead mark a
+ * control record: with bits 0 to 2 clear, a new run that starts at the
+ * step that follows, with the delta state afresh.
+ */
+namespace binarytrace {
+
+constexpr char MAGIC[8] = {'N', 'S', 'B', 'A', 'C', 'I', 'T', 'R'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t ENDIAN_MARK = 0x01020304;
+
+/// @brief File header: magic, version, byte-order mark, block size, padding.
+constexpr size_t FILE_HEADER_SIZE = 24;
+/// @brief Block header: first step, last step, run, records, bytes, padding.
+constexpr size_t BLOCK_HEADER_SIZE = 32;
+/// @brief Bytes of a block, header included.
+constexpr size_t BLOCK_SIZE = size_t(64) << 10;
+
+/// @brief Record flags: the thread ID follows.
+constexpr uint8_t THREAD_CHANGED = 1;
+/// @brief Record flags: the step difference follows.
+constexpr uint8_t STEP_JUMPED = 2;
+/// @brief Record flags: the pc difference follows.
+constexpr uint8_t PC_JUMPED = 4;
+/// @brief Write count field: the count follows as a varint.
+constexpr uint8_t WRITES_FOLLOW = 30;
+/// @brief Write count field: a control record.
+constexpr uint8_t CONTROL = 31;
+/// @brief Control record: a new run starts.
+constexpr uint8_t NEW_RUN = 0;
+/// @brief Threads whose next pc is predicted.
+constexpr size_t PC_THREADS = 256;
+/// @brief Most writes in one record.
+constexpr size_t MAX_WRITES = 1024;
+/// @brief Most bytes a record takes.
+constexpr size_t MAX_RECORD_SIZE = 1 + 10 + 10 + 5 + 1 + 5 + MAX_WRITES * 10;
+
+/**
+ * @struct BlockHeader
+ * @brief What a block starts with.
+ */
+struct BlockHeader {
+  uint64_t firstStep = 0;  ///< Step of the first record.
+  uint64_t lastStep = 0;   ///< Step of the last record.
+  uint32_t run = 0;        ///< Run of the first record.
+  uint32_t records = 0;    ///< Records, control records included.
+  uint32_t bytes = 0;      ///< Bytes of records after the header.
+};
+
+/**
+ * @brief Appends an unsigned varint, seven bits per byte, low bits first.
+ * @param out Where to write; room for 10 bytes is needed.
+ * @return Past the last byte written.
+ */
+inline char* putVarint(char* out, uint64_t value) {
+  while (value >= 0x80) {
+    *out++ = static_cast<char>(value | 0x80);
+    value >>= 7;
+  }
+  *out++ = static_cast<char>(value);
+  return out;
+}
+
+/**
+ * @brief Reads an unsigned varint.
+ * @param in Cursor, moved past the varint.
+ * @param end End of the data.
+ * @param value Receives the value.
+ * @return False if the data ends first or the varint is too long.
+ */
+inline bool getVarint(const char*& in, const char* end, uint64_t& value) {
+  value = 0;
+  for (int shift = 0; shift < 64 && in != end; shift += 7) {
+    auto byte = static_cast<uint8_t>(*in++);
+    value |= uint64_t(byte & 0x7f) << shift;
+    if (byte < 0x80) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Maps a signed difference to an unsigned one, small either way.
+ */
+inline uint64_t zigzag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+/**
+ * @brief Inverse of zigzag().
+ */
+inline int64_t unzigzag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/**
+ * @brief Writes a block header.
+ * @param out Start of the block.
+ */
+inline void putBlockHeader(char* out, const BlockHeader& header) {
+  std::memset(out, 0, BLOCK_HEADER_SIZE);
+  std::memcpy(out, &header.firstStep, 8);
+  std::memcpy(out + 8, &header.lastStep, 8);
+  std::memcpy(out + 16, &header.run, 4);
+  std::memcpy(out + 20, &header.records, 4);
+  std::memcpy(out + 24, &header.bytes, 4);
+}
+
+/**
+ * @brief Reads a block header.
+ * @param in Start of the block, at least BLOCK_HEADER_SIZE bytes.
+ */
+inline BlockHeader getBlockHeader(const char* in) {
+  BlockHeader header;
+  std::memcpy(&header.firstStep, in, 8);
+  std::memcpy(&header.lastStep, in + 8, 8);
+  std::memcpy(&header.run, in + 16, 4);
+  std::memcpy(&header.records, in + 20, 4);
+  std::memcpy(&header.bytes, in + 24, 4);
+  return header;
+}
+
+}  // namespace binarytrace
+
+}  // namespace nsbaci::services::runtime
+
+#endif  // NSBACI_SERVICES_RUNTIME_BINARYTRACE_H
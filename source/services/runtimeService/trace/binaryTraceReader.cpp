@@ -0,0 +1,205 @@
+/**
+ * @file binaryTraceReader.cpp
+ * @brief BinaryTraceReader class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "binaryTraceReader.h"
+
+#include <algorithm>
+#include <string>
+
+namespace nsbaci::services::runtime {
+
+using namespace binarytrace;
+
+namespace {
+
+BinaryTraceResult malformed(const std::string& what) {
+  nsbaci::Error err;
+  err.basic.severity = nsbaci::types::ErrSeverity::Error;
+  err.basic.message = "Binary trace: " + what;
+  err.basic.type = nsbaci::types::ErrType::unknown;
+  err.payload = nsbaci::types::RuntimeError{};
+  return BinaryTraceResult(std::move(err));
+}
+
+// Run and step of a record, ordered as they are in the trace
+bool before(uint32_t run, uint64_t step, uint32_t otherRun,
+            uint64_t otherStep) {
+  return run != otherRun ? run < otherRun : step < otherStep;
+}
+
+}  // namespace
+
+BinaryTraceResult BinaryTraceReader::parse(const char* data, size_t size) {
+  if (size < FILE_HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC))) {
+    return malformed("not an nsbaci binary trace");
+  }
+  uint32_t version = 0;
+  uint32_t mark = 0;
+  uint32_t blockSize = 0;
+  std::memcpy(&version, data + 8, 4);
+  std::memcpy(&mark, data + 12, 4);
+  std::memcpy(&blockSize, data + 16, 4);
+  if (mark != ENDIAN_MARK) {
+    return malformed("written on a machine with a different byte order");
+  }
+  if (version == 0 || version > VERSION) {
+    return malformed("format version " + std::to_string(version) +
+                     " is not supported");
+  }
+  if (blockSize != BLOCK_SIZE) {
+    return malformed("block size " + std::to_string(blockSize) +
+                     " is not supported");
+  }
+
+  BinaryTraceResult result;
+  result.reader.data = data;
+  result.reader.size = size;
+  // A last block cut short of its header was never finished
+  size_t body = size - FILE_HEADER_SIZE;
+  result.reader.blocks = body / BLOCK_SIZE;
+  if (body % BLOCK_SIZE >= BLOCK_HEADER_SIZE) {
+    ++result.reader.blocks;
+  }
+  return result;
+}
+
+BlockHeader BinaryTraceReader::blockHeader(size_t block) const {
+  return getBlockHeader(data + FILE_HEADER_SIZE + block * BLOCK_SIZE);
+}
+
+BinaryTraceReader::Cursor BinaryTraceReader::seek(uint32_t run,
+                                                  uint64_t step) const {
+  // Last block starting before the step: a record split over two blocks
+  // starts in the earlier one
+  size_t low = 0;
+  size_t high = blocks;
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    BlockHeader header = blockHeader(mid);
+    if (before(header.run, header.firstStep, run, step)) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  Cursor cursor(*this, low > 0 ? low - 1 : 0);
+  cursor.fromRun = run;
+  cursor.fromStep = step;
+  return cursor;
+}
+
+BinaryTraceReader::Cursor::Cursor(const BinaryTraceReader& r, size_t first)
+    : reader(&r) {
+  if (first < reader->blocks) {
+    enter(first);
+  } else {
+    block = reader->blocks;
+  }
+}
+
+bool BinaryTraceReader::Cursor::next(TraceRecord& record) {
+  while (!bad) {
+    if (in == end) {
+      if (block + 1 >= reader->blocks || !enter(block + 1)) {
+        return false;
+      }
+      continue;
+    }
+
+    auto flags = static_cast<uint8_t>(*in++);
+    uint64_t value = 0;
+    if ((flags >> 3) == CONTROL) {
+      if ((flags & 7) != NEW_RUN || !getVarint(in, end, value)) {
+        bad = true;
+        return false;
+      }
+      ++run;
+      resetDeltas(value);
+      continue;
+    }
+
+    if (flags & THREAD_CHANGED) {
+      bad = !getVarint(in, end, value);
+      prevThread = value;
+    }
+    if (flags & STEP_JUMPED) {
+      bad = bad || !getVarint(in, end, value);
+      prevStep += value;
+    } else {
+      ++prevStep;
+    }
+    uint32_t pc = prevThread < PC_THREADS ? nextPc[prevThread] : 0;
+    if (flags & PC_JUMPED) {
+      bad = bad || !getVarint(in, end, value);
+      pc = static_cast<uint32_t>(int64_t(pc) + unzigzag(value));
+    }
+    uint64_t count = flags >> 3;
+    if (count == WRITES_FOLLOW) {
+      bad = bad || !getVarint(in, end, count) || count > MAX_WRITES;
+    }
+    if (bad || in == end ||
+        static_cast<uint8_t>(*in) >=
+            static_cast<uint8_t>(nsbaci::compiler::Opcode::_Count)) {
+      bad = true;
+      return false;
+    }
+    record.opcode = static_cast<nsbaci::compiler::Opcode>(*in++);
+    record.writes.resize(static_cast<size_t>(count));
+    for (auto& write : record.writes) {
+      uint64_t address = 0;
+      if (!getVarint(in, end, address) || !getVarint(in, end, value)) {
+        bad = true;
+        return false;
+      }
+      prevAddress = static_cast<nsbaci::types::MemoryAddr>(
+          int64_t(prevAddress) + unzigzag(address));
+      write.address = prevAddress;
+      write.value = static_cast<int32_t>(unzigzag(value));
+    }
+
+    if (prevThread < PC_THREADS) {
+      nextPc[prevThread] = pc + 1;
+    }
+    if (before(run, prevStep, fromRun, fromStep)) {
+      continue;
+    }
+    record.run = run;
+    record.step = prevStep;
+    record.thread = prevThread;
+    record.pc = pc;
+    return true;
+  }
+  return false;
+}
+
+bool BinaryTraceReader::Cursor::enter(size_t index) {
+  block = index;
+  size_t offset = FILE_HEADER_SIZE + index * BLOCK_SIZE;
+  size_t available = std::min(BLOCK_SIZE, reader->size - offset);
+  BlockHeader header = reader->blockHeader(index);
+  if (header.bytes > available - BLOCK_HEADER_SIZE) {
+    // Only the last block may be cut short, by a writer that never finished
+    bad = index + 1 < reader->blocks;
+    return false;
+  }
+  in = reader->data + offset + BLOCK_HEADER_SIZE;
+  end = in + header.bytes;
+  run = header.run;
+  resetDeltas(header.firstStep);
+  return true;
+}
+
+void BinaryTraceReader::Cursor::resetDeltas(uint64_t step) {
+  prevStep = step - 1;
+  prevThread = 0;
+  prevAddress = 0;
+  nextPc.fill(0);
+}
+
+}  // namespace nsbaci::services::runtime
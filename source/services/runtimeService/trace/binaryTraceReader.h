@@ -0,0 +1,171 @@
+/**
+ * @file binaryTraceReader.h
+ * @brief BinaryTraceReader class declaration for nsbaci runtime service.
+ *
+ * This module defines the reader of binary execution traces (see
+ * binaryTrace.h). It decodes straight out of the file contents, typically a
+ * memory mapping, so a trace of gigabytes is paged in only where it is
+ * read.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_BINARYTRACEREADER_H
+#define NSBACI_SERVICES_RUNTIME_BINARYTRACEREADER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "baseResult.h"
+#include "binaryTrace.h"
+
+/**
+ * @namespace nsbaci::services::runtime
+ * @brief Runtime services namespace for nsbaci.
+ */
+namespace nsbaci::services::runtime {
+
+struct BinaryTraceResult;
+
+/**
+ * @class BinaryTraceReader
+ * @brief Iterates over the records of a binary trace, or seeks by step.
+ *
+ * Seeking reads the headers of about log2(blocks) blocks to find the one
+ * holding the step, then decodes that block from its start: at most
+ * BLOCK_SIZE bytes, whatever the size of the trace. The contents are not
+ * owned and must outlive the reader and its cursors.
+ */
+class BinaryTraceReader {
+ public:
+  /**
+   * @class Cursor
+   * @brief A position in the trace, moving forwards record by record.
+   */
+  class Cursor {
+   public:
+    /**
+     * @brief Decodes the next record.
+     * @param record Receives the record; its writes vector is reused.
+     * @return False at the end of the trace, or if the data is corrupt.
+     */
+    bool next(TraceRecord& record);
+
+    /**
+     * @brief Checks whether decoding stopped at corrupt data.
+     * @return True if next() found a record it could not decode.
+     */
+    bool corrupt() const { return bad; }
+
+   private:
+    friend class BinaryTraceReader;
+
+    Cursor(const BinaryTraceReader& reader, size_t block);
+
+    /**
+     * @brief Starts decoding a block, a sync point.
+     */
+    bool enter(size_t block);
+
+    /**
+     * @brief Puts the delta state back as at the start of a block.
+     */
+    void resetDeltas(uint64_t step);
+
+    const BinaryTraceReader* reader;  ///< The trace
+    size_t block = 0;                 ///< Block being decoded
+    const char* in = nullptr;         ///< Next byte of its records
+    const char* end = nullptr;        ///< End of its records
+    bool bad = false;                 ///< Stopped at corrupt data
+    uint32_t fromRun = 0;             ///< Records before this run are skipped
+    uint64_t fromStep = 0;            ///< And before this step in it
+
+    uint32_t run = 0;                           ///< Run being decoded
+    uint64_t prevStep = 0;                      ///< Step of the last record
+    nsbaci::types::ThreadID prevThread = 0;     ///< Thread of the last record
+    nsbaci::types::MemoryAddr prevAddress = 0;  ///< Last address written
+    /// @brief Predicted pc of each thread below PC_THREADS
+    std::array<uint32_t, binarytrace::PC_THREADS> nextPc{};
+  };
+
+  /**
+   * @brief Default constructor creates a reader of an empty trace.
+   */
+  BinaryTraceReader() = default;
+
+  /**
+   * @brief Checks the file header of a trace written by BinaryTraceWriter.
+   *
+   * Blocks are checked as they are read. A trace cut short, as when the
+   * writer never finished, reads up to the end of its last complete block.
+   *
+   * @param data Start of the file contents, typically a mapping of the file.
+   * @param size Size of the contents in bytes.
+   * @return The reader, or an error describing what is wrong.
+   */
+  static BinaryTraceResult parse(const char* data, size_t size);
+
+  /**
+   * @brief Gets the number of blocks.
+   * @return Blocks in the trace.
+   */
+  size_t blockCount() const { return blocks; }
+
+  /**
+   * @brief Reads the header of a block.
+   * @param block Index of the block, below blockCount().
+   * @return Its header.
+   */
+  binarytrace::BlockHeader blockHeader(size_t block) const;
+
+  /**
+   * @brief Gets a cursor at the first record.
+   * @return The cursor.
+   */
+  Cursor begin() const { return Cursor(*this, 0); }
+
+  /**
+   * @brief Gets a cursor at the first record of a run at or after a step.
+   * @param run The run, from 0.
+   * @param step Steps executed before the record.
+   * @return The cursor; at the end if the trace holds nothing that late.
+   */
+  Cursor seek(uint32_t run, uint64_t step) const;
+
+ private:
+  const char* data = nullptr;  ///< The file contents
+  size_t size = 0;             ///< Their size
+  size_t blocks = 0;           ///< Blocks with a complete header
+};
+
+/**
+ * @struct BinaryTraceResult
+ * @brief Result of opening a binary trace.
+ */
+struct BinaryTraceResult : nsbaci::BaseResult {
+  /**
+   * @brief Default constructor creates a successful result.
+   */
+  BinaryTraceResult() : BaseResult() {}
+
+  /**
+   * @brief Constructs a failed result from a single error.
+   * @param error Why the trace could not be read.
+   */
+  explicit BinaryTraceResult(nsbaci::Error error)
+      : BaseResult(std::move(error)) {}
+
+  BinaryTraceResult(BinaryTraceResult&&) noexcept = default;
+  BinaryTraceResult& operator=(BinaryTraceResult&&) noexcept = default;
+  BinaryTraceResult(const BinaryTraceResult&) = default;
+  BinaryTraceResult& operator=(const BinaryTraceResult&) = default;
+
+  BinaryTraceReader reader;  ///< The reader.
+};
+
+}  // namespace nsbaci::services::runtime
+
+#endif  // NSBACI_SERVICES_RUNTIME_BINARYTRACEREADER_H
@@ -0,0 +1,177 @@
+/**
+ * @file binaryTraceWriter.cpp
+ * @brief BinaryTraceWriter class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "binaryTraceWriter.h"
+
+#include <algorithm>
+
+namespace nsbaci::services::runtime {
+
+using namespace binarytrace;
+
+BinaryTraceWriter::BinaryTraceWriter(Sink s)
+    : sink(std::move(s)), ring(RING_BLOCKS * BLOCK_SIZE, '\0') {
+  std::string fileHeader(FILE_HEADER_SIZE, '\0');
+  uint32_t blockSize = static_cast<uint32_t>(BLOCK_SIZE);
+  std::memcpy(&fileHeader[0], MAGIC, sizeof(MAGIC));
+  std::memcpy(&fileHeader[8], &VERSION, 4);
+  std::memcpy(&fileHeader[12], &ENDIAN_MARK, 4);
+  std::memcpy(&fileHeader[16], &blockSize, 4);
+  failed = !sink(fileHeader);
+}
+
+void BinaryTraceWriter::restart(uint64_t step) {
+  if (finished || !runRecorded) {
+    return;
+  }
+  ++run;
+  runRecorded = false;
+  if (!blockOpen) {
+    return;
+  }
+
+  // Mid-block: a control record, after which deltas start afresh
+  if (used + 1 + 10 > BLOCK_SIZE) {
+    sealBlock();
+    return;
+  }
+  char* out = &ring[block * BLOCK_SIZE + used];
+  *out++ = static_cast<char>((CONTROL << 3) | NEW_RUN);
+  out = putVarint(out, step);
+  used = static_cast<size_t>(out - &ring[block * BLOCK_SIZE]);
+  ++header.records;
+  ++records;
+  resetDeltas(step);
+}
+
+void BinaryTraceWriter::record(uint64_t step, nsbaci::types::ThreadID thread,
+                               uint32_t pc, nsbaci::compiler::Opcode opcode,
+                               const std::vector<TraceWrite>& writes) {
+  if (finished) {
+    return;
+  }
+  if (runRecorded && step < latest) {
+    restart(step);
+  }
+  runRecorded = true;
+  latest = step;
+
+  // More writes than a record holds: several records, same step
+  size_t done = 0;
+  do {
+    size_t count = std::min(writes.size() - done, MAX_WRITES);
+    if (!blockOpen ||
+        used + MAX_RECORD_SIZE - (MAX_WRITES - count) * 10 > BLOCK_SIZE) {
+      if (blockOpen) {
+        sealBlock();
+      }
+      openBlock(step);
+    }
+
+    char* start = &ring[block * BLOCK_SIZE + used];
+    char* out = start + 1;
+    uint8_t flags = 0;
+    if (thread != prevThread) {
+      flags |= THREAD_CHANGED;
+      out = putVarint(out, thread);
+    }
+    if (step - prevStep != 1) {
+      flags |= STEP_JUMPED;
+      out = putVarint(out, step - prevStep);
+    }
+    uint32_t expected = thread < PC_THREADS ? nextPc[thread] : 0;
+    if (pc != expected) {
+      flags |= PC_JUMPED;
+      out = putVarint(out, zigzag(int64_t(pc) - int64_t(expected)));
+    }
+    if (count < WRITES_FOLLOW) {
+      flags |= static_cast<uint8_t>(count << 3);
+    } else {
+      flags |= WRITES_FOLLOW << 3;
+      out = putVarint(out, count);
+    }
+    *start = static_cast<char>(flags);
+    *out++ = static_cast<char>(opcode);
+    for (size_t i = done; i < done + count; ++i) {
+      out = putVarint(out, zigzag(int64_t(writes[i].address) -
+                                  int64_t(prevAddress)));
+      out = putVarint(out, zigzag(writes[i].value));
+      prevAddress = writes[i].address;
+    }
+
+    used += static_cast<size_t>(out - start);
+    prevStep = step;
+    prevThread = thread;
+    if (thread < PC_THREADS) {
+      nextPc[thread] = pc + 1;
+    }
+    header.lastStep = step;
+    ++header.records;
+    ++records;
+    done += count;
+  } while (done < writes.size());
+}
+
+bool BinaryTraceWriter::finish() {
+  if (finished) {
+    return !failed;
+  }
+  // The last block is cut short rather than padded
+  size_t bytes = block * BLOCK_SIZE;
+  if (blockOpen) {
+    header.bytes = static_cast<uint32_t>(used - BLOCK_HEADER_SIZE);
+    putBlockHeader(&ring[bytes], header);
+    bytes += used;
+    blockOpen = false;
+  }
+  if (bytes > 0) {
+    flush(bytes);
+  }
+  finished = true;
+  ring = std::string();
+  return !failed;
+}
+
+void BinaryTraceWriter::openBlock(uint64_t step) {
+  blockOpen = true;
+  used = BLOCK_HEADER_SIZE;
+  header = BlockHeader{};
+  header.firstStep = step;
+  header.lastStep = step;
+  header.run = run;
+  resetDeltas(step);
+}
+
+void BinaryTraceWriter::sealBlock() {
+  char* base = &ring[block * BLOCK_SIZE];
+  header.bytes = static_cast<uint32_t>(used - BLOCK_HEADER_SIZE);
+  putBlockHeader(base, header);
+  std::memset(base + used, 0, BLOCK_SIZE - used);
+  blockOpen = false;
+  if (++block == RING_BLOCKS) {
+    flush(ring.size());
+    block = 0;
+  }
+}
+
+void BinaryTraceWriter::resetDeltas(uint64_t step) {
+  prevStep = step - 1;
+  prevThread = 0;
+  prevAddress = 0;
+  nextPc.fill(0);
+}
+
+void BinaryTraceWriter::flush(size_t bytes) {
+  if (failed) {
+    return;
+  }
+  failed = !(bytes == ring.size() ? sink(ring) : sink(ring.substr(0, bytes)));
+}
+
+}  // namespace nsbaci::services::runtime
@@ -0,0 +1,134 @@
+/**
+ * @file binaryTraceWriter.h
+ * @brief BinaryTraceWriter class declaration for nsbaci runtime service.
+ *
+ * This module defines the writer of binary execution traces (see
+ * binaryTrace.h), compact enough to record every instruction of runs of
+ * billions of steps.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_BINARYTRACEWRITER_H
+#define NSBACI_SERVICES_RUNTIME_BINARYTRACEWRITER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "binaryTrace.h"
+
+/**
+ * @namespace nsbaci::services::runtime
+ * @brief Runtime services namespace for nsbaci.
+ */
+namespace nsbaci::services::runtime {
+
+/**
+ * @class BinaryTraceWriter
+ * @brief Encodes executed instructions into a binary trace.
+ *
+ * Records are encoded in place into a ring of RING_BLOCKS blocks allocated
+ * once. A block is sealed when the next record might not fit, and the ring
+ * is handed to the sink in one piece when every block in it is sealed, so
+ * the sink sees a few large writes and nothing is allocated per record.
+ *
+ * A new run starts at restart(), and whenever the steps go backwards, as
+ * after stepping back; each run is stepped through in order by the reader.
+ */
+class BinaryTraceWriter {
+ public:
+  /// @brief Receives the next part of the file; false if it failed.
+  using Sink = std::function<bool(const std::string&)>;
+
+  /// @brief Blocks in the ring, handed to the sink together.
+  static constexpr size_t RING_BLOCKS = 16;
+
+  /**
+   * @brief Hands the file header to the sink.
+   * @param sink Where the file goes.
+   */
+  explicit BinaryTraceWriter(Sink sink);
+
+  /**
+   * @brief Starts a new run, unless the current one has no records yet.
+   * @param step Steps executed when the run starts.
+   */
+  void restart(uint64_t step);
+
+  /**
+   * @brief Encodes an executed instruction.
+   * @param step Steps executed before this one.
+   * @param thread The thread that executed it.
+   * @param pc Address of the instruction.
+   * @param opcode Its opcode.
+   * @param writes Global words it wrote, with their new values.
+   */
+  void record(uint64_t step, nsbaci::types::ThreadID thread, uint32_t pc,
+              nsbaci::compiler::Opcode opcode,
+              const std::vector<TraceWrite>& writes);
+
+  /**
+   * @brief Seals the last block and hands the rest to the sink. Nothing can
+   * be recorded afterwards.
+   * @return False if the sink failed at any point.
+   */
+  bool finish();
+
+  /**
+   * @brief Gets the number of records encoded.
+   * @return Records so far, control records included.
+   */
+  uint64_t recordCount() const { return records; }
+
+ private:
+  /**
+   * @brief Opens a block at the next slot of the ring, a sync point.
+   */
+  void openBlock(uint64_t step);
+
+  /**
+   * @brief Writes the header of the open block and pads it to BLOCK_SIZE.
+   */
+  void sealBlock();
+
+  /**
+   * @brief Puts the delta state back as at the start of a block.
+   */
+  void resetDeltas(uint64_t step);
+
+  /**
+   * @brief Hands the first bytes of the ring to the sink.
+   */
+  void flush(size_t bytes);
+
+  Sink sink;              ///< Where the file goes
+  std::string ring;       ///< RING_BLOCKS blocks
+  bool failed = false;    ///< The sink failed; nothing more is sent
+  bool finished = false;  ///< The file is closed
+  uint64_t records = 0;   ///< Records encoded
+
+  uint32_t run = 0;          ///< Current run
+  bool runRecorded = false;  ///< The current run has records
+  uint64_t latest = 0;       ///< Highest step recorded in the current run
+
+  bool blockOpen = false;           ///< Records go to the open block
+  size_t block = 0;                 ///< Slot of the open block in the ring
+  size_t used = 0;                  ///< Bytes of the open block used
+  binarytrace::BlockHeader header;  ///< Header of the open block
+
+  uint64_t prevStep = 0;                      ///< Step of the last record
+  nsbaci::types::ThreadID prevThread = 0;     ///< Thread of the last record
+  nsbaci::types::MemoryAddr prevAddress = 0;  ///< Last address written
+  /// @brief Predicted pc of each thread below PC_THREADS
+  std::array<uint32_t, binarytrace::PC_THREADS> nextPc{};
+};
+
+}  // namespace nsbaci::services::runtime
+
+#endif  // NSBACI_SERVICES_RUNTIME_BINARYTRACEWRITER_H
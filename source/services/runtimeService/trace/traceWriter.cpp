@@ -0,0 +1,303 @@
+/**
+ * @file traceWriter.cpp
+ * @brief TraceWriter class implementation for nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include "traceWriter.h"
+
+#include <algorithm>
+#include <charconv>
+
+namespace nsbaci::services::runtime {
+
+namespace {
+
+bool isMonitor(const nsbaci::types::WaitResource& resource) {
+  return resource.kind == nsbaci::types::ResourceKind::Monitor;
+}
+
+}  // namespace
+
+TraceWriter::TraceWriter(Sink s) : sink(std::move(s)) {
+  buffer =
+      "{\"otherData\":{\"clock\":\"1 us is 1 executed instruction\"},"
+      "\"traceEvents\":[\n";
+}
+
+void TraceWriter::restart(std::shared_ptr<const CodeImage> img,
+                          uint64_t step) {
+  image = std::move(img);
+  newRun(step);
+}
+
+void TraceWriter::ran(nsbaci::types::ThreadID thread, uint32_t pc,
+                      uint64_t step) {
+  advance(step);
+  if (track(thread).wait != Wait::None) {
+    endWait(thread, step);
+  }
+  // Same thread straight after its previous step: the quantum goes on
+  if (!running || runner != thread || quantumEnd != step) {
+    endQuantum();
+    running = true;
+    runner = thread;
+    quantumStart = step;
+    quantumPc = pc;
+  }
+  quantumEnd = step + 1;
+}
+
+void TraceWriter::blocked(nsbaci::types::ThreadID thread,
+                          const nsbaci::types::WaitResource& resource,
+                          uint64_t step) {
+  advance(step);
+  if (runner == thread) {
+    endQuantum();
+  }
+  instant(thread,
+          isMonitor(resource) ? "block on monitor @" : "block on semaphore @",
+          resource.address, step);
+
+  // Blocking again after a wakeup lost to another thread: same wait
+  Track& t = tracks[thread];
+  if (t.wait == Wait::Resource && t.resource == resource) {
+    return;
+  }
+  endWait(thread, step);
+  t.wait = Wait::Resource;
+  t.resource = resource;
+  t.since = step;
+}
+
+void TraceWriter::woken(nsbaci::types::ThreadID thread, uint64_t step) {
+  advance(step);
+  endWait(thread, step);
+}
+
+void TraceWriter::acquired(nsbaci::types::ThreadID thread,
+                           const nsbaci::types::WaitResource& resource,
+                           uint64_t step) {
+  advance(step);
+  instant(thread, isMonitor(resource) ? "enter monitor @" : "wait semaphore @",
+          resource.address, step);
+}
+
+void TraceWriter::released(nsbaci::types::ThreadID thread,
+                           const nsbaci::types::WaitResource& resource,
+                           uint64_t step) {
+  advance(step);
+  instant(thread,
+          isMonitor(resource) ? "exit monitor @" : "signal semaphore @",
+          resource.address, step);
+}
+
+void TraceWriter::waitingInput(nsbaci::types::ThreadID thread,
+                               uint64_t step) {
+  advance(step);
+  if (runner == thread) {
+    endQuantum();
+  }
+  Track& t = track(thread);
+  if (t.wait == Wait::Input) {
+    return;
+  }
+  endWait(thread, step);
+  t.wait = Wait::Input;
+  t.since = step;
+}
+
+void TraceWriter::exited(nsbaci::types::ThreadID thread, uint64_t step) {
+  advance(step);
+  if (runner == thread) {
+    endQuantum();
+  }
+  endWait(thread, step);
+  instant(thread, "exit", NO_NUMBER, step);
+}
+
+bool TraceWriter::finish(uint64_t step) {
+  if (finished) {
+    return !failed;
+  }
+  advance(step);
+  endQuantum();
+  for (size_t thread = 0; thread < tracks.size(); ++thread) {
+    endWait(static_cast<nsbaci::types::ThreadID>(thread), latest);
+  }
+  buffer += "\n]}\n";
+  flush();
+  finished = true;
+  return !failed;
+}
+
+void TraceWriter::advance(uint64_t step) {
+  if (run == 0 || step < latest) {
+    newRun(step);
+  }
+  latest = std::max(latest, step);
+}
+
+TraceWriter::Track& TraceWriter::track(nsbaci::types::ThreadID thread) {
+  if (thread >= tracks.size()) {
+    tracks.resize(thread + 1);
+  }
+  Track& t = tracks[thread];
+  if (!t.named) {
+    t.named = true;
+    nameRun();
+    std::string ids = "\"pid\":" + std::to_string(run) +
+                      ",\"tid\":" + std::to_string(thread);
+    append("{\"name\":\"thread_name\",\"ph\":\"M\"," + ids +
+           ",\"args\":{\"name\":\"thread " + std::to_string(thread) + "\"}}");
+    append("{\"name\":\"thread_sort_index\",\"ph\":\"M\"," + ids +
+           ",\"args\":{\"sort_index\":" + std::to_string(thread) + "}}");
+  }
+  return t;
+}
+
+void TraceWriter::endQuantum() {
+  if (!running) {
+    return;
+  }
+  running = false;
+
+  // Named after the line it started on, so each line gets its own colour
+  uint32_t line = image ? image->lines().lineAt(quantumPc) : 0;
+  begin(line ? "line " : "pc ", line ? line : quantumPc, "schedule", "X",
+        quantumStart, runner);
+  buffer += ",\"dur\":";
+  appendNumber(quantumEnd - quantumStart);
+  buffer += ",\"args\":{\"pc\":";
+  appendNumber(quantumPc);
+  if (line) {
+    buffer += ",\"line\":";
+    appendNumber(line);
+  }
+  buffer += '}';
+  end();
+}
+
+void TraceWriter::endWait(nsbaci::types::ThreadID thread, uint64_t step) {
+  if (thread >= tracks.size() || tracks[thread].wait == Wait::None) {
+    return;
+  }
+  Track& t = tracks[thread];
+  if (t.wait == Wait::Input) {
+    begin("wait for input", NO_NUMBER, "wait", "X", t.since, thread);
+  } else {
+    begin(isMonitor(t.resource) ? "blocked on monitor @"
+                                : "blocked on semaphore @",
+          t.resource.address, "wait", "X", t.since, thread);
+  }
+  buffer += ",\"dur\":";
+  appendNumber(std::max(step, t.since) - t.since);
+  end();
+  t.wait = Wait::None;
+}
+
+void TraceWriter::newRun(uint64_t step) {
+  // Whatever was open ends where the old run got to
+  if (run > 0) {
+    endQuantum();
+    for (size_t thread = 0; thread < tracks.size(); ++thread) {
+      endWait(static_cast<nsbaci::types::ThreadID>(thread), latest);
+    }
+  }
+  tracks.clear();
+  ++run;
+  runStart = step;
+  runNamed = false;
+  latest = step;
+}
+
+void TraceWriter::nameRun() {
+  if (runNamed) {
+    return;
+  }
+  runNamed = true;
+  std::string name = "run " + std::to_string(run);
+  if (runStart > 0) {
+    name += " from step " + std::to_string(runStart);
+  }
+  std::string pid = "\"pid\":" + std::to_string(run);
+  append("{\"name\":\"process_name\",\"ph\":\"M\"," + pid +
+         ",\"args\":{\"name\":\"" + name + "\"}}");
+  append("{\"name\":\"process_sort_index\",\"ph\":\"M\"," + pid +
+         ",\"args\":{\"sort_index\":" + std::to_string(run) + "}}");
+}
+
+void TraceWriter::instant(nsbaci::types::ThreadID thread, const char* name,
+                          uint64_t number, uint64_t step) {
+  track(thread);
+  begin(name, number, "sync", "i", step, thread);
+  buffer += ",\"s\":\"t\"";
+  end();
+}
+
+void TraceWriter::append(const std::string& event) {
+  if (finished) {
+    return;
+  }
+  if (events > 0) {
+    buffer += ",\n";
+  }
+  buffer += event;
+  ++events;
+  if (buffer.size() >= FLUSH_BYTES) {
+    flush();
+  }
+}
+
+void TraceWriter::begin(const char* name, uint64_t number,
+                        const char* category, const char* phase, uint64_t ts,
+                        nsbaci::types::ThreadID thread) {
+  if (events > 0) {
+    buffer += ",\n";
+  }
+  buffer += "{\"name\":\"";
+  buffer += name;
+  if (number != NO_NUMBER) {
+    appendNumber(number);
+  }
+  buffer += "\",\"cat\":\"";
+  buffer += category;
+  buffer += "\",\"ph\":\"";
+  buffer += phase;
+  buffer += "\",\"ts\":";
+  appendNumber(ts);
+  buffer += ",\"pid\":";
+  appendNumber(run);
+  buffer += ",\"tid\":";
+  appendNumber(thread);
+}
+
+void TraceWriter::end() {
+  if (finished) {
+    buffer.clear();
+    return;
+  }
+  buffer += '}';
+  ++events;
+  if (buffer.size() >= FLUSH_BYTES) {
+    flush();
+  }
+}
+
+void TraceWriter::appendNumber(uint64_t value) {
+  char digits[20];
+  char* last = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+  buffer.append(digits, last);
+}
+
+void TraceWriter::flush() {
+  if (!failed && !buffer.empty() && !sink(buffer)) {
+    failed = true;
+  }
+  buffer.clear();
+}
+
+}  // namespace nsbaci::services::runtime
@@ -0,0 +1,247 @@
+/**
+ * @file traceWriter.h
+ * @brief TraceWriter class declaration for nsbaci runtime service.
+ *
+ * This module defines a writer of the thread schedule in the Chrome Trace
+ * Event format, read by chrome://tracing and the Perfetto UI. Each thread
+ * gets a track with a slice per scheduling quantum and per wait, and
+ * semaphore and monitor operations show as instant events. Timestamps are
+ * virtual: one microsecond of trace time is one executed instruction.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_SERVICES_RUNTIME_TRACEWRITER_H
+#define NSBACI_SERVICES_RUNTIME_TRACEWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "codeImage.h"
+#include "runtimeTypes.h"
+
+/**
+ * @namespace nsbaci::services::runtime
+ * @brief Runtime services namespace for nsbaci.
+ */
+namespace nsbaci::services::runtime {
+
+/**
+ * @class TraceWriter
+ * @brief Streams the schedule of a run as Chrome Trace Event JSON.
+ *
+ * Events are formatted into a buffer that is handed to the sink whenever
+ * it grows past FLUSH_BYTES, so a trace of millions of events never sits
+ * in memory whole. A slice is written when it ends; its start is all that
+ * is kept meanwhile.
+ *
+ * Every run is a process in the trace. A new one starts at restart(), and
+ * whenever the steps go backwards, as after stepping back, so that slices
+ * of a discarded future never overlap the ones that replace them.
+ */
+class TraceWriter {
+ public:
+  /// @brief Receives the next part of the document; false if it failed.
+  using Sink = std::function<bool(const std::string&)>;
+
+  /// @brief Bytes buffered before they are handed to the sink.
+  static constexpr size_t FLUSH_BYTES = size_t(64) << 10;
+
+  /**
+   * @brief Starts the document.
+   * @param sink Where the document goes.
+   */
+  explicit TraceWriter(Sink sink);
+
+  /**
+   * @brief Ends the open slices and starts a new run.
+   * @param image The program the run executes, to name lines.
+   * @param step Steps executed when the run starts.
+   */
+  void restart(std::shared_ptr<const CodeImage> image, uint64_t step);
+
+  /**
+   * @brief Notes a thread executing an instruction.
+   * @param thread The thread.
+   * @param pc Address of the instruction.
+   * @param step Steps executed before this one.
+   */
+  void ran(nsbaci::types::ThreadID thread, uint32_t pc, uint64_t step);
+
+  /**
+   * @brief Notes a thread blocking on a semaphore or monitor.
+   * @param thread The thread.
+   * @param resource What it waits for.
+   * @param step Steps executed so far.
+   */
+  void blocked(nsbaci::types::ThreadID thread,
+               const nsbaci::types::WaitResource& resource, uint64_t step);
+
+  /**
+   * @brief Notes a blocked thread woken up.
+   * @param thread The thread.
+   * @param step Steps executed so far.
+   */
+  void woken(nsbaci::types::ThreadID thread, uint64_t step);
+
+  /**
+   * @brief Notes a thread taking a semaphore or monitor.
+   * @param thread The thread.
+   * @param resource What it took.
+   * @param step Steps executed so far.
+   */
+  void acquired(nsbaci::types::ThreadID thread,
+                const nsbaci::types::WaitResource& resource, uint64_t step);
+
+  /**
+   * @brief Notes a thread signalling a semaphore or leaving a monitor.
+   * @param thread The thread.
+   * @param resource What it released.
+   * @param step Steps executed so far.
+   */
+  void released(nsbaci::types::ThreadID thread,
+                const nsbaci::types::WaitResource& resource, uint64_t step);
+
+  /**
+   * @brief Notes a thread waiting for input; the wait ends when it next
+   * runs.
+   * @param thread The thread.
+   * @param step Steps executed so far.
+   */
+  void waitingInput(nsbaci::types::ThreadID thread, uint64_t step);
+
+  /**
+   * @brief Notes a thread terminating.
+   * @param thread The thread.
+   * @param step Steps executed so far.
+   */
+  void exited(nsbaci::types::ThreadID thread, uint64_t step);
+
+  /**
+   * @brief Ends the open slices and the document, and hands the rest to
+   * the sink. Nothing can be written afterwards.
+   * @param step Steps executed so far.
+   * @return False if the sink failed at any point.
+   */
+  bool finish(uint64_t step);
+
+  /**
+   * @brief Gets the number of events written.
+   * @return Events so far, metadata included.
+   */
+  uint64_t eventCount() const { return events; }
+
+ private:
+  /**
+   * @enum Wait
+   * @brief What a thread not running is waiting for.
+   */
+  enum class Wait { None, Resource, Input };
+
+  /**
+   * @struct Track
+   * @brief What is open on the track of one thread.
+   */
+  struct Track {
+    bool named = false;                    ///< Its name was written
+    Wait wait = Wait::None;                ///< Open wait, if any
+    nsbaci::types::WaitResource resource;  ///< What Wait::Resource is for
+    uint64_t since = 0;                    ///< Start of the open wait
+  };
+
+  /**
+   * @brief Follows the steps, starting a new run if they went back.
+   */
+  void advance(uint64_t step);
+
+  /**
+   * @brief Gets the track of a thread, naming it on first use.
+   */
+  Track& track(nsbaci::types::ThreadID thread);
+
+  /**
+   * @brief Writes the open quantum, if any.
+   */
+  void endQuantum();
+
+  /**
+   * @brief Writes the open wait of a thread, if any, as ending at a step.
+   */
+  void endWait(nsbaci::types::ThreadID thread, uint64_t step);
+
+  /**
+   * @brief Ends every open slice and starts the process of a new run.
+   */
+  void newRun(uint64_t step);
+
+  /**
+   * @brief Writes an instant event on a thread's track.
+   * @param name Text of the name, followed by number unless NO_NUMBER.
+   */
+  void instant(nsbaci::types::ThreadID thread, const char* name,
+               uint64_t number, uint64_t step);
+
+  /**
+   * @brief Writes the name of the current run, before its first event.
+   */
+  void nameRun();
+
+  /**
+   * @brief Writes a metadata event, or any other event formatted whole.
+   */
+  void append(const std::string& event);
+
+  /**
+   * @brief Starts writing an event, up to its thread ID.
+   * @param name Text of the name, followed by number unless NO_NUMBER.
+   */
+  void begin(const char* name, uint64_t number, const char* category,
+             const char* phase, uint64_t ts, nsbaci::types::ThreadID thread);
+
+  /**
+   * @brief Ends the event begun, flushing if the buffer is full.
+   */
+  void end();
+
+  /**
+   * @brief Appends a number in decimal to the buffer.
+   */
+  void appendNumber(uint64_t value);
+
+  /**
+   * @brief Hands the buffer to the sink.
+   */
+  void flush();
+
+  /// @brief Name with no number after it, for begin().
+  static constexpr uint64_t NO_NUMBER = UINT64_MAX;
+
+  Sink sink;              ///< Where the document goes
+  std::string buffer;     ///< Formatted, not yet handed over
+  bool failed = false;    ///< The sink failed; nothing more is sent
+  bool finished = false;  ///< The document is closed
+  uint64_t events = 0;    ///< Events written
+
+  uint32_t run = 0;                        ///< Process ID of the current run
+  uint64_t runStart = 0;                   ///< Step the current run began at
+  bool runNamed = false;                   ///< Its name was written
+  uint64_t latest = 0;                     ///< Highest step seen in this run
+  std::shared_ptr<const CodeImage> image;  ///< Program of the current run
+  std::vector<Track> tracks;               ///< By thread ID
+
+  bool running = false;                ///< A quantum is open
+  nsbaci::types::ThreadID runner = 0;  ///< Thread of the open quantum
+  uint64_t quantumStart = 0;           ///< Its first step
+  uint64_t quantumEnd = 0;             ///< One past its last step
+  uint32_t quantumPc = 0;              ///< Address of its first instruction
+};
+
+}  // namespace nsbaci::services::runtime
+
+#endif  // NSBACI_SERVICES_RUNTIME_TRACEWRITER_H
@@ -36,6 +36,7 @@ struct SymbolInfo {
   MemoryAddr address;
   std::string type;  ///< "int", "bool", "char", "void", etc.
   bool isGlobal;
+  uint32_t size = 1;  ///< Number of memory words (array length for arrays)
 };
 
 /// @brief Lookup table mapping variable names to their symbol info
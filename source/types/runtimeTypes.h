@@ -13,6 +13,9 @@
 #ifndef NSBACI_TYPES_RUNTIMETYPES_H
 #define NSBACI_TYPES_RUNTIMETYPES_H
 
+#include <cstdint>
+#include <tuple>
+
 /**
  * @namespace nsbaci::types
  * @brief Type definitions namespace for nsbaci.
@@ -32,6 +35,29 @@ enum class ThreadState {
   Terminated  ///< Thread has finished execution
 };
 
+enum class ResourceKind {
+  Semaphore,  ///< Counting semaphore; no owner, any thread may signal
+  Monitor,    ///< Monitor lock; owned by the thread inside the monitor
+  Spin        ///< Busy-wait loop, named by its backward jump's address
+};
+
+/**
+ * @struct WaitResource
+ * @brief Something a blocked thread waits for, named by its memory word
+ * (its instruction address for ResourceKind::Spin).
+ */
+struct WaitResource {
+  ResourceKind kind = ResourceKind::Semaphore;
+  uint32_t address = 0;
+
+  bool operator==(const WaitResource& other) const {
+    return kind == other.kind && address == other.address;
+  }
+  bool operator<(const WaitResource& other) const {
+    return std::tie(kind, address) < std::tie(other.kind, other.address);
+  }
+};
+
 /**
  * @struct Address
  * @brief Represents a memory address in the runtime.
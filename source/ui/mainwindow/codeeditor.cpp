@@ -9,8 +9,10 @@
 
 #include "codeeditor.h"
 
+#include <QMouseEvent>
 #include <QPainter>
 #include <QTextBlock>
+#include <QtMath>
 
 CodeEditor::CodeEditor(QWidget* parent) : QPlainTextEdit(parent) {
   lineNumberArea = new LineNumberArea(this);
@@ -21,6 +23,8 @@ CodeEditor::CodeEditor(QWidget* parent) : QPlainTextEdit(parent) {
           &CodeEditor::updateLineNumberArea);
   connect(this, &CodeEditor::cursorPositionChanged, this,
           &CodeEditor::highlightCurrentLine);
+  // Once edited, the source no longer matches the run
+  connect(this, &CodeEditor::textChanged, this, &CodeEditor::clearRunMarks);
 
   updateLineNumberAreaWidth(0);
   highlightCurrentLine();
@@ -78,9 +82,55 @@ void CodeEditor::highlightCurrentLine() {
     extraSelections.append(selection);
   }
 
+  for (int line : executionLines) {
+    QTextBlock block = document()->findBlockByNumber(line - 1);
+    if (!block.isValid()) {
+      continue;
+    }
+    QTextEdit::ExtraSelection selection;
+    selection.format.setBackground(QColor("#2d3a22"));
+    selection.format.setProperty(QTextFormat::FullWidthSelection, true);
+    selection.cursor = QTextCursor(block);
+    extraSelections.append(selection);
+  }
+
   setExtraSelections(extraSelections);
 }
 
+void CodeEditor::setExecutionLines(const QList<int>& lines) {
+  executionLines = lines;
+  highlightCurrentLine();
+}
+
+void CodeEditor::clearRunMarks() {
+  if (!executionLines.isEmpty()) {
+    executionLines.clear();
+    highlightCurrentLine();
+  }
+  if (!lineCounts.isEmpty()) {
+    setLineCounts({});
+  }
+}
+
+void CodeEditor::setLineCounts(const QList<quint64>& counts) {
+  lineCounts = counts;
+  maxLineCount = 0;
+  for (quint64 count : lineCounts) {
+    maxLineCount = qMax(maxLineCount, count);
+  }
+  lineNumberArea->update();
+}
+
+void CodeEditor::setBreakpointLines(const QList<int>& lines) {
+  breakpointLines = QSet<int>(lines.begin(), lines.end());
+  lineNumberArea->update();
+}
+
+void CodeEditor::lineNumberAreaMousePressEvent(QMouseEvent* event) {
+  QTextCursor cursor = cursorForPosition(QPoint(0, event->pos().y()));
+  emit lineNumberClicked(cursor.blockNumber() + 1);
+}
+
 void CodeEditor::lineNumberAreaPaintEvent(QPaintEvent* event) {
   QPainter painter(lineNumberArea);
   painter.fillRect(event->rect(), QColor("#1a1a1a"));
@@ -95,6 +145,25 @@ void CodeEditor::lineNumberAreaPaintEvent(QPaintEvent* event) {
     if (block.isVisible() && bottom >= event->rect().top()) {
       QString number = QString::number(blockNumber + 1);
 
+      // Heatmap: log scale, so lines run once still show against hot loops
+      quint64 count =
+          blockNumber + 1 < lineCounts.size() ? lineCounts[blockNumber + 1] : 0;
+      if (count > 0) {
+        qreal heat = qLn(qreal(count) + 1) / qLn(qreal(maxLineCount) + 1);
+        QColor shade = QColor("#7a2a12");
+        shade.setAlphaF(0.15 + 0.85 * heat);
+        painter.fillRect(0, top, lineNumberArea->width(), bottom - top, shade);
+      }
+
+      // Breakpoint marker left of the number
+      if (breakpointLines.contains(blockNumber + 1)) {
+        int size = fontMetrics().height() / 2;
+        painter.setBrush(QColor("#c04040"));
+        painter.setPen(Qt::NoPen);
+        painter.drawEllipse(2, top + (fontMetrics().height() - size) / 2, size,
+                            size);
+      }
+
       // Highlight current line number
       if (blockNumber == textCursor().blockNumber()) {
         painter.setPen(QColor("#a0a0a0"));
@@ -10,7 +10,9 @@
 #ifndef CODEEDITOR_H
 #define CODEEDITOR_H
 
+#include <QList>
 #include <QPlainTextEdit>
+#include <QSet>
 #include <QWidget>
 
 class LineNumberArea;
@@ -22,8 +24,18 @@ class CodeEditor : public QPlainTextEdit {
   explicit CodeEditor(QWidget* parent = nullptr);
 
   void lineNumberAreaPaintEvent(QPaintEvent* event);
+  void lineNumberAreaMousePressEvent(QMouseEvent* event);
   int lineNumberAreaWidth();
 
+  // Lines are 1-based, as shown in the line number area
+  void setExecutionLines(const QList<int>& lines);
+  void setBreakpointLines(const QList<int>& lines);
+  // Instructions executed per line, indexed by line; shades the line numbers
+  void setLineCounts(const QList<quint64>& counts);
+
+ signals:
+  void lineNumberClicked(int line);
+
  protected:
   void resizeEvent(QResizeEvent* event) override;
 
@@ -31,9 +43,14 @@ class CodeEditor : public QPlainTextEdit {
   void updateLineNumberAreaWidth(int newBlockCount);
   void highlightCurrentLine();
   void updateLineNumberArea(const QRect& rect, int dy);
+  void clearRunMarks();
 
  private:
   LineNumberArea* lineNumberArea;
+  QList<int> executionLines;  // Lines the threads of the last run were on
+  QSet<int> breakpointLines;  // Lines holding a breakpoint
+  QList<quint64> lineCounts;  // Profile of the last run, by line
+  quint64 maxLineCount = 0;   // Hottest line, for scaling the shading
 };
 
 class LineNumberArea : public QWidget {
@@ -50,6 +67,10 @@ class LineNumberArea : public QWidget {
     codeEditor->lineNumberAreaPaintEvent(event);
   }
 
+  void mousePressEvent(QMouseEvent* event) override {
+    codeEditor->lineNumberAreaMousePressEvent(event);
+  }
+
  private:
   CodeEditor* codeEditor;
 };
@@ -17,13 +17,16 @@
 #include <QFontDatabase>
 #include <QFrame>
 #include <QHBoxLayout>
+#include <QInputDialog>
 #include <QMenu>
 #include <QMenuBar>
 #include <QMessageBox>
+#include <QSignalBlocker>
 #include <QStatusBar>
 #include <QStyle>
 #include <QVBoxLayout>
 #include <QWidget>
+#include <limits>
 
 MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
   resize(900, 650);
@@ -364,8 +367,74 @@ void MainWindow::createMenuBar() {
   actionRun->setShortcut(QKeySequence(Qt::Key_F9));
   actionRun->setStatusTip(tr("Run the compiled program"));
 
+  actionDetectRaces = new QAction(tr("Detect Data &Races"), this);
+  actionDetectRaces->setStatusTip(
+      tr("Report unsynchronized accesses to shared variables while running"));
+  actionDetectRaces->setCheckable(true);
+
+  actionProfile = new QAction(tr("&Profile Execution"), this);
+  actionProfile->setStatusTip(
+      tr("Count the instructions each line runs and shade the line numbers, "
+         "and measure waits on semaphores and monitors"));
+  actionProfile->setCheckable(true);
+
+  actionSaveProfile = new QAction(tr("Save Pro&file"), this);
+  actionSaveProfile->setStatusTip(
+      tr("Save the profile of the current run next to the file, as CSV and "
+         "folded stacks, with the contention of its semaphores and monitors"));
+
+  actionTrace = new QAction(tr("Record &Trace"), this);
+  actionTrace->setStatusTip(
+      tr("Stream the thread schedule next to the file as a trace for the "
+         "Perfetto UI or chrome://tracing"));
+  actionTrace->setCheckable(true);
+
+  actionSaveReplay = new QAction(tr("Save Replay &Log"), this);
+  actionSaveReplay->setStatusTip(
+      tr("Save the current run's scheduling and input decisions next to the "
+         "file"));
+
+  actionReplay = new QAction(tr("Re&play Log"), this);
+  actionReplay->setStatusTip(
+      tr("Restart the program and repeat the run saved next to the file"));
+
+  actionSaveSession = new QAction(tr("Save &Session"), this);
+  actionSaveSession->setStatusTip(
+      tr("Save the whole state of the current run next to the file"));
+
+  actionResumeSession = new QAction(tr("Res&ume Session"), this);
+  actionResumeSession->setStatusTip(
+      tr("Carry on the run saved next to the file where it stopped"));
+
+  actionConditionalBreakpoint = new QAction(tr("Conditional &Breakpoint..."),
+                                            this);
+  actionConditionalBreakpoint->setStatusTip(
+      tr("Stop any thread at an instruction while a condition holds"));
+
+  actionAddInvariant = new QAction(tr("Add &Invariant..."), this);
+  actionAddInvariant->setStatusTip(
+      tr("Stop as soon as a condition on the variables stops holding"));
+
+  actionClearInvariants = new QAction(tr("&Clear Invariants"), this);
+  actionClearInvariants->setStatusTip(tr("Remove every invariant"));
+
   buildMenu->addAction(actionCompile);
   buildMenu->addAction(actionRun);
+  buildMenu->addSeparator();
+  buildMenu->addAction(actionDetectRaces);
+  buildMenu->addAction(actionProfile);
+  buildMenu->addAction(actionSaveProfile);
+  buildMenu->addAction(actionTrace);
+  buildMenu->addSeparator();
+  buildMenu->addAction(actionConditionalBreakpoint);
+  buildMenu->addAction(actionAddInvariant);
+  buildMenu->addAction(actionClearInvariants);
+  buildMenu->addSeparator();
+  buildMenu->addAction(actionSaveReplay);
+  buildMenu->addAction(actionReplay);
+  buildMenu->addSeparator();
+  buildMenu->addAction(actionSaveSession);
+  buildMenu->addAction(actionResumeSession);
 
   // Help menu
   QMenu* helpMenu = menuBar()->addMenu(tr("&Help"));
@@ -406,6 +475,26 @@ void MainWindow::createMenuBar() {
   // Build
   connect(actionCompile, &QAction::triggered, this, &MainWindow::onCompile);
   connect(actionRun, &QAction::triggered, this, &MainWindow::onRun);
+  connect(actionDetectRaces, &QAction::toggled, this,
+          &MainWindow::raceDetectionToggled);
+  connect(actionProfile, &QAction::toggled, this,
+          &MainWindow::profilingToggled);
+  connect(actionSaveProfile, &QAction::triggered, this,
+          &MainWindow::onSaveProfile);
+  connect(actionTrace, &QAction::toggled, this, &MainWindow::onTrace);
+  connect(actionSaveReplay, &QAction::triggered, this,
+          &MainWindow::onSaveReplay);
+  connect(actionReplay, &QAction::triggered, this, &MainWindow::onReplay);
+  connect(actionSaveSession, &QAction::triggered, this,
+          &MainWindow::onSaveSession);
+  connect(actionResumeSession, &QAction::triggered, this,
+          &MainWindow::onResumeSession);
+  connect(actionConditionalBreakpoint, &QAction::triggered, this,
+          &MainWindow::onConditionalBreakpoint);
+  connect(actionAddInvariant, &QAction::triggered, this,
+          &MainWindow::onAddInvariant);
+  connect(actionClearInvariants, &QAction::triggered, this,
+          &MainWindow::invariantsCleared);
 
   // Help
   connect(actionAbout, &QAction::triggered, this, &MainWindow::onAbout);
@@ -518,6 +607,8 @@ void MainWindow::createEditorView() {
   connect(runButton, &QToolButton::clicked, this, &MainWindow::onRun);
   connect(codeEditor, &CodeEditor::textChanged, this,
           &MainWindow::onTextChanged);
+  connect(codeEditor, &CodeEditor::lineNumberClicked, this,
+          &MainWindow::lineBreakpointToggled);
 }
 
 void MainWindow::createRuntimeView() {
@@ -528,6 +619,16 @@ void MainWindow::createRuntimeView() {
           &MainWindow::stepRequested);
   connect(runtimeView, &nsbaci::ui::RuntimeView::stepThreadRequested, this,
           &MainWindow::stepThreadRequested);
+  connect(runtimeView, &nsbaci::ui::RuntimeView::stepBackRequested, this,
+          &MainWindow::stepBackRequested);
+  connect(runtimeView, &nsbaci::ui::RuntimeView::runBackwardRequested, this,
+          &MainWindow::runBackwardRequested);
+  connect(runtimeView, &nsbaci::ui::RuntimeView::seekRequested, this,
+          &MainWindow::seekRequested);
+  connect(runtimeView, &nsbaci::ui::RuntimeView::breakpointToggled, this,
+          &MainWindow::breakpointToggled);
+  connect(runtimeView, &nsbaci::ui::RuntimeView::watchpointToggled, this,
+          &MainWindow::watchpointToggled);
   connect(runtimeView, &nsbaci::ui::RuntimeView::runRequested, this,
           &MainWindow::runContinueRequested);
   connect(runtimeView, &nsbaci::ui::RuntimeView::pauseRequested, this,
@@ -750,6 +851,113 @@ void MainWindow::onRun() {
   statusBar()->showMessage(tr("Running..."));
 }
 
+void MainWindow::onSaveReplay() {
+  if (!hasName) {
+    QMessageBox::warning(
+        this, tr("Cannot Save Replay Log"),
+        tr("Please save the program first; the log is stored next to it."));
+    return;
+  }
+  // program.nsb -> program.nsb.replay
+  emit saveReplayRequested(currentFilePath + ".replay");
+  statusBar()->showMessage(tr("Replay log saved"));
+}
+
+void MainWindow::onReplay() {
+  if (!hasName) {
+    QMessageBox::warning(
+        this, tr("Cannot Replay"),
+        tr("Please save the program first; the log is read from next to "
+           "it."));
+    return;
+  }
+  emit replayRequested(currentFilePath + ".replay");
+  statusBar()->showMessage(tr("Replaying..."));
+}
+
+void MainWindow::onSaveProfile() {
+  if (!hasName) {
+    QMessageBox::warning(
+        this, tr("Cannot Save Profile"),
+        tr("Please save the program first; the profile is stored next to "
+           "it."));
+    return;
+  }
+  // program.nsb -> program.nsb.profile.csv, program.nsb.profile.folded and
+  // program.nsb.profile.contention.csv
+  emit saveProfileRequested(currentFilePath + ".profile.csv");
+  statusBar()->showMessage(tr("Profile saved"));
+}
+
+void MainWindow::onTrace(bool checked) {
+  if (checked && !hasName) {
+    QMessageBox::warning(
+        this, tr("Cannot Record Trace"),
+        tr("Please save the program first; the trace is stored next to "
+           "it."));
+    QSignalBlocker blocker(actionTrace);
+    actionTrace->setChecked(false);
+    return;
+  }
+  // program.nsb -> program.nsb.trace.json
+  emit traceToggled(checked, currentFilePath + ".trace.json");
+  statusBar()->showMessage(checked ? tr("Recording trace...")
+                                   : tr("Trace saved"));
+}
+
+void MainWindow::onSaveSession() {
+  if (!hasName) {
+    QMessageBox::warning(
+        this, tr("Cannot Save Session"),
+        tr("Please save the program first; the session is stored next to "
+           "it."));
+    return;
+  }
+  // program.nsb -> program.nsb.session
+  emit saveSessionRequested(currentFilePath + ".session");
+  statusBar()->showMessage(tr("Session saved"));
+}
+
+void MainWindow::onResumeSession() {
+  if (!hasName) {
+    QMessageBox::warning(
+        this, tr("Cannot Resume Session"),
+        tr("Please save the program first; the session is read from next to "
+           "it."));
+    return;
+  }
+  emit resumeSessionRequested(currentFilePath + ".session");
+  statusBar()->showMessage(tr("Session resumed"));
+}
+
+void MainWindow::onConditionalBreakpoint() {
+  bool ok = false;
+  int pc = QInputDialog::getInt(this, tr("Conditional Breakpoint"),
+                                tr("Instruction address:"), 0, 0,
+                                std::numeric_limits<int>::max(), 1, &ok);
+  if (!ok) {
+    return;
+  }
+  QString condition = QInputDialog::getText(
+      this, tr("Conditional Breakpoint"),
+      tr("Stop when (e.g. count > 10):"), QLineEdit::Normal, QString(), &ok);
+  if (ok && !condition.trimmed().isEmpty()) {
+    emit conditionalBreakpointRequested(static_cast<quint32>(pc),
+                                        condition.trimmed());
+  }
+}
+
+void MainWindow::onAddInvariant() {
+  bool ok = false;
+  QString text = QInputDialog::getText(
+      this, tr("Add Invariant"),
+      tr("Must always hold (e.g. mutex_count <= 1):"), QLineEdit::Normal,
+      QString(), &ok);
+  if (ok && !text.trimmed().isEmpty()) {
+    emit invariantAdded(text.trimmed());
+  }
+}
+
 // Help slots
 
 void MainWindow::onAbout() {
@@ -823,6 +1031,26 @@ void MainWindow::onVariablesUpdated(
   runtimeView->updateVariables(variables);
 }
 
+void MainWindow::onTimelineUpdated(quint64 position, quint64 length) {
+  runtimeView->updateTimeline(position, length);
+}
+
+void MainWindow::onExecutionLinesUpdated(const QList<int>& lines) {
+  codeEditor->setExecutionLines(lines);
+}
+
+void MainWindow::onBreakpointLinesUpdated(const QList<int>& lines) {
+  codeEditor->setBreakpointLines(lines);
+}
+
+void MainWindow::onLineProfileUpdated(const QList<quint64>& counts) {
+  codeEditor->setLineCounts(counts);
+}
+
+void MainWindow::onStatsUpdated(const QString& summary) {
+  runtimeView->updateStats(summary);
+}
+
 void MainWindow::onOutputReceived(const QString& output) {
   runtimeView->appendOutput(output);
 }
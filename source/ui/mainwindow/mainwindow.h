@@ -45,11 +45,28 @@ class MainWindow : public QMainWindow {
   // Runtime control signals
   void stepRequested();
   void stepThreadRequested(nsbaci::types::ThreadID threadId);
+  void stepBackRequested();
+  void runBackwardRequested();
+  void seekRequested(quint64 position);
+  void breakpointToggled(quint32 pc, nsbaci::types::ThreadID threadId);
+  void watchpointToggled(quint32 address);
+  void lineBreakpointToggled(int line);
+  void conditionalBreakpointRequested(quint32 pc, const QString& condition);
+  void invariantAdded(const QString& text);
+  void invariantsCleared();
   void runContinueRequested();
   void pauseRequested();
   void resetRequested();
   void stopRequested();
   void inputProvided(const QString& input);
+  void raceDetectionToggled(bool enabled);
+  void profilingToggled(bool enabled);
+  void saveProfileRequested(const QString& filePath);
+  void traceToggled(bool enabled, const QString& filePath);
+  void saveReplayRequested(const QString& filePath);
+  void replayRequested(const QString& filePath);
+  void saveSessionRequested(const QString& filePath);
+  void resumeSessionRequested(const QString& filePath);
 
  public slots:
   void setEditorContents(const QString& contents);
@@ -72,6 +89,11 @@ class MainWindow : public QMainWindow {
       const std::vector<nsbaci::ui::VariableInfo>& variables);
   void onOutputReceived(const QString& output);
   void onInputRequested(const QString& prompt);
+  void onTimelineUpdated(quint64 position, quint64 length);
+  void onExecutionLinesUpdated(const QList<int>& lines);
+  void onBreakpointLinesUpdated(const QList<int>& lines);
+  void onLineProfileUpdated(const QList<quint64>& counts);
+  void onStatsUpdated(const QString& summary);
 
  private slots:
   // File menu
@@ -82,6 +104,14 @@ class MainWindow : public QMainWindow {
   void onExit();
   void onCompile();
   void onRun();
+  void onSaveReplay();
+  void onReplay();
+  void onSaveProfile();
+  void onTrace(bool checked);
+  void onSaveSession();
+  void onResumeSession();
+  void onConditionalBreakpoint();
+  void onAddInvariant();
 
   // Edit menu
   void onUndo();
@@ -150,6 +180,17 @@ class MainWindow : public QMainWindow {
   // Build actions
   QAction* actionCompile = nullptr;
   QAction* actionRun = nullptr;
+  QAction* actionDetectRaces = nullptr;
+  QAction* actionProfile = nullptr;
+  QAction* actionSaveProfile = nullptr;
+  QAction* actionTrace = nullptr;
+  QAction* actionSaveReplay = nullptr;
+  QAction* actionReplay = nullptr;
+  QAction* actionSaveSession = nullptr;
+  QAction* actionResumeSession = nullptr;
+  QAction* actionConditionalBreakpoint = nullptr;
+  QAction* actionAddInvariant = nullptr;
+  QAction* actionClearInvariants = nullptr;
 
   // Help actions
   QAction* actionAbout = nullptr;
@@ -9,6 +9,9 @@
 
 #include "runtimeView.h"
 
+#include <algorithm>
+#include <limits>
+
 #include <QFrame>
 #include <QGroupBox>
 #include <QStyle>
@@ -98,6 +101,28 @@ void RuntimeView::createToolbar() {
 
   QStyle* style = this->style();
 
+  // Run back button
+  runBackButton = new QToolButton();
+  runBackButton->setObjectName("runBackButton");
+  runBackButton->setText("Run Back");
+  runBackButton->setIcon(style->standardIcon(QStyle::SP_MediaSeekBackward));
+  runBackButton->setToolButtonStyle(Qt::ToolButtonTextBesideIcon);
+  runBackButton->setToolTip("Undo steps back to the start of the run");
+  connect(runBackButton, &QToolButton::clicked, this,
+          &RuntimeView::onRunBackwardClicked);
+  layout->addWidget(runBackButton);
+
+  // Step back button
+  stepBackButton = new QToolButton();
+  stepBackButton->setObjectName("stepBackButton");
+  stepBackButton->setText("Back");
+  stepBackButton->setIcon(style->standardIcon(QStyle::SP_MediaSkipBackward));
+  stepBackButton->setToolButtonStyle(Qt::ToolButtonTextBesideIcon);
+  stepBackButton->setToolTip("Undo the last instruction (Shift+F10)");
+  connect(stepBackButton, &QToolButton::clicked, this,
+          &RuntimeView::onStepBackClicked);
+  layout->addWidget(stepBackButton);
+
   // Step button
   stepButton = new QToolButton();
   stepButton->setObjectName("stepButton");
@@ -153,7 +178,30 @@ void RuntimeView::createToolbar() {
   connect(stopButton, &QToolButton::clicked, this, &RuntimeView::onStopClicked);
   layout->addWidget(stopButton);
 
-  layout->addStretch();
+  layout->addSpacing(12);
+
+  // Timeline slider: seeks when released, not on every pixel dragged
+  timelineSlider = new QSlider(Qt::Horizontal);
+  timelineSlider->setObjectName("timelineSlider");
+  timelineSlider->setRange(0, 0);
+  timelineSlider->setTracking(false);
+  timelineSlider->setToolTip("Jump to any step of the run so far");
+  connect(timelineSlider, &QSlider::valueChanged, this,
+          &RuntimeView::onTimelineMoved);
+  layout->addWidget(timelineSlider, 1);
+
+  timelineLabel = new QLabel("Step 0 / 0");
+  timelineLabel->setObjectName("timelineLabel");
+  layout->addWidget(timelineLabel);
+
+  layout->addSpacing(12);
+
+  // Runtime statistics, empty in builds without them
+  statsLabel = new QLabel;
+  statsLabel->setObjectName("runtimeStats");
+  layout->addWidget(statsLabel);
+
+  layout->addSpacing(12);
 
   // Status label
   statusLabel = new QLabel("Ready");
@@ -177,6 +225,9 @@ void RuntimeView::createThreadPanel() {
 
   connect(threadTree, &QTreeWidget::itemClicked, this,
           &RuntimeView::onThreadSelected);
+  // Double-clicking a thread toggles a breakpoint at its instruction
+  connect(threadTree, &QTreeWidget::itemDoubleClicked, this,
+          &RuntimeView::onThreadActivated);
 }
 
 void RuntimeView::createVariablePanel() {
@@ -197,6 +248,10 @@ void RuntimeView::createVariablePanel() {
   variableTable->setColumnWidth(3, 60);
   variableTable->horizontalHeader()->setSectionResizeMode(0,
                                                           QHeaderView::Stretch);
+
+  // Double-clicking a variable toggles a watchpoint on it
+  connect(variableTable, &QTableWidget::cellDoubleClicked, this,
+          &RuntimeView::onVariableActivated);
 }
 
 void RuntimeView::createConsolePanel() {
@@ -430,6 +485,7 @@ void RuntimeView::updateThreads(const std::vector<ThreadInfo>& threads) {
 
     // Store thread ID for selection
     item->setData(0, Qt::UserRole, QVariant::fromValue(thread.id));
+    item->setData(2, Qt::UserRole, static_cast<qulonglong>(thread.pc));
 
     threadTree->addTopLevelItem(item);
   }
@@ -460,6 +516,9 @@ void RuntimeView::updateExecutionState(bool running, bool halted) {
 
   stepButton->setEnabled(!running && !halted);
   runButton->setEnabled(!running && !halted);
+  stepBackButton->setEnabled(!running);
+  runBackButton->setEnabled(!running);
+  timelineSlider->setEnabled(!running);
   pauseButton->setEnabled(running);
   resetButton->setEnabled(!running);
 
@@ -472,6 +531,21 @@ void RuntimeView::updateExecutionState(bool running, bool halted) {
   }
 }
 
+void RuntimeView::updateTimeline(quint64 position, quint64 length) {
+  // QSlider counts in int; past that the slider stops at its end
+  const quint64 max = static_cast<quint64>(std::numeric_limits<int>::max());
+  updatingTimeline = true;
+  timelineSlider->setRange(0, static_cast<int>(std::min(length, max)));
+  timelineSlider->setValue(static_cast<int>(std::min(position, max)));
+  updatingTimeline = false;
+  timelineLabel->setText(
+      QString("Step %1 / %2").arg(position).arg(length));
+}
+
+void RuntimeView::updateStats(const QString& summary) {
+  statsLabel->setText(summary);
+}
+
 // I/O slots
 
 void RuntimeView::appendOutput(const QString& text) {
@@ -502,6 +576,7 @@ void RuntimeView::onProgramLoaded(const QString& programName) {
   variableTable->setRowCount(0);
   statusLabel->setText("Ready - " + programName);
   updateExecutionState(false, false);
+  updateTimeline(0, 0);
 }
 
 void RuntimeView::onProgramHalted() {
@@ -519,6 +594,10 @@ void RuntimeView::onStepClicked() {
   }
 }
 
+void RuntimeView::onStepBackClicked() { emit stepBackRequested(); }
+
+void RuntimeView::onRunBackwardClicked() { emit runBackwardRequested(); }
+
 void RuntimeView::onRunClicked() { emit runRequested(); }
 
 void RuntimeView::onPauseClicked() { emit pauseRequested(); }
@@ -527,6 +606,12 @@ void RuntimeView::onResetClicked() { emit resetRequested(); }
 
 void RuntimeView::onStopClicked() { emit stopRequested(); }
 
+void RuntimeView::onTimelineMoved(int value) {
+  if (!updatingTimeline) {
+    emit seekRequested(static_cast<quint64>(value));
+  }
+}
+
 void RuntimeView::onInputSubmitted() {
   if (!waitingForInput) {
     return;
@@ -559,4 +644,23 @@ void RuntimeView::onThreadSelected(QTreeWidgetItem* item, int /*column*/) {
   selectedThread = item->data(0, Qt::UserRole).value<nsbaci::types::ThreadID>();
 }
 
+void RuntimeView::onVariableActivated(int row, int /*column*/) {
+  QTableWidgetItem* address = variableTable->item(row, 3);
+  if (!address) {
+    return;
+  }
+
+  emit watchpointToggled(address->text().toUInt());
+}
+
+void RuntimeView::onThreadActivated(QTreeWidgetItem* item, int /*column*/) {
+  if (!item) {
+    return;
+  }
+
+  emit breakpointToggled(
+      static_cast<quint32>(item->data(2, Qt::UserRole).toULongLong()),
+      item->data(0, Qt::UserRole).value<nsbaci::types::ThreadID>());
+}
+
 }  // namespace nsbaci::ui
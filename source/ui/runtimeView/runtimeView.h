@@ -20,6 +20,7 @@
 #include <QListWidget>
 #include <QPlainTextEdit>
 #include <QPushButton>
+#include <QSlider>
 #include <QSplitter>
 #include <QTableWidget>
 #include <QToolButton>
@@ -40,6 +41,7 @@ struct ThreadInfo {
   nsbaci::types::ThreadState state;
   size_t pc;
   QString currentInstruction;
+  uint32_t line = 0;  // Source line of pc, 0 if unknown
 };
 
 /**
@@ -61,7 +63,8 @@ struct VariableInfo {
  * - Thread list with states and current instruction
  * - Variables/memory watch panel
  * - I/O console for program input/output
- * - Execution controls (step, run, pause, reset)
+ * - Execution controls (step back, run back, step, run, pause, reset)
+ * - Timeline slider to jump to any step of the run so far
  */
 class RuntimeView : public QWidget {
   Q_OBJECT
@@ -74,10 +77,15 @@ class RuntimeView : public QWidget {
   // Execution control signals
   void stepRequested();
   void stepThreadRequested(nsbaci::types::ThreadID threadId);
+  void stepBackRequested();
+  void runBackwardRequested();
   void runRequested();
   void pauseRequested();
   void resetRequested();
   void stopRequested();
+  void seekRequested(quint64 position);
+  void breakpointToggled(quint32 pc, nsbaci::types::ThreadID threadId);
+  void watchpointToggled(quint32 address);
 
   // I/O signals
   void inputProvided(const QString& input);
@@ -88,6 +96,8 @@ class RuntimeView : public QWidget {
   void updateVariables(const std::vector<VariableInfo>& variables);
   void updateCurrentInstruction(const QString& instruction);
   void updateExecutionState(bool running, bool halted);
+  void updateTimeline(quint64 position, quint64 length);
+  void updateStats(const QString& summary);
 
   // I/O
   void appendOutput(const QString& text);
@@ -100,12 +110,17 @@ class RuntimeView : public QWidget {
 
  private slots:
   void onStepClicked();
+  void onStepBackClicked();
+  void onRunBackwardClicked();
   void onRunClicked();
   void onPauseClicked();
   void onResetClicked();
   void onStopClicked();
+  void onTimelineMoved(int value);
   void onInputSubmitted();
   void onThreadSelected(QTreeWidgetItem* item, int column);
+  void onThreadActivated(QTreeWidgetItem* item, int column);
+  void onVariableActivated(int row, int column);
 
  private:
   void createUI();
@@ -117,12 +132,18 @@ class RuntimeView : public QWidget {
 
   // Toolbar
   QWidget* toolbar = nullptr;
+  QToolButton* runBackButton = nullptr;
+  QToolButton* stepBackButton = nullptr;
   QToolButton* stepButton = nullptr;
   QToolButton* runButton = nullptr;
   QToolButton* pauseButton = nullptr;
   QToolButton* resetButton = nullptr;
   QToolButton* stopButton = nullptr;
   QLabel* statusLabel = nullptr;
+  QLabel* statsLabel = nullptr;
+  QSlider* timelineSlider = nullptr;
+  QLabel* timelineLabel = nullptr;
+  bool updatingTimeline = false;  ///< Set while the slider follows the run
 
   // Thread panel
   QTreeWidget* threadTree = nullptr;
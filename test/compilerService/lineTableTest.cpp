@@ -0,0 +1,148 @@
+/**
+ * @file lineTableTest.cpp
+ * @brief Tests of the source line table emitted by the nsbaci compiler.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "lineTable.h"
+
+namespace {
+
+using nsbaci::compiler::LineTable;
+using nsbaci::compiler::PcRange;
+
+// Flattens ranges for comparison
+std::vector<uint32_t> bounds(const std::vector<PcRange>& ranges) {
+  std::vector<uint32_t> flat;
+  for (const auto& r : ranges) {
+    flat.push_back(r.begin);
+    flat.push_back(r.end);
+  }
+  return flat;
+}
+
+TEST(LineTableTest, MapsInstructionsToLines) {
+  LineTable lines;
+  lines.mark(0, 3);
+  lines.mark(2, 4);
+  lines.mark(5, 7);
+  lines.finish(8);
+
+  ASSERT_EQ(lines.runs().size(), 3u);
+  EXPECT_EQ(lines.instructionCount(), 8u);
+  EXPECT_EQ(lines.lineAt(0), 3u);
+  EXPECT_EQ(lines.lineAt(1), 3u);
+  EXPECT_EQ(lines.lineAt(4), 4u);
+  EXPECT_EQ(lines.lineAt(7), 7u);
+  EXPECT_EQ(lines.lineAt(8), 0u);
+
+  EXPECT_EQ(bounds(lines.pcsAt(4)), (std::vector<uint32_t>{2, 5}));
+  EXPECT_EQ(bounds(lines.pcsAt(7)), (std::vector<uint32_t>{5, 8}));
+  EXPECT_TRUE(lines.pcsAt(5).empty());
+
+  uint32_t pc = 0;
+  ASSERT_TRUE(lines.firstPcAt(7, pc));
+  EXPECT_EQ(pc, 5u);
+  EXPECT_FALSE(lines.firstPcAt(5, pc));
+  EXPECT_FALSE(lines.firstPcAt(1, pc));
+  EXPECT_FALSE(lines.firstPcAt(9, pc));
+}
+
+TEST(LineTableTest, InstructionsBeforeTheFirstMarkHaveNoLine) {
+  LineTable lines;
+  lines.mark(2, 1);
+  lines.finish(4);
+  EXPECT_EQ(lines.lineAt(0), 0u);
+  EXPECT_EQ(lines.lineAt(1), 0u);
+  EXPECT_EQ(lines.lineAt(2), 1u);
+}
+
+TEST(LineTableTest, LaterLowerMarkUndoesRuns) {
+  LineTable lines;
+  lines.mark(0, 1);
+  lines.mark(4, 2);
+  lines.mark(6, 3);
+  // The parser goes back to address 4 for the enclosing rule
+  lines.mark(4, 5);
+  lines.finish(8);
+
+  ASSERT_EQ(lines.runs().size(), 2u);
+  EXPECT_EQ(lines.lineAt(5), 5u);
+  EXPECT_EQ(lines.lineAt(7), 5u);
+  EXPECT_TRUE(lines.pcsAt(2).empty());
+  EXPECT_TRUE(lines.pcsAt(3).empty());
+  EXPECT_EQ(bounds(lines.pcsAt(5)), (std::vector<uint32_t>{4, 8}));
+}
+
+TEST(LineTableTest, EqualNeighbouringRunsAreMerged) {
+  LineTable lines;
+  lines.mark(0, 1);
+  lines.mark(2, 1);  // Same line: still the first run
+  EXPECT_EQ(lines.runs().size(), 1u);
+
+  // A lower mark drops line 2 and joins the run before it, since both
+  // are line 1
+  lines.mark(4, 2);
+  lines.mark(3, 1);
+  lines.mark(5, 1);
+  lines.mark(5, 3);
+  lines.finish(6);
+
+  ASSERT_EQ(lines.runs().size(), 2u);
+  EXPECT_EQ(lines.runs()[0].pc, 0u);
+  EXPECT_EQ(lines.runs()[0].line, 1u);
+  EXPECT_EQ(lines.runs()[1].pc, 5u);
+  EXPECT_EQ(lines.runs()[1].line, 3u);
+  EXPECT_EQ(bounds(lines.pcsAt(1)), (std::vector<uint32_t>{0, 5}));
+}
+
+TEST(LineTableTest, LineSplitOverSeveralRanges) {
+  // A while loop on line 2: its condition is tested after the body
+  LineTable lines;
+  lines.mark(0, 1);
+  lines.mark(1, 2);
+  lines.mark(3, 3);
+  lines.mark(6, 2);
+  lines.mark(8, 4);
+  lines.mark(9, 2);
+  lines.finish(10);
+
+  EXPECT_EQ(bounds(lines.pcsAt(2)),
+            (std::vector<uint32_t>{1, 3, 6, 8, 9, 10}));
+  uint32_t pc = 0;
+  ASSERT_TRUE(lines.firstPcAt(2, pc));
+  EXPECT_EQ(pc, 1u);
+  EXPECT_EQ(bounds(lines.pcsAt(3)), (std::vector<uint32_t>{3, 6}));
+  EXPECT_EQ(lines.lineAt(7), 2u);
+  EXPECT_EQ(lines.lineAt(8), 4u);
+}
+
+TEST(LineTableTest, FinishDropsRunsPastTheEnd) {
+  LineTable lines;
+  lines.mark(0, 1);
+  lines.mark(3, 2);
+  lines.finish(3);
+
+  ASSERT_EQ(lines.runs().size(), 1u);
+  EXPECT_TRUE(lines.pcsAt(2).empty());
+  EXPECT_EQ(bounds(lines.pcsAt(1)), (std::vector<uint32_t>{0, 3}));
+}
+
+TEST(LineTableTest, EmptyTable) {
+  LineTable lines;
+  lines.finish(0);
+  EXPECT_TRUE(lines.empty());
+  EXPECT_EQ(lines.lineAt(0), 0u);
+  EXPECT_TRUE(lines.pcsAt(1).empty());
+  uint32_t pc = 0;
+  EXPECT_FALSE(lines.firstPcAt(1, pc));
+}
+
+}  // namespace
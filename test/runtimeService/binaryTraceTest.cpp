@@ -0,0 +1,277 @@
+/**
+ * @file binaryTraceTest.cpp
+ * @brief Tests of the binary execution trace format of the nsbaci runtime
+ * service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binaryTraceReader.h"
+#include "binaryTraceWriter.h"
+
+namespace {
+
+using nsbaci::compiler::Opcode;
+using namespace nsbaci::services::runtime;
+namespace bt = nsbaci::services::runtime::binarytrace;
+
+/**
+ * @brief A writer whose file is kept in a string.
+ */
+struct Trace {
+  std::string file;
+  BinaryTraceWriter writer{[this](const std::string& part) {
+    file += part;
+    return true;
+  }};
+  std::vector<TraceRecord> records;  ///< What was recorded.
+
+  void record(const TraceRecord& r) {
+    writer.record(r.step, r.thread, r.pc, r.opcode, r.writes);
+    records.push_back(r);
+  }
+};
+
+// Mostly straight-line steps of a few threads, with the odd jump in pc or
+// step, a thread above PC_THREADS and writes of negative values
+void fill(Trace& trace, size_t count, uint32_t run, uint64_t firstStep) {
+  std::mt19937 random(count + run);
+  std::vector<uint32_t> pcs(4, 0);
+  uint64_t step = firstStep;
+  for (size_t i = 0; i < count; ++i) {
+    TraceRecord r;
+    r.run = run;
+    r.step = step;
+    size_t which = random() % 5;
+    r.thread = which < 4 ? which : 300;
+    uint32_t& pc = pcs[which % 4];
+    r.pc = random() % 8 == 0 ? random() % 1000 : pc;
+    pc = r.pc + 1;
+    r.opcode = static_cast<Opcode>(random() % uint32_t(Opcode::_Count));
+    for (uint32_t w = random() % 4; w > 0; --w) {
+      r.writes.push_back(
+          {uint32_t(random() % 4096), int32_t(random()) - (1 << 30)});
+    }
+    trace.record(r);
+    step += random() % 16 == 0 ? 1 + random() % 1000 : 1;
+  }
+}
+
+std::vector<TraceRecord> readAll(BinaryTraceReader::Cursor cursor) {
+  std::vector<TraceRecord> out;
+  TraceRecord r;
+  while (cursor.next(r)) {
+    out.push_back(r);
+  }
+  EXPECT_FALSE(cursor.corrupt());
+  return out;
+}
+
+void expectSame(const std::vector<TraceRecord>& read,
+                const std::vector<TraceRecord>& written) {
+  ASSERT_EQ(read.size(), written.size());
+  for (size_t i = 0; i < read.size(); ++i) {
+    const TraceRecord& a = read[i];
+    const TraceRecord& b = written[i];
+    ASSERT_EQ(a.run, b.run) << i;
+    ASSERT_EQ(a.step, b.step) << i;
+    ASSERT_EQ(a.thread, b.thread) << i;
+    ASSERT_EQ(a.pc, b.pc) << i;
+    ASSERT_EQ(a.opcode, b.opcode) << i;
+    ASSERT_EQ(a.writes.size(), b.writes.size()) << i;
+    for (size_t w = 0; w < a.writes.size(); ++w) {
+      ASSERT_EQ(a.writes[w].address, b.writes[w].address) << i;
+      ASSERT_EQ(a.writes[w].value, b.writes[w].value) << i;
+    }
+  }
+}
+
+TEST(BinaryTraceTest, RoundTripOverManyBlocks) {
+  Trace trace;
+  fill(trace, 100000, 0, 0);
+  ASSERT_TRUE(trace.writer.finish());
+
+  auto result = BinaryTraceReader::parse(trace.file.data(), trace.file.size());
+  ASSERT_TRUE(result.ok);
+  EXPECT_GT(result.reader.blockCount(), 2u);
+  expectSame(readAll(result.reader.begin()), trace.records);
+}
+
+TEST(BinaryTraceTest, RunsStartAtRestartAndWhenStepsGoBack) {
+  Trace trace;
+  fill(trace, 500, 0, 0);
+  trace.writer.restart(200);
+  fill(trace, 500, 1, 200);
+  // Stepping back starts the next run on its own
+  fill(trace, 500, 2, 100);
+  ASSERT_TRUE(trace.writer.finish());
+
+  auto result = BinaryTraceReader::parse(trace.file.data(), trace.file.size());
+  ASSERT_TRUE(result.ok);
+  expectSame(readAll(result.reader.begin()), trace.records);
+}
+
+TEST(BinaryTraceTest, SeekFindsTheFirstRecordAtOrAfterAStep) {
+  Trace trace;
+  fill(trace, 60000, 0, 0);
+  trace.writer.restart(10);
+  fill(trace, 60000, 1, 10);
+  ASSERT_TRUE(trace.writer.finish());
+  auto result = BinaryTraceReader::parse(trace.file.data(), trace.file.size());
+  ASSERT_TRUE(result.ok);
+
+  std::mt19937 random(7);
+  for (int i = 0; i < 50; ++i) {
+    const TraceRecord& target = trace.records[random() % trace.records.size()];
+    uint64_t step = target.step > 0 ? target.step - random() % 2 : 0;
+    size_t first = 0;
+    while (trace.records[first].run < target.run ||
+           (trace.records[first].run == target.run &&
+            trace.records[first].step < step)) {
+      ++first;
+    }
+    TraceRecord r;
+    auto cursor = result.reader.seek(target.run, step);
+    ASSERT_TRUE(cursor.next(r));
+    expectSame({r}, {trace.records[first]});
+  }
+
+  TraceRecord r;
+  auto end = result.reader.seek(2, 0);
+  EXPECT_FALSE(end.next(r));
+  EXPECT_FALSE(end.corrupt());
+}
+
+TEST(BinaryTraceTest, ManyWritesAreSplitOverRecordsOfOneStep) {
+  Trace trace;
+  TraceRecord big;
+  big.step = 5;
+  big.thread = 1;
+  big.pc = 40;
+  big.opcode = Opcode::CopyBlock;
+  for (uint32_t i = 0; i < bt::MAX_WRITES * 2 + 3; ++i) {
+    big.writes.push_back({i, int32_t(i) * 3});
+  }
+  trace.writer.record(big.step, big.thread, big.pc, big.opcode, big.writes);
+  ASSERT_TRUE(trace.writer.finish());
+
+  auto result = BinaryTraceReader::parse(trace.file.data(), trace.file.size());
+  ASSERT_TRUE(result.ok);
+  auto read = readAll(result.reader.begin());
+  ASSERT_EQ(read.size(), 3u);
+  TraceRecord joined = read.front();
+  joined.writes.clear();
+  for (const auto& r : read) {
+    EXPECT_EQ(r.step, big.step);
+    EXPECT_EQ(r.thread, big.thread);
+    EXPECT_EQ(r.opcode, big.opcode);
+    joined.writes.insert(joined.writes.end(), r.writes.begin(),
+                         r.writes.end());
+  }
+  expectSame({joined}, {big});
+}
+
+TEST(BinaryTraceTest, TruncatedTraceReadsItsCompleteBlocks) {
+  Trace trace;
+  fill(trace, 100000, 0, 0);
+  ASSERT_TRUE(trace.writer.finish());
+  auto whole = BinaryTraceReader::parse(trace.file.data(), trace.file.size());
+  ASSERT_TRUE(whole.ok);
+  ASSERT_GT(whole.reader.blockCount(), 2u);
+  size_t kept = whole.reader.blockHeader(0).records +
+                whole.reader.blockHeader(1).records;
+
+  // Cut in the middle of the third block, as by a writer that never
+  // finished
+  size_t size = bt::FILE_HEADER_SIZE + 2 * bt::BLOCK_SIZE + 100;
+  auto cut = BinaryTraceReader::parse(trace.file.data(), size);
+  ASSERT_TRUE(cut.ok);
+  auto read = readAll(cut.reader.begin());
+  trace.records.resize(kept);
+  expectSame(read, trace.records);
+
+  // Cut inside a block header: that block does not count
+  size = bt::FILE_HEADER_SIZE + bt::BLOCK_SIZE + bt::BLOCK_HEADER_SIZE - 1;
+  cut = BinaryTraceReader::parse(trace.file.data(), size);
+  ASSERT_TRUE(cut.ok);
+  EXPECT_EQ(cut.reader.blockCount(), 1u);
+
+  EXPECT_FALSE(
+      BinaryTraceReader::parse(trace.file.data(), bt::FILE_HEADER_SIZE - 1)
+          .ok);
+}
+
+TEST(BinaryTraceTest, BadHeadersAreRejected) {
+  Trace trace;
+  fill(trace, 10, 0, 0);
+  ASSERT_TRUE(trace.writer.finish());
+  auto parses = [](const std::string& file) {
+    return BinaryTraceReader::parse(file.data(), file.size()).ok;
+  };
+  ASSERT_TRUE(parses(trace.file));
+
+  std::string magic = trace.file;
+  magic[0] = 'X';
+  EXPECT_FALSE(parses(magic));
+  std::string version = trace.file;
+  version[8] = 9;
+  EXPECT_FALSE(parses(version));
+  std::string order = trace.file;
+  std::swap(order[12], order[15]);
+  EXPECT_FALSE(parses(order));
+  std::string blockSize = trace.file;
+  blockSize[16] ^= 1;
+  EXPECT_FALSE(parses(blockSize));
+}
+
+TEST(BinaryTraceTest, CorruptRecordStopsTheCursor) {
+  Trace trace;
+  fill(trace, 100000, 0, 0);
+  ASSERT_TRUE(trace.writer.finish());
+  // A control record of an unknown kind at the start of the second block
+  trace.file[bt::FILE_HEADER_SIZE + bt::BLOCK_SIZE + bt::BLOCK_HEADER_SIZE] =
+      static_cast<char>(0xff);
+  auto result = BinaryTraceReader::parse(trace.file.data(), trace.file.size());
+  ASSERT_TRUE(result.ok);
+
+  auto cursor = result.reader.begin();
+  TraceRecord r;
+  size_t read = 0;
+  while (cursor.next(r)) {
+    ++read;
+  }
+  EXPECT_TRUE(cursor.corrupt());
+  EXPECT_EQ(read, result.reader.blockHeader(0).records);
+
+  // A block claiming more bytes than it holds, followed by another
+  std::string file = trace.file;
+  uint32_t bytes = bt::BLOCK_SIZE;
+  std::memcpy(&file[bt::FILE_HEADER_SIZE + 24], &bytes, 4);
+  result = BinaryTraceReader::parse(file.data(), file.size());
+  ASSERT_TRUE(result.ok);
+  cursor = result.reader.begin();
+  EXPECT_FALSE(cursor.next(r));
+  EXPECT_TRUE(cursor.corrupt());
+}
+
+TEST(BinaryTraceTest, FinishReportsAFailedSink) {
+  int calls = 0;
+  BinaryTraceWriter writer([&calls](const std::string&) {
+    return ++calls == 1;  // Only the file header gets through
+  });
+  writer.record(0, 0, 0, Opcode::Halt, {});
+  EXPECT_FALSE(writer.finish());
+  EXPECT_EQ(calls, 2);
+}
+
+}  // namespace
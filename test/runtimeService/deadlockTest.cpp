@@ -0,0 +1,135 @@
+/**
+ * @file deadlockTest.cpp
+ * @brief Tests of deadlock detection in the nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "nsbaciInterpreter.h"
+#include "runtimeFixture.h"
+#include "runtimeService.h"
+
+namespace {
+
+using nsbaci::compiler::Instruction;
+using nsbaci::compiler::InstructionStream;
+using nsbaci::compiler::Opcode;
+using nsbaci::services::RuntimeResult;
+using nsbaci::services::RuntimeService;
+using namespace nsbaci::services::runtime;
+using namespace nsbaci::test;
+
+constexpr uint32_t SEM_A = 0;
+constexpr uint32_t SEM_B = 1;
+constexpr uint32_t COUNTER = 2;
+
+// Main thread: counts for ever if rounds is 0, otherwise for that many
+// rounds and then signals A
+void counter(InstructionStream& is, int32_t rounds) {
+  uint32_t top = static_cast<uint32_t>(is.size());
+  is.emplace_back(Opcode::LoadValue, COUNTER);
+  is.emplace_back(Opcode::PushLiteral, int32_t(1));
+  is.emplace_back(Opcode::Add);
+  if (rounds == 0) {
+    is.emplace_back(Opcode::Store, COUNTER);
+    is.emplace_back(Opcode::Jump, int32_t(top));
+    return;
+  }
+  is.emplace_back(Opcode::StoreKeep, COUNTER);
+  is.emplace_back(Opcode::PushLiteral, rounds);
+  is.emplace_back(Opcode::TestLT);
+  is.emplace_back(Opcode::JumpZero, int32_t(is.size() + 2));
+  is.emplace_back(Opcode::Jump, int32_t(top));
+  signal(is, SEM_A);
+  is.emplace_back(Opcode::Halt);
+}
+
+// Thread 1 waits for A then signals B; thread 2 waits for B then signals A
+RuntimeService crossedWaits(int32_t rounds) {
+  InstructionStream is;
+  counter(is, rounds);
+  uint32_t first = static_cast<uint32_t>(is.size());
+  waitOn(is, SEM_A);
+  signal(is, SEM_B);
+  is.emplace_back(Opcode::Halt);
+  uint32_t second = static_cast<uint32_t>(is.size());
+  waitOn(is, SEM_B);
+  signal(is, SEM_A);
+  is.emplace_back(Opcode::Halt);
+
+  nsbaci::types::SymbolTable symbols;
+  symbols["a"] = {"a", SEM_A, "semaphore", true};
+  symbols["b"] = {"b", SEM_B, "semaphore", true};
+  symbols["count"] = {"count", COUNTER, "int", true};
+
+  RuntimeService service(
+      std::make_unique<NsbaciInterpreter>(),
+      std::make_unique<StartsScheduler>(std::vector<uint32_t>{first, second}));
+  service.loadProgram(std::make_shared<const CodeImage>(std::move(is),
+                                                        std::move(symbols)));
+  return service;
+}
+
+TEST(DeadlockTest, TwoSemaphoresDeadlockWhileAnotherThreadRuns) {
+  // The main thread's loop never ends, so the deadlock is partial
+  RuntimeService service = crossedWaits(0);
+  auto result = service.run(10000);
+
+  ASSERT_TRUE(result.deadlock.has_value());
+  EXPECT_FALSE(result.deadlock->global);
+  ASSERT_EQ(result.deadlock->edges.size(), 2u);
+  std::vector<nsbaci::types::ThreadID> waiters;
+  for (const auto& edge : result.deadlock->edges) {
+    EXPECT_EQ(edge.resource.kind, nsbaci::types::ResourceKind::Semaphore);
+    EXPECT_FALSE(edge.holder.has_value());
+    waiters.push_back(edge.waiter);
+  }
+  std::sort(waiters.begin(), waiters.end());
+  EXPECT_EQ(waiters, (std::vector<nsbaci::types::ThreadID>{1, 2}));
+}
+
+TEST(DeadlockTest, NoDeadlockWhileARunningThreadCanStillSignal) {
+  // The main thread signals A once its loop ends, which frees both
+  RuntimeService service = crossedWaits(50);
+  RuntimeResult result;
+  do {
+    result = service.run(10000);
+    EXPECT_FALSE(result.deadlock.has_value());
+  } while (result.ok && !result.halted && !result.deadlock.has_value());
+
+  EXPECT_TRUE(result.ok);
+  EXPECT_TRUE(result.halted);
+}
+
+TEST(DeadlockTest, SemaphoreNobodyCanSignal) {
+  InstructionStream is;
+  counter(is, 0);
+  uint32_t waiter = static_cast<uint32_t>(is.size());
+  waitOn(is, SEM_A);
+  is.emplace_back(Opcode::Halt);
+
+  nsbaci::types::SymbolTable symbols;
+  symbols["a"] = {"a", SEM_A, "semaphore", true};
+  symbols["count"] = {"count", COUNTER, "int", true};
+  RuntimeService service(
+      std::make_unique<NsbaciInterpreter>(),
+      std::make_unique<StartsScheduler>(std::vector<uint32_t>{waiter}));
+  service.loadProgram(
+      std::make_shared<const CodeImage>(std::move(is), std::move(symbols)));
+
+  auto result = service.run(10000);
+  ASSERT_TRUE(result.deadlock.has_value());
+  EXPECT_FALSE(result.deadlock->global);
+  ASSERT_EQ(result.deadlock->edges.size(), 1u);
+  EXPECT_EQ(result.deadlock->edges.front().waiter, 1u);
+}
+
+}  // namespace
@@ -0,0 +1,282 @@
+/**
+ * @file historyTest.cpp
+ * @brief Tests of reverse stepping and seeking in the nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "nsbaciInterpreter.h"
+#include "runtimeFixture.h"
+#include "runtimeService.h"
+#include "session.h"
+
+namespace {
+
+using nsbaci::compiler::InstructionStream;
+using nsbaci::compiler::Opcode;
+using nsbaci::services::RuntimeResult;
+using nsbaci::services::RuntimeService;
+using namespace nsbaci::services::runtime;
+using namespace nsbaci::test;
+
+// Words of spinners()
+constexpr uint32_t FLAG = 0;
+constexpr uint32_t COUNTER = 1;
+
+// Words of handoff(), and the address of its Signal
+constexpr uint32_t SEM = 0;
+constexpr uint32_t VALUE = 1;
+constexpr uint32_t TOTAL = 2;
+constexpr uint32_t SIGNAL = 11;
+
+// Two threads spin on FLAG, so they get parked, while a third counts to
+// 1000 and then sets it
+RuntimeService spinners() {
+  InstructionStream is;
+  is.emplace_back(Opcode::Halt);
+  uint32_t spinner = static_cast<uint32_t>(is.size());
+  is.emplace_back(Opcode::LoadValue, FLAG);
+  is.emplace_back(Opcode::JumpZero, int32_t(spinner));
+  is.emplace_back(Opcode::Halt);
+  uint32_t worker = static_cast<uint32_t>(is.size());
+  is.emplace_back(Opcode::LoadValue, COUNTER);
+  is.emplace_back(Opcode::PushLiteral, int32_t(1));
+  is.emplace_back(Opcode::Add);
+  is.emplace_back(Opcode::StoreKeep, COUNTER);
+  is.emplace_back(Opcode::PushLiteral, int32_t(1000));
+  is.emplace_back(Opcode::TestLT);
+  is.emplace_back(Opcode::JumpZero, int32_t(is.size() + 2));
+  is.emplace_back(Opcode::Jump, int32_t(worker));
+  is.emplace_back(Opcode::PushLiteral, int32_t(1));
+  is.emplace_back(Opcode::Store, FLAG);
+  is.emplace_back(Opcode::Halt);
+
+  nsbaci::types::SymbolTable symbols;
+  symbols["count"] = {"count", COUNTER, "int", true};
+  symbols["flag"] = {"flag", FLAG, "int", true};
+
+  RuntimeService service(std::make_unique<NsbaciInterpreter>(),
+                         std::make_unique<StartsScheduler>(
+                             std::vector<uint32_t>{spinner, spinner, worker}));
+  service.loadProgram(
+      std::make_shared<const CodeImage>(std::move(is), std::move(symbols)));
+  return service;
+}
+
+// The main thread reads a value, stores it, counts to 30 and signals;
+// thread 1 waits for the signal and adds the value to the total
+RuntimeService handoff() {
+  InstructionStream is;
+  is.emplace_back(Opcode::Read);
+  is.emplace_back(Opcode::Store, VALUE);
+  uint32_t top = static_cast<uint32_t>(is.size());
+  is.emplace_back(Opcode::LoadValue, TOTAL);
+  is.emplace_back(Opcode::PushLiteral, int32_t(1));
+  is.emplace_back(Opcode::Add);
+  is.emplace_back(Opcode::StoreKeep, TOTAL);
+  is.emplace_back(Opcode::PushLiteral, int32_t(30));
+  is.emplace_back(Opcode::TestLT);
+  is.emplace_back(Opcode::JumpZero, int32_t(is.size() + 2));
+  is.emplace_back(Opcode::Jump, int32_t(top));
+  signal(is, SEM);
+  is.emplace_back(Opcode::Halt);
+  uint32_t waiter = static_cast<uint32_t>(is.size());
+  waitOn(is, SEM);
+  is.emplace_back(Opcode::LoadValue, TOTAL);
+  is.emplace_back(Opcode::LoadValue, VALUE);
+  is.emplace_back(Opcode::Add);
+  is.emplace_back(Opcode::Store, TOTAL);
+  is.emplace_back(Opcode::Halt);
+
+  nsbaci::types::SymbolTable symbols;
+  symbols["total"] = {"total", TOTAL, "int", true};
+  symbols["s"] = {"s", SEM, "semaphore", true};
+  symbols["value"] = {"value", VALUE, "int", true};
+
+  RuntimeService service(
+      std::make_unique<NsbaciInterpreter>(),
+      std::make_unique<StartsScheduler>(std::vector<uint32_t>{waiter}));
+  service.loadProgram(
+      std::make_shared<const CodeImage>(std::move(is), std::move(symbols)));
+  return service;
+}
+
+// Everything a step can change, as a session sees it
+struct State {
+  Session session;
+  uint64_t fingerprint = 0;
+};
+
+State capture(const RuntimeService& service) {
+  return {service.saveSession(), service.fingerprint()};
+}
+
+void expectSameState(const State& expected, const RuntimeService& service) {
+  State actual = capture(service);
+  const Session& e = expected.session;
+  const Session& a = actual.session;
+  EXPECT_EQ(a.memory, e.memory);
+  EXPECT_EQ(a.stepCount, e.stepCount);
+
+  ASSERT_EQ(a.threads.threads.size(), e.threads.threads.size());
+  for (size_t i = 0; i < e.threads.threads.size(); ++i) {
+    const Thread& et = e.threads.threads[i];
+    const Thread& at = a.threads.threads[i];
+    EXPECT_EQ(at.getId(), et.getId()) << "thread " << i;
+    EXPECT_EQ(at.getPC(), et.getPC()) << "thread " << i;
+    EXPECT_EQ(at.getBP(), et.getBP()) << "thread " << i;
+    EXPECT_EQ(at.getSP(), et.getSP()) << "thread " << i;
+    EXPECT_EQ(at.getState(), et.getState()) << "thread " << i;
+    EXPECT_EQ(at.getStack(), et.getStack()) << "thread " << i;
+
+    const WaitEdge* ee = e.threads.waitFor.edgeOf(et.getId());
+    const WaitEdge* ae = a.threads.waitFor.edgeOf(at.getId());
+    ASSERT_EQ(ae != nullptr, ee != nullptr) << "thread " << i;
+    if (ee) {
+      EXPECT_EQ(ae->resource, ee->resource) << "thread " << i;
+      EXPECT_EQ(ae->holder, ee->holder) << "thread " << i;
+    }
+  }
+  EXPECT_EQ(a.threads.readyQueue, e.threads.readyQueue);
+  EXPECT_EQ(a.threads.blockedQueue, e.threads.blockedQueue);
+  EXPECT_EQ(a.threads.ioQueue, e.threads.ioQueue);
+  EXPECT_EQ(a.threads.waitFor.size(), e.threads.waitFor.size());
+
+  EXPECT_EQ(a.input.waiting, e.input.waiting);
+  EXPECT_EQ(a.input.available, e.input.available);
+  EXPECT_EQ(a.input.value, e.input.value);
+  EXPECT_EQ(actual.fingerprint, expected.fingerprint);
+}
+
+// Steps thread id, checking the step back takes the service to where it
+// was before, then steps it again
+RuntimeResult stepAndUndo(RuntimeService& service, nsbaci::types::ThreadID id) {
+  State before = capture(service);
+  RuntimeResult result = service.stepThread(id);
+  EXPECT_TRUE(result.ok);
+  EXPECT_TRUE(service.stepBack().ok);
+  expectSameState(before, service);
+  return service.stepThread(id);
+}
+
+// Runs to the end, keeping the fingerprint at every position
+std::map<uint64_t, uint64_t> runToEnd(RuntimeService& service) {
+  std::map<uint64_t, uint64_t> fingerprints;
+  fingerprints[service.timelinePosition()] = service.fingerprint();
+  while (!service.isHalted()) {
+    EXPECT_TRUE(service.step().ok);
+    fingerprints[service.timelinePosition()] = service.fingerprint();
+  }
+  return fingerprints;
+}
+
+TEST(HistoryTest, SeekAndStepBackMatchTheOriginalRun) {
+  RuntimeService service = spinners();
+  // A small journal, so most seeks go through a checkpoint
+  service.setUndoJournalLimit(size_t(1) << 16);
+  service.setCheckpointInterval(200);
+  auto fingerprints = runToEnd(service);
+  ASSERT_GT(service.getSpinStats().parks, 0u);
+  const uint64_t end = service.timelineLength();
+
+  std::mt19937_64 random(5);
+  for (int i = 0; i < 100; ++i) {
+    uint64_t k = random() % (end + 1);
+    ASSERT_TRUE(service.seekTo(k).ok) << k;
+    ASSERT_EQ(service.timelinePosition(), k);
+    EXPECT_EQ(service.fingerprint(), fingerprints[k]) << "seek to " << k;
+    if (k > 0) {
+      ASSERT_TRUE(service.stepBack().ok) << k;
+      ASSERT_EQ(service.timelinePosition(), k - 1);
+      EXPECT_EQ(service.fingerprint(), fingerprints[k - 1])
+          << "step back from " << k;
+    }
+  }
+
+  // Back to the end, the run finishes as it did
+  ASSERT_TRUE(service.seekTo(end).ok);
+  EXPECT_EQ(service.fingerprint(), fingerprints[end]);
+}
+
+
+TEST(HistoryTest, StepBackUndoesABlockingWait) {
+  RuntimeService service = handoff();
+  service.setUndoJournalLimit(size_t(1) << 16);
+
+  ASSERT_TRUE(service.stepThread(1).ok);  // LoadAddress
+  ASSERT_TRUE(stepAndUndo(service, 1).ok);
+  const Thread& waiter = service.getThreads()[1];
+  EXPECT_EQ(waiter.getState(), nsbaci::types::ThreadState::Blocked);
+}
+
+TEST(HistoryTest, StepBackUndoesAReadThatConsumedInput) {
+  RuntimeService service = handoff();
+  service.setUndoJournalLimit(size_t(1) << 16);
+
+  ASSERT_TRUE(service.stepThread(0).needsInput);
+  service.provideInput("7");
+  ASSERT_TRUE(stepAndUndo(service, 0).ok);
+  EXPECT_FALSE(service.isWaitingForInput());
+  EXPECT_EQ(service.getThreads()[0].getStack(), std::vector<int32_t>{7});
+}
+
+TEST(HistoryTest, StepBackUndoesASignalThatWokeAThread) {
+  RuntimeService service = handoff();
+  service.setUndoJournalLimit(size_t(1) << 16);
+
+  ASSERT_TRUE(service.stepThread(1).ok);
+  ASSERT_TRUE(service.stepThread(1).ok);  // Blocks on the semaphore
+  ASSERT_TRUE(service.stepThread(0).needsInput);
+  service.provideInput("7");
+  while (service.getThreads()[0].getPC() != SIGNAL) {
+    ASSERT_TRUE(service.stepThread(0).ok);
+  }
+  ASSERT_TRUE(stepAndUndo(service, 0).ok);
+  EXPECT_NE(service.getThreads()[1].getState(),
+            nsbaci::types::ThreadState::Blocked);
+
+  while (!service.isHalted()) {
+    ASSERT_TRUE(service.step().ok);
+  }
+  EXPECT_EQ(service.getProgram().memory()[TOTAL], 37);
+}
+
+TEST(HistoryTest, StepBackRebuildsTheJournalFromCheckpoints) {
+  RuntimeService service = handoff();
+  // Too small for more than a handful of steps, so most steps back
+  // re-execute from a checkpoint to rebuild the journal
+  service.setUndoJournalLimit(size_t(1) << 12);
+  service.setCheckpointInterval(16);
+
+  std::map<uint64_t, State> states;
+  states[service.timelinePosition()] = capture(service);
+  while (!service.isHalted()) {
+    RuntimeResult r = service.step();
+    ASSERT_TRUE(r.ok);
+    if (r.needsInput) {
+      service.provideInput("7");
+    }
+    states[service.timelinePosition()] = capture(service);
+  }
+  ASSERT_GT(service.timelineLength(), 100u);
+
+  while (service.canStepBack()) {
+    ASSERT_TRUE(service.stepBack().ok);
+    uint64_t at = service.timelinePosition();
+    SCOPED_TRACE("position " + std::to_string(at));
+    expectSameState(states[at], service);
+  }
+  EXPECT_EQ(service.timelinePosition(), 0u);
+}
+
+}  // namespace
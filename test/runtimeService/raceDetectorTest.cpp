@@ -0,0 +1,173 @@
+/**
+ * @file raceDetectorTest.cpp
+ * @brief Tests of the data race detector of the nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "raceDetector.h"
+
+namespace {
+
+using namespace nsbaci::services::runtime;
+
+constexpr uint32_t WORD = 5;
+constexpr uint32_t OTHER = 6;
+constexpr uint32_t SEM = 0;
+constexpr uint32_t LOCK = 1;
+
+void expectRace(const Race& race, uint32_t address, Access first,
+                Access second) {
+  EXPECT_EQ(race.address, address);
+  EXPECT_EQ(race.first.thread, first.thread);
+  EXPECT_EQ(race.first.pc, first.pc);
+  EXPECT_EQ(race.first.write, first.write);
+  EXPECT_EQ(race.second.thread, second.thread);
+  EXPECT_EQ(race.second.pc, second.pc);
+  EXPECT_EQ(race.second.write, second.write);
+}
+
+TEST(RaceDetectorTest, UnorderedWritesRace) {
+  RaceDetector detector;
+  detector.write(0, WORD, 10);
+  detector.write(1, WORD, 20);
+  ASSERT_EQ(detector.races().size(), 1u);
+  expectRace(detector.races()[0], WORD, {0, 10, true}, {1, 20, true});
+  EXPECT_EQ(detector.races()[0].describe(),
+            "@5: thread 0 write at pc 10, thread 1 write at pc 20");
+}
+
+TEST(RaceDetectorTest, UnorderedReadAndWriteRace) {
+  RaceDetector detector;
+  detector.read(0, WORD, 10);
+  detector.write(1, WORD, 20);
+  detector.write(0, OTHER, 30);
+  detector.read(1, OTHER, 40);
+  ASSERT_EQ(detector.races().size(), 2u);
+  expectRace(detector.races()[0], WORD, {0, 10, false}, {1, 20, true});
+  expectRace(detector.races()[1], OTHER, {0, 30, true}, {1, 40, false});
+}
+
+TEST(RaceDetectorTest, AccessesOfOneThreadNeverRace) {
+  RaceDetector detector;
+  detector.write(0, WORD, 10);
+  detector.read(0, WORD, 11);
+  detector.write(0, WORD, 12);
+  EXPECT_TRUE(detector.races().empty());
+}
+
+TEST(RaceDetectorTest, SamePairOfInstructionsIsReportedOnce) {
+  RaceDetector detector;
+  for (int i = 0; i < 3; ++i) {
+    detector.write(0, WORD, 10);
+    detector.write(1, WORD, 20);
+  }
+  EXPECT_EQ(detector.races().size(), 1u);
+}
+
+TEST(RaceDetectorTest, ReleaseThenAcquireOrdersAccesses) {
+  RaceDetector detector;
+  detector.write(0, WORD, 10);
+  detector.release(0, SEM);
+  detector.acquire(1, SEM);
+  detector.write(1, WORD, 20);
+  detector.read(1, WORD, 21);
+
+  // Monitors too, and the order is transitive
+  detector.release(1, LOCK);
+  detector.acquire(2, LOCK);
+  detector.write(2, WORD, 30);
+  EXPECT_TRUE(detector.races().empty());
+}
+
+TEST(RaceDetectorTest, AcquireOfAnotherObjectDoesNotOrder) {
+  RaceDetector detector;
+  detector.write(0, WORD, 10);
+  detector.release(0, SEM);
+  detector.acquire(1, LOCK);
+  detector.write(1, WORD, 20);
+  ASSERT_EQ(detector.races().size(), 1u);
+  expectRace(detector.races()[0], WORD, {0, 10, true}, {1, 20, true});
+}
+
+TEST(RaceDetectorTest, AccessesAfterTheReleaseAreNotOrdered) {
+  RaceDetector detector;
+  detector.release(0, SEM);
+  detector.write(0, WORD, 10);
+  detector.acquire(1, SEM);
+  detector.write(1, WORD, 20);
+  ASSERT_EQ(detector.races().size(), 1u);
+  expectRace(detector.races()[0], WORD, {0, 10, true}, {1, 20, true});
+}
+
+TEST(RaceDetectorTest, ConcurrentReadsDoNotRace) {
+  RaceDetector detector;
+  detector.read(0, WORD, 10);
+  detector.read(1, WORD, 20);
+  detector.read(2, WORD, 30);
+  detector.read(1, WORD, 21);
+  EXPECT_TRUE(detector.races().empty());
+}
+
+TEST(RaceDetectorTest, WriteRacesWithEverySharedReadItDoesNotFollow) {
+  RaceDetector detector;
+  detector.read(0, WORD, 10);
+  detector.read(1, WORD, 20);
+  detector.read(2, WORD, 30);
+
+  // Thread 0 is ordered after thread 1's read only
+  detector.release(1, SEM);
+  detector.acquire(0, SEM);
+  detector.write(0, WORD, 40);
+  ASSERT_EQ(detector.races().size(), 1u);
+  expectRace(detector.races()[0], WORD, {2, 30, false}, {0, 40, true});
+}
+
+TEST(RaceDetectorTest, RecycledSharedReadsStartEmpty) {
+  RaceDetector detector;
+  // Threads 1 and 3 share the reads of WORD, then thread 0 writes it after
+  // both, which frees their shared read clocks
+  detector.read(1, WORD, 10);
+  detector.read(3, WORD, 30);
+  detector.release(1, SEM);
+  detector.release(3, SEM);
+  detector.acquire(0, SEM);
+  detector.write(0, WORD, 40);
+  EXPECT_TRUE(detector.races().empty());
+
+  // Reads of OTHER by threads 0 and 1 take the freed slot; thread 3's old
+  // read of WORD must not show up as one of them
+  detector.read(0, OTHER, 50);
+  detector.read(1, OTHER, 60);
+  detector.write(2, OTHER, 70);
+  ASSERT_EQ(detector.races().size(), 2u);
+  expectRace(detector.races()[0], OTHER, {0, 50, false}, {2, 70, true});
+  expectRace(detector.races()[1], OTHER, {1, 60, false}, {2, 70, true});
+
+  // And the write ended the sharing: a later read races with it alone
+  detector.read(3, OTHER, 80);
+  ASSERT_EQ(detector.races().size(), 3u);
+  expectRace(detector.races()[2], OTHER, {2, 70, true}, {3, 80, false});
+}
+
+TEST(RaceDetectorTest, ClearForgetsEverything) {
+  RaceDetector detector;
+  detector.write(0, WORD, 10);
+  detector.release(0, SEM);
+  detector.write(1, WORD, 20);
+  ASSERT_EQ(detector.races().size(), 1u);
+
+  detector.clear();
+  EXPECT_TRUE(detector.races().empty());
+  detector.acquire(1, SEM);
+  detector.write(1, WORD, 20);
+  detector.write(0, WORD, 10);
+  ASSERT_EQ(detector.races().size(), 1u);
+  expectRace(detector.races()[0], WORD, {1, 20, true}, {0, 10, true});
+}
+
+}  // namespace
@@ -0,0 +1,126 @@
+/**
+ * @file replayLogTest.cpp
+ * @brief Tests of the replay log text format of the nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "replayLog.h"
+
+namespace {
+
+using namespace nsbaci::services::runtime;
+
+ReplayLog sample() {
+  ReplayLog log;
+  for (int i = 0; i < 15; ++i) {
+    log.recordPick(0);
+  }
+  log.recordInput("42");
+  for (int i = 0; i < 3; ++i) {
+    log.recordPick(1);
+  }
+  log.recordPick(0);
+  log.recordInput("");
+  log.recordInput("  spaced out ");
+  log.recordPick(2);
+  return log;
+}
+
+void expectSameLog(const ReplayLog& actual, const ReplayLog& expected) {
+  ASSERT_EQ(actual.schedule().size(), expected.schedule().size());
+  for (size_t i = 0; i < expected.schedule().size(); ++i) {
+    EXPECT_EQ(actual.schedule()[i].thread, expected.schedule()[i].thread)
+        << "run " << i;
+    EXPECT_EQ(actual.schedule()[i].count, expected.schedule()[i].count)
+        << "run " << i;
+  }
+  EXPECT_EQ(actual.inputs(), expected.inputs());
+  EXPECT_EQ(actual.picks(), expected.picks());
+}
+
+TEST(ReplayLogTest, SerializeWritesRunsAndInputs) {
+  EXPECT_EQ(sample().serialize(),
+            "nsbaci-replay 1\n"
+            "schedule 4\n"
+            "0 15\n"
+            "1 3\n"
+            "0 1\n"
+            "2 1\n"
+            "inputs 3\n"
+            "42\n"
+            "\n"
+            "  spaced out \n");
+}
+
+TEST(ReplayLogTest, ParseReadsBackWhatSerializeWrote) {
+  ReplayLog log = sample();
+  auto parsed = ReplayLog::parse(log.serialize());
+  ASSERT_TRUE(parsed.ok);
+  expectSameLog(parsed.log, log);
+  EXPECT_EQ(parsed.log.picks(), 20u);
+  EXPECT_EQ(parsed.log.serialize(), log.serialize());
+
+  auto empty = ReplayLog::parse(ReplayLog().serialize());
+  ASSERT_TRUE(empty.ok);
+  EXPECT_TRUE(empty.log.empty());
+}
+
+TEST(ReplayLogTest, ParseAcceptsWindowsLineEndings) {
+  ReplayLog log = sample();
+  std::string text;
+  for (char c : log.serialize()) {
+    if (c == '\n') {
+      text += '\r';
+    }
+    text += c;
+  }
+  auto parsed = ReplayLog::parse(text);
+  ASSERT_TRUE(parsed.ok);
+  expectSameLog(parsed.log, log);
+}
+
+TEST(ReplayLogTest, ParsedLogReplaysTheSameDecisions) {
+  auto parsed = ReplayLog::parse(sample().serialize());
+  ASSERT_TRUE(parsed.ok);
+  ReplayCursor cursor(parsed.log);
+  std::vector<nsbaci::types::ThreadID> picks;
+  while (auto pick = cursor.nextPick()) {
+    picks.push_back(*pick);
+  }
+  ASSERT_EQ(picks.size(), 20u);
+  EXPECT_EQ(picks.front(), 0u);
+  EXPECT_EQ(picks[15], 1u);
+  EXPECT_EQ(picks[18], 0u);
+  EXPECT_EQ(picks.back(), 2u);
+  EXPECT_EQ(cursor.nextInput(), "42");
+  EXPECT_EQ(cursor.nextInput(), "");
+  EXPECT_EQ(cursor.nextInput(), "  spaced out ");
+  EXPECT_FALSE(cursor.nextInput().has_value());
+}
+
+TEST(ReplayLogTest, MalformedTextIsRejected) {
+  const std::vector<std::string> bad = {
+      "",
+      "nsbaci-replay 2\nschedule 0\ninputs 0\n",
+      "nsbaci-replay 1\n",
+      "nsbaci-replay 1\nschedule 2\n0 15\n",
+      "nsbaci-replay 1\nschedule 1\n0 0\ninputs 0\n",
+      "nsbaci-replay 1\nschedule 1\n0 15 3\ninputs 0\n",
+      "nsbaci-replay 1\nschedule 1\nzero 15\ninputs 0\n",
+      "nsbaci-replay 1\nschedule 0\n",
+      "nsbaci-replay 1\nschedule 0\ninputs 2\n42\n",
+  };
+  for (const auto& text : bad) {
+    EXPECT_FALSE(ReplayLog::parse(text).ok) << text;
+  }
+}
+
+}  // namespace
@@ -0,0 +1,67 @@
+/**
+ * @file runtimeFixture.h
+ * @brief Helpers shared by the tests of the nsbaci runtime service.
+ *
+ * Tests build small instruction streams by hand and run them under a
+ * scheduler that starts extra threads at chosen addresses, since the
+ * language itself has no cobegin yet.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#ifndef NSBACI_TEST_RUNTIME_FIXTURE_H
+#define NSBACI_TEST_RUNTIME_FIXTURE_H
+
+#include <utility>
+#include <vector>
+
+#include "instruction.h"
+#include "nsbaciScheduler.h"
+
+namespace nsbaci::test {
+
+/**
+ * @class StartsScheduler
+ * @brief Starts one more thread at each of the given addresses along with
+ * the main thread, which starts at 0.
+ */
+class StartsScheduler : public nsbaci::services::runtime::NsbaciScheduler {
+ public:
+  explicit StartsScheduler(std::vector<uint32_t> pcs)
+      : NsbaciScheduler(1), starts(std::move(pcs)) {}
+
+  void addThread(nsbaci::services::runtime::Thread t) override {
+    bool main = t.getId() == 0;
+    NsbaciScheduler::addThread(std::move(t));
+    if (main) {
+      for (uint32_t pc : starts) {
+        nsbaci::services::runtime::Thread extra(allocateThreadId());
+        extra.setPC(pc);
+        NsbaciScheduler::addThread(std::move(extra));
+      }
+    }
+  }
+
+ private:
+  std::vector<uint32_t> starts;
+};
+
+/// @brief Appends a Wait on the semaphore at the given address.
+inline void waitOn(nsbaci::compiler::InstructionStream& is,
+                   uint32_t semaphore) {
+  is.emplace_back(nsbaci::compiler::Opcode::LoadAddress, semaphore);
+  is.emplace_back(nsbaci::compiler::Opcode::Wait);
+}
+
+/// @brief Appends a Signal of the semaphore at the given address.
+inline void signal(nsbaci::compiler::InstructionStream& is,
+                   uint32_t semaphore) {
+  is.emplace_back(nsbaci::compiler::Opcode::LoadAddress, semaphore);
+  is.emplace_back(nsbaci::compiler::Opcode::Signal);
+}
+
+}  // namespace nsbaci::test
+
+#endif  // NSBACI_TEST_RUNTIME_FIXTURE_H
@@ -0,0 +1,221 @@
+/**
+ * @file sessionTest.cpp
+ * @brief Tests of the session file format of the nsbaci runtime service.
+ *
+ * @author Nicolás Serrano García
+ * @copyright Copyright (c) 2025 Nicolás Serrano García. Licensed under the MIT
+ * License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nsbaciInterpreter.h"
+#include "runtimeFixture.h"
+#include "runtimeService.h"
+#include "session.h"
+
+namespace {
+
+using nsbaci::compiler::InstructionStream;
+using nsbaci::compiler::Opcode;
+using nsbaci::services::RuntimeService;
+using namespace nsbaci::services::runtime;
+using namespace nsbaci::test;
+
+constexpr uint32_t SEM = 0;
+constexpr uint32_t COUNTER = 1;
+
+// Main thread counts to 20 then signals; thread 1 waits for the signal
+RuntimeService handoff() {
+  InstructionStream is;
+  uint32_t top = static_cast<uint32_t>(is.size());
+  is.emplace_back(Opcode::LoadValue, COUNTER);
+  is.emplace_back(Opcode::PushLiteral, int32_t(1));
+  is.emplace_back(Opcode::Add);
+  is.emplace_back(Opcode::StoreKeep, COUNTER);
+  is.emplace_back(Opcode::PushLiteral, int32_t(20));
+  is.emplace_back(Opcode::TestLT);
+  is.emplace_back(Opcode::JumpZero, int32_t(is.size() + 2));
+  is.emplace_back(Opcode::Jump, int32_t(top));
+  signal(is, SEM);
+  is.emplace_back(Opcode::Halt);
+  uint32_t waiter = static_cast<uint32_t>(is.size());
+  waitOn(is, SEM);
+  is.emplace_back(Opcode::Halt);
+
+  nsbaci::types::SymbolTable symbols;
+  symbols["count"] = {"count", COUNTER, "int", true};
+  symbols["s"] = {"s", SEM, "semaphore", true};
+
+  RuntimeService service(
+      std::make_unique<NsbaciInterpreter>(),
+      std::make_unique<StartsScheduler>(std::vector<uint32_t>{waiter}));
+  service.loadProgram(
+      std::make_shared<const CodeImage>(std::move(is), std::move(symbols)));
+  return service;
+}
+
+RuntimeService empty() {
+  return RuntimeService(
+      std::make_unique<NsbaciInterpreter>(),
+      std::make_unique<StartsScheduler>(std::vector<uint32_t>{0}));
+}
+
+// Session taken with thread 1 blocked on the semaphore and the main thread
+// halfway through its count
+Session midRun() {
+  RuntimeService service = handoff();
+  service.run(30);
+  return service.saveSession();
+}
+
+bool parses(const std::string& bytes) {
+  return Session::parse(bytes.data(), bytes.size()).ok;
+}
+
+// Offset and size of a section, from the table after the 24-byte header
+std::pair<size_t, size_t> section(const std::string& bytes, uint32_t kind) {
+  uint32_t count = 0;
+  std::memcpy(&count, bytes.data() + 16, 4);
+  for (uint32_t i = 0; i < count; ++i) {
+    const char* entry = bytes.data() + 24 + i * 24;
+    uint32_t k = 0;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    std::memcpy(&k, entry, 4);
+    std::memcpy(&offset, entry + 8, 8);
+    std::memcpy(&size, entry + 16, 8);
+    if (k == kind) {
+      return {size_t(offset), size_t(size)};
+    }
+  }
+  return {0, 0};
+}
+
+TEST(SessionTest, RoundTripResumesTheRun) {
+  RuntimeService original = handoff();
+  original.run(30);
+  std::string bytes = original.saveSession().serialize();
+
+  auto parsed = Session::parse(bytes.data(), bytes.size());
+  ASSERT_TRUE(parsed.ok);
+  RuntimeService resumed = empty();
+  ASSERT_TRUE(resumed.restoreSession(parsed.session).ok);
+  EXPECT_EQ(resumed.saveSession().serialize(), bytes);
+  EXPECT_EQ(resumed.fingerprint(), original.fingerprint());
+
+  while (!original.isHalted()) {
+    ASSERT_TRUE(original.run(1000).ok);
+  }
+  while (!resumed.isHalted()) {
+    ASSERT_TRUE(resumed.run(1000).ok);
+  }
+  EXPECT_EQ(resumed.getProgram().memory(), original.getProgram().memory());
+  EXPECT_EQ(resumed.getStepCount(), original.getStepCount());
+}
+
+TEST(SessionTest, TruncatedFilesAreRejected) {
+  std::string bytes = midRun().serialize();
+  size_t end = 0;
+  for (uint32_t kind = 1; kind <= 7; ++kind) {
+    auto [offset, size] = section(bytes, kind);
+    end = std::max(end, offset + size);
+  }
+  // Only the padding after the last section can go
+  for (size_t size = 0; size < bytes.size(); ++size) {
+    EXPECT_EQ(Session::parse(bytes.data(), size).ok, size >= end) << size;
+  }
+}
+
+TEST(SessionTest, BadHeadersAreRejected) {
+  std::string bytes = midRun().serialize();
+  std::string magic = bytes;
+  magic[0] = 'X';
+  EXPECT_FALSE(parses(magic));
+  std::string version = bytes;
+  version[8] = 9;
+  EXPECT_FALSE(parses(version));
+  std::string outside = bytes;
+  uint64_t offset = bytes.size();
+  std::memcpy(&outside[24 + 8], &offset, 8);
+  EXPECT_FALSE(parses(outside));
+}
+
+TEST(SessionTest, OperandOfTheWrongTypeIsRejected) {
+  Session s = midRun();
+  auto code = s.image->instructions();
+  code[1].operand1 = std::string("one");  // PushLiteral of a string
+  s.image = std::make_shared<const CodeImage>(code, s.image->symbols());
+  EXPECT_FALSE(parses(s.serialize()));
+
+  code = s.image->instructions();
+  code[1].operand1 = int32_t(1);
+  code[1].operand2 = int32_t(1);
+  s.image = std::make_shared<const CodeImage>(code, s.image->symbols());
+  EXPECT_FALSE(parses(s.serialize()));
+}
+
+TEST(SessionTest, DirectAddressPastTheSymbolsIsRejected) {
+  Session s = midRun();
+  auto code = s.image->instructions();
+  code[0].operand1 = uint32_t(2);  // LoadValue one past "s" and "count"
+  s.image = std::make_shared<const CodeImage>(code, s.image->symbols());
+  EXPECT_FALSE(parses(s.serialize()));
+}
+
+TEST(SessionTest, HugeSymbolIsRejectedBeforeAllocating) {
+  std::string bytes = midRun().serialize();
+  // Symbols are sorted by name, so the code section ends with the size of
+  // "s"
+  auto [offset, size] = section(bytes, 1);
+  uint32_t huge = 0xffffffff;
+  std::memcpy(&bytes[offset + size - 4], &huge, 4);
+  EXPECT_FALSE(parses(bytes));
+}
+
+TEST(SessionTest, BadThreadsAreRejected) {
+  Session good = midRun();
+  ASSERT_TRUE(parses(good.serialize()));
+
+  Session s = good;
+  s.threads.threads[1].setPC(
+      static_cast<uint32_t>(s.image->instructionCount()));
+  EXPECT_FALSE(parses(s.serialize()));
+
+  s = good;
+  s.threads.threads[0].setSP(s.threads.threads[0].getSP() + 1);
+  EXPECT_FALSE(parses(s.serialize()));
+
+  s = good;
+  s.threads.threads[1] = Thread(0);
+  EXPECT_FALSE(parses(s.serialize()));
+
+  s = good;
+  s.threads.nextThreadId = 1;
+  EXPECT_FALSE(parses(s.serialize()));
+}
+
+TEST(SessionTest, WaitEdgeOfAnUnknownThreadIsRejected) {
+  Session s = midRun();
+  ASSERT_FALSE(s.threads.waitFor.allEdges().empty());
+  WaitEdge edge;
+  edge.waiter = 7;
+  edge.resource = {nsbaci::types::ResourceKind::Semaphore, SEM};
+  s.threads.waitFor.add(edge);
+  EXPECT_FALSE(parses(s.serialize()));
+
+  s = midRun();
+  edge = s.threads.waitFor.allEdges().front();
+  edge.holder = 7;
+  s.threads.waitFor.add(edge);
+  EXPECT_FALSE(parses(s.serialize()));
+}
+
+}  // namespace